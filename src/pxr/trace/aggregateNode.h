@@ -11,6 +11,7 @@
 #include "pxr/trace/pxr.h"
 
 #include "pxr/trace/api.h"
+#include "pxr/trace/aggregateNodeArena.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/threads.h"
 
@@ -22,8 +23,9 @@
 #include <pxr/tf/declarePtrs.h>
 #include <pxr/arch/timing.h>
 
+#include <mutex>
+#include <string>
 #include <vector>
-#include <pxr/tf/denseHashMap.h>
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
@@ -36,6 +38,11 @@ TF_DECLARE_WEAK_AND_REF_PTRS(TraceAggregateNode);
 /// occurred in the trace. Multiple calls to a child node are aggregated into one
 /// node.
 ///
+/// A TraceAggregateNode is a view of a node of a TraceAggregateNodeArena,
+/// which holds the data of the node and of the rest of its tree. Views of the
+/// children of a node are only created when they are requested. Code which
+/// traverses large trees should use the arena directly.
+///
 
 class TraceAggregateNode : public TfRefBase, public TfWeakBase {
 public:
@@ -45,6 +52,7 @@ public:
     using ThisRefPtr = TraceAggregateNodeRefPtr;
 
     using TimeStamp = TraceEvent::TimeStamp;
+    using Index = TraceAggregateNodeArena::Index;
 
     // This class is only used for validity checks.
     // FIXME: This class should be removed.
@@ -62,43 +70,56 @@ public:
         return This::New(Id(), TfToken("root"), 0, 0);
     }
 
-    static ThisRefPtr New(const Id &id,
+    TRACE_API static ThisRefPtr New(const Id &id,
                           const TfToken &key,
                           const TimeStamp ts,
                           const int count = 1,
-                          const int exclusiveCount = 1) {
-        return TfCreateRefPtr(new This(id, key, ts, count, exclusiveCount));
+                          const int exclusiveCount = 1);
+
+    /// Creates a view of node \p index of \p arena.
+    static ThisRefPtr New(
+        const TraceAggregateNodeArenaRefPtr& arena, Index index) {
+        return TfCreateRefPtr(new This(arena, index));
     }
 
     TRACE_API TraceAggregateNodeRefPtr 
     Append(Id id, const TfToken &key, TimeStamp ts,
            int c = 1, int xc = 1);
 
+    /// Appends \p child and its descendants to this node. If this node
+    /// already has a child with the same key, \p child is merged into it,
+    /// otherwise a copy of \p child is appended.
     TRACE_API void Append(TraceAggregateNodeRefPtr child);
 
     /// Returns the node's key.
-    TfToken GetKey() { return _key;}
+    TfToken GetKey() const { return _arena->GetKey(_index); }
 
     /// Returns the node's id.
-    const Id &GetId() { return _id;}
+    TRACE_API const Id &GetId() const;
 
     /// \name Profile Data Accessors
     /// @{
 
     /// Returns the total time of this node ands its children.
-    TimeStamp GetInclusiveTime() { return _ts; }
+    TimeStamp GetInclusiveTime() const {
+        return _arena->GetInclusiveTime(_index);
+    }
 
     /// Returns the time spent in this node but not its children.
-    TRACE_API TimeStamp GetExclusiveTime(bool recursive = false);
+    TimeStamp GetExclusiveTime(bool recursive = false) const {
+        return _arena->GetExclusiveTime(_index, recursive);
+    }
 
     /// Returns the call count of this node. \p recursive determines if 
     /// recursive calls are counted.
     int GetCount(bool recursive = false) const {
-        return recursive ? _recursiveCount : _count; 
+        return _arena->GetCount(_index, recursive);
     }
 
     /// Returns the exclusive count.
-    int GetExclusiveCount() const { return _exclusiveCount; }
+    int GetExclusiveCount() const {
+        return _arena->GetExclusiveCount(_index);
+    }
 
     /// @}
 
@@ -106,31 +127,40 @@ public:
     /// \name Counter Value Accessors
     /// @{
 
-    TRACE_API void AppendInclusiveCounterValue(int index, double value);
+    void AppendInclusiveCounterValue(int index, double value) {
+        _arena->AppendInclusiveCounterValue(_index, index, value);
+    }
 
-    TRACE_API double GetInclusiveCounterValue(int index) const;
+    double GetInclusiveCounterValue(int index) const {
+        return _arena->GetInclusiveCounterValue(_index, index);
+    }
 
-    TRACE_API void AppendExclusiveCounterValue(int index, double value);
+    void AppendExclusiveCounterValue(int index, double value) {
+        _arena->AppendExclusiveCounterValue(_index, index, value);
+    }
 
-    TRACE_API double GetExclusiveCounterValue(int index) const;
+    double GetExclusiveCounterValue(int index) const {
+        return _arena->GetExclusiveCounterValue(_index, index);
+    }
 
     /// @}
 
     /// Recursively calculates the inclusive counter values from the inclusive 
     /// and exclusive counts of child nodes.
-    TRACE_API void CalculateInclusiveCounterValues();
+    void CalculateInclusiveCounterValues() {
+        _arena->CalculateInclusiveCounterValues(_index);
+    }
 
 
     /// \name Children Accessors
     /// @{
     const TraceAggregateNodePtrVector GetChildren() {
         // convert to a vector of weak ptrs
-        return TraceAggregateNodePtrVector( _children.begin(),_children.end() );
+        const TraceAggregateNodeRefPtrVector& children = GetChildrenRef();
+        return TraceAggregateNodePtrVector(children.begin(), children.end());
     }
 
-    const TraceAggregateNodeRefPtrVector &GetChildrenRef() {
-        return _children;
-    }
+    TRACE_API const TraceAggregateNodeRefPtrVector &GetChildrenRef();
 
     TRACE_API TraceAggregateNodeRefPtr GetChild(const TfToken &key);
     TraceAggregateNodeRefPtr GetChild(const std::string &key) {
@@ -142,12 +172,12 @@ public:
 
     /// Sets whether or not this node is expanded in a gui.
     void SetExpanded(bool expanded) {
-        _expanded = expanded;
+        _arena->SetExpanded(_index, expanded);
     }
 
     /// Returns whether this node is expanded in a gui.
-    bool IsExpanded() {
-        return _expanded;
+    bool IsExpanded() const {
+        return _arena->IsExpanded(_index);
     }
 
     /// Subtract \p scopeOverhead cost times the number of descendant nodes from
@@ -158,9 +188,12 @@ public:
     /// parent's exclusive time, but instead set their times to zero.  This way
     /// we retain the sample count, but do not pollute the parent node's
     /// exclusive time with noise.
-    TRACE_API void AdjustForOverheadAndNoise(
+    void AdjustForOverheadAndNoise(
         TimeStamp scopeOverhead, TimeStamp timerQuantum,
-        uint64_t *numDescendantNodes = nullptr);
+        uint64_t *numDescendantNodes = nullptr) {
+        _arena->AdjustForOverheadAndNoise(
+            _index, scopeOverhead, timerQuantum, numDescendantNodes);
+    }
 
     /// \name Recursion
     /// @{
@@ -170,89 +203,69 @@ public:
     /// This call leaves the tree topology intact, and only updates the
     /// recursion-related data in the node.  Prior to this call, recursion
     /// data is invalid in the node.
-    TRACE_API void MarkRecursiveChildren();
+    ///
+    /// Nodes are added to the tree for the merged calls, so views of the
+    /// children of the nodes are updated when they are next requested.
+    void MarkRecursiveChildren() {
+        _arena->MarkRecursiveChildren(_index);
+    }
 
     /// Returns true if this node is simply a marker for a merged recursive 
     /// subtree; otherwise returns false.
     ///
     /// This value is meaningless until this node or any of its ancestors have 
     /// been marked with MarkRecursiveChildren().
-    bool IsRecursionMarker() const { return _isRecursionMarker; }
+    bool IsRecursionMarker() const {
+        return _arena->IsRecursionMarker(_index);
+    }
 
     /// Returns true if this node is the head of a recursive call tree
     /// (i.e. the function has been called recursively).  
     ///
     /// This value is meaningless until this node or any of its ancestors have 
     /// been marked with MarkRecursiveChildren().
-    bool IsRecursionHead() const { return _isRecursionHead; }
+    bool IsRecursionHead() const {
+        return _arena->IsRecursionHead(_index);
+    }
 
     /// @}
 
+    /// Returns the arena which holds the data of this node.
+    const TraceAggregateNodeArenaRefPtr& GetArena() const { return _arena; }
 
-private:
-
-    TraceAggregateNode(const Id &id, const TfToken &key, TimeStamp ts,
-              int count, int exclusiveCount) :
-        _id(id), _key(key), _ts(ts), _exclusiveTs(ts),
-        _count(count), _exclusiveCount(exclusiveCount),
-        _recursiveCount(count), _recursiveExclusiveTs(ts), _expanded(false), 
-        _isRecursionMarker(false), _isRecursionHead(false),
-        _isRecursionProcessed(false) {}
+    /// Returns the index of this node in its arena.
+    Index GetIndex() const { return _index; }
 
-    using _ChildDictionary = TfDenseHashMap<TfToken, size_t, TfHash>;
-
-    void _MergeRecursive(const TraceAggregateNodeRefPtr &node);
+private:
 
-    void _SetAsRecursionMarker(TraceAggregateNodePtr parent);
+    TraceAggregateNode(
+        const TraceAggregateNodeArenaRefPtr& arena, Index index)
+        : _arena(arena)
+        , _index(index)
+    {
+        // The views of the children of a leaf are already up to date.
+        if (_arena->GetFirstChild(_index) ==
+                TraceAggregateNodeArena::InvalidIndex) {
+            _childrenVersion = _arena->GetVersion();
+        }
+    }
 
-    Id _id;
-    TfToken _key;
+    // Returns the view of child, which is a child of this node, updating
+    // the views of the children if needed. The caller must hold _mutex.
+    const TraceAggregateNodeRefPtr& _GetChild(Index child);
 
-    TimeStamp _ts;  
-    TimeStamp _exclusiveTs;
-    int _count;
-    int _exclusiveCount;
+    // Updates the views of the children if the arena changed. The caller
+    // must hold _mutex.
+    void _UpdateChildren();
 
-    // We keep the recursive counts separate so that we don't mess with 
-    // the collected data.
-    int _recursiveCount;
-    TraceAggregateNodePtr _recursionParent;
-    TimeStamp _recursiveExclusiveTs;
+    TraceAggregateNodeArenaRefPtr _arena;
+    Index _index;
 
+    // Views of the children, created on demand and updated when nodes are
+    // added to the arena.
+    std::mutex _mutex;
     TraceAggregateNodeRefPtrVector _children;
-    _ChildDictionary _childrenByKey;
-
-    // A structure that holds on to the inclusive and exclusive counter
-    // values. These values are usually populated together, so it's beneficial
-    // to maintain them in a tightly packed structure.
-    struct _CounterValue {
-        _CounterValue() : inclusive(0.0), exclusive(0.0) {}
-        double inclusive;
-        double exclusive;
-    };
-
-    using _CounterValues = TfDenseHashMap<int, _CounterValue, TfHash>;
-
-    // The counter values associated with specific counter indices
-    _CounterValues _counterValues;
-    
-    unsigned int
-    // If multiple Trace Editors are to be pointed at the same Reporter, this
-    // might have to be changed
-                _expanded:1,
-
-    // This flag keeps track of whether or not this node is simply intended
-    // as a marker for the start of a recursive call tree.
-                _isRecursionMarker:1,
-
-    // This flag keeps track of whether or not a node is the head of a
-    // recursive call tree.  In other words, if it is a function that has been
-    // called recursively.
-                _isRecursionHead:1,
-
-    // This flag is used during recursive traversal to mark the node as having 
-    // been visited and avoid too much processing.
-                _isRecursionProcessed:1;
+    size_t _childrenVersion = size_t(-1);
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
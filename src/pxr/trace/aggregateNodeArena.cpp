@@ -0,0 +1,604 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/aggregateNodeArena.h"
+
+#include "pxr/trace/pxr.h"
+
+#include <pxr/tf/diagnostic.h>
+
+#include <algorithm>
+#include <utility>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TraceAggregateNodeArena::KeyId
+TraceAggregateNodeArena::AddKey(const TfToken& key)
+{
+    const auto it = _keyIdsByKey.emplace(key, KeyId(_keys.size())).first;
+    if (it->second == _keys.size()) {
+        _keys.push_back(key);
+    }
+    return it->second;
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::AddNode(
+    KeyId key,
+    TimeStamp ts,
+    int count,
+    int exclusiveCount,
+    bool hasValidId)
+{
+    if (!TF_VERIFY(_keyIds.size() < InvalidIndex) ||
+        !TF_VERIFY(key < _keys.size())) {
+        return InvalidIndex;
+    }
+
+    const Index index = Index(_keyIds.size());
+    _keyIds.push_back(key);
+    _inclusiveTimes.push_back(ts);
+    _exclusiveTimes.push_back(ts);
+    _counts.push_back(count);
+    _exclusiveCounts.push_back(exclusiveCount);
+    _parents.push_back(InvalidIndex);
+    _firstChildren.push_back(InvalidIndex);
+    _lastChildren.push_back(InvalidIndex);
+    _nextSiblings.push_back(InvalidIndex);
+    _ordinals.push_back(0);
+    _flags.push_back(hasValidId ? _ValidId : 0);
+    _recursiveCounts.push_back(count);
+    _recursiveExclusiveTimes.push_back(ts);
+    _recursionParents.push_back(InvalidIndex);
+    ++_version;
+    return index;
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::AppendChild(
+    Index parent,
+    KeyId key,
+    TimeStamp ts,
+    int count,
+    int exclusiveCount,
+    bool hasValidId)
+{
+    if (!TF_VERIFY(parent < GetSize())) {
+        return InvalidIndex;
+    }
+
+    Index child = FindChild(parent, key);
+    if (child != InvalidIndex) {
+        _SetFlag(child, _ValidId, hasValidId);
+        _inclusiveTimes[child] += ts;
+        _counts[child] += count;
+        _recursiveCounts[child] += count;
+        _exclusiveCounts[child] += exclusiveCount;
+        _exclusiveTimes[child] += ts;
+        _recursiveExclusiveTimes[child] += ts;
+    } else {
+        child = AddNode(key, ts, count, exclusiveCount, hasValidId);
+        LinkChild(parent, child);
+    }
+
+    // Update the exclusive time of the parent to discount the time of the
+    // child.
+    TimeStamp& exclusiveTs = _exclusiveTimes[parent];
+    exclusiveTs = exclusiveTs >= ts ? exclusiveTs - ts : 0;
+    TimeStamp& recursiveExclusiveTs = _recursiveExclusiveTimes[parent];
+    recursiveExclusiveTs =
+        recursiveExclusiveTs >= ts ? recursiveExclusiveTs - ts : 0;
+
+    return child;
+}
+
+void
+TraceAggregateNodeArena::LinkChild(Index parent, Index child)
+{
+    if (!TF_VERIFY(parent < GetSize() && child < GetSize()) ||
+        !TF_VERIFY(_parents[child] == InvalidIndex) ||
+        !TF_VERIFY(FindChild(parent, _keyIds[child]) == InvalidIndex)) {
+        return;
+    }
+
+    _parents[child] = parent;
+    _ordinals[child] = Index(GetNumChildren(parent));
+    if (_lastChildren[parent] == InvalidIndex) {
+        _firstChildren[parent] = child;
+    } else {
+        _nextSiblings[_lastChildren[parent]] = child;
+    }
+    _lastChildren[parent] = child;
+    _InsertChild(child);
+    ++_version;
+}
+
+std::vector<TraceAggregateNodeArena::KeyId>
+TraceAggregateNodeArena::_MapKeyIds(const TraceAggregateNodeArena& arena)
+{
+    std::vector<KeyId> keyIds(arena._keys.size());
+    for (KeyId k = 0; k < keyIds.size(); ++k) {
+        keyIds[k] = AddKey(arena._keys[k]);
+    }
+    return keyIds;
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::CopySubtree(
+    const TraceAggregateNodeArena& arena, Index node)
+{
+    if (!TF_VERIFY(node < arena.GetSize())) {
+        return InvalidIndex;
+    }
+    return _CopySubtree(arena, node, _MapKeyIds(arena));
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::_CopySubtree(
+    const TraceAggregateNodeArena& arena, Index node,
+    const std::vector<KeyId>& keyIds)
+{
+    // The ancestors of the node being copied, up to node, with their
+    // copies.
+    std::vector<std::pair<Index, Index>> ancestors;
+    Index result = InvalidIndex;
+    arena.ForEachInSubtree(node, [&](Index i) {
+        // The source node may be in this arena, so its fields are read
+        // before any column grows.
+        const Index parent = arena._parents[i];
+        const Index recursionParent = arena._recursionParents[i];
+        const TimeStamp exclusiveTs = arena._exclusiveTimes[i];
+        const int recursiveCount = arena._recursiveCounts[i];
+        const TimeStamp recursiveExclusiveTs =
+            arena._recursiveExclusiveTimes[i];
+        const uint8_t flags = arena._flags[i];
+
+        const Index copy = AddNode(keyIds[arena._keyIds[i]],
+            arena._inclusiveTimes[i], arena._counts[i],
+            arena._exclusiveCounts[i], false);
+        _exclusiveTimes[copy] = exclusiveTs;
+        _recursiveCounts[copy] = recursiveCount;
+        _recursiveExclusiveTimes[copy] = recursiveExclusiveTs;
+        _flags[copy] = flags;
+
+        for (size_t c = 0; c < arena._counterValues.size(); ++c) {
+            if (i < arena._counterValues[c].size()) {
+                const _CounterValue value = arena._counterValues[c][i];
+                *_GetOrAddCounterValue(copy, int(c)) = value;
+            }
+        }
+
+        if (i != node) {
+            while (ancestors.back().first != parent) {
+                ancestors.pop_back();
+            }
+            LinkChild(ancestors.back().second, copy);
+        } else {
+            result = copy;
+        }
+
+        // Recursion markers refer to one of their ancestors, which is only
+        // kept if it is copied as well.
+        for (const std::pair<Index, Index>& ancestor : ancestors) {
+            if (ancestor.first == recursionParent) {
+                _recursionParents[copy] = ancestor.second;
+            }
+        }
+
+        ancestors.emplace_back(i, copy);
+    });
+    return result;
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::AppendSubtree(
+    Index parent, const TraceAggregateNodeArena& arena, Index node)
+{
+    if (!TF_VERIFY(parent < GetSize() && node < arena.GetSize())) {
+        return InvalidIndex;
+    }
+
+    // The subtree may contain parent, so nodes of this arena are merged
+    // from a copy.
+    if (&arena == this) {
+        TraceAggregateNodeArenaRefPtr copy = New();
+        const Index root = copy->CopySubtree(*this, node);
+        return AppendSubtree(parent, *copy, root);
+    }
+    return _AppendSubtree(parent, arena, node, _MapKeyIds(arena));
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::_AppendSubtree(
+    Index parent, const TraceAggregateNodeArena& arena, Index node,
+    const std::vector<KeyId>& keyIds)
+{
+    const TimeStamp ts = arena._inclusiveTimes[node];
+    Index child = FindChild(parent, keyIds[arena._keyIds[node]]);
+    if (child != InvalidIndex) {
+        _SetFlag(child, _ValidId, arena.HasValidId(node));
+        _inclusiveTimes[child] += ts;
+        _counts[child] += arena._counts[node];
+        _recursiveCounts[child] += arena._counts[node];
+        _exclusiveCounts[child] += arena._exclusiveCounts[node];
+        _exclusiveTimes[child] += ts;
+        _recursiveExclusiveTimes[child] += ts;
+
+        for (size_t c = 0; c < arena._counterValues.size(); ++c) {
+            if (node < arena._counterValues[c].size()) {
+                const _CounterValue& value = arena._counterValues[c][node];
+                _CounterValue* v = _GetOrAddCounterValue(child, int(c));
+                v->inclusive += value.inclusive;
+                v->exclusive += value.exclusive;
+            }
+        }
+
+        for (Index c = arena._firstChildren[node]; c != InvalidIndex;
+                c = arena._nextSiblings[c]) {
+            _AppendSubtree(child, arena, c, keyIds);
+        }
+    } else {
+        child = _CopySubtree(arena, node, keyIds);
+        LinkChild(parent, child);
+    }
+
+    // Update the exclusive time of the parent to discount the time of the
+    // child.
+    TimeStamp& exclusiveTs = _exclusiveTimes[parent];
+    exclusiveTs = exclusiveTs >= ts ? exclusiveTs - ts : 0;
+    TimeStamp& recursiveExclusiveTs = _recursiveExclusiveTimes[parent];
+    recursiveExclusiveTs =
+        recursiveExclusiveTs >= ts ? recursiveExclusiveTs - ts : 0;
+
+    return child;
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::FindChild(Index parent, const TfToken& key) const
+{
+    const auto it = _keyIdsByKey.find(key);
+    return it != _keyIdsByKey.end()
+        ? FindChild(parent, it->second) : InvalidIndex;
+}
+
+TraceAggregateNodeArena::Index
+TraceAggregateNodeArena::FindChild(Index parent, KeyId key) const
+{
+    return _childTable.empty()
+        ? InvalidIndex : _childTable[_GetChildSlot(parent, key)];
+}
+
+size_t
+TraceAggregateNodeArena::_GetChildSlot(Index parent, KeyId key) const
+{
+    // The high bits of the product depend on all the bits of the parent
+    // and key.
+    const uint64_t hash =
+        ((uint64_t(parent) << 32) | key) * 0x9E3779B97F4A7C15ull;
+    const size_t mask = _childTable.size() - 1;
+    size_t slot = size_t(hash >> 32) & mask;
+    while (_childTable[slot] != InvalidIndex &&
+           (_parents[_childTable[slot]] != parent ||
+            _keyIds[_childTable[slot]] != key)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void
+TraceAggregateNodeArena::_InsertChild(Index child)
+{
+    if (2 * (_numChildren + 1) > _childTable.size()) {
+        _GrowChildTable();
+    }
+    _childTable[_GetChildSlot(_parents[child], _keyIds[child])] = child;
+    ++_numChildren;
+}
+
+void
+TraceAggregateNodeArena::_GrowChildTable()
+{
+    std::vector<Index> children;
+    children.swap(_childTable);
+    _childTable.assign(std::max<size_t>(16, 2 * children.size()),
+        InvalidIndex);
+    for (Index child : children) {
+        if (child != InvalidIndex) {
+            _childTable[_GetChildSlot(_parents[child], _keyIds[child])] =
+                child;
+        }
+    }
+}
+
+TraceAggregateNodeArena::_CounterValue*
+TraceAggregateNodeArena::_GetOrAddCounterValue(Index node, int index)
+{
+    if (!TF_VERIFY(index >= 0 && node < GetSize())) {
+        return nullptr;
+    }
+    if (size_t(index) >= _counterValues.size()) {
+        _counterValues.resize(index + 1);
+    }
+    std::vector<_CounterValue>& values = _counterValues[index];
+    if (node >= values.size()) {
+        values.resize(node + 1);
+    }
+    return &values[node];
+}
+
+void
+TraceAggregateNodeArena::AppendInclusiveCounterValue(
+    Index node, int index, double value)
+{
+    if (_CounterValue* v = _GetOrAddCounterValue(node, index)) {
+        v->inclusive += value;
+    }
+}
+
+void
+TraceAggregateNodeArena::AppendExclusiveCounterValue(
+    Index node, int index, double value)
+{
+    if (_CounterValue* v = _GetOrAddCounterValue(node, index)) {
+        v->exclusive += value;
+    }
+}
+
+void
+TraceAggregateNodeArena::CalculateInclusiveCounterValues(Index node)
+{
+    if (!TF_VERIFY(node < GetSize())) {
+        return;
+    }
+
+    // Visiting the nodes in reverse pre-order visits children before their
+    // parents.
+    std::vector<Index> nodes;
+    ForEachInSubtree(node, [&nodes](Index i) { nodes.push_back(i); });
+
+    for (std::vector<_CounterValue>& values : _counterValues) {
+        if (values.empty()) {
+            continue;
+        }
+        values.resize(GetSize());
+
+        // Reset the inclusive value to the exclusive value, then accumulate
+        // the inclusive values of the children.
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+            double inclusive = values[*it].exclusive;
+            for (Index c = _firstChildren[*it]; c != InvalidIndex;
+                    c = _nextSiblings[c]) {
+                if (values[c].inclusive != 0) {
+                    inclusive += values[c].inclusive;
+                }
+            }
+            values[*it].inclusive = inclusive;
+        }
+    }
+}
+
+void
+TraceAggregateNodeArena::AdjustForOverheadAndNoise(
+    Index node,
+    TimeStamp scopeOverhead,
+    TimeStamp timerQuantum,
+    uint64_t *numDescendantNodes)
+{
+    if (!TF_VERIFY(node < GetSize())) {
+        return;
+    }
+
+    // Visit everything depth-first and accumulate descendant counts, children
+    // before their parents. Subtract scopeOverhead times number of
+    // descendant scopes from inclusive time.
+    std::vector<Index> nodes;
+    ForEachInSubtree(node, [&nodes](Index i) { nodes.push_back(i); });
+    std::vector<uint64_t> descendantNodes(GetSize(), 0);
+
+    // Each sample measurement has an error of +/- \p timerQuantum, so if
+    // the number of samples times the quantum is of some threshold fraction
+    // of the inclusive time, we consider the child "noisy".
+    auto isNoisy = [timerQuantum](TimeStamp totalTime, int count) {
+        // Consider a scope noisy if timerQuantum times count is 5% or more of
+        // totalTime.  (count * timerQuantum) >= (totalTime / 20)
+        return count * timerQuantum * 20 >= totalTime;
+    };
+
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        const Index i = *it;
+        const uint64_t localNumDescendantNodes =
+            GetNumChildren(i) + descendantNodes[i];
+
+        TimeStamp totalOverhead = scopeOverhead * localNumDescendantNodes;
+        if (totalOverhead > _inclusiveTimes[i]) {
+            totalOverhead = _inclusiveTimes[i];
+        }
+        _inclusiveTimes[i] -= totalOverhead;
+
+        // Our exclusive time should be our inclusive time minus the
+        // inclusive times of our direct children.  But if we have any
+        // children whose measurements are overly "noisy" then we mark their
+        // inclusive/exclusive times as zero, and do not deduct them from our
+        // exclusive time.
+        TimeStamp newExclusiveTs = _inclusiveTimes[i];
+        for (Index c = _firstChildren[i]; c != InvalidIndex;
+                c = _nextSiblings[c]) {
+            if (isNoisy(_inclusiveTimes[c], _counts[c])) {
+                _inclusiveTimes[c] = _exclusiveTimes[c] = 0;
+            } else {
+                newExclusiveTs -= (newExclusiveTs > _inclusiveTimes[c])
+                    ? _inclusiveTimes[c] : newExclusiveTs;
+            }
+        }
+        _exclusiveTimes[i] = newExclusiveTs;
+
+        // Publish number of descendant nodes.
+        if (i != node) {
+            descendantNodes[_parents[i]] += localNumDescendantNodes;
+        } else if (numDescendantNodes) {
+            *numDescendantNodes += localNumDescendantNodes;
+        }
+    }
+}
+
+void
+TraceAggregateNodeArena::MarkRecursiveChildren(Index node)
+{
+    if (!TF_VERIFY(node < GetSize())) {
+        return;
+    }
+
+    // Trivial case, if we are already marked, there is nothing left to do.
+    if (IsRecursionHead(node)) {
+        return;
+    }
+
+    // This code performs an iterative post-order traversal of the subtree.
+    // Our algorithm for each node is to collapse its children, then check
+    // the stack for recursion, if found, merge with the parent node and set
+    // the node as a dummy marker.
+    struct _StackNode {
+        Index node;
+        int parentIdx;
+        int remainingChildren;
+    };
+    std::vector<_StackNode> stack;
+    stack.push_back({node, -1, int(GetNumChildren(node))});
+
+    while (!stack.empty()) {
+        const Index curNode = stack.back().node;
+        const int numKids = stack.back().remainingChildren;
+        const int parentIdx = stack.back().parentIdx;
+
+        // We're processing this node, mark it so that we don't process it
+        // again, ever.
+        _SetFlag(curNode, _RecursionProcessed, true);
+
+        // If our current node does not have kids, process it.  Processing
+        // the node means to search the parent stack for an existing key and
+        // if found, merge with it and mark ourselves as a simple marker.
+        if (numKids == 0) {
+            for (int p = parentIdx; p != -1; p = stack[p].parentIdx) {
+                const Index parentNode = stack[p].node;
+                if (_keyIds[curNode] == _keyIds[parentNode]) {
+                    // We found the key, now merge up with that parent, and
+                    // leave a marker in our place.
+                    _MergeRecursive(parentNode, curNode);
+                    _SetAsRecursionMarker(curNode, parentNode);
+                    break;
+                }
+            }
+
+            // If we have a valid parent, decrease the count of children
+            // remaining to be processed.
+            if (parentIdx > -1) {
+                stack[parentIdx].remainingChildren -= 1;
+            }
+            stack.pop_back();
+        } else {
+            // Here our node has children, so before we go on, we must push
+            // them on the stack.  This gives us the post-order traversal we
+            // need.  Only nodes that have not been previously processed (by
+            // a previous call to Report() for example) are pushed.
+            const int parent = int(stack.size()) - 1;
+            Index child = _firstChildren[curNode];
+            for (int i = 0; i < numKids; ++i, child = _nextSiblings[child]) {
+                if (!(_flags[child] & _RecursionProcessed)) {
+                    stack.push_back(
+                        {child, parent, int(GetNumChildren(child))});
+                } else {
+                    stack[parent].remainingChildren -= 1;
+                }
+            }
+        }
+    }
+}
+
+void
+TraceAggregateNodeArena::_MergeRecursive(Index target, Index node)
+{
+    // Merge the times of node into those of target.  Note that here we only
+    // use the recursion data in order to keep the original state intact.
+    if (IsRecursionMarker(target)) {
+        // If target is a recursion marker, what we actually intend is to
+        // merge with its parent (i.e. the head of the recursive call).
+        if (_recursionParents[target] == InvalidIndex) {
+            TF_CODING_ERROR("Marker has no or expired parent.");
+            return;
+        }
+        _MergeRecursive(_recursionParents[target], node);
+        return;
+    }
+
+    _recursiveCounts[target] += _recursiveCounts[node];
+    _recursiveExclusiveTimes[target] += _recursiveExclusiveTimes[node];
+
+    // Mark target as a recursive head so that we recognize that its
+    // inclusive times are invalid.
+    _SetFlag(target, _RecursionHead, true);
+
+    // Now merge the children. Nodes may be added to the children of node
+    // while they are merged, and those are not.
+    const size_t size = GetNumChildren(node);
+    Index child = _firstChildren[node];
+    for (size_t i = 0; i < size; ++i, child = _nextSiblings[child]) {
+        Index n = FindChild(target, _keyIds[child]);
+        if (n == InvalidIndex) {
+            // Create an empty node to merge with.
+            n = AddNode(_keyIds[child], _inclusiveTimes[child], 0,
+                _exclusiveCounts[child], HasValidId(child));
+
+            // On the new node, we want the exclusive time to be computed by
+            // the recursive time, which is done during the merge (this
+            // avoids double counting exclusive time).
+            _exclusiveTimes[n] = _exclusiveTimes[child];
+            _recursiveExclusiveTimes[n] = 0;
+            LinkChild(target, n);
+
+            // If the original node is a recursive marker, then the new node
+            // should be one too.
+            if (IsRecursionMarker(child)) {
+                _SetAsRecursionMarker(n, _recursionParents[child]);
+            } else {
+                // We always want to merge new nodes.
+                _MergeRecursive(n, child);
+            }
+        } else {
+            // This key already exists, determine if we want to merge it in.
+            //
+            // non-marker into non-marker:
+            //      both nodes contain useful information, merge them.
+            // non-marker into marker:
+            //      this case can happen when we have two branches that come
+            //      out from the same root and have the same recursive
+            //      pattern. We can't control the order that the siblings
+            //      will be merged, and therefore we have to handle this case.
+            // marker into non-marker:
+            //      non-marker will eventually become a marker, and we
+            //      already accounted for the marker's counts.
+            // marker into marker:
+            //      trivial case, two markers with the same key are as good as
+            //      one marker for that key.
+            if (!IsRecursionMarker(child)) {
+                _MergeRecursive(n, child);
+            }
+        }
+    }
+}
+
+void
+TraceAggregateNodeArena::_SetAsRecursionMarker(Index node, Index parent)
+{
+    _SetFlag(node, _RecursionMarker, true);
+    _recursionParents[node] = parent;
+    if (parent == InvalidIndex) {
+        TF_CODING_ERROR("Marker has no or expired parent.");
+    }
+    // Note that we'd love to be able to blow away the subtrees here, but
+    // because we don't want the mark call to modify the integrity of the
+    // tree, we have to keep them untouched.
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,310 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_AGGREGATE_NODE_ARENA_H
+#define PXR_TRACE_AGGREGATE_NODE_ARENA_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/event.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/refPtr.h>
+#include <pxr/tf/token.h>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TF_DECLARE_REF_PTRS(TraceAggregateNodeArena);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceAggregateNodeArena
+///
+/// This class stores the nodes of a TraceAggregateTree as a table with one
+/// column per field, rather than as one heap object per node. Nodes are
+/// identified by their index in the table, and are linked to their parent,
+/// first and last children and next sibling by index. A single hash table
+/// keyed by the index of the parent and the id of the key finds the child of
+/// a node with a given key, and the counter values of the nodes are stored
+/// in one column per counter index.
+///
+/// Building, merging and destroying a tree therefore only touches a few
+/// large arrays, no matter how many call paths it has. TraceAggregateNode
+/// instances are views of the nodes of an arena.
+///
+class TraceAggregateNodeArena : public TfRefBase {
+public:
+    using Index = uint32_t;
+    using KeyId = uint32_t;
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    /// The index of missing nodes, e.g. the parent of a root node.
+    static constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
+
+    /// Creates an empty arena.
+    static TraceAggregateNodeArenaRefPtr New() {
+        return TfCreateRefPtr(new TraceAggregateNodeArena());
+    }
+
+    /// Returns the id of \p key, adding it to the arena if needed.
+    TRACE_API KeyId AddKey(const TfToken& key);
+
+    /// \name Construction
+    /// @{
+
+    /// Adds a node with no parent and returns its index.
+    TRACE_API Index AddNode(
+        KeyId key,
+        TimeStamp ts,
+        int count,
+        int exclusiveCount,
+        bool hasValidId);
+
+    /// Adds \p ts, \p count and \p exclusiveCount to the child of \p parent
+    /// with \p key, which is created if needed, and returns its index. The
+    /// time is discounted from the exclusive time of \p parent.
+    TRACE_API Index AppendChild(
+        Index parent,
+        KeyId key,
+        TimeStamp ts,
+        int count,
+        int exclusiveCount,
+        bool hasValidId);
+
+    /// Makes \p child, which must have no parent, the last child of
+    /// \p parent. \p parent must not already have a child with the key of
+    /// \p child.
+    TRACE_API void LinkChild(Index parent, Index child);
+
+    /// Copies \p node of \p arena and its descendants to this arena, and
+    /// returns the index of the copy of \p node, which has no parent.
+    TRACE_API Index CopySubtree(
+        const TraceAggregateNodeArena& arena, Index node);
+
+    /// Appends \p node of \p arena and its descendants to \p parent. If
+    /// \p parent has no child with the key of \p node, a copy of \p node is
+    /// linked to it, otherwise \p node is merged into that child. Returns
+    /// the index of the child.
+    TRACE_API Index AppendSubtree(
+        Index parent, const TraceAggregateNodeArena& arena, Index node);
+
+    /// @}
+
+    /// Returns the number of nodes.
+    size_t GetSize() const { return _keyIds.size(); }
+
+    /// Returns a number which changes every time a node is added or linked.
+    size_t GetVersion() const { return _version; }
+
+    /// \name Node accessors
+    /// @{
+
+    KeyId GetKeyId(Index node) const { return _keyIds[node]; }
+    const TfToken& GetKey(Index node) const { return _keys[_keyIds[node]]; }
+    bool HasValidId(Index node) const { return _flags[node] & _ValidId; }
+
+    TimeStamp GetInclusiveTime(Index node) const {
+        return _inclusiveTimes[node];
+    }
+    TimeStamp GetExclusiveTime(Index node, bool recursive = false) const {
+        return recursive
+            ? _recursiveExclusiveTimes[node] : _exclusiveTimes[node];
+    }
+    int GetCount(Index node, bool recursive = false) const {
+        return recursive ? _recursiveCounts[node] : _counts[node];
+    }
+    int GetExclusiveCount(Index node) const {
+        return _exclusiveCounts[node];
+    }
+
+    Index GetParent(Index node) const { return _parents[node]; }
+    Index GetFirstChild(Index node) const { return _firstChildren[node]; }
+    Index GetLastChild(Index node) const { return _lastChildren[node]; }
+    Index GetNextSibling(Index node) const { return _nextSiblings[node]; }
+
+    /// Returns the position of \p node among the children of its parent.
+    Index GetChildOrdinal(Index node) const { return _ordinals[node]; }
+
+    /// Returns the number of children of \p node.
+    size_t GetNumChildren(Index node) const {
+        return _lastChildren[node] == InvalidIndex
+            ? 0 : _ordinals[_lastChildren[node]] + 1;
+    }
+
+    /// Returns the child of \p parent with \p key, or InvalidIndex.
+    TRACE_API Index FindChild(Index parent, const TfToken& key) const;
+
+    /// Returns the child of \p parent with key id \p key, or InvalidIndex.
+    TRACE_API Index FindChild(Index parent, KeyId key) const;
+
+    bool IsExpanded(Index node) const { return _flags[node] & _Expanded; }
+    void SetExpanded(Index node, bool expanded) {
+        _SetFlag(node, _Expanded, expanded);
+    }
+
+    bool IsRecursionMarker(Index node) const {
+        return _flags[node] & _RecursionMarker;
+    }
+    bool IsRecursionHead(Index node) const {
+        return _flags[node] & _RecursionHead;
+    }
+
+    /// @}
+
+    /// \name Counter Value Accessors
+    /// @{
+
+    TRACE_API void AppendInclusiveCounterValue(
+        Index node, int index, double value);
+    TRACE_API void AppendExclusiveCounterValue(
+        Index node, int index, double value);
+
+    double GetInclusiveCounterValue(Index node, int index) const {
+        const _CounterValue* v = _GetCounterValue(node, index);
+        return v ? v->inclusive : 0.0;
+    }
+    double GetExclusiveCounterValue(Index node, int index) const {
+        const _CounterValue* v = _GetCounterValue(node, index);
+        return v ? v->exclusive : 0.0;
+    }
+
+    /// @}
+
+    /// \name Processing
+    /// These implement the corresponding methods of TraceAggregateNode for
+    /// the subtree of \p node.
+    /// @{
+
+    TRACE_API void CalculateInclusiveCounterValues(Index node);
+
+    TRACE_API void AdjustForOverheadAndNoise(
+        Index node,
+        TimeStamp scopeOverhead,
+        TimeStamp timerQuantum,
+        uint64_t *numDescendantNodes = nullptr);
+
+    TRACE_API void MarkRecursiveChildren(Index node);
+
+    /// @}
+
+    /// Calls \p fn with \p node and each of its descendants, parents before
+    /// their children and children in order.
+    template <class Fn>
+    void ForEachInSubtree(Index node, Fn&& fn) const {
+        Index i = node;
+        while (true) {
+            fn(i);
+            if (_firstChildren[i] != InvalidIndex) {
+                i = _firstChildren[i];
+                continue;
+            }
+            while (i != node && _nextSiblings[i] == InvalidIndex) {
+                i = _parents[i];
+            }
+            if (i == node) {
+                return;
+            }
+            i = _nextSiblings[i];
+        }
+    }
+
+private:
+    TraceAggregateNodeArena() = default;
+
+    enum _Flag : uint8_t {
+        _ValidId = 1 << 0,
+        // Whether the node is expanded in a gui.
+        _Expanded = 1 << 1,
+        // Whether the node is a marker for the start of a recursive call
+        // tree.
+        _RecursionMarker = 1 << 2,
+        // Whether the node is the head of a recursive call tree.
+        _RecursionHead = 1 << 3,
+        // Whether MarkRecursiveChildren visited the node.
+        _RecursionProcessed = 1 << 4,
+    };
+
+    void _SetFlag(Index node, _Flag flag, bool value) {
+        _flags[node] = uint8_t(
+            value ? (_flags[node] | flag) : (_flags[node] & ~flag));
+    }
+
+    // The inclusive and exclusive values of a counter are usually populated
+    // together, so they are stored next to each other.
+    struct _CounterValue {
+        double inclusive = 0.0;
+        double exclusive = 0.0;
+    };
+
+    const _CounterValue* _GetCounterValue(Index node, int index) const {
+        return index >= 0 && size_t(index) < _counterValues.size() &&
+            node < _counterValues[index].size()
+            ? &_counterValues[index][node] : nullptr;
+    }
+    _CounterValue* _GetOrAddCounterValue(Index node, int index);
+
+    // Returns the ids in this arena of the keys of arena.
+    std::vector<KeyId> _MapKeyIds(const TraceAggregateNodeArena& arena);
+
+    // Implement CopySubtree and AppendSubtree, with the ids in this arena of
+    // the keys of arena.
+    Index _CopySubtree(
+        const TraceAggregateNodeArena& arena, Index node,
+        const std::vector<KeyId>& keyIds);
+    Index _AppendSubtree(
+        Index parent, const TraceAggregateNodeArena& arena, Index node,
+        const std::vector<KeyId>& keyIds);
+
+    // Helpers for MarkRecursiveChildren.
+    void _MergeRecursive(Index target, Index node);
+    void _SetAsRecursionMarker(Index node, Index parent);
+
+    // The child table is an open addressing hash table of the indices of
+    // all nodes with a parent, keyed by their parent and key id.
+    size_t _GetChildSlot(Index parent, KeyId key) const;
+    void _InsertChild(Index child);
+    void _GrowChildTable();
+
+    std::vector<TfToken> _keys;
+    std::unordered_map<TfToken, KeyId, TfToken::HashFunctor> _keyIdsByKey;
+
+    // Node columns.
+    std::vector<KeyId> _keyIds;
+    std::vector<TimeStamp> _inclusiveTimes;
+    std::vector<TimeStamp> _exclusiveTimes;
+    std::vector<int> _counts;
+    std::vector<int> _exclusiveCounts;
+    std::vector<Index> _parents;
+    std::vector<Index> _firstChildren;
+    std::vector<Index> _lastChildren;
+    std::vector<Index> _nextSiblings;
+    std::vector<Index> _ordinals;
+    std::vector<uint8_t> _flags;
+
+    // Recursion columns. These are kept separate so that folding recursive
+    // calls leaves the collected data intact.
+    std::vector<int> _recursiveCounts;
+    std::vector<TimeStamp> _recursiveExclusiveTimes;
+    std::vector<Index> _recursionParents;
+
+    // The counter values of each counter index, for the nodes up to the
+    // last one which has a value.
+    std::vector<std::vector<_CounterValue>> _counterValues;
+
+    std::vector<Index> _childTable;
+    size_t _numChildren = 0;
+
+    size_t _version = 0;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_AGGREGATE_NODE_ARENA_H
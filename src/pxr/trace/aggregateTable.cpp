@@ -0,0 +1,68 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/aggregateTable.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/aggregateTree.h"
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TraceAggregateTable::TraceAggregateTable(const TraceAggregateTree& tree)
+{
+    using Index = TraceAggregateNodeArena::Index;
+    const TraceAggregateNodeArena& arena = tree.GetNodeArena();
+    const Index root = tree.GetRootIndex();
+
+    // The arena holds the root and thread nodes, which are not rows.
+    const size_t size = arena.GetSize();
+    _threadIds.reserve(size);
+    _keyIds.reserve(size);
+    _depths.reserve(size);
+    _parents.reserve(size);
+    _inclusiveTimes.reserve(size);
+    _exclusiveTimes.reserve(size);
+    _counts.reserve(size);
+    _exclusiveCounts.reserve(size);
+
+    // Maps the key ids of the arena to the key ids of the table.
+    std::vector<KeyId> keyIds;
+    auto getKeyId = [&](Index node) {
+        const TraceAggregateNodeArena::KeyId arenaKeyId = arena.GetKeyId(node);
+        if (arenaKeyId >= keyIds.size()) {
+            keyIds.resize(arenaKeyId + 1, KeyId(-1));
+        }
+        if (keyIds[arenaKeyId] == KeyId(-1)) {
+            keyIds[arenaKeyId] = KeyId(_keys.size());
+            _keys.push_back(arena.GetKey(node));
+        }
+        return keyIds[arenaKeyId];
+    };
+
+    // The row of each node of the arena which has one.
+    std::vector<int64_t> rows(size, -1);
+    for (Index thread = arena.GetFirstChild(root);
+            thread != TraceAggregateNodeArena::InvalidIndex;
+            thread = arena.GetNextSibling(thread)) {
+        const KeyId threadId = getKeyId(thread);
+        arena.ForEachInSubtree(thread, [&](Index i) {
+            if (i == thread) {
+                return;
+            }
+            const int64_t parent = rows[arena.GetParent(i)];
+            rows[i] = int64_t(_keyIds.size());
+            _threadIds.push_back(threadId);
+            _keyIds.push_back(getKeyId(i));
+            _depths.push_back(parent < 0 ? 0 : _depths[parent] + 1);
+            _parents.push_back(parent);
+            _inclusiveTimes.push_back(arena.GetInclusiveTime(i));
+            _exclusiveTimes.push_back(arena.GetExclusiveTime(i));
+            _counts.push_back(arena.GetCount(i));
+            _exclusiveCounts.push_back(arena.GetExclusiveCount(i));
+        });
+    }
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,94 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_AGGREGATE_TABLE_H
+#define PXR_TRACE_AGGREGATE_TABLE_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/event.h"
+
+#include <pxr/tf/token.h>
+
+#include <cstdint>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+class TraceAggregateTree;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceAggregateTable
+///
+/// This class holds the nodes of a TraceAggregateTree as a table with one
+/// row per node and one contiguous column per field, like TraceEventTable
+/// does for the events of a TraceEventTree.
+///
+/// Rows are in depth first order, so the parent of a node always comes
+/// before it. Keys are stored once, and the key and thread columns hold
+/// indices into the key table.
+///
+class TraceAggregateTable {
+public:
+    using KeyId = uint32_t;
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    /// Creates a table of the nodes of \p tree.
+    TRACE_API explicit TraceAggregateTable(const TraceAggregateTree& tree);
+
+    /// Returns the number of rows.
+    size_t GetSize() const { return _keyIds.size(); }
+
+    /// Returns the keys and thread names referenced by the table.
+    const std::vector<TfToken>& GetKeys() const { return _keys; }
+
+    /// Returns the id of the name of the thread of each node.
+    const std::vector<KeyId>& GetThreadIds() const { return _threadIds; }
+
+    /// Returns the id of the key of each node.
+    const std::vector<KeyId>& GetKeyIds() const { return _keyIds; }
+
+    /// Returns the depth of each node in its thread, starting from 0.
+    const std::vector<uint32_t>& GetDepths() const { return _depths; }
+
+    /// Returns the row of the parent of each node, or -1 for the nodes at
+    /// depth 0.
+    const std::vector<int64_t>& GetParents() const { return _parents; }
+
+    /// Returns the inclusive time of each node, in ticks.
+    const std::vector<TimeStamp>& GetInclusiveTimes() const {
+        return _inclusiveTimes;
+    }
+
+    /// Returns the exclusive time of each node, in ticks.
+    const std::vector<TimeStamp>& GetExclusiveTimes() const {
+        return _exclusiveTimes;
+    }
+
+    /// Returns the number of calls of each node.
+    const std::vector<int>& GetCounts() const { return _counts; }
+
+    /// Returns the exclusive count of each node, as returned by
+    /// TraceAggregateNode::GetExclusiveCount().
+    const std::vector<int>& GetExclusiveCounts() const {
+        return _exclusiveCounts;
+    }
+
+private:
+    std::vector<TfToken> _keys;
+    std::vector<KeyId> _threadIds;
+    std::vector<KeyId> _keyIds;
+    std::vector<uint32_t> _depths;
+    std::vector<int64_t> _parents;
+    std::vector<TimeStamp> _inclusiveTimes;
+    std::vector<TimeStamp> _exclusiveTimes;
+    std::vector<int> _counts;
+    std::vector<int> _exclusiveCounts;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_AGGREGATE_TABLE_H
@@ -46,6 +46,17 @@ public:
     /// Returns the root node of the tree.
     TraceAggregateNodePtr GetRoot() { return _root; }
 
+    /// Returns the arena which holds the nodes of the tree.
+    TraceAggregateNodeArena& GetNodeArena() { return *_root->GetArena(); }
+    const TraceAggregateNodeArena& GetNodeArena() const {
+        return *_root->GetArena();
+    }
+
+    /// Returns the index of the root node in the arena of the tree.
+    TraceAggregateNodeArena::Index GetRootIndex() const {
+        return _root->GetIndex();
+    }
+
     /// Returns a map of event keys to total inclusive time.
     const EventTimes& GetEventTimes() const { return _eventTimes; }
 
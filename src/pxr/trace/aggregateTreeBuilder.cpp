@@ -11,7 +11,12 @@
 
 #include "pxr/trace/collection.h"
 
-#include <stack>
+#include <pxr/tf/stringUtils.h>
+#include <pxr/arch/demangle.h>
+#include <pxr/arch/symbols.h>
+
+#include <string>
+#include <vector>
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
@@ -25,7 +30,8 @@ Trace_AggregateTreeBuilder::AddEventTreeToAggregate(
     Trace_AggregateTreeBuilder builder(aggregateTree, eventTree);
 
     builder._CreateAggregateNodes();
-    builder._ProcessCounters(collection);
+    builder._ProcessEvents(collection);
+    builder._AddScopeTallies(collection);
 }
 
 Trace_AggregateTreeBuilder::Trace_AggregateTreeBuilder(
@@ -36,59 +42,90 @@ Trace_AggregateTreeBuilder::Trace_AggregateTreeBuilder(
 }
 
 void
-Trace_AggregateTreeBuilder::_ProcessCounters(const TraceCollection& collection)
+Trace_AggregateTreeBuilder::_ProcessEvents(const TraceCollection& collection)
 {
-    collection.Iterate(*this);
-    _aggregateTree->GetRoot()->CalculateInclusiveCounterValues();
+    // Counter and sample events are attributed to the nodes which enclose
+    // them.
+    collection.IterateBatches(*this);
+    _aggregateTree->GetNodeArena().CalculateInclusiveCounterValues(
+        _aggregateTree->GetRootIndex());
+}
+
+void
+Trace_AggregateTreeBuilder::_AddScopeTallies(const TraceCollection& collection)
+{
+    // Scopes shorter than the minimum scope duration have no nodes, but
+    // still count towards the total time of their key.
+    for (const auto& i : collection.GetScopeTallies()) {
+        _aggregateTree->_eventTimes[i.first] += i.second.duration;
+    }
 }
 
 void
 Trace_AggregateTreeBuilder::_CreateAggregateNodes()
 {
-    using TreeIt = std::pair<TraceEventNodeRefPtr, size_t>;
-    std::stack<TreeIt> treeStack;
-    std::stack<TraceAggregateNodePtr> aggStack;
+    constexpr _Index InvalidIndex = TraceEventNodeArena::InvalidIndex;
+    const TraceEventNodeArena& arena = _tree->GetNodeArena();
+    TraceAggregateNodeArena& aggregateArena =
+        _aggregateTree->GetNodeArena();
+    _aggregateNodes.assign(
+        arena.GetSize(), TraceAggregateNodeArena::InvalidIndex);
+
+    // The ids in the aggregate arena of the keys of the event arena, and
+    // the total time of each key, which are added to the event times of the
+    // tree at the end.
+    std::vector<TraceAggregateNodeArena::KeyId> keyIds;
+    std::vector<TraceEvent::TimeStamp> keyTimes;
+    std::vector<bool> hasKeyTimes;
 
     // Prime the aggregate stack with the root node.
-    aggStack.push(_aggregateTree->GetRoot());
-
-    // Prime the stack with the children of the root. These are the node that
-    // represent threads.
-    for (TraceEventNodeRefPtrVector::const_reverse_iterator it =
-            _tree->GetRoot()->GetChildrenRef().rbegin(); 
-            it != _tree->GetRoot()->GetChildrenRef().rend(); ++it) {
-        treeStack.push(std::make_pair(*it, 0));
-    }
-    
-    // A valid id needed for node creation.
-    TraceAggregateNode::Id id = TraceAggregateNode::Id(TraceThreadId());
+    std::vector<_AggregateIndex> aggStack;
+    aggStack.push_back(_aggregateTree->GetRootIndex());
+
+    // The children of the root are the nodes that represent threads.
+    for (_Index thread = arena.GetFirstChild(_tree->GetRootIndex());
+            thread != InvalidIndex; thread = arena.GetNextSibling(thread)) {
+        arena.ForEachInSubtree(thread, [&](_Index node) {
+            // Pop the aggregate nodes of the nodes which are not ancestors
+            // of this node.
+            const _Index parent = arena.GetParent(node);
+            while (node != thread &&
+                   aggStack.size() > 1 &&
+                   aggStack.back() != _aggregateNodes[parent]) {
+                aggStack.pop_back();
+            }
 
-    while (!treeStack.empty()) {
-        TreeIt it = treeStack.top();
-        treeStack.pop();
+            const TraceEventNodeArena::KeyId key = arena.GetKeyId(node);
+            if (key >= keyIds.size()) {
+                keyIds.resize(key + 1, TraceAggregateNodeArena::KeyId(-1));
+                keyTimes.resize(key + 1, 0);
+                hasKeyTimes.resize(key + 1, false);
+            }
+            if (keyIds[key] == TraceAggregateNodeArena::KeyId(-1)) {
+                keyIds[key] = aggregateArena.AddKey(arena.GetKey(node));
+            }
 
-        // The first time a node is visited, add it to the aggregate tree.
-        if (it.second == 0) {
             const TraceEvent::TimeStamp duration =
-                it.first->GetEndTime() - it.first->GetBeginTime();
+                arena.GetEndTime(node) - arena.GetBeginTime(node);
 
             if (duration > 0 && aggStack.size() > 1) {
-                _aggregateTree->_eventTimes[it.first->GetKey()] += duration;
+                keyTimes[key] += duration;
+                hasKeyTimes[key] = true;
             }
 
-            TraceAggregateNodePtr newNode = aggStack.top()->Append(
-                id, it.first->GetKey(), duration);
-            aggStack.push(newNode);
-        }
-        // When there are no more children to visit, pop the aggregate tree
-        // stack.
-        if (it.second >= it.first->GetChildrenRef().size()) {
-            aggStack.pop();
-        } else {
-            // Visit the current child and then the next child.
-            treeStack.push(std::make_pair(it.first, it.second+1));
-            treeStack.push(
-                std::make_pair(it.first->GetChildrenRef()[it.second], 0));
+            // Nodes are created with a valid id.
+            const _AggregateIndex newNode = aggregateArena.AppendChild(
+                aggStack.back(), keyIds[key], duration, 1, 1, true);
+            _aggregateNodes[node] = newNode;
+            aggStack.push_back(newNode);
+        });
+        aggStack.resize(1);
+    }
+
+    for (TraceEventNodeArena::KeyId key = 0; key < keyTimes.size(); ++key) {
+        if (hasKeyTimes[key]) {
+            _aggregateTree->_eventTimes[arena.GetKeyFromId(key)] +=
+                keyTimes[key];
         }
     }
 }
@@ -103,31 +140,47 @@ Trace_AggregateTreeBuilder::OnEndCollection()
 
 void
 Trace_AggregateTreeBuilder::OnBeginThread(const TraceThreadId& threadId)
-{}
+{
+    constexpr _Index InvalidIndex = TraceEventNodeArena::InvalidIndex;
+    const TraceEventNodeArena& arena = _tree->GetNodeArena();
+
+    // Find the root node of the thread.
+    const TfToken threadKey(threadId.ToString());
+    _Index thread = arena.GetFirstChild(_tree->GetRootIndex());
+    while (thread != InvalidIndex && arena.GetKey(thread) != threadKey) {
+        thread = arena.GetNextSibling(thread);
+    }
+
+    _path.clear();
+    _pathTime = 0;
+    if (thread != InvalidIndex) {
+        _path.emplace_back(thread, arena.GetFirstChild(thread));
+    }
+}
 
 void
 Trace_AggregateTreeBuilder::OnEndThread(const TraceThreadId& threadId)
 {}
 
-bool
-Trace_AggregateTreeBuilder::AcceptsCategory(TraceCategoryId categoryId) 
-{
-    return true;
-}
-
 void
-Trace_AggregateTreeBuilder::OnEvent(
+Trace_AggregateTreeBuilder::OnEvents(
     const TraceThreadId& threadIndex, 
-    const TfToken& key, 
-    const TraceEvent& e)
+    const TraceCollection::EventSpan& events)
 {
-    switch(e.GetType()) {
-        case TraceEvent::EventType::CounterDelta:
-        case TraceEvent::EventType::CounterValue:
-            _OnCounterEvent(threadIndex, key, e);
-            break;
-        default:
-            break;
+    const TraceCollection::KeyTable& keys = events.GetKeyTable();
+    for (const TraceEvent& e : events) {
+        switch(e.GetType()) {
+            case TraceEvent::EventType::CounterDelta:
+            case TraceEvent::EventType::CounterValue:
+                _OnCounterEvent(
+                    threadIndex, keys.GetToken(keys.GetKeyId(e.GetKey())), e);
+                break;
+            case TraceEvent::EventType::Sample:
+                _OnSampleEvent(e);
+                break;
+            default:
+                break;
+        }
     }
 }
 
@@ -169,66 +222,104 @@ Trace_AggregateTreeBuilder::_OnCounterEvent(
     // the moment. This might need to be revisted in the future.
     if (isDelta) {
         // Set the counter value on the current node.
-    
-        TraceAggregateNodePtr node =
-            _FindAggregateNode(threadIndex, e.GetTimeStamp());
-        if (node) {
-            node->AppendExclusiveCounterValue(res.first->second, e.GetCounterValue());
-            node->AppendInclusiveCounterValue(res.first->second, e.GetCounterValue());
+        const _AggregateIndex node = _FindAggregateNode(e.GetTimeStamp());
+        if (node != TraceAggregateNodeArena::InvalidIndex) {
+            TraceAggregateNodeArena& arena = _aggregateTree->GetNodeArena();
+            arena.AppendExclusiveCounterValue(
+                node, res.first->second, e.GetCounterValue());
+            arena.AppendInclusiveCounterValue(
+                node, res.first->second, e.GetCounterValue());
         }
     }
 }
 
-TraceAggregateNodePtr
- Trace_AggregateTreeBuilder::_FindAggregateNode(
-        const TraceThreadId& threadId, const TraceEvent::TimeStamp ts) const
+void
+Trace_AggregateTreeBuilder::_OnSampleEvent(const TraceEvent& e)
 {
-    // Find the root node of the thread.
-    const TraceEventNodeRefPtrVector& threadNodeList =
-        _tree->GetRoot()->GetChildrenRef();
-    TfToken threadKey(threadId.ToString());
-    TraceEventNodeRefPtrVector::const_iterator it =
-        std::find_if(threadNodeList.begin(), threadNodeList.end(), 
-        [&threadKey](const TraceEventNodeRefPtr& node) {
-            return node->GetKey() == threadKey;
-        });
-    if (it == threadNodeList.end()) {
-        return nullptr;
-    }
-
-    // Construct a sequence of node names from the thread root node to the
-    // lowest node in the tree which contains this timestamp.
-    TraceEventNodeRefPtr node = *it;
-    std::vector<TfToken> path;
-    while (true) {
-        path.push_back(node->GetKey());
-        // Find the first child which contains this timestamp
-        TraceEventNodeRefPtrVector::const_iterator childIt = 
-            std::lower_bound(
-                node->GetChildrenRef().begin(),
-                node->GetChildrenRef().end(), ts, 
-                []( const TraceEventNodeRefPtr& node,
-                    TraceEvent::TimeStamp ts) {
-                    return node->GetEndTime() < ts;
-                });
-        if (childIt == node->GetChildrenRef().end()) {
-            break;
-        } else {
-            node = *childIt;
-        }
+    const std::vector<uintptr_t> frames = e.GetStackFrames();
+    if (frames.empty()) {
+        return;
+    }
+
+    const _AggregateIndex node = _FindAggregateNode(e.GetTimeStamp());
+    if (node != TraceAggregateNodeArena::InvalidIndex) {
+        // Samples are counted under the innermost function they
+        // interrupted. They have no time, so the times of the scope are
+        // unchanged.
+        _aggregateTree->GetNodeArena().AppendChild(
+            node, _GetSampleKeyId(frames.front()), 0, 1, 1, true);
+    }
+}
+
+TraceAggregateNodeArena::KeyId
+Trace_AggregateTreeBuilder::_GetSampleKeyId(uintptr_t address)
+{
+    const auto it = _sampleKeyIds.find(address);
+    if (it != _sampleKeyIds.end()) {
+        return it->second;
     }
 
-    // Use the sequence of node names to find the corresponding node in the
-    // aggregate tree.
-    TraceAggregateNodePtr aggNode = _aggregateTree->GetRoot();
-    for (const TfToken& name : path) {
-        TraceAggregateNodePtr child = aggNode->GetChild(name);
-        if (!child) {
-            return nullptr;
+    std::string objectPath;
+    void* baseAddress = nullptr;
+    std::string symbolName;
+    void* symbolAddress = nullptr;
+    std::string label;
+    if (!ArchGetAddressInfo(reinterpret_cast<void*>(address),
+            &objectPath, &baseAddress, &symbolName, &symbolAddress)) {
+        label = TfStringPrintf("0x%zx", size_t(address));
+    } else if (!symbolName.empty()) {
+        ArchDemangle(&symbolName);
+        label = symbolName;
+    } else {
+        label = TfStringPrintf("%s+0x%zx",
+            TfGetBaseName(objectPath).c_str(),
+            size_t(address - reinterpret_cast<uintptr_t>(baseAddress)));
+    }
+
+    const TraceAggregateNodeArena::KeyId keyId =
+        _aggregateTree->GetNodeArena().AddKey(TfToken("[sample] " + label));
+    _sampleKeyIds.emplace(address, keyId);
+    return keyId;
+}
+
+Trace_AggregateTreeBuilder::_AggregateIndex
+Trace_AggregateTreeBuilder::_FindAggregateNode(const TraceEvent::TimeStamp ts)
+{
+    constexpr _Index InvalidIndex = TraceEventNodeArena::InvalidIndex;
+    const TraceEventNodeArena& arena = _tree->GetNodeArena();
+    if (_path.empty()) {
+        return TraceAggregateNodeArena::InvalidIndex;
+    }
+
+    // Children only move past the time of earlier events, so search again
+    // from the thread node when time goes backwards.
+    if (ts < _pathTime) {
+        const _Index thread = _path.front().first;
+        _path.clear();
+        _path.emplace_back(thread, arena.GetFirstChild(thread));
+    }
+    _pathTime = ts;
+
+    // Descend from the thread node to the lowest node in the tree which
+    // contains this timestamp, following the first child of each node which
+    // ends at or after it, unless that child begins after it, in which case
+    // the timestamp is in the exclusive time of the node.
+    for (size_t depth = 0; ; ++depth) {
+        _Index& child = _path[depth].second;
+        while (child != InvalidIndex && arena.GetEndTime(child) < ts) {
+            child = arena.GetNextSibling(child);
+        }
+        if (child == InvalidIndex || arena.GetBeginTime(child) > ts) {
+            _path.resize(depth + 1);
+            break;
+        }
+        if (depth + 1 == _path.size() || _path[depth + 1].first != child) {
+            _path.resize(depth + 1);
+            _path.emplace_back(child, arena.GetFirstChild(child));
         }
-        aggNode = child;
     }
-    return aggNode;
+
+    return _aggregateNodes[_path.back().first];
 }
 
 TRACE_NAMESPACE_CLOSE_SCOPE
@@ -14,6 +14,12 @@
 #include "pxr/trace/collection.h"
 #include "pxr/trace/aggregateTree.h"
 #include "pxr/trace/eventTree.h"
+#include "pxr/trace/eventNodeArena.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
@@ -24,7 +30,7 @@ TRACE_NAMESPACE_OPEN_SCOPE
 /// TraceCollection instances.
 ///
 ///
-class Trace_AggregateTreeBuilder : private TraceCollection::Visitor
+class Trace_AggregateTreeBuilder
 {
 public:
     static void AddEventTreeToAggregate(
@@ -36,30 +42,53 @@ private:
     Trace_AggregateTreeBuilder(
         TraceAggregateTree* tree, const TraceEventTreeRefPtr& eventTree);
 
-    void _ProcessCounters(const TraceCollection& collection);
+    void _ProcessEvents(const TraceCollection& collection);
+
+    void _AddScopeTallies(const TraceCollection& collection);
 
     void _CreateAggregateNodes();
 
-    // TraceCollection::Visitor interface
-    virtual void OnBeginCollection() override;
-    virtual void OnEndCollection() override;
-    virtual void OnBeginThread(const TraceThreadId& threadId) override;
-    virtual void OnEndThread(const TraceThreadId& threadId) override;
-    virtual bool AcceptsCategory(TraceCategoryId categoryId) override;
-    virtual void OnEvent(
+    // TraceCollection batched visitor interface
+    friend class TraceCollection;
+    void OnBeginCollection();
+    void OnEndCollection();
+    void OnBeginThread(const TraceThreadId& threadId);
+    void OnEndThread(const TraceThreadId& threadId);
+    void OnEvents(
         const TraceThreadId& threadIndex, 
-        const TfToken& key, 
-        const TraceEvent& e) override;
+        const TraceCollection::EventSpan& events);
 
     void _OnCounterEvent(const TraceThreadId& threadIndex, 
         const TfToken& key, 
         const TraceEvent& e);
 
-    TraceAggregateNodePtr _FindAggregateNode(
-        const TraceThreadId& threadId, const TraceEvent::TimeStamp ts) const ;
+    void _OnSampleEvent(const TraceEvent& e);
+
+    using _Index = TraceEventNodeArena::Index;
+    using _AggregateIndex = TraceAggregateNodeArena::Index;
+
+    _AggregateIndex _FindAggregateNode(const TraceEvent::TimeStamp ts);
+
+    // Returns the id of the key of the samples interrupted at \p address.
+    TraceAggregateNodeArena::KeyId _GetSampleKeyId(uintptr_t address);
 
     TraceAggregateTree* _aggregateTree;
     TraceEventTreeRefPtr _tree;
+
+    // The aggregate node of each node of the event tree.
+    std::vector<_AggregateIndex> _aggregateNodes;
+
+    // The nodes from the thread node being visited down to the lowest node
+    // which contained the time of the last counter or sample event, each
+    // with the first of its children which ends after that time, or
+    // InvalidIndex. Events are mostly in time order, so the next search
+    // resumes from there.
+    std::vector<std::pair<_Index, _Index>> _path;
+    TraceEvent::TimeStamp _pathTime = 0;
+
+    // The key ids of the addresses of samples, which are symbolized once.
+    std::unordered_map<uintptr_t, TraceAggregateNodeArena::KeyId>
+        _sampleKeyIds;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
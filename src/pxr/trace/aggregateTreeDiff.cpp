@@ -0,0 +1,439 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/aggregateTreeDiff.h"
+
+#include "pxr/trace/pxr.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/mallocTag.h>
+#include <pxr/tf/stringUtils.h>
+#include <pxr/arch/timing.h>
+#include <pxr/js/json.h>
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+// A node of the tree merging the call paths of all baseline and candidate
+// trees. Each side holds one value per run.
+struct _MergedNode {
+    enum Side { Baseline, Candidate };
+
+    explicit _MergedNode(const TfToken& key_) : key(key_) {}
+
+    TfToken key;
+    bool present[2] = {false, false};
+    std::vector<double> inclusive[2];
+    std::vector<double> exclusive[2];
+    std::vector<double> count[2];
+    std::vector<size_t> children;
+    std::unordered_map<TfToken, size_t, TfToken::HashFunctor> childIndices;
+};
+
+double
+_TicksToMilliseconds(double ticks, int iterationCount)
+{
+    return ArchTicksToSeconds(uint64_t(ticks)) * 1e3 / iterationCount;
+}
+
+// Returns the index of the child of nodes[index] with \p key, adding it if
+// needed. Indices remain valid when nodes is reallocated.
+size_t
+_GetChildIndex(
+    std::vector<_MergedNode>& nodes, size_t index, const TfToken& key)
+{
+    auto it = nodes[index].childIndices.find(key);
+    if (it != nodes[index].childIndices.end()) {
+        return it->second;
+    }
+    const size_t childIndex = nodes.size();
+    nodes.emplace_back(key);
+    nodes[index].childIndices.emplace(key, childIndex);
+    nodes[index].children.push_back(childIndex);
+    return childIndex;
+}
+
+// Adds the values of \p node and its descendants for \p run to the merged
+// node at \p index.
+void
+_MergeNode(
+    std::vector<_MergedNode>& nodes,
+    size_t index,
+    const TraceAggregateNodeArena& arena,
+    TraceAggregateNodeArena::Index node,
+    _MergedNode::Side side,
+    size_t run,
+    size_t numRuns,
+    int iterationCount)
+{
+    // Trees may be deep, so they are walked with an explicit stack of the
+    // nodes to merge and their merged node.
+    std::vector<std::pair<TraceAggregateNodeArena::Index, size_t>> stack;
+    stack.emplace_back(node, index);
+    while (!stack.empty()) {
+        const TraceAggregateNodeArena::Index current = stack.back().first;
+        const size_t mergedIndex = stack.back().second;
+        stack.pop_back();
+
+        _MergedNode& merged = nodes[mergedIndex];
+        if (!merged.present[side]) {
+            merged.present[side] = true;
+            merged.inclusive[side].resize(numRuns, 0.0);
+            merged.exclusive[side].resize(numRuns, 0.0);
+            merged.count[side].resize(numRuns, 0.0);
+        }
+        merged.inclusive[side][run] += _TicksToMilliseconds(
+            arena.GetInclusiveTime(current), iterationCount);
+        merged.exclusive[side][run] += _TicksToMilliseconds(
+            arena.GetExclusiveTime(current), iterationCount);
+        merged.count[side][run] +=
+            double(arena.GetCount(current)) / iterationCount;
+
+        // The children are added to the merged node in order, so that the
+        // entries follow the order of the first tree.
+        for (TraceAggregateNodeArena::Index child =
+                arena.GetFirstChild(current);
+                child != TraceAggregateNodeArena::InvalidIndex;
+                child = arena.GetNextSibling(child)) {
+            stack.emplace_back(child,
+                _GetChildIndex(nodes, mergedIndex, arena.GetKey(child)));
+        }
+    }
+}
+
+double
+_Mean(const std::vector<double>& values)
+{
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+double
+_StdDev(const std::vector<double>& values, double mean)
+{
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double v : values) {
+        sum += (v - mean) * (v - mean);
+    }
+    return std::sqrt(sum / (values.size() - 1));
+}
+
+std::string
+_IndentString(size_t indent)
+{
+    std::string s(indent, ' ');
+
+    // Insert '|' characters every 4 spaces, as in TraceReporter::Report.
+    for (size_t i = 2; i < indent; i += 4) {
+        s[i] = '|';
+    }
+    return s;
+}
+
+} // anonymous namespace
+
+double
+TraceAggregateTreeDiff::Entry::GetRelativeDelta() const
+{
+    return baseline.inclusiveTime != 0.0
+        ? GetInclusiveDelta() / baseline.inclusiveTime : 0.0;
+}
+
+TraceAggregateTreeDiff::TraceAggregateTreeDiff(
+    const std::vector<ParsedTree>& baselines,
+    const std::vector<ParsedTree>& candidates,
+    const Options& options)
+    : _options(options)
+    , _numBaselines(0)
+    , _numCandidates(0)
+{
+    TfAutoMallocTag2 tag("Trace", "TraceAggregateTreeDiff");
+
+    std::vector<_MergedNode> nodes;
+    nodes.emplace_back(TfToken("root"));
+
+    auto mergeTrees = [&nodes](
+        const std::vector<ParsedTree>& trees, _MergedNode::Side side) {
+        size_t numRuns = 0;
+        for (const ParsedTree& tree : trees) {
+            if (tree.tree) {
+                ++numRuns;
+            }
+        }
+        size_t run = 0;
+        for (const ParsedTree& tree : trees) {
+            if (!tree.tree) {
+                TF_CODING_ERROR("Invalid aggregate tree");
+                continue;
+            }
+            int iterationCount = tree.iterationCount;
+            if (iterationCount < 1) {
+                TF_CODING_ERROR("iterationCount %d is invalid; "
+                    "falling back to 1", iterationCount);
+                iterationCount = 1;
+            }
+            // Only the children of the root are merged, the root holds no
+            // useful stats.
+            const TraceAggregateNodeArena& arena = tree.tree->GetNodeArena();
+            for (TraceAggregateNodeArena::Index child =
+                    arena.GetFirstChild(tree.tree->GetRootIndex());
+                    child != TraceAggregateNodeArena::InvalidIndex;
+                    child = arena.GetNextSibling(child)) {
+                _MergeNode(nodes, _GetChildIndex(nodes, 0, arena.GetKey(child)),
+                    arena, child, side, run, numRuns, iterationCount);
+            }
+            ++run;
+        }
+        return numRuns;
+    };
+    _numBaselines = mergeTrees(baselines, _MergedNode::Baseline);
+    _numCandidates = mergeTrees(candidates, _MergedNode::Candidate);
+
+    auto measure = [](const _MergedNode& node, _MergedNode::Side side) {
+        Measurement m;
+        if (node.present[side]) {
+            m.inclusiveTime = _Mean(node.inclusive[side]);
+            m.exclusiveTime = _Mean(node.exclusive[side]);
+            m.count = _Mean(node.count[side]);
+            m.inclusiveTimeStdDev =
+                _StdDev(node.inclusive[side], m.inclusiveTime);
+        }
+        return m;
+    };
+
+    const bool hasScores = _numBaselines > 1 && _numCandidates > 1;
+
+    // Walk the merged tree depth first.
+    std::vector<TfToken> path;
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(0, 0);
+    while (!stack.empty()) {
+        const size_t index = stack.back().first;
+        const size_t childIndex = stack.back().second++;
+        if (childIndex >= nodes[index].children.size()) {
+            stack.pop_back();
+            if (!path.empty()) {
+                path.pop_back();
+            }
+            continue;
+        }
+
+        const _MergedNode& node = nodes[nodes[index].children[childIndex]];
+        path.push_back(node.key);
+        stack.emplace_back(nodes[index].children[childIndex], 0);
+
+        Entry entry;
+        entry.path = path;
+        entry.baseline = measure(node, _MergedNode::Baseline);
+        entry.candidate = measure(node, _MergedNode::Candidate);
+
+        const double delta = entry.GetInclusiveDelta();
+        if (hasScores) {
+            const double error = std::sqrt(
+                entry.baseline.inclusiveTimeStdDev
+                * entry.baseline.inclusiveTimeStdDev / _numBaselines
+                + entry.candidate.inclusiveTimeStdDev
+                * entry.candidate.inclusiveTimeStdDev / _numCandidates);
+            entry.hasScore = true;
+            if (error > 0.0) {
+                entry.score = delta / error;
+            } else if (delta != 0.0) {
+                // Identical runs on both sides, any change is significant.
+                entry.score = std::copysign(
+                    std::numeric_limits<double>::infinity(), delta);
+            }
+        }
+
+        if (!node.present[_MergedNode::Baseline]) {
+            entry.status = Status::Added;
+        } else if (!node.present[_MergedNode::Candidate]) {
+            entry.status = Status::Removed;
+        } else {
+            const bool exceedsThreshold =
+                entry.baseline.inclusiveTime != 0.0
+                ? std::fabs(entry.GetRelativeDelta()) > _options.threshold
+                : delta != 0.0;
+            const bool isSignificant = !entry.hasScore
+                || std::fabs(entry.score) >= _options.significance;
+            if (exceedsThreshold && isSignificant
+                    && std::fabs(delta) >= _options.minimumTime) {
+                entry.status =
+                    delta > 0.0 ? Status::Regression : Status::Improvement;
+            }
+        }
+
+        _entries.push_back(std::move(entry));
+    }
+}
+
+std::vector<TraceAggregateTreeDiff::Entry>
+TraceAggregateTreeDiff::GetEntries(Status status) const
+{
+    std::vector<Entry> result;
+    for (const Entry& entry : _entries) {
+        if (entry.status == status) {
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
+
+bool
+TraceAggregateTreeDiff::HasRegressions() const
+{
+    for (const Entry& entry : _entries) {
+        if (entry.status == Status::Regression) {
+            return true;
+        }
+        if (entry.status == Status::Added
+                && entry.candidate.inclusiveTime > _options.minimumTime) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char*
+TraceAggregateTreeDiff::GetStatusName(Status status)
+{
+    switch (status) {
+        case Status::Unchanged: return "unchanged";
+        case Status::Regression: return "regression";
+        case Status::Improvement: return "improvement";
+        case Status::Added: return "added";
+        case Status::Removed: return "removed";
+    }
+    return "";
+}
+
+void
+TraceAggregateTreeDiff::Report(std::ostream& s, bool changedOnly) const
+{
+    // Select the flagged entries and their ancestors.
+    std::vector<bool> selected(_entries.size(), !changedOnly);
+    if (changedOnly) {
+        std::vector<size_t> ancestors;
+        for (size_t i = 0; i < _entries.size(); ++i) {
+            while (!ancestors.empty()
+                    && _entries[ancestors.back()].GetDepth()
+                        >= _entries[i].GetDepth()) {
+                ancestors.pop_back();
+            }
+            if (_entries[i].status != Status::Unchanged) {
+                selected[i] = true;
+                for (auto it = ancestors.rbegin();
+                        it != ancestors.rend() && !selected[*it]; ++it) {
+                    selected[*it] = true;
+                }
+            }
+            ancestors.push_back(i);
+        }
+    }
+
+    s << "\nTree diff  ==============\n";
+    s << "Baseline runs: " << _numBaselines
+      << ", candidate runs: " << _numCandidates
+      << TfStringPrintf(", threshold: %.1f%%\n", _options.threshold * 100.0);
+    s << "    baseline    candidate        delta   change"
+         "  count delta  status\n";
+
+    size_t counts[5] = {0, 0, 0, 0, 0};
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        const Entry& entry = _entries[i];
+        ++counts[static_cast<int>(entry.status)];
+        if (!selected[i]) {
+            continue;
+        }
+
+        std::string changeStr = entry.baseline.inclusiveTime != 0.0
+            ? TfStringPrintf("%+7.1f%% ", entry.GetRelativeDelta() * 100.0)
+            : std::string(9, ' ');
+        s << TfStringPrintf("%9.3f ms %9.3f ms %+9.3f ms ",
+                entry.baseline.inclusiveTime, entry.candidate.inclusiveTime,
+                entry.GetInclusiveDelta())
+          << changeStr
+          << TfStringPrintf("%+12.3f  %-12s ", entry.GetCountDelta(),
+                entry.status == Status::Unchanged
+                    ? "" : GetStatusName(entry.status))
+          << _IndentString(2 * entry.GetDepth())
+          << entry.GetKey().GetString() << "\n";
+    }
+
+    s << "\n" << counts[static_cast<int>(Status::Regression)] << " regressions, "
+      << counts[static_cast<int>(Status::Improvement)] << " improvements, "
+      << counts[static_cast<int>(Status::Added)] << " added, "
+      << counts[static_cast<int>(Status::Removed)] << " removed\n";
+}
+
+void
+TraceAggregateTreeDiff::ReportJson(std::ostream& s) const
+{
+    JsWriter writer(s);
+    WriteJson(writer);
+}
+
+void
+TraceAggregateTreeDiff::WriteJson(JsWriter& js) const
+{
+    auto writeMeasurement = [](JsWriter& js, const Measurement& m) {
+        js.WriteObject(
+            "inclusiveTime", m.inclusiveTime,
+            "exclusiveTime", m.exclusiveTime,
+            "count", m.count,
+            "inclusiveTimeStdDev", m.inclusiveTimeStdDev);
+    };
+
+    js.BeginObject();
+    js.WriteKeyValue("baselineRuns", uint64_t(_numBaselines));
+    js.WriteKeyValue("candidateRuns", uint64_t(_numCandidates));
+    js.WriteKeyValue("threshold", _options.threshold);
+    js.WriteKeyValue("minimumTime", _options.minimumTime);
+    js.WriteKeyValue("significance", _options.significance);
+    js.WriteKeyValue("hasRegressions", HasRegressions());
+    js.WriteKey("nodes");
+    js.WriteArray(_entries, [&writeMeasurement](
+        JsWriter& js, const Entry& entry) {
+        js.BeginObject();
+        js.WriteKey("path");
+        js.WriteArray(entry.path, [](JsWriter& js, const TfToken& key) {
+            js.WriteValue(key.GetString());
+        });
+        js.WriteKeyValue("status", GetStatusName(entry.status));
+        js.WriteKey("baseline");
+        writeMeasurement(js, entry.baseline);
+        js.WriteKey("candidate");
+        writeMeasurement(js, entry.candidate);
+        js.WriteKeyValue("inclusiveDelta", entry.GetInclusiveDelta());
+        js.WriteKeyValue("exclusiveDelta", entry.GetExclusiveDelta());
+        js.WriteKeyValue("countDelta", entry.GetCountDelta());
+        js.WriteKeyValue("relativeDelta", entry.GetRelativeDelta());
+        if (entry.hasScore) {
+            // JSON has no infinity, so exact changes only have a flag.
+            const bool isExact = std::isinf(entry.score);
+            if (!isExact) {
+                js.WriteKeyValue("score", entry.score);
+            }
+            js.WriteKeyValue("exact", isExact);
+        }
+        js.EndObject();
+    });
+    js.EndObject();
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,197 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_AGGREGATE_TREE_DIFF_H
+#define PXR_TRACE_AGGREGATE_TREE_DIFF_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/aggregateTree.h"
+#include "pxr/trace/reporter.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/token.h>
+#include <pxr/tf/weakBase.h>
+
+#include <iosfwd>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+class JsWriter;
+
+TF_DECLARE_WEAK_AND_REF_PTRS(TraceAggregateTreeDiff);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceAggregateTreeDiff
+///
+/// Compares a baseline and a candidate set of TraceAggregateTree instances,
+/// for example the reports of two builds loaded with
+/// TraceReporter::LoadReport().
+///
+/// Nodes are aligned by call path, the sequence of keys used by
+/// TraceAggregateNode::GetChild() to reach them from the root. Each side may
+/// hold several trees, one per run. When both sides hold at least two runs,
+/// the spread of the inclusive times is used to estimate whether a change is
+/// significant. A node whose inclusive time changes by more than the
+/// relative threshold, by more than the minimum time and significantly, is
+/// reported as a regression or an improvement.
+///
+class TraceAggregateTreeDiff : public TfRefBase, public TfWeakBase {
+public:
+    using This = TraceAggregateTreeDiff;
+    using ThisPtr = TraceAggregateTreeDiffPtr;
+    using ThisRefPtr = TraceAggregateTreeDiffRefPtr;
+
+    using ParsedTree = TraceReporter::ParsedTree;
+
+    /// Parameters controlling which changes are flagged.
+    struct Options {
+        Options() : threshold(0.05), minimumTime(0.0), significance(2.0) {}
+
+        /// Relative change in inclusive time, beyond which a node is flagged.
+        double threshold;
+
+        /// Absolute change in inclusive time in milliseconds per iteration,
+        /// below which a node is never flagged.
+        double minimumTime;
+
+        /// Minimum magnitude of the Welch t statistic of the inclusive times
+        /// for a change to be significant. This only applies when both sides
+        /// have at least two runs.
+        double significance;
+    };
+
+    /// The state of a node in the diff.
+    enum class Status {
+        Unchanged,   ///< The node did not change beyond the thresholds.
+        Regression,  ///< The node got slower.
+        Improvement, ///< The node got faster.
+        Added,       ///< The node only exists in the candidate.
+        Removed      ///< The node only exists in the baseline.
+    };
+
+    /// The measurements of a node on one side of the diff. Times are in
+    /// milliseconds per iteration and values are averaged over the runs.
+    struct Measurement {
+        double inclusiveTime = 0.0;
+        double exclusiveTime = 0.0;
+        double count = 0.0;
+
+        /// The sample standard deviation of the inclusive time over the
+        /// runs, or zero when there is a single run.
+        double inclusiveTimeStdDev = 0.0;
+    };
+
+    /// A node of the diff.
+    struct Entry {
+        /// The keys of the node and its ancestors, outermost first.
+        std::vector<TfToken> path;
+
+        Measurement baseline;
+        Measurement candidate;
+
+        /// The Welch t statistic of the change in inclusive time. This is
+        /// only meaningful if hasScore is true. It is infinite if the time
+        /// changed but the runs of both sides have no spread.
+        double score = 0.0;
+        bool hasScore = false;
+
+        Status status = Status::Unchanged;
+
+        /// Returns the key of the node.
+        const TfToken& GetKey() const { return path.back(); }
+
+        /// Returns the depth of the node, 1 for children of the root.
+        size_t GetDepth() const { return path.size(); }
+
+        /// Returns the change in inclusive time.
+        double GetInclusiveDelta() const {
+            return candidate.inclusiveTime - baseline.inclusiveTime;
+        }
+
+        /// Returns the change in exclusive time.
+        double GetExclusiveDelta() const {
+            return candidate.exclusiveTime - baseline.exclusiveTime;
+        }
+
+        /// Returns the change in count.
+        double GetCountDelta() const {
+            return candidate.count - baseline.count;
+        }
+
+        /// Returns the change in inclusive time relative to the baseline, or
+        /// zero if the baseline time is zero.
+        TRACE_API double GetRelativeDelta() const;
+    };
+
+    /// Compares \p baseline to \p candidate.
+    static ThisRefPtr New(
+        const TraceAggregateTreeRefPtr& baseline,
+        const TraceAggregateTreeRefPtr& candidate,
+        const Options& options = Options()) {
+        return New({ParsedTree{baseline, 1}}, {ParsedTree{candidate, 1}},
+            options);
+    }
+
+    /// Compares the runs in \p baselines to the runs in \p candidates. The
+    /// times of each tree are divided by its iteration count.
+    static ThisRefPtr New(
+        const std::vector<ParsedTree>& baselines,
+        const std::vector<ParsedTree>& candidates,
+        const Options& options = Options()) {
+        return TfCreateRefPtr(new This(baselines, candidates, options));
+    }
+
+    /// Returns the options the diff was computed with.
+    const Options& GetOptions() const { return _options; }
+
+    /// Returns the number of baseline runs.
+    size_t GetBaselineRunCount() const { return _numBaselines; }
+
+    /// Returns the number of candidate runs.
+    size_t GetCandidateRunCount() const { return _numCandidates; }
+
+    /// Returns all nodes of the diff in depth first order.
+    const std::vector<Entry>& GetEntries() const { return _entries; }
+
+    /// Returns the nodes with status \p status in depth first order.
+    TRACE_API std::vector<Entry> GetEntries(Status status) const;
+
+    /// Returns true if any node regressed, or was added with an inclusive
+    /// time above the minimum time of the options.
+    TRACE_API bool HasRegressions() const;
+
+    /// Writes a text report of the diff to \p s. Unless \p changedOnly is
+    /// false, only the nodes which were flagged and their ancestors are
+    /// written.
+    TRACE_API void Report(std::ostream& s, bool changedOnly = true) const;
+
+    /// Writes a JSON report of the diff to \p s.
+    TRACE_API void ReportJson(std::ostream& s) const;
+
+    /// Writes the diff as a JSON object to \p writer.
+    TRACE_API void WriteJson(JsWriter& writer) const;
+
+    /// Returns the name of \p status used in the reports.
+    TRACE_API static const char* GetStatusName(Status status);
+
+private:
+    TRACE_API TraceAggregateTreeDiff(
+        const std::vector<ParsedTree>& baselines,
+        const std::vector<ParsedTree>& candidates,
+        const Options& options);
+
+    Options _options;
+    size_t _numBaselines;
+    size_t _numCandidates;
+    std::vector<Entry> _entries;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_AGGREGATE_TREE_DIFF_H
@@ -0,0 +1,33 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_ALLOCATION_OBSERVER_H
+#define PXR_TRACE_ALLOCATION_OBSERVER_H
+
+#include "pxr/trace/pxr.h"
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class TraceAllocationObserver
+///
+/// Interface of the objects notified when a TraceEventContainer or a
+/// TraceDataBuffer allocates a block of memory. The TraceCollector uses it to
+/// account for the memory of the events of each thread, which only changes
+/// when blocks are allocated.
+///
+class TraceAllocationObserver {
+public:
+    virtual ~TraceAllocationObserver() = default;
+
+    /// Called after a block was allocated, on the thread which allocated it.
+    /// The observer may release the oldest blocks of the event container,
+    /// see TraceEventContainer::DropOldestBlocks().
+    virtual void OnBlockAllocated() = 0;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_ALLOCATION_OBSERVER_H
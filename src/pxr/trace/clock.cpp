@@ -0,0 +1,269 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/clock.h"
+
+#include "pxr/trace/pxr.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/defines.h>
+
+#if defined(ARCH_OS_WINDOWS)
+#include <cstdlib>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+std::atomic<uint8_t> TraceClock::_source(uint8_t(TraceClock::Source::Tick));
+
+namespace {
+
+using TimeStamp = TraceClock::TimeStamp;
+
+// Number of readings used to find the tightest anchor.
+constexpr int _CalibrationSamples = 16;
+
+std::atomic<TimeStamp> _virtualTime(0);
+
+std::mutex _calibrationMutex;
+TraceClockCalibration _calibration;
+
+TimeStamp
+_NanosecondsToTicks(int64_t ns)
+{
+    return TimeStamp(double(ns) / ArchGetNanosecondsPerTick());
+}
+
+int64_t
+_Realtime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#if defined(ARCH_OS_WINDOWS)
+
+int64_t
+_Monotonic()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#else
+
+int64_t
+_ReadClock(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int64_t
+_Monotonic()
+{
+    return _ReadClock(CLOCK_MONOTONIC);
+}
+
+#endif
+
+} // anonymous namespace
+
+int64_t
+TraceClockCalibration::GetRealtime(TimeStamp time) const
+{
+    if (!IsValid()) {
+        return 0;
+    }
+    const int64_t ticks = int64_t(time - anchor);
+    return realtime + std::llround(double(ticks) * 1.0e9 / ticksPerSecond);
+}
+
+TraceClockCalibration::TimeStamp
+TraceClockCalibration::GetTimeStamp(int64_t time) const
+{
+    if (!IsValid()) {
+        return 0;
+    }
+    const int64_t ns = time - realtime;
+    return anchor +
+        TimeStamp(std::llround(double(ns) * ticksPerSecond / 1.0e9));
+}
+
+bool
+TraceClockCalibration::IsSameClock(const TraceClockCalibration& other) const
+{
+    return source == other.source &&
+        source != TraceClock::GetSourceName(TraceClock::Source::Virtual) &&
+        !host.empty() && host == other.host;
+}
+
+TraceClockCalibration::TimeStamp
+TraceClockCalibration::Convert(
+    TimeStamp time, const TraceClockCalibration& target) const
+{
+    if (!IsValid() || !target.IsValid() || IsSameClock(target)) {
+        return time;
+    }
+    return target.GetTimeStamp(GetRealtime(time));
+}
+
+bool
+TraceClockCalibration::operator==(const TraceClockCalibration& other) const
+{
+    return source == other.source &&
+        host == other.host &&
+        ticksPerSecond == other.ticksPerSecond &&
+        anchor == other.anchor &&
+        realtime == other.realtime &&
+        monotonic == other.monotonic &&
+        uncertainty == other.uncertainty;
+}
+
+TraceClock::TimeStamp
+TraceClock::_Now()
+{
+    switch (_GetSource()) {
+        case Source::Tick:
+            return ArchGetTickTime();
+        case Source::Monotonic:
+            return _NanosecondsToTicks(_Monotonic());
+        case Source::MonotonicRaw:
+#if defined(CLOCK_MONOTONIC_RAW)
+            return _NanosecondsToTicks(_ReadClock(CLOCK_MONOTONIC_RAW));
+#else
+            break;
+#endif
+        case Source::Virtual:
+            return _virtualTime.load(std::memory_order_acquire);
+    }
+    return ArchGetTickTime();
+}
+
+bool
+TraceClock::SetSource(Source source)
+{
+    if (!IsSourceAvailable(source)) {
+        TF_RUNTIME_ERROR("Clock source '%s' is not available",
+            GetSourceName(source));
+        return false;
+    }
+    _source.store(uint8_t(source), std::memory_order_relaxed);
+    Calibrate();
+    return true;
+}
+
+bool
+TraceClock::IsSourceAvailable(Source source)
+{
+    switch (source) {
+        case Source::Tick:
+        case Source::Monotonic:
+        case Source::Virtual:
+            return true;
+        case Source::MonotonicRaw:
+#if defined(CLOCK_MONOTONIC_RAW)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char*
+TraceClock::GetSourceName(Source source)
+{
+    switch (source) {
+        case Source::Tick: return "Tick";
+        case Source::Monotonic: return "Monotonic";
+        case Source::MonotonicRaw: return "MonotonicRaw";
+        case Source::Virtual: return "Virtual";
+    }
+    return "Unknown";
+}
+
+void
+TraceClock::SetVirtualTime(TimeStamp time)
+{
+    _virtualTime.store(time, std::memory_order_release);
+}
+
+TraceClock::TimeStamp
+TraceClock::AdvanceVirtualTime(TimeStamp delta)
+{
+    return _virtualTime.fetch_add(delta, std::memory_order_acq_rel) + delta;
+}
+
+TraceClockCalibration
+TraceClock::GetCalibration()
+{
+    {
+        std::lock_guard<std::mutex> lock(_calibrationMutex);
+        if (_calibration.IsValid() &&
+            _calibration.source == GetSourceName(GetSource())) {
+            return _calibration;
+        }
+    }
+    return Calibrate();
+}
+
+TraceClockCalibration
+TraceClock::Calibrate()
+{
+    TraceClockCalibration calibration;
+    calibration.source = GetSourceName(GetSource());
+    calibration.host = GetHostName();
+    calibration.ticksPerSecond = 1.0e9 / ArchGetNanosecondsPerTick();
+
+    // Read the wall clocks between two readings of the trace clock and keep
+    // the tightest interval.
+    TimeStamp best = std::numeric_limits<TimeStamp>::max();
+    for (int i = 0; i < _CalibrationSamples; ++i) {
+        const TimeStamp before = Now();
+        const int64_t realtime = _Realtime();
+        const int64_t monotonic = _Monotonic();
+        const TimeStamp after = Now();
+        if (after < before || after - before >= best) {
+            continue;
+        }
+        best = after - before;
+        calibration.anchor = before + best / 2;
+        calibration.realtime = realtime;
+        calibration.monotonic = monotonic;
+    }
+    calibration.uncertainty = best == std::numeric_limits<TimeStamp>::max()
+        ? 0 : uint64_t(ArchTicksToNanoseconds(best / 2 + best % 2));
+
+    std::lock_guard<std::mutex> lock(_calibrationMutex);
+    _calibration = calibration;
+    return calibration;
+}
+
+std::string
+TraceClock::GetHostName()
+{
+#if defined(ARCH_OS_WINDOWS)
+    const char* name = std::getenv("COMPUTERNAME");
+    return name ? std::string(name) : std::string();
+#else
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) != 0) {
+        return std::string();
+    }
+    return std::string(name);
+#endif
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,182 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_CLOCK_H
+#define PXR_TRACE_CLOCK_H
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/api.h"
+
+#include <pxr/arch/hints.h>
+#include <pxr/arch/timing.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceClockCalibration
+///
+/// Relates the timestamps of a TraceClock to the wall clock of the host which
+/// recorded them.
+///
+/// A calibration is an anchor: a timestamp of the trace clock read at the
+/// same time as CLOCK_REALTIME and CLOCK_MONOTONIC, within \c uncertainty
+/// nanoseconds. It is stored in the collections created by the
+/// TraceCollector and in serialized traces, so that timestamps recorded by
+/// different processes or hosts can be placed on a common timeline.
+///
+struct TraceClockCalibration {
+    using TimeStamp = uint64_t;
+
+    /// Name of the clock source, see TraceClock::GetSourceName().
+    std::string source;
+
+    /// Name of the host the clock belongs to.
+    std::string host;
+
+    /// Number of timestamp units per second.
+    double ticksPerSecond = 0.0;
+
+    /// Timestamp of the trace clock at the anchor.
+    TimeStamp anchor = 0;
+
+    /// CLOCK_REALTIME at the anchor, in nanoseconds since the epoch.
+    int64_t realtime = 0;
+
+    /// CLOCK_MONOTONIC at the anchor, in nanoseconds.
+    int64_t monotonic = 0;
+
+    /// Maximum error of the anchor, in nanoseconds.
+    uint64_t uncertainty = 0;
+
+    /// Returns true if the calibration was measured.
+    bool IsValid() const { return ticksPerSecond > 0.0; }
+
+    /// Returns the wall clock time of \p time, in nanoseconds since the
+    /// epoch.
+    TRACE_API int64_t GetRealtime(TimeStamp time) const;
+
+    /// Returns the timestamp of the wall clock time \p realtime, in
+    /// nanoseconds since the epoch.
+    TRACE_API TimeStamp GetTimeStamp(int64_t realtime) const;
+
+    /// Returns true if timestamps of this calibration and \p other come
+    /// from the same clock and need no conversion, i.e. clocks of the same
+    /// source, other than the virtual clock, on the same host.
+    TRACE_API bool IsSameClock(const TraceClockCalibration& other) const;
+
+    /// Converts \p time, a timestamp of the clock of this calibration, to
+    /// the clock of \p target.
+    ///
+    /// Timestamps of the same clock are returned unchanged. Otherwise, they
+    /// are converted through the wall clock, so the result is as accurate as
+    /// the synchronization of the wall clocks of the hosts, plus the
+    /// uncertainty of both calibrations.
+    TRACE_API TimeStamp Convert(
+        TimeStamp time, const TraceClockCalibration& target) const;
+
+    /// Equality operator.
+    TRACE_API bool operator==(const TraceClockCalibration& other) const;
+
+    /// Inequality operator.
+    bool operator!=(const TraceClockCalibration& other) const {
+        return !(*this == other);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceClock
+///
+/// The clock used to timestamp the events recorded by the TraceCollector.
+///
+/// Timestamps are expressed in ticks, as returned by ArchGetTickTime(),
+/// whatever the source, so they can be converted with ArchTicksToSeconds()
+/// and related functions. The source should be selected before recording:
+/// timestamps read from different sources cannot be compared.
+///
+class TraceClock {
+public:
+    using TimeStamp = uint64_t;
+
+    /// The sources of timestamps.
+    enum class Source : uint8_t {
+        Tick,          ///< ArchGetTickTime(), e.g. the TSC. The default.
+        Monotonic,     ///< CLOCK_MONOTONIC.
+        MonotonicRaw,  ///< CLOCK_MONOTONIC_RAW, which is not slewed by NTP.
+        Virtual,       ///< Time set by SetVirtualTime(), for tests.
+    };
+
+    /// Returns the current time.
+    static TimeStamp Now() {
+        if (ARCH_LIKELY(_GetSource() == Source::Tick)) {
+            return ArchGetTickTime();
+        }
+        return _Now();
+    }
+
+    /// Returns the current time, for the start of a measured interval.
+    static TimeStamp GetStartTime() {
+        if (ARCH_LIKELY(_GetSource() == Source::Tick)) {
+            return ArchGetStartTickTime();
+        }
+        return _Now();
+    }
+
+    /// Returns the current time, for the end of a measured interval.
+    static TimeStamp GetStopTime() {
+        if (ARCH_LIKELY(_GetSource() == Source::Tick)) {
+            return ArchGetStopTickTime();
+        }
+        return _Now();
+    }
+
+    /// Sets the source of timestamps and measures its calibration.
+    /// Returns false and issues an error if \p source is not available on
+    /// this platform.
+    TRACE_API static bool SetSource(Source source);
+
+    /// Returns the source of timestamps.
+    static Source GetSource() { return _GetSource(); }
+
+    /// Returns true if \p source is available on this platform.
+    TRACE_API static bool IsSourceAvailable(Source source);
+
+    /// Returns the name of \p source.
+    TRACE_API static const char* GetSourceName(Source source);
+
+    /// Sets the time returned by the virtual clock.
+    TRACE_API static void SetVirtualTime(TimeStamp time);
+
+    /// Advances the virtual clock by \p delta and returns the new time.
+    TRACE_API static TimeStamp AdvanceVirtualTime(TimeStamp delta);
+
+    /// Returns the calibration of the current source, measuring it if
+    /// needed.
+    TRACE_API static TraceClockCalibration GetCalibration();
+
+    /// Measures a new calibration of the current source. Long running
+    /// processes may call this periodically so that the anchor follows the
+    /// adjustments of the wall clock.
+    TRACE_API static TraceClockCalibration Calibrate();
+
+    /// Returns the name of the current host.
+    TRACE_API static std::string GetHostName();
+
+private:
+    static Source _GetSource() {
+        return Source(_source.load(std::memory_order_relaxed));
+    }
+
+    TRACE_API static TimeStamp _Now();
+
+    TRACE_API static std::atomic<uint8_t> _source;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_CLOCK_H
@@ -9,59 +9,524 @@
 
 #include "pxr/trace/pxr.h"
 
+#include <pxr/tf/diagnostic.h>
+
+#include <limits>
+
 TRACE_NAMESPACE_OPEN_SCOPE
 
+// The time index divides the events of each thread into chunks of at most 
+// _TimeIndex::ChunkSize contiguous events and records the range of 
+// timestamps covered by each chunk. Events are mostly, but not strictly, 
+// recorded in time order so the index keeps running bounds which can be 
+// binary searched. It also records the scopes which are open at each chunk
+// boundary so that slices do not need to look at events outside of the
+// range.
+struct TraceCollection::_TimeIndex {
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    static constexpr size_t ChunkSize = 256;
+
+    struct Chunk {
+        const TraceEvent* begin;
+        const TraceEvent* end;
+        // The smallest timestamp or Timespan start time in the chunk.
+        TimeStamp minTime;
+        // The largest timestamp in the chunk.
+        TimeStamp maxTime;
+    };
+
+    struct Thread {
+        std::vector<Chunk> chunks;
+        // The largest timestamp in chunk i and all earlier chunks.
+        std::vector<TimeStamp> earlierMaxTimes;
+        // The smallest timestamp in chunk i and all later chunks. This has
+        // one more element than chunks.
+        std::vector<TimeStamp> laterMinTimes;
+
+        // Begin events without a matching End event before boundary i, 
+        // outermost first. Boundary i is the start of chunk i and boundary
+        // chunks.size() is the end of the thread.
+        std::vector<size_t> openBeginOffsets;
+        std::vector<const TraceEvent*> openBegins;
+
+        // Timespan events recorded after boundary i which contain the time
+        // of the last event before it, outermost first.
+        std::vector<size_t> enclosingOffsets;
+        std::vector<const TraceEvent*> enclosing;
+    };
+
+    std::once_flag once;
+    std::map<TraceThreadId, Thread> threads;
+};
+
+TraceCollection::TraceCollection()
+    : _timeIndex(new _TimeIndex)
+    , _keyTable(new _KeyTableData)
+{}
+
+TraceCollection::~TraceCollection() = default;
+
+TraceCollection::TraceCollection(TraceCollection&&) = default;
+
+TraceCollection& TraceCollection::operator=(TraceCollection&&) = default;
+
 void TraceCollection::AddToCollection(const TraceThreadId& id, EventListPtr&& events)
 {
-    EventTable::iterator it = _eventsPerThread.find(id);
-    if (it == _eventsPerThread.end()) {
-        _eventsPerThread.emplace(id, std::move(events));
+    // Keep ids stable by extending a table which has already been handed
+    // out rather than rebuilding it.
+    if (_keyTable && _keyTable->built) {
+        events->ForEachBlock(
+            [this](const TraceEvent* begin, const TraceEvent* end) {
+                _AddKeysToTable(_keyTable->table, begin, end);
+            });
+    }
+    _timeIndex.reset(new _TimeIndex);
+
+    _SegmentList& segments = _eventsPerThread[id];
+    if (!segments.empty() && segments.back().events) {
+        segments.back().events->Append(std::move(*events));
     } else {
-        it->second->Append(std::move(*events));
+        segments.emplace_back();
+        segments.back().events = std::move(events);
+    }
+}
+
+TraceCollection::KeyId
+TraceCollection::KeyTable::GetKeyId(const TraceKey& key) const
+{
+    _KeyIdMap::const_iterator it = _ids.find(key);
+    return it != _ids.end() ? it->second : InvalidKeyId;
+}
+
+TraceCollection::KeyId
+TraceCollection::KeyTable::_Insert(const TraceKey& key)
+{
+    _KeyIdMap::const_iterator it = _ids.find(key);
+    if (it != _ids.end()) {
+        return it->second;
+    }
+
+    // Distinct key data may share a name, e.g. the same dynamic key cached
+    // by the event lists of several threads. Those share a single id.
+    TfToken token(key._ptr->GetString());
+    std::pair<_TokenIdMap::iterator, bool> result = 
+        _idsByToken.emplace(token, static_cast<KeyId>(_tokens.size()));
+    if (result.second) {
+        _tokens.push_back(std::move(token));
+    }
+    _ids.emplace(key, result.first->second);
+    return result.first->second;
+}
+
+void
+TraceCollection::_AddKeysToTable(
+    KeyTable& table, const TraceEvent* begin, const TraceEvent* end)
+{
+    // Events with the same key tend to be adjacent, so avoid the hash 
+    // lookup when the key repeats.
+    const TraceStaticKeyData* lastKey = nullptr;
+    for (const TraceEvent* e = begin; e != end; ++e) {
+        const TraceKey key = e->GetKey();
+        if (key._ptr != lastKey) {
+            table._Insert(key);
+            lastKey = key._ptr;
+        }
+    }
+}
+
+const TraceCollection::KeyTable&
+TraceCollection::GetKeyTable() const
+{
+    if (!_keyTable) {
+        // Moved-from collections have no events.
+        static const KeyTable emptyTable;
+        return emptyTable;
+    }
+    std::call_once(_keyTable->once, [this]() {
+        TfAutoMallocTag2 tag("Trace", "TraceCollection::GetKeyTable");
+        for (const EventTable::value_type& i : _eventsPerThread) {
+            _ForEachBlock(i.second, /* doReverse = */ false,
+                [this](const TraceEvent* begin, const TraceEvent* end) {
+                    _AddKeysToTable(_keyTable->table, begin, end);
+                });
+        }
+        _keyTable->built = true;
+    });
+    return _keyTable->table;
+}
+
+TraceCollection::ScopeTallyMap
+TraceCollection::GetScopeTallies() const
+{
+    ScopeTallyMap tallies;
+    for (const EventTable::value_type& i : _eventsPerThread) {
+        for (const _Segment& segment : i.second) {
+            if (!segment.events) {
+                continue;
+            }
+            for (const auto& j : segment.events->GetScopeTallies()) {
+                ScopeTally& tally = tallies[TfToken(j.first._ptr->GetString())];
+                tally.count += j.second.count;
+                tally.duration += j.second.duration;
+            }
+        }
     }
+    return tallies;
+}
+
+uint64_t
+TraceCollection::GetDroppedEventCount() const
+{
+    uint64_t count = 0;
+    for (const EventTable::value_type& i : _eventsPerThread) {
+        for (const _Segment& segment : i.second) {
+            if (segment.events) {
+                count += segment.events->GetDroppedEventCount();
+            }
+        }
+    }
+    return count;
+}
+
+// Updates \p open, the stack of Begin events which have not been matched by
+// an End event, with the event \p e.
+static void
+_UpdateOpenScopes(std::vector<const TraceEvent*>& open, const TraceEvent& e)
+{
+    switch (e.GetType()) {
+        case TraceEvent::EventType::Begin:
+            open.push_back(&e);
+            break;
+        case TraceEvent::EventType::End:
+            // Unmatched Begin events inside the scope are closed with it.
+            for (size_t i = open.size(); i > 0; --i) {
+                if (open[i-1]->GetKey() == e.GetKey()) {
+                    open.resize(i-1);
+                    break;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+const TraceCollection::_TimeIndex&
+TraceCollection::_GetTimeIndex() const
+{
+    if (!_timeIndex) {
+        // Moved-from collections have no events.
+        static const _TimeIndex emptyIndex;
+        return emptyIndex;
+    }
+    std::call_once(_timeIndex->once, [this]() {
+        TfAutoMallocTag2 tag("Trace", "TraceCollection::_GetTimeIndex");
+        using TimeStamp = TraceEvent::TimeStamp;
+        for (const EventTable::value_type& i : _eventsPerThread) {
+            _TimeIndex::Thread& thread = _timeIndex->threads[i.first];
+
+            _ForEachBlock(i.second, /* doReverse = */ false,
+                [&thread](const TraceEvent* begin, const TraceEvent* end) {
+                    while (begin != end) {
+                        const TraceEvent* chunkEnd = begin + std::min<size_t>(
+                            end - begin, _TimeIndex::ChunkSize);
+                        _TimeIndex::Chunk chunk = {begin, chunkEnd,
+                            std::numeric_limits<TimeStamp>::max(), 0};
+                        TimeStamp minRecorded = chunk.minTime;
+                        for (const TraceEvent* e = begin; e != chunkEnd; ++e) {
+                            const TimeStamp t = e->GetTimeStamp();
+                            minRecorded = std::min(minRecorded, t);
+                            chunk.maxTime = std::max(chunk.maxTime, t);
+                            chunk.minTime = std::min(chunk.minTime,
+                                e->GetType() == TraceEvent::EventType::Timespan
+                                ? e->GetStartTimeStamp() : t);
+                        }
+                        thread.chunks.push_back(chunk);
+                        thread.laterMinTimes.push_back(minRecorded);
+                        begin = chunkEnd;
+                    }
+                });
+
+            const std::vector<_TimeIndex::Chunk>& chunks = thread.chunks;
+            const size_t numChunks = chunks.size();
+
+            // Running bounds.
+            thread.earlierMaxTimes.resize(numChunks);
+            TimeStamp maxTime = 0;
+            for (size_t c = 0; c < numChunks; ++c) {
+                maxTime = std::max(maxTime, chunks[c].maxTime);
+                thread.earlierMaxTimes[c] = maxTime;
+            }
+            thread.laterMinTimes.push_back(
+                std::numeric_limits<TimeStamp>::max());
+            for (size_t c = numChunks; c > 0; --c) {
+                thread.laterMinTimes[c-1] = std::min(
+                    thread.laterMinTimes[c-1], thread.laterMinTimes[c]);
+            }
+
+            // Begin events open at each boundary.
+            std::vector<const TraceEvent*> open;
+            for (size_t c = 0; c <= numChunks; ++c) {
+                thread.openBeginOffsets.push_back(thread.openBegins.size());
+                thread.openBegins.insert(
+                    thread.openBegins.end(), open.begin(), open.end());
+                if (c < numChunks) {
+                    for (const TraceEvent* e = chunks[c].begin; 
+                            e != chunks[c].end; ++e) {
+                        _UpdateOpenScopes(open, *e);
+                    }
+                }
+            }
+            thread.openBeginOffsets.push_back(thread.openBegins.size());
+
+            // Timespan events enclosing each boundary. Timespans are 
+            // recorded when they end, so these are found by walking the 
+            // events backwards.
+            std::vector<std::vector<const TraceEvent*>> enclosing(
+                numChunks + 1);
+            std::vector<const TraceEvent*> spans;
+            for (size_t c = numChunks; c > 0; --c) {
+                enclosing[c] = spans;
+                for (const TraceEvent* e = chunks[c-1].end;
+                        e != chunks[c-1].begin; ) {
+                    --e;
+                    const TimeStamp t = e->GetTimeStamp();
+                    while (!spans.empty() 
+                            && spans.back()->GetStartTimeStamp() > t) {
+                        spans.pop_back();
+                    }
+                    if (e->GetType() == TraceEvent::EventType::Timespan) {
+                        spans.push_back(e);
+                    }
+                }
+            }
+            enclosing[0] = std::move(spans);
+            for (const std::vector<const TraceEvent*>& e : enclosing) {
+                thread.enclosingOffsets.push_back(thread.enclosing.size());
+                thread.enclosing.insert(
+                    thread.enclosing.end(), e.begin(), e.end());
+            }
+            thread.enclosingOffsets.push_back(thread.enclosing.size());
+        }
+    });
+    return *_timeIndex;
+}
+
+TraceCollection
+TraceCollection::Slice(
+    TraceEvent::TimeStamp begin, TraceEvent::TimeStamp end) const
+{
+    TraceCollection slice;
+    if (begin > end) {
+        TF_CODING_ERROR("Invalid time range: begin (%llu) is after end (%llu)",
+            static_cast<unsigned long long>(begin),
+            static_cast<unsigned long long>(end));
+        return slice;
+    }
+
+    TfAutoMallocTag2 tag("Trace", "TraceCollection::Slice");
+    using TimeStamp = TraceEvent::TimeStamp;
+    const _TimeIndex& index = _GetTimeIndex();
+    for (const auto& i : index.threads) {
+        const _TimeIndex::Thread& thread = i.second;
+        const std::vector<_TimeIndex::Chunk>& chunks = thread.chunks;
+
+        // Chunks before lo only have events before the range and chunks 
+        // from hi on only have events after it.
+        const size_t lo = std::lower_bound(
+            thread.earlierMaxTimes.begin(), thread.earlierMaxTimes.end(),
+            begin) - thread.earlierMaxTimes.begin();
+        // laterMinTimes ends with a sentinel which an end at the largest
+        // timestamp is not below.
+        const size_t hi = std::max(lo, std::min(chunks.size(),
+            static_cast<size_t>(std::upper_bound(
+                thread.laterMinTimes.begin(), thread.laterMinTimes.end(),
+                end) - thread.laterMinTimes.begin())));
+
+        auto isInRange = [begin, end](const _TimeIndex::Chunk& chunk) {
+            return chunk.minTime >= begin && chunk.maxTime <= end;
+        };
+
+        // Find the scopes which are open at the beginning of the range.
+        std::vector<const TraceEvent*> open(
+            thread.openBegins.begin() + thread.openBeginOffsets[lo],
+            thread.openBegins.begin() + thread.openBeginOffsets[lo+1]);
+        for (size_t c = lo; c < hi; ++c) {
+            if (isInRange(chunks[c])) {
+                continue;
+            }
+            for (const TraceEvent* e = chunks[c].begin; 
+                    e != chunks[c].end; ++e) {
+                if (e->GetTimeStamp() < begin) {
+                    _UpdateOpenScopes(open, *e);
+                }
+            }
+        }
+
+        _SegmentList segments;
+        auto ownedEvents = [&segments]() -> EventList& {
+            if (segments.empty() || !segments.back().events) {
+                segments.emplace_back();
+                segments.back().events.reset(new EventList);
+            }
+            return *segments.back().events;
+        };
+        auto borrowEvents = [&segments](
+            const TraceEvent* spanBegin, const TraceEvent* spanEnd) {
+            if (segments.empty() || segments.back().events 
+                    || segments.back().end != spanBegin) {
+                segments.emplace_back();
+                segments.back().begin = spanBegin;
+            }
+            segments.back().end = spanEnd;
+        };
+
+        for (const TraceEvent* e : open) {
+            ownedEvents().EmplaceBack(
+                TraceEvent::Begin, e->GetKey(), begin, e->GetCategory());
+        }
+
+        // Chunks entirely in the range are borrowed, the others are 
+        // filtered and clipped.
+        std::vector<const TraceEvent*> enclosing;
+        for (size_t c = lo; c < hi; ++c) {
+            const _TimeIndex::Chunk& chunk = chunks[c];
+            if (isInRange(chunk)) {
+                borrowEvents(chunk.begin, chunk.end);
+                for (const TraceEvent* e = chunk.begin; e != chunk.end; ++e) {
+                    _UpdateOpenScopes(open, *e);
+                }
+                continue;
+            }
+            for (const TraceEvent* e = chunk.begin; e != chunk.end; ++e) {
+                const TimeStamp t = e->GetTimeStamp();
+                if (e->GetType() == TraceEvent::EventType::Timespan) {
+                    const TimeStamp start = e->GetStartTimeStamp();
+                    if (t < begin || start > end) {
+                        continue;
+                    }
+                    if (t > end) {
+                        enclosing.push_back(e);
+                    } else if (start < begin) {
+                        ownedEvents().EmplaceBack(TraceEvent::Timespan, 
+                            e->GetKey(), begin, t, e->GetCategory());
+                    } else {
+                        ownedEvents().EmplaceBack(TraceEvent(TraceEvent::_Copy, *e));
+                    }
+                } else if (t >= begin && t <= end) {
+                    ownedEvents().EmplaceBack(TraceEvent(TraceEvent::_Copy, *e));
+                    _UpdateOpenScopes(open, *e);
+                }
+            }
+        }
+
+        // Close the scopes which are still open at the end of the range.
+        const TraceEvent* const* enclosingBegin = 
+            thread.enclosing.data() + thread.enclosingOffsets[hi];
+        const TraceEvent* const* enclosingEnd = 
+            thread.enclosing.data() + thread.enclosingOffsets[hi+1];
+        enclosing.insert(enclosing.end(), 
+            std::reverse_iterator<const TraceEvent* const*>(enclosingEnd),
+            std::reverse_iterator<const TraceEvent* const*>(enclosingBegin));
+        for (const TraceEvent* e : enclosing) {
+            if (e->GetStartTimeStamp() <= end) {
+                ownedEvents().EmplaceBack(TraceEvent::Timespan, e->GetKey(),
+                    std::max(begin, e->GetStartTimeStamp()), end,
+                    e->GetCategory());
+            }
+        }
+        for (auto it = open.rbegin(); it != open.rend(); ++it) {
+            ownedEvents().EmplaceBack(
+                TraceEvent::End, (*it)->GetKey(), end, (*it)->GetCategory());
+        }
+
+        if (!segments.empty()) {
+            slice._eventsPerThread.emplace(i.first, std::move(segments));
+        }
+    }
+    slice._clockCalibration = _clockCalibration;
+    slice._overflowCount = _overflowCount;
+    slice._recordingPaused = _recordingPaused;
+    return slice;
+}
+
+std::unique_ptr<TraceCollection>
+TraceCollection::Slice(
+    const std::vector<std::shared_ptr<TraceCollection>>& collections,
+    TraceEvent::TimeStamp begin, TraceEvent::TimeStamp end)
+{
+    // A view of the events of all the collections, in order.
+    TraceCollection joined;
+    for (const std::shared_ptr<TraceCollection>& collection : collections) {
+        if (!collection) {
+            continue;
+        }
+        if (!joined._clockCalibration.IsValid()) {
+            joined._clockCalibration = collection->_clockCalibration;
+        }
+        joined._overflowCount += collection->_overflowCount;
+        joined._recordingPaused |= collection->_recordingPaused;
+        for (const EventTable::value_type& i : collection->_eventsPerThread) {
+            _SegmentList& segments = joined._eventsPerThread[i.first];
+            _ForEachBlock(i.second, /* doReverse = */ false,
+                [&segments](const TraceEvent* first, const TraceEvent* last) {
+                    segments.emplace_back();
+                    segments.back().begin = first;
+                    segments.back().end = last;
+                });
+        }
+    }
+
+    std::unique_ptr<TraceCollection> slice(
+        new TraceCollection(joined.Slice(begin, end)));
+    slice->_sources = collections;
+    return slice;
 }
 
 template <class I>
 void TraceCollection::_IterateEvents(Visitor& visitor,
-    KeyTokenCache& cache,
+    const KeyTable& table,
     const TraceThreadId& threadIndex, 
     I begin,
     I end) const {
 
+    const TraceStaticKeyData* lastKey = nullptr;
+    KeyId keyId = KeyTable::InvalidKeyId;
     for (I iter = begin; 
         iter != end; ++iter){
         const TraceEvent& e = *iter;
         if (visitor.AcceptsCategory(e.GetCategory())) {
-            // Create the token from the hash using a cache because there 
-            // are likely to be many duplicate keys.
-            KeyTokenCache::const_iterator it = cache.find(e.GetKey());
-            if (it == cache.end()) {
-                it = cache.insert(
-                    std::make_pair(e.GetKey(),
-                        TfToken(e.GetKey()._ptr->GetString()))).first;
-            }
-            visitor.OnEvent(threadIndex, it->second, e);
+            const TraceKey key = e.GetKey();
+            if (key._ptr != lastKey) {
+                keyId = table.GetKeyId(key);
+                lastKey = key._ptr;
+            }
+            visitor.OnKeyedEvent(
+                threadIndex, keyId, table.GetToken(keyId), e);
         }
     }
 }
 
 void 
 TraceCollection::_Iterate(Visitor& visitor, bool doReverse) const {
-    KeyTokenCache cache;
+    const KeyTable& table = GetKeyTable();
     visitor.OnBeginCollection();
     for (const EventTable::value_type& i : _eventsPerThread) {
         const TraceThreadId& threadIndex = i.first;
-        const EventListPtr &events = i.second;
         visitor.OnBeginThread(threadIndex);
         
-        if (doReverse) {
-            _IterateEvents(visitor, cache, 
-                threadIndex, events->rbegin(), events->rend());
-        }
-        else {
-            _IterateEvents(visitor, cache, 
-                threadIndex, events->begin(), events->end());
-        }
+        using ReverseIterator = std::reverse_iterator<const TraceEvent*>;
+        _ForEachBlock(i.second, doReverse, 
+            [&](const TraceEvent* begin, const TraceEvent* end) {
+                if (doReverse) {
+                    _IterateEvents(visitor, table, threadIndex,
+                        ReverseIterator(end), ReverseIterator(begin));
+                }
+                else {
+                    _IterateEvents(visitor, table, threadIndex, begin, end);
+                }
+            });
 
         visitor.OnEndThread(threadIndex);
     }
@@ -80,4 +545,16 @@ TraceCollection::ReverseIterate(Visitor& visitor) const {
 
 TraceCollection::Visitor::~Visitor() {}
 
+TraceCollection::BatchVisitor::~BatchVisitor() {}
+
+void
+TraceCollection::Visitor::OnKeyedEvent(
+    const TraceThreadId& threadId,
+    KeyId keyId,
+    const TfToken& key,
+    const TraceEvent& event)
+{
+    OnEvent(threadId, key, event);
+}
+
 TRACE_NAMESPACE_CLOSE_SCOPE
@@ -11,14 +11,21 @@
 #include "pxr/trace/pxr.h"
 
 #include "pxr/trace/api.h"
+#include "pxr/trace/clock.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/eventList.h"
 #include "pxr/trace/threads.h"
 
 #include <pxr/tf/mallocTag.h>
+#include <pxr/tf/token.h>
 
+#include <algorithm>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
@@ -39,13 +46,16 @@ public:
     using EventListPtr = std::unique_ptr<EventList>;
 
     /// Constructor.
-    TraceCollection() = default;
+    TRACE_API TraceCollection();
+
+    /// Destructor.
+    TRACE_API ~TraceCollection();
 
     /// Move constructor.
-    TraceCollection(TraceCollection&&) = default;
+    TRACE_API TraceCollection(TraceCollection&&);
 
     /// Move assignment operator.
-    TraceCollection& operator=(TraceCollection&&) = default;
+    TRACE_API TraceCollection& operator=(TraceCollection&&);
 
     // Collections should not be copied because TraceEvents contain 
     // pointers to elements in the Key cache.
@@ -57,6 +67,134 @@ public:
     /// take ownership of the data.
     TRACE_API void AddToCollection(const TraceThreadId& id, EventListPtr&& events);
 
+    /// Returns a collection holding the events of this collection which 
+    /// occurred between \p begin and \p end.
+    ///
+    /// The returned collection is a view: it refers to the events, keys and 
+    /// data of this collection and must not outlive it. Events are only 
+    /// copied near the boundaries of the range, so the cost of slicing is 
+    /// proportional to the number of events in the range rather than to 
+    /// the size of the collection.
+    ///
+    /// Scopes which are open at the boundaries are reconstructed and 
+    /// clipped to the range: unmatched Begin events get an End event at 
+    /// \p end, scopes that began before the range get a Begin event at 
+    /// \p begin, and Timespan events overlapping a boundary are clipped.
+    /// Counter events are included as recorded, so counter values in the 
+    /// slice are relative to the beginning of the range.
+    ///
+    /// The first call builds a sparse per-thread index of the collection's
+    /// timestamps which is reused by subsequent calls.
+    TRACE_API TraceCollection Slice(
+        TraceEvent::TimeStamp begin, TraceEvent::TimeStamp end) const;
+
+    /// Returns a collection holding the events of \p collections which
+    /// occurred between \p begin and \p end. The collections are expected
+    /// to hold consecutive events, e.g. successive collections produced by
+    /// the TraceCollector, and are treated as a single collection.
+    ///
+    /// Like the other overload, the returned collection refers to the
+    /// events of \p collections, but it keeps them alive so it may outlive
+    /// the caller's references.
+    TRACE_API static std::unique_ptr<TraceCollection> Slice(
+        const std::vector<std::shared_ptr<TraceCollection>>& collections,
+        TraceEvent::TimeStamp begin, TraceEvent::TimeStamp end);
+
+    /// Sets the calibration of the clock the events were recorded with.
+    void SetClockCalibration(const TraceClockCalibration& calibration) {
+        _clockCalibration = calibration;
+    }
+
+    /// Returns the calibration of the clock the events were recorded with.
+    /// It is set by the TraceCollector and read from serialized traces, and
+    /// is invalid if unknown.
+    const TraceClockCalibration& GetClockCalibration() const {
+        return _clockCalibration;
+    }
+
+    using ScopeTally = EventList::ScopeTally;
+    using ScopeTallyMap = std::map<TfToken, ScopeTally>;
+
+    /// Returns the number and total duration of the scopes, by key, which
+    /// were not stored as events because they were shorter than the minimum
+    /// scope duration of the TraceCollector. Slices do not have tallies.
+    TRACE_API ScopeTallyMap GetScopeTallies() const;
+
+    /// Sets the number of block allocations which exceeded the memory limit
+    /// of the TraceCollector while the events were recorded.
+    void SetOverflowCount(uint64_t count) { _overflowCount = count; }
+
+    /// Returns the number of block allocations which exceeded the memory
+    /// limit of the TraceCollector while the events were recorded. Events
+    /// may be missing from the collection when it is not 0, see
+    /// TraceCollector::SetMemoryLimit().
+    uint64_t GetOverflowCount() const { return _overflowCount; }
+
+    /// Sets whether the TraceCollector paused recording because the memory
+    /// limit was exceeded while the events were recorded.
+    void SetRecordingPaused(bool paused) { _recordingPaused = paused; }
+
+    /// Returns true if the TraceCollector paused recording because the
+    /// memory limit was exceeded, see TraceCollector::OverflowPolicy::Stop.
+    /// The events which would have been recorded meanwhile are missing from
+    /// the collection.
+    bool WasRecordingPaused() const { return _recordingPaused; }
+
+    /// Returns the number of events which were dropped to stay below the
+    /// memory limit of the TraceCollector. Slices do not have dropped events,
+    /// but keep the overflow count of the collections they were taken from.
+    TRACE_API uint64_t GetDroppedEventCount() const;
+
+    ////////////////////////////////////////////////////////////////////////
+    ///
+    /// \class KeyTable
+    ///
+    /// The resolved keys of a collection. Each distinct key name in the 
+    /// collection is assigned a dense id and a TfToken.
+    /// Ids are stable for the lifetime of the collection, including across
+    /// calls to AddToCollection, so visitors may use them to index their own
+    /// per-key storage.
+    ///
+    class KeyTable {
+    public:
+        using KeyId = uint32_t;
+
+        /// The id returned for keys which are not part of the collection.
+        static constexpr KeyId InvalidKeyId = ~KeyId(0);
+
+        /// Returns the id of \p key, or InvalidKeyId.
+        TRACE_API KeyId GetKeyId(const TraceKey& key) const;
+
+        /// Returns the token of the key with id \p keyId.
+        const TfToken& GetToken(KeyId keyId) const {
+            return _tokens[keyId];
+        }
+
+        /// Returns the number of distinct keys in the table.
+        size_t GetSize() const { return _tokens.size(); }
+
+    private:
+        friend class TraceCollection;
+
+        // Assigns an id to \p key if it does not already have one.
+        KeyId _Insert(const TraceKey& key);
+
+        using _KeyIdMap = 
+            std::unordered_map<TraceKey, KeyId, TraceKey::HashFunctor>;
+        using _TokenIdMap = 
+            std::unordered_map<TfToken, KeyId, TfToken::HashFunctor>;
+        _KeyIdMap _ids;
+        _TokenIdMap _idsByToken;
+        std::vector<TfToken> _tokens;
+    };
+
+    using KeyId = KeyTable::KeyId;
+
+    /// Returns the key table for the collection. The table is built the
+    /// first time it is requested and is shared by all subsequent 
+    /// iterations. This method is thread safe.
+    TRACE_API const KeyTable& GetKeyTable() const;
+
     ////////////////////////////////////////////////////////////////////////
     ///
     /// \class Visitor
@@ -92,6 +230,16 @@ public:
             const TraceThreadId& threadId, 
             const TfToken& key, 
             const TraceEvent& event) = 0;
+
+        /// Called for every event \p event with \p key on thread 
+        /// \p threadId if AcceptsCategory returns true. \p keyId is the id 
+        /// of \p key in the collection's KeyTable. The default 
+        /// implementation calls OnEvent.
+        TRACE_API virtual void OnKeyedEvent(
+            const TraceThreadId& threadId, 
+            KeyId keyId,
+            const TfToken& key, 
+            const TraceEvent& event);
     };
 
     /// Forward iterates over the events of the collection and calls the
@@ -102,10 +250,109 @@ public:
     /// \p visitor callbacks.
     TRACE_API void ReverseIterate(Visitor& visitor) const;
 
-private:
-    using KeyTokenCache = 
-        std::unordered_map<TraceKey, TfToken, TraceKey::HashFunctor>;
+    ////////////////////////////////////////////////////////////////////////
+    ///
+    /// \class EventSpan
+    ///
+    /// A contiguous range of events recorded by a single thread. Events are
+    /// always stored in the order they were recorded; reverse iterations
+    /// should walk spans from rbegin() to rend().
+    ///
+    class EventSpan {
+    public:
+        using const_iterator = const TraceEvent*;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        EventSpan(const TraceEvent* begin, const TraceEvent* end,
+                  const KeyTable& keyTable)
+            : _begin(begin), _end(end), _keyTable(&keyTable)
+        {}
+
+        const_iterator begin() const { return _begin; }
+        const_iterator end() const { return _end; }
+
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(_end);
+        }
+        const_reverse_iterator rend() const {
+            return const_reverse_iterator(_begin);
+        }
+
+        size_t size() const { return _end - _begin; }
+        bool empty() const { return _begin == _end; }
+
+        /// Returns the key table of the collection the events belong to.
+        const KeyTable& GetKeyTable() const { return *_keyTable; }
+
+    private:
+        const TraceEvent* _begin;
+        const TraceEvent* _end;
+        const KeyTable* _keyTable;
+    };
+
+    /// The categories accepted by a batched iteration. An empty filter 
+    /// accepts events of every category.
+    using CategoryFilter = std::vector<TraceCategoryId>;
+
+    ////////////////////////////////////////////////////////////////////////
+    ///
+    /// \class BatchVisitor
+    ///
+    /// This interface provides access to the data of a TraceCollection a 
+    /// span of events at a time. 
+    ///
+    /// IterateBatches() and ReverseIterateBatches() are templates, so any 
+    /// class providing these methods may be passed to them directly, in 
+    /// which case the calls are resolved at compile time. Deriving from 
+    /// BatchVisitor is only needed when the visitor type is not known 
+    /// statically.
+    ///
+    class BatchVisitor {
+    public:
+        /// Destructor
+        TRACE_API virtual ~BatchVisitor();
+
+        /// Called at the beginning of an iteration.
+        virtual void OnBeginCollection() = 0;
+
+        /// Called at the end of an iteration.
+        virtual void OnEndCollection() = 0;
+
+        /// Called before the first span of events from the thread with 
+        /// \p threadId.
+        virtual void OnBeginThread(const TraceThreadId& threadId) = 0;
+
+        /// Called after the last span of events from the thread with 
+        /// \p threadId.
+        virtual void OnEndThread(const TraceThreadId& threadId) = 0;
+
+        /// Called for every span of \p events recorded on thread 
+        /// \p threadId.
+        virtual void OnEvents(
+            const TraceThreadId& threadId, const EventSpan& events) = 0;
+    };
+
+    /// Forward iterates over the events of the collection and calls the
+    /// \p visitor callbacks once per span of contiguous events. If 
+    /// \p filter is not empty, only events with a category in \p filter are
+    /// passed to the visitor.
+    template <class V>
+    void IterateBatches(
+        V& visitor, const CategoryFilter& filter = CategoryFilter()) const {
+        _IterateBatches(visitor, filter, /* doReverse = */ false);
+    }
 
+    /// Reverse iterates over the events of the collection and calls the
+    /// \p visitor callbacks once per span of contiguous events. Spans are
+    /// visited last to first. If \p filter is not empty, only events with a
+    /// category in \p filter are passed to the visitor.
+    template <class V>
+    void ReverseIterateBatches(
+        V& visitor, const CategoryFilter& filter = CategoryFilter()) const {
+        _IterateBatches(visitor, filter, /* doReverse = */ true);
+    }
+
+private:
     /// Iterate through threads, then choose either forward or reverse
     /// iteration for the events in the threads
     void _Iterate(Visitor& visitor, bool doReverse) const;
@@ -113,14 +360,171 @@ private:
     // Iterate through events in either forward or reverse order, depending on
     // the templated arguments
     template <class I> 
-    void _IterateEvents(Visitor&, KeyTokenCache&, 
+    void _IterateEvents(Visitor&, const KeyTable&, 
         const TraceThreadId&, I, I) const;
 
-    using EventTable = std::map<TraceThreadId, EventListPtr>;
+    template <class V>
+    void _IterateBatches(
+        V& visitor, const CategoryFilter& filter, bool doReverse) const;
+
+    // Calls \p fn with each run of events in [begin, end) whose category
+    // is accepted by \p filter, in forward or reverse order.
+    template <class Fn>
+    static void _ForEachAcceptedRun(
+        const TraceEvent* begin, const TraceEvent* end,
+        const CategoryFilter& filter, bool doReverse, Fn&& fn);
+
+    // The events of a thread are a sequence of segments. A segment either 
+    // owns a list of events or, in slices, borrows a contiguous span of 
+    // events from the collection the slice was taken from.
+    struct _Segment {
+        EventListPtr events;
+        const TraceEvent* begin = nullptr;
+        const TraceEvent* end = nullptr;
+    };
+    using _SegmentList = std::vector<_Segment>;
+
+    // Calls \p fn with the begin and end pointers of each non-empty block of
+    // events in \p segments, in forward or reverse order.
+    template <class Fn>
+    static void _ForEachBlock(
+        const _SegmentList& segments, bool doReverse, Fn&& fn);
+
+    // Adds the keys of the events in [begin, end) to \p table.
+    static void _AddKeysToTable(
+        KeyTable& table, const TraceEvent* begin, const TraceEvent* end);
+
+    using EventTable = std::map<TraceThreadId, _SegmentList>;
 
     EventTable _eventsPerThread;
+
+    // The sparse time index used by Slice(). It is built lazily and 
+    // replaced when events are added to the collection. Like the key table
+    // it is held by pointer so that the collection remains movable.
+    struct _TimeIndex;
+    const _TimeIndex& _GetTimeIndex() const;
+    std::unique_ptr<_TimeIndex> _timeIndex;
+
+    // The key table is built lazily. It is held by pointer so that the 
+    // collection remains movable.
+    struct _KeyTableData {
+        std::once_flag once;
+        bool built = false;
+        KeyTable table;
+    };
+    std::unique_ptr<_KeyTableData> _keyTable;
+
+    // Collections whose events are referred to by this collection.
+    std::vector<std::shared_ptr<TraceCollection>> _sources;
+
+    TraceClockCalibration _clockCalibration;
+
+    uint64_t _overflowCount = 0;
+    bool _recordingPaused = false;
 };
 
+template <class Fn>
+void
+TraceCollection::_ForEachAcceptedRun(
+    const TraceEvent* begin, const TraceEvent* end,
+    const CategoryFilter& filter, bool doReverse, Fn&& fn)
+{
+    auto accepts = [&filter](const TraceEvent& e) {
+        return std::find(filter.begin(), filter.end(), e.GetCategory()) 
+            != filter.end();
+    };
+
+    if (doReverse) {
+        const TraceEvent* runEnd = end;
+        while (runEnd != begin) {
+            while (runEnd != begin && !accepts(*(runEnd - 1))) {
+                --runEnd;
+            }
+            const TraceEvent* runBegin = runEnd;
+            while (runBegin != begin && accepts(*(runBegin - 1))) {
+                --runBegin;
+            }
+            if (runBegin != runEnd) {
+                fn(runBegin, runEnd);
+            }
+            runEnd = runBegin;
+        }
+    } else {
+        const TraceEvent* runBegin = begin;
+        while (runBegin != end) {
+            while (runBegin != end && !accepts(*runBegin)) {
+                ++runBegin;
+            }
+            const TraceEvent* runEnd = runBegin;
+            while (runEnd != end && accepts(*runEnd)) {
+                ++runEnd;
+            }
+            if (runBegin != runEnd) {
+                fn(runBegin, runEnd);
+            }
+            runBegin = runEnd;
+        }
+    }
+}
+
+template <class Fn>
+void
+TraceCollection::_ForEachBlock(
+    const _SegmentList& segments, bool doReverse, Fn&& fn)
+{
+    auto visitSegment = [&fn, doReverse](const _Segment& segment) {
+        if (segment.events) {
+            if (doReverse) {
+                segment.events->ReverseForEachBlock(fn);
+            } else {
+                segment.events->ForEachBlock(fn);
+            }
+        } else if (segment.begin != segment.end) {
+            fn(segment.begin, segment.end);
+        }
+    };
+
+    if (doReverse) {
+        for (_SegmentList::const_reverse_iterator it = segments.rbegin();
+                it != segments.rend(); ++it) {
+            visitSegment(*it);
+        }
+    } else {
+        for (const _Segment& segment : segments) {
+            visitSegment(segment);
+        }
+    }
+}
+
+template <class V>
+void
+TraceCollection::_IterateBatches(
+    V& visitor, const CategoryFilter& filter, bool doReverse) const
+{
+    const KeyTable& table = GetKeyTable();
+    visitor.OnBeginCollection();
+    for (const EventTable::value_type& i : _eventsPerThread) {
+        const TraceThreadId& threadIndex = i.first;
+        visitor.OnBeginThread(threadIndex);
+
+        auto visitSpan = [&visitor, &threadIndex, &table](
+            const TraceEvent* begin, const TraceEvent* end) {
+            visitor.OnEvents(threadIndex, EventSpan(begin, end, table));
+        };
+        auto visitBlock = [&](const TraceEvent* begin, const TraceEvent* end) {
+            if (filter.empty()) {
+                visitSpan(begin, end);
+            } else {
+                _ForEachAcceptedRun(begin, end, filter, doReverse, visitSpan);
+            }
+        };
+        _ForEachBlock(i.second, doReverse, visitBlock);
+
+        visitor.OnEndThread(threadIndex);
+    }
+    visitor.OnEndCollection();
+}
+
 TRACE_NAMESPACE_CLOSE_SCOPE
 
 #endif // PXR_TRACE_COLLECTION_H
@@ -0,0 +1,156 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/collectionGenerator.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/category.h"
+#include "pxr/trace/eventList.h"
+#include "pxr/trace/threads.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/mallocTag.h>
+#include <pxr/tf/stringUtils.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+// Generates the events of one thread.
+class _ThreadGenerator {
+public:
+    _ThreadGenerator(
+        const TraceCollectionGenerator::Shape& shape,
+        int threadIndex,
+        TraceEventList* events)
+        : _shape(shape)
+        , _events(events)
+        , _random(shape.seed * 1000003 + threadIndex)
+        , _time(0)
+    {
+        for (int i = 0; i < _shape.numKeys; ++i) {
+            _keys.push_back(_events->CacheKey(TfStringPrintf("Key %d", i)));
+        }
+        for (int i = 0; i < _shape.numCounters; ++i) {
+            _counterKeys.push_back(
+                _events->CacheKey(TfStringPrintf("Counter %d", i)));
+        }
+    }
+
+    // Generates a top level scope and the tree of depth \p depth under it.
+    // The tree is walked with an explicit stack, so that deep trees do not
+    // overflow the call stack.
+    void GenerateScope(int depth) {
+        _stack.clear();
+        _BeginScope(depth);
+        while (!_stack.empty()) {
+            _Frame& frame = _stack.back();
+            if (frame.childrenLeft > 0) {
+                --frame.childrenLeft;
+                _BeginScope(frame.depth - 1);
+                continue;
+            }
+            _events->EmplaceBack(
+                TraceEvent::End, frame.key, _NextTime(),
+                TraceCategory::Default);
+            _stack.pop_back();
+        }
+    }
+
+private:
+    // A scope which was begun and not ended yet.
+    struct _Frame {
+        TraceKey key;
+        int depth;
+        int childrenLeft;
+    };
+
+    // Records the begin and counter events of a scope of depth \p depth
+    // and pushes it on the stack.
+    void _BeginScope(int depth) {
+        const TraceKey key = _keys[_random() % _keys.size()];
+        _events->EmplaceBack(
+            TraceEvent::Begin, key, _NextTime(), TraceCategory::Default);
+
+        if (!_counterKeys.empty() && _shape.countersPerScope > 0.0) {
+            const double whole = std::floor(_shape.countersPerScope);
+            std::bernoulli_distribution extra(
+                _shape.countersPerScope - whole);
+            const int numCounters = int(whole) + (extra(_random) ? 1 : 0);
+            for (int i = 0; i < numCounters; ++i) {
+                // Counter events are stamped with the current time when
+                // constructed.
+                TraceEvent counter(TraceEvent::CounterDelta,
+                    _counterKeys[_random() % _counterKeys.size()], 1.0,
+                    TraceCategory::Default);
+                counter.SetTimeStamp(_NextTime());
+                _events->EmplaceBack(std::move(counter));
+            }
+        }
+
+        _stack.push_back({key, depth, depth > 1 ? _shape.fanOut : 0});
+    }
+
+    TraceEvent::TimeStamp _NextTime() {
+        _time += _shape.ticksPerEvent;
+        return _time;
+    }
+
+    const TraceCollectionGenerator::Shape& _shape;
+    TraceEventList* _events;
+    std::mt19937_64 _random;
+    TraceEvent::TimeStamp _time;
+    std::vector<TraceKey> _keys;
+    std::vector<TraceKey> _counterKeys;
+    std::vector<_Frame> _stack;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<TraceCollection>
+TraceCollectionGenerator::Generate(const Shape& shape)
+{
+    TfAutoMallocTag2 tag("Trace", "TraceCollectionGenerator::Generate");
+
+    if (shape.numKeys < 1 || shape.depth < 1 || shape.fanOut < 0) {
+        TF_CODING_ERROR("Invalid collection shape: numKeys %d, depth %d, "
+            "fanOut %d", shape.numKeys, shape.depth, shape.fanOut);
+        return std::unique_ptr<TraceCollection>();
+    }
+
+    std::unique_ptr<TraceCollection> collection(new TraceCollection);
+    for (int t = 0; t < shape.numThreads; ++t) {
+        TraceCollection::EventListPtr events(new TraceEventList);
+        _ThreadGenerator generator(shape, t, events.get());
+        for (int i = 0; i < shape.iterations; ++i) {
+            generator.GenerateScope(shape.depth);
+        }
+        collection->AddToCollection(
+            TraceThreadId(TfStringPrintf("Thread %d", t)), std::move(events));
+    }
+    return collection;
+}
+
+double
+TraceCollectionGenerator::GetExpectedEventCount(const Shape& shape)
+{
+    // Number of scopes under each top level scope.
+    double scopes = 0.0;
+    double level = 1.0;
+    for (int d = 0; d < shape.depth; ++d) {
+        scopes += level;
+        level *= shape.fanOut;
+    }
+    const double countersPerScope =
+        shape.numCounters > 0 ? shape.countersPerScope : 0.0;
+    return double(shape.numThreads) * shape.iterations * scopes
+        * (2.0 + countersPerScope);
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
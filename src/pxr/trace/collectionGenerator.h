@@ -0,0 +1,70 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_COLLECTION_GENERATOR_H
+#define PXR_TRACE_COLLECTION_GENERATOR_H
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/api.h"
+#include "pxr/trace/collection.h"
+
+#include <cstdint>
+#include <memory>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceCollectionGenerator
+///
+/// This class contains methods to create synthetic TraceCollections of a
+/// given shape, for benchmarking and testing the processing of traces.
+///
+class TraceCollectionGenerator {
+public:
+    /// Parameters describing the shape of a generated collection.
+    struct Shape {
+        /// Number of threads in the collection.
+        int numThreads = 4;
+
+        /// Number of top level scopes recorded by each thread.
+        int iterations = 100;
+
+        /// Depth of the scope tree under each top level scope, including the
+        /// top level scope.
+        int depth = 4;
+
+        /// Number of child scopes of each scope which is not a leaf.
+        int fanOut = 4;
+
+        /// Number of distinct scope keys. Keys are picked at random for each
+        /// scope, so a small number of keys produces recursive call trees.
+        int numKeys = 100;
+
+        /// Average number of counter delta events recorded in each scope.
+        double countersPerScope = 0.0;
+
+        /// Number of distinct counter keys.
+        int numCounters = 4;
+
+        /// Number of ticks between consecutive events of a thread.
+        uint64_t ticksPerEvent = 100;
+
+        /// Seed of the random number generator. The same shape and seed
+        /// always generate the same events.
+        uint64_t seed = 0;
+    };
+
+    /// Returns a new collection with the shape \p shape.
+    TRACE_API static std::unique_ptr<TraceCollection> Generate(
+        const Shape& shape);
+
+    /// Returns the number of events a collection with the shape \p shape
+    /// holds on average.
+    TRACE_API static double GetExpectedEventCount(const Shape& shape);
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_COLLECTION_GENERATOR_H
@@ -8,14 +8,18 @@
 #include "pxr/trace/collector.h"
 
 #include "pxr/trace/pxr.h"
+#include "pxr/trace/clock.h"
 #include "pxr/trace/collection.h"
 #include "pxr/trace/collectionNotice.h"
+#include "pxr/trace/eventContainer.h"
 #include "pxr/trace/reporter.h"
+#include "pxr/trace/sampler.h"
 #include "pxr/trace/trace.h"
 
 #include <pxr/arch/stackTrace.h>
 #include <pxr/arch/timing.h>
 
+#include <pxr/tf/diagnostic.h>
 #include <pxr/tf/getenv.h>
 #include <pxr/tf/instantiateSingleton.h>
 
@@ -28,6 +32,7 @@
 
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <utility>
 
@@ -40,6 +45,10 @@ TRACE_NAMESPACE_OPEN_SCOPE
 TF_INSTANTIATE_SINGLETON(TraceCollector);
 
 std::atomic<int> TraceCollector::_isEnabled(0);
+std::atomic<int> TraceCollector::_isMetricsOnly(0);
+std::atomic<TraceCollector::TimeStamp> TraceCollector::_counterDeltaQuantum(0);
+std::atomic<uint64_t> TraceCollector::_minScopeDurationVersion(0);
+std::atomic<uint64_t> TraceCollector::_scopeStatsVersion(0);
 
 TraceCollector::_PerThreadData* TraceCollector::_GetThreadData() noexcept
 {
@@ -59,7 +68,8 @@ void _OutputGlobalReport()
 }
 
 TraceCollector::TraceCollector()
-    : _label("TraceRegistry global collector")
+    : _samplingInterval(ArchSecondsToTicks(1.0e-3))
+    , _label("TraceRegistry global collector")
     , _measuredScopeOverhead(0)
 #ifdef PXR_PYTHON_SUPPORT_ENABLED
     , _isPythonTracingEnabled(false)
@@ -97,6 +107,7 @@ TraceCollector::TraceCollector()
 TraceCollector::~TraceCollector()
 {
     SetEnabled(false);
+    SetSamplingEnabled(false);
 }
 
 void
@@ -105,14 +116,127 @@ TraceCollector::SetEnabled(bool isEnabled)
     _isEnabled.store((int)isEnabled, std::memory_order_release);
 }
 
+void
+TraceCollector::SetMetricsOnly(bool isMetricsOnly)
+{
+    _isMetricsOnly.store((int)isMetricsOnly, std::memory_order_release);
+}
+
+void
+TraceCollector::SetCounterDeltaQuantum(TimeStamp quantum)
+{
+    _counterDeltaQuantum.store(quantum, std::memory_order_relaxed);
+}
+
+void
+TraceCollector::SetMinimumScopeDuration(TimeStamp duration)
+{
+    std::lock_guard<std::mutex> lock(_minScopeDurationsMutex);
+    _minScopeDurations.duration = duration;
+    _minScopeDurations.version = ++_minScopeDurationVersion;
+}
+
+void
+TraceCollector::SetMinimumScopeDuration(
+    TraceCategoryId id, TimeStamp duration)
+{
+    std::lock_guard<std::mutex> lock(_minScopeDurationsMutex);
+    _minScopeDurations.categories[id] = duration;
+    _minScopeDurations.version = ++_minScopeDurationVersion;
+}
+
+void
+TraceCollector::ResetMinimumScopeDuration(TraceCategoryId id)
+{
+    std::lock_guard<std::mutex> lock(_minScopeDurationsMutex);
+    _minScopeDurations.categories.erase(id);
+    _minScopeDurations.version = ++_minScopeDurationVersion;
+}
+
+TraceCollector::TimeStamp
+TraceCollector::GetMinimumScopeDuration(TraceCategoryId id) const
+{
+    std::lock_guard<std::mutex> lock(_minScopeDurationsMutex);
+    const auto it = _minScopeDurations.categories.find(id);
+    return it != _minScopeDurations.categories.end()
+        ? it->second : _minScopeDurations.duration;
+}
+
+void
+TraceCollector::SetSamplingEnabled(bool isEnabled)
+{
+    std::lock_guard<std::mutex> lock(_samplerMutex);
+    if (isEnabled && !_sampler) {
+        if (!Trace_Sampler::IsSupported()) {
+            TF_RUNTIME_ERROR("Sampling is not available on this platform");
+            return;
+        }
+        _sampler.reset(new Trace_Sampler(*this, _samplingInterval));
+    } else if (!isEnabled) {
+        _sampler.reset();
+    }
+}
+
+bool
+TraceCollector::IsSamplingEnabled() const
+{
+    std::lock_guard<std::mutex> lock(_samplerMutex);
+    return bool(_sampler);
+}
+
+void
+TraceCollector::SetSamplingInterval(TimeStamp interval)
+{
+    if (interval == 0) {
+        TF_CODING_ERROR("Sampling interval must be greater than 0");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_samplerMutex);
+    _samplingInterval = interval;
+    // The timers of the threads are started with the interval.
+    if (_sampler) {
+        _sampler.reset();
+        _sampler.reset(new Trace_Sampler(*this, _samplingInterval));
+    }
+}
+
+TraceCollector::TimeStamp
+TraceCollector::GetSamplingInterval() const
+{
+    std::lock_guard<std::mutex> lock(_samplerMutex);
+    return _samplingInterval;
+}
+
+TraceCollector::ScopeStatsMap
+TraceCollector::GetScopeStats()
+{
+    TfAutoMallocTag2 tag("Trace", "TraceCollector::GetScopeStats");
+    ScopeStatsMap stats;
+    for (_PerThreadData& i : _allPerThreadData) {
+        i.MergeScopeStats(&stats);
+    }
+    return stats;
+}
+
+void
+TraceCollector::ClearScopeStats()
+{
+    // The statistics are only written by their threads, so they are reset
+    // by them.
+    _scopeStatsVersion.fetch_add(1, std::memory_order_relaxed);
+}
 
 void
 TraceCollector::Scope(
     const TraceKey& key, TimeStamp start, TimeStamp stop) noexcept
 {
     _PerThreadData *threadData = GetInstance()._GetThreadData();
-    threadData->EmplaceEvent(
-        TraceEvent::Timespan, key, start, stop, DefaultCategory::GetId());
+    if (ARCH_UNLIKELY(IsMetricsOnly())) {
+        threadData->RecordScopeStats(key, stop - start);
+        return;
+    }
+    threadData->RecordScope(key, start, stop, DefaultCategory::GetId());
 }
 
 TraceCollector::TimeStamp
@@ -190,6 +314,14 @@ TraceCollector::_MarkerEventAtTime(const Key& key, double ms, TraceCategoryId ca
     threadData->MarkerEventAtTime(key, ms, cat);
 }
 
+void
+TraceCollector::_ScopeEvent(const Key& key,
+    TimeStamp start, TimeStamp stop, TraceCategoryId cat)
+{
+    _PerThreadData *threadData = _GetThreadData();
+    threadData->RecordScope(key, start, stop, cat);
+}
+
 TraceCollector::TimeStamp
 TraceCollector::GetScopeOverhead() const
 {
@@ -202,6 +334,78 @@ TraceCollector::Clear()
     for (_PerThreadData& i : _allPerThreadData) {
         i.Clear();
     }
+    _overflowCount.store(0, std::memory_order_relaxed);
+    _recordingPaused.store(false, std::memory_order_relaxed);
+    _ResumeBelowMemoryLimit();
+}
+
+TraceCollector::MemoryUsage
+TraceCollector::GetMemoryUsage()
+{
+    MemoryUsage total;
+    for (_PerThreadData& i : _allPerThreadData) {
+        const MemoryUsage usage = i.GetMemoryUsage();
+        total.eventBytes += usage.eventBytes;
+        total.keyBytes += usage.keyBytes;
+        total.dataBytes += usage.dataBytes;
+        total.spilledBytes += usage.spilledBytes;
+    }
+    return total;
+}
+
+std::vector<std::pair<TraceThreadId, TraceCollector::MemoryUsage>>
+TraceCollector::GetMemoryUsagePerThread()
+{
+    std::vector<std::pair<TraceThreadId, MemoryUsage>> usages;
+    for (_PerThreadData& i : _allPerThreadData) {
+        usages.emplace_back(i.GetThreadId(), i.GetMemoryUsage());
+    }
+    return usages;
+}
+
+void
+TraceCollector::SetMemoryLimit(size_t bytes, OverflowPolicy policy)
+{
+    _overflowPolicy.store(int(policy), std::memory_order_relaxed);
+    _memoryLimit.store(bytes, std::memory_order_relaxed);
+    _ResumeBelowMemoryLimit();
+}
+
+size_t
+TraceCollector::GetMemoryLimit() const
+{
+    return _memoryLimit.load(std::memory_order_relaxed);
+}
+
+TraceCollector::OverflowPolicy
+TraceCollector::GetOverflowPolicy() const
+{
+    return OverflowPolicy(_overflowPolicy.load(std::memory_order_relaxed));
+}
+
+void
+TraceCollector::_StopForMemoryLimit()
+{
+    int enabled = 1;
+    if (_isEnabled.compare_exchange_strong(enabled, _StoppedByMemoryLimit)) {
+        _recordingPaused.store(true, std::memory_order_relaxed);
+    }
+}
+
+void
+TraceCollector::_ResumeBelowMemoryLimit()
+{
+    const size_t limit = _memoryLimit.load(std::memory_order_relaxed);
+    if (limit == 0 || _memoryUsage.load(std::memory_order_relaxed) <= limit) {
+        int stopped = _StoppedByMemoryLimit;
+        _isEnabled.compare_exchange_strong(stopped, 1);
+    }
+
+    // Recording remains paused in the next collection if it is still above
+    // the limit.
+    if (_isEnabled.load(std::memory_order_relaxed) == _StoppedByMemoryLimit) {
+        _recordingPaused.store(true, std::memory_order_relaxed);
+    }
 }
 
 void
@@ -232,12 +436,19 @@ TraceCollector::_MeasureScopeOverhead()
 void
 TraceCollector::CreateCollection() {
     std::unique_ptr<TraceCollection> collection(new TraceCollection());
+    collection->SetClockCalibration(TraceClock::GetCalibration());
     for (_PerThreadData& i : _allPerThreadData) {
         TraceCollection::EventListPtr collData = i.GetCollectionData();
-        if (!collData->IsEmpty()) {
+        if (!collData->IsEmpty() || !collData->GetScopeTallies().empty() ||
+                collData->GetDroppedEventCount() != 0) {
             collection->AddToCollection(i.GetThreadId(), std::move(collData));
         }
     }
+    collection->SetOverflowCount(
+        _overflowCount.exchange(0, std::memory_order_relaxed));
+    collection->SetRecordingPaused(
+        _recordingPaused.exchange(false, std::memory_order_relaxed));
+    _ResumeBelowMemoryLimit();
 
     TraceCollectionAvailable notice(std::move(collection));
     notice.Send();
@@ -305,9 +516,12 @@ TraceCollector::SetPythonTracingEnabled(bool enabled)
 
 TraceCollector::_PerThreadData::_PerThreadData()
     : _writing()
+    , _samplerData(new Trace_SamplerThreadData)
 {
     _threadIndex = TraceGetThreadId();
-    _events = new EventList();
+    EventList* events = new EventList();
+    _memoryAccounts[0].Reset(events);
+    _events = events;
 }
 
 TraceCollector::_PerThreadData::~_PerThreadData()
@@ -315,11 +529,129 @@ TraceCollector::_PerThreadData::~_PerThreadData()
     delete _events.load(std::memory_order_acquire);
 }
 
+void
+TraceCollector::_PerThreadData::_MemoryAccount::Reset(EventList* events)
+{
+    _events = events;
+    _events->SetAllocationObserver(this);
+    _limitExceeded.store(false, std::memory_order_relaxed);
+    _Publish(_events->GetMemoryUsage());
+}
+
+void
+TraceCollector::_PerThreadData::_MemoryAccount::Release()
+{
+    _events->SetAllocationObserver(nullptr);
+    _events = nullptr;
+    _Publish(MemoryUsage());
+}
+
+TraceCollector::MemoryUsage
+TraceCollector::_PerThreadData::_MemoryAccount::GetUsage() const
+{
+    MemoryUsage usage;
+    usage.eventBytes = _eventBytes.load(std::memory_order_relaxed);
+    usage.keyBytes = _keyBytes.load(std::memory_order_relaxed);
+    usage.dataBytes = _dataBytes.load(std::memory_order_relaxed);
+    usage.spilledBytes = _spilledBytes.load(std::memory_order_relaxed);
+    return usage;
+}
+
+void
+TraceCollector::_PerThreadData::_MemoryAccount::_Publish(
+    const MemoryUsage& usage)
+{
+    const size_t previous = GetUsage().GetTotal();
+    _eventBytes.store(usage.eventBytes, std::memory_order_relaxed);
+    _keyBytes.store(usage.keyBytes, std::memory_order_relaxed);
+    _dataBytes.store(usage.dataBytes, std::memory_order_relaxed);
+    _spilledBytes.store(usage.spilledBytes, std::memory_order_relaxed);
+
+    // The difference wraps around when the usage decreases.
+    GetInstance()._memoryUsage.fetch_add(
+        usage.GetTotal() - previous, std::memory_order_relaxed);
+}
+
+void
+TraceCollector::_PerThreadData::_MemoryAccount::OnBlockAllocated()
+{
+    _Publish(_events->GetMemoryUsage());
+
+    TraceCollector& collector = GetInstance();
+    const size_t limit = collector._memoryLimit.load(std::memory_order_relaxed);
+    const size_t total = collector._memoryUsage.load(std::memory_order_relaxed);
+    if (limit == 0 || total <= limit) {
+        return;
+    }
+    collector._overflowCount.fetch_add(1, std::memory_order_relaxed);
+
+    // The list may be in the middle of storing an event, so the limit is
+    // enforced by the _WriteScope once it is stored.
+    _limitExceeded.store(true, std::memory_order_relaxed);
+}
+
+TraceEventContainer::SpillFilePtr
+TraceCollector::_PerThreadData::_MemoryAccount::EnforceLimit()
+{
+    if (!_limitExceeded.exchange(false, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    TraceCollector& collector = GetInstance();
+    const size_t limit = collector._memoryLimit.load(std::memory_order_relaxed);
+    const size_t total = collector._memoryUsage.load(std::memory_order_relaxed);
+    if (limit == 0 || total <= limit) {
+        return nullptr;
+    }
+
+    // Release enough events of this thread to bring the total back to the
+    // limit, if it holds that many.
+    const size_t excess = total - limit;
+    const size_t eventBytes = _eventBytes.load(std::memory_order_relaxed);
+    const size_t targetBytes = eventBytes > excess ? eventBytes - excess : 0;
+
+    TraceEventContainer::SpillFilePtr spillFile;
+    switch (collector.GetOverflowPolicy()) {
+    case OverflowPolicy::Stop:
+        collector._StopForMemoryLimit();
+        return nullptr;
+    case OverflowPolicy::Spill:
+        spillFile = _events->SpillOldestEvents(targetBytes);
+        if (spillFile) {
+            break;
+        }
+        [[fallthrough]];
+    case OverflowPolicy::DropOldest:
+        _events->DropOldestEvents(targetBytes);
+        break;
+    }
+    _Publish(_events->GetMemoryUsage());
+    return spillFile;
+}
+
+void
+TraceCollector::_PerThreadData::_EnforceMemoryLimit()
+{
+    const TraceEventContainer::SpillFilePtr spillFiles[] = {
+        _memoryAccounts[0].EnforceLimit(),
+        _memoryAccounts[1].EnforceLimit()
+    };
+    _writing.store(false, std::memory_order_release);
+
+    // The spilled blocks are written once the list may be swapped out, so
+    // that a collection only waits for the block being written.
+    for (const TraceEventContainer::SpillFilePtr& spillFile : spillFiles) {
+        if (spillFile) {
+            TraceEventContainer::WriteSpilledBlocks(spillFile);
+        }
+    }
+}
+
 TraceCollector::TimeStamp
 TraceCollector::_PerThreadData::BeginEvent(const Key& key, TraceCategoryId cat)
 {
     TfAutoMallocTag2 tag("Trace", "TraceCollector::_PerThreadData::BeginEvent");
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     EventList* events = _events.load(std::memory_order_acquire);
     const TraceEvent& event = 
         events->EmplaceBack(TraceEvent::Begin, events->CacheKey(key), cat);
@@ -330,7 +662,7 @@ TraceCollector::TimeStamp
 TraceCollector::_PerThreadData::EndEvent(const Key& key, TraceCategoryId cat)
 {
     TfAutoMallocTag2 tag("Trace", "TraceCollector::_PerThreadData::EndEvent");
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     EventList* events = _events.load(std::memory_order_acquire);
     const TraceEvent& event =
         events->EmplaceBack(TraceEvent::End, events->CacheKey(key), cat);
@@ -341,7 +673,7 @@ TraceCollector::TimeStamp
 TraceCollector::_PerThreadData::MarkerEvent(const Key& key, TraceCategoryId cat)
 {
     TfAutoMallocTag2 tag("Trace", "TraceCollector::_PerThreadData::MarkerEvent");
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     EventList* events = _events.load(std::memory_order_acquire);
     const TraceEvent& event =
         events->EmplaceBack(TraceEvent::Marker, events->CacheKey(key), cat);
@@ -352,7 +684,7 @@ void
 TraceCollector::_PerThreadData::BeginEventAtTime(
     const Key& key, double ms, TraceCategoryId cat)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     TfAutoMallocTag2 tag("Trace", 
         "TraceCollector::_PerThreadData::BeginEventAtTime");
     const TimeStamp ts = 
@@ -365,7 +697,7 @@ void
 TraceCollector::_PerThreadData::EndEventAtTime(
     const Key& key, double ms, TraceCategoryId cat)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     TfAutoMallocTag2 tag("Trace", 
         "TraceCollector::_PerThreadData::EndEventAtTime");
     const TimeStamp ts = 
@@ -378,7 +710,7 @@ void
 TraceCollector::_PerThreadData::MarkerEventAtTime(
     const Key& key, double ms, TraceCategoryId cat)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     TfAutoMallocTag2 tag("Trace", 
         "TraceCollector::_PerThreadData::MarkerEventAtTime");
     const TimeStamp ts = 
@@ -398,20 +730,110 @@ void
 TraceCollector::_PerThreadData::CounterDelta(
     const Key& key, double value, TraceCategoryId cat)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     EventList* events = _events.load(std::memory_order_acquire);
-    events->EmplaceBack(
-        TraceEvent::CounterDelta, events->CacheKey(key), value, cat);
+    _CounterDelta(events, events->CacheKey(key), value, cat);
 }
 
 void
 TraceCollector::_PerThreadData::CounterValue(
     const Key& key, double value, TraceCategoryId cat)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
+    EventList* events = _events.load(std::memory_order_acquire);
+    _CounterValue(events, events->CacheKey(key), value, cat);
+}
+
+void
+TraceCollector::_PerThreadData::RecordScope(const Key& key,
+    TimeStamp start, TimeStamp stop, TraceCategoryId cat)
+{
+    _WriteScope lock(*this);
     EventList* events = _events.load(std::memory_order_acquire);
-    events->EmplaceBack(
-        TraceEvent::CounterValue, events->CacheKey(key), value, cat);
+    _RecordScope(events, events->CacheKey(key), start, stop, cat);
+}
+
+void
+TraceCollector::_PerThreadData::_UpdateMinimumScopeDurations()
+{
+    TraceCollector& collector = TraceCollector::GetInstance();
+    std::lock_guard<std::mutex> lock(collector._minScopeDurationsMutex);
+    _minScopeDurations = collector._minScopeDurations;
+}
+
+void
+TraceCollector::_PerThreadData::MergeScopeStats(ScopeStatsMap* stats)
+{
+    // Copy the statistics so the recording thread is not blocked while the
+    // keys are converted to tokens.
+    std::vector<std::pair<const TraceStaticKeyData*, TraceScopeStats>> copy;
+    {
+        tbb::spin_mutex::scoped_lock lock(_scopeStatsMutex);
+        if (_scopeStatsCleared.load(std::memory_order_relaxed) !=
+                _scopeStatsVersion.load(std::memory_order_relaxed)) {
+            return;
+        }
+        for (const auto& entry : _scopeStats) {
+            TraceScopeStats scopeStats = entry.second.Get();
+            if (scopeStats.GetCount() > 0) {
+                copy.emplace_back(entry.first, scopeStats);
+            }
+        }
+    }
+    for (const auto& entry : copy) {
+        (*stats)[TfToken(entry.first->GetString())].Merge(entry.second);
+    }
+}
+
+TraceCollector::_PerThreadData::_ScopeStatsSlot*
+TraceCollector::_PerThreadData::_GetScopeStatsSlot(
+    const TraceStaticKeyData* key)
+{
+    // Only this thread modifies the map, so it is searched without the
+    // mutex.
+    const auto it = _scopeStats.find(key);
+    if (it != _scopeStats.end()) {
+        return &it->second;
+    }
+    tbb::spin_mutex::scoped_lock lock(_scopeStatsMutex);
+    return &_scopeStats[key];
+}
+
+void
+TraceCollector::_PerThreadData::_ResetScopeStats(uint64_t version)
+{
+    tbb::spin_mutex::scoped_lock lock(_scopeStatsMutex);
+    for (auto& entry : _scopeStats) {
+        entry.second.Reset();
+    }
+    _scopeStatsCleared.store(version, std::memory_order_relaxed);
+}
+
+void
+TraceCollector::_PerThreadData::_ScopeStatsSlot::Reset()
+{
+    _count.store(0, std::memory_order_relaxed);
+    _total.store(0, std::memory_order_relaxed);
+    _min.store(std::numeric_limits<uint64_t>::max(),
+        std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint64_t>& bucket : _histogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+TraceScopeStats
+TraceCollector::_PerThreadData::_ScopeStatsSlot::Get() const
+{
+    TraceScopeStats stats;
+    stats._count = _count.load(std::memory_order_relaxed);
+    stats._total = _total.load(std::memory_order_relaxed);
+    stats._min = _min.load(std::memory_order_relaxed);
+    stats._max = _max.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < _histogram.size(); ++i) {
+        stats._histogram[i] = _histogram[i].load(std::memory_order_relaxed);
+    }
+    return stats;
 }
 
 #ifdef PXR_PYTHON_SUPPORT_ENABLED
@@ -420,7 +842,7 @@ void
 TraceCollector::_PerThreadData::PushPyScope(
     const Key& key, bool enabled)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     if (enabled) {
         EventList* events = _events.load(std::memory_order_acquire);
         TraceKey stableKey = events->CacheKey(key);
@@ -432,7 +854,7 @@ TraceCollector::_PerThreadData::PushPyScope(
 void
 TraceCollector::_PerThreadData::PopPyScope(bool enabled)
 {
-    AtomicRef lock(_writing);
+    _WriteScope lock(*this);
     if (!_pyScopes.empty()) {
         if (enabled) {
             const PyScope& scope = _pyScopes.back();
@@ -448,9 +870,27 @@ TraceCollector::_PerThreadData::PopPyScope(bool enabled)
 
 std::unique_ptr<TraceCollection::EventList>
 TraceCollector::_PerThreadData::GetCollectionData() {
+    std::unique_ptr<EventList> prevList = _SwapEventList();
+    prevList->LoadSpilledEvents();
+    return prevList;
+}
+
+void
+TraceCollector::_PerThreadData::Clear() {
+    // Swap out the data and let the event list be cleaned up.
+    _SwapEventList();
+}
+
+std::unique_ptr<TraceCollection::EventList>
+TraceCollector::_PerThreadData::_SwapEventList() {
+    std::lock_guard<std::mutex> lock(_swapMutex);
 
     // Create a new event list and atomically swap it with the current list.
+    // The new list is accounted for by the other account.
+    const int account = _memoryAccount.load(std::memory_order_relaxed);
     EventList* newEventList = new EventList();
+    _memoryAccounts[1 - account].Reset(newEventList);
+    _memoryAccount.store(1 - account, std::memory_order_release);
 
     std::unique_ptr<EventList> prevList(_events.exchange(newEventList));
 
@@ -458,14 +898,18 @@ TraceCollector::_PerThreadData::GetCollectionData() {
     // potentially writing to prevList.
     while (_writing.load(std::memory_order_acquire)) {}
 
+    _memoryAccounts[account].Release();
+
+    // Events written with non-temporal stores are not ordered by the
+    // release of _writing.
+    TraceEventContainer::FenceNonTemporalStores();
+
+    // Samples are not ordered with the other events, since they are taken
+    // by the sampler.
+    _samplerData->MoveSamples(prevList.get());
+
     // Now it should be ok to release the list to the outside.
     return prevList;
 }
 
-void
-TraceCollector::_PerThreadData::Clear() {
-    // Swap out the data and let the event list be cleaned up.
-    GetCollectionData();
-}
-
 TRACE_NAMESPACE_CLOSE_SCOPE
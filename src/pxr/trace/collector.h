@@ -10,11 +10,14 @@
 
 #include "pxr/trace/pxr.h"
 
+#include "pxr/trace/allocationObserver.h"
 #include "pxr/trace/api.h"
+#include "pxr/trace/category.h"
 #include "pxr/trace/concurrentList.h"
 #include "pxr/trace/collection.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/key.h"
+#include "pxr/trace/scopeStats.h"
 #include "pxr/trace/threads.h"
 
 #include <pxr/tf/declarePtrs.h>
@@ -25,13 +28,20 @@
 #include <pxr/tf/singleton.h>
 #include <pxr/tf/refBase.h>
 #include <pxr/tf/refPtr.h>
+#include <pxr/tf/token.h>
 #include <pxr/tf/weakBase.h>
 #include <pxr/tf/weakPtr.h>
 
 #include <pxr/arch/pragmas.h>
 
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <tbb/spin_mutex.h>
@@ -39,6 +49,8 @@
 TRACE_NAMESPACE_OPEN_SCOPE
 
 class TraceScopeHolder;
+class Trace_Sampler;
+class Trace_SamplerThreadData;
  
 TF_DECLARE_WEAK_PTRS(TraceCollector);
 TF_DECLARE_WEAK_AND_REF_PTRS(TraceScope);
@@ -78,6 +90,167 @@ public:
         return (_isEnabled.load(std::memory_order_acquire) == 1);
     }
 
+    /// Enables or disables metrics-only recording.
+    ///
+    /// In this mode, the scopes recorded by the TRACE_FUNCTION, TRACE_SCOPE
+    /// and TRACE_FUNCTION_SCOPE macros and by Scope() do not produce events,
+    /// and the arguments passed to TraceScopeAuto are not stored. Instead,
+    /// each thread accumulates TraceScopeStats for each call site, so the
+    /// memory used depends on the number of call sites rather than the
+    /// number of scopes executed. The statistics are returned by
+    /// GetScopeStats().
+    ///
+    /// The statistics are only accumulated while collection is enabled by
+    /// SetEnabled(). Every other event is still stored in the event list of
+    /// its thread until a collection is created: the begin and end events
+    /// of BeginEvent(), BeginScope(), TraceAuto and the _DYNAMIC macros,
+    /// the scopes of ScopeEvent() and of Trace.TraceScope and
+    /// Trace.TraceFunction in Python, markers, counters, data stored by
+    /// StoreData(), the scopes of Python tracing and the samples of the
+    /// sampler. Their memory is only bounded by SetMemoryLimit().
+    TRACE_API void SetMetricsOnly(bool isMetricsOnly);
+
+    /// Returns whether metrics-only recording is enabled.
+    static bool IsMetricsOnly() {
+        return (_isMetricsOnly.load(std::memory_order_acquire) == 1);
+    }
+
+    /// Statistics of the scopes, keyed by name.
+    using ScopeStatsMap =
+        std::unordered_map<TfToken, TraceScopeStats, TfToken::HashFunctor>;
+
+    /// Returns the statistics of the scopes recorded in metrics-only mode,
+    /// merged across threads. This can be called while recording.
+    TRACE_API ScopeStatsMap GetScopeStats();
+
+    /// Resets the statistics of the scopes recorded in metrics-only mode.
+    TRACE_API void ClearScopeStats();
+
+    /// Sets the minimum \p duration, in ticks, of the scopes recorded by the
+    /// TRACE_FUNCTION, TRACE_SCOPE and TRACE_FUNCTION_SCOPE macros.
+    ///
+    /// Shorter scopes are not stored as events. Instead, their number and
+    /// total duration are tallied per thread and key, and returned by
+    /// TraceCollection::GetScopeTallies(), so the total time of each key in
+    /// the TraceAggregateTree remains accurate. A duration of 0, the
+    /// default, records every scope.
+    TRACE_API void SetMinimumScopeDuration(TimeStamp duration);
+
+    /// Sets the minimum \p duration of the scopes of category \p id,
+    /// overriding the duration set for all categories.
+    TRACE_API void SetMinimumScopeDuration(
+        TraceCategoryId id, TimeStamp duration);
+
+    /// Removes the minimum scope duration of category \p id, which then
+    /// uses the duration set for all categories.
+    TRACE_API void ResetMinimumScopeDuration(TraceCategoryId id);
+
+    /// Returns the minimum duration of the scopes of category \p id.
+    TRACE_API TimeStamp GetMinimumScopeDuration(
+        TraceCategoryId id = TraceCategory::Default) const;
+
+    /// Sets the \p quantum, in ticks, over which counter deltas are
+    /// coalesced.
+    ///
+    /// When it is not 0, the deltas recorded by a thread for a counter
+    /// during \p quantum ticks are summed into a single CounterDelta event
+    /// timestamped at the first of them, which reduces the cost of counters
+    /// updated at a high frequency. A quantum of 0, the default, records
+    /// every delta.
+    TRACE_API void SetCounterDeltaQuantum(TimeStamp quantum);
+
+    /// Returns the quantum over which counter deltas are coalesced.
+    static TimeStamp GetCounterDeltaQuantum() {
+        return _counterDeltaQuantum.load(std::memory_order_relaxed);
+    }
+
+    /// \name Sampling
+    /// @{
+
+    /// Enables or disables the sampling profiler.
+    ///
+    /// While it is enabled, each thread which has recorded an event is
+    /// interrupted every sampling interval of CPU time it uses, and the
+    /// native stack it was interrupted in is stored as a Sample event while
+    /// collection is enabled. The TraceAggregateTree attributes the samples
+    /// to the scopes which enclose them, and symbolizes their stacks.
+    ///
+    /// Sampling uses SIGPROF and is only available on Linux. Elsewhere,
+    /// enabling it issues an error.
+    TRACE_API void SetSamplingEnabled(bool isEnabled);
+
+    /// Returns whether the sampling profiler is enabled.
+    TRACE_API bool IsSamplingEnabled() const;
+
+    /// Sets the \p interval, in ticks of the CPU time of each thread,
+    /// between samples. The default is 1 millisecond. The timers of threads
+    /// fire on the scheduler ticks of the kernel, so shorter intervals than
+    /// a tick take one sample per tick.
+    TRACE_API void SetSamplingInterval(TimeStamp interval);
+
+    /// Returns the interval between samples.
+    TRACE_API TimeStamp GetSamplingInterval() const;
+
+    /// @}
+
+    /// \name Memory
+    /// The memory held by the events of each thread which were not collected
+    /// yet, with the keys and the data they refer to, is accounted for each
+    /// time the thread allocates a block of events or data. A limit can be
+    /// set on the memory of all the threads, which is enforced by the thread
+    /// whose allocation exceeded it.
+    /// @{
+
+    using MemoryUsage = TraceEventList::MemoryUsage;
+
+    /// Returns the memory held by the events which were not collected yet,
+    /// summed across threads.
+    TRACE_API MemoryUsage GetMemoryUsage();
+
+    /// Returns the memory held by the events of each thread which were not
+    /// collected yet.
+    TRACE_API std::vector<std::pair<TraceThreadId, MemoryUsage>>
+    GetMemoryUsagePerThread();
+
+    /// What to do when the memory limit is exceeded.
+    enum class OverflowPolicy {
+        /// Stop recording until a collection is created or the collector is
+        /// cleared, and the memory is back below the limit. IsEnabled()
+        /// returns false meanwhile, so the events which are not recorded
+        /// are not counted.
+        Stop,
+        /// Drop the oldest events of the thread which exceeded the limit.
+        DropOldest,
+        /// Write the oldest events of the thread which exceeded the limit to
+        /// a temporary file, from which they are read back when a collection
+        /// is created. Events are dropped if the file cannot be written.
+        Spill
+    };
+
+    /// Sets the maximum number of \p bytes held by the events which were not
+    /// collected, and the \p policy applied when it is exceeded. A limit of
+    /// 0, the default, disables it.
+    ///
+    /// The policy is applied once the event which allocated a block above
+    /// the limit is stored. Only blocks of events are released by the
+    /// policies, and each thread keeps the block it writes to, whose size is
+    /// reduced to fit in the limit, so the memory held may remain above a
+    /// limit that is too low for the number of threads. Spilled blocks are
+    /// written by the thread which recorded them after the event is stored,
+    /// so creating a collection waits for at most one block to be written.
+    /// The number of allocations which exceeded the limit and the number of
+    /// events dropped are reported by the next TraceCollection.
+    TRACE_API void SetMemoryLimit(
+        size_t bytes, OverflowPolicy policy = OverflowPolicy::Stop);
+
+    /// Returns the memory limit, or 0 if there is none.
+    TRACE_API size_t GetMemoryLimit() const;
+
+    /// Returns the policy applied when the memory limit is exceeded.
+    TRACE_API OverflowPolicy GetOverflowPolicy() const;
+
+    /// @}
+
     /// Default Trace category which corresponds to events stored for TRACE_
     /// macros.
     struct DefaultCategory {
@@ -191,6 +364,21 @@ public:
       _MarkerEventAtTime(key, ms, Category::GetId());
     }
 
+    /// Record a scope event with \a key that started at \a start and
+    /// stopped at \a stop if \p Category is enabled.
+    ///
+    /// Like BeginEvent(), the key is cached by the event list of the thread,
+    /// so it does not need to outlive the event. Unlike Scope(), the scope
+    /// is stored as an event in metrics-only mode.
+    /// \sa Scope
+    template <typename Category = DefaultCategory>
+    void ScopeEvent(const Key& key, TimeStamp start, TimeStamp stop) {
+        if (ARCH_LIKELY(!Category::IsEnabled())) {
+            return;
+        }
+        _ScopeEvent(key, start, stop, Category::GetId());
+    }
+
     /// Record a begin event for a scope described by \a key if \p Category is
     /// enabled.
     /// It is more efficient to use the \c Scope method than to call both
@@ -271,8 +459,11 @@ public:
         if (ARCH_LIKELY(!Category::IsEnabled()))
             return;
         _PerThreadData *threadData = _GetThreadData();
-        threadData->EmplaceEvent(
-            TraceEvent::Timespan, key, start, stop, Category::GetId());
+        if (ARCH_UNLIKELY(IsMetricsOnly())) {
+            threadData->RecordScopeStats(key, stop - start);
+            return;
+        }
+        threadData->RecordScope(key, start, stop, Category::GetId());
     }
     
     /// Record multiple data events with category \a cat if \p Category is 
@@ -339,8 +530,7 @@ public:
         // Only record counter values if the collector is enabled.
         if (ARCH_UNLIKELY(Category::IsEnabled())) {
             _PerThreadData *threadData = _GetThreadData();
-            threadData->EmplaceEvent(
-                TraceEvent::CounterDelta, key, delta, Category::GetId());
+            threadData->CounterDelta(key, delta, Category::GetId());
         }
     }
 
@@ -359,8 +549,7 @@ public:
         // Only record counter values if the collector is enabled.
         if (ARCH_UNLIKELY(Category::IsEnabled())) {
             _PerThreadData *threadData = _GetThreadData();
-            threadData->EmplaceEvent(
-                TraceEvent::CounterValue, key, value, Category::GetId());
+            threadData->CounterValue(key, value, Category::GetId());
         }
     }
 
@@ -394,8 +583,30 @@ private:
 
     friend class TfSingleton<TraceCollector>;
 
+    // The sampler visits the data of each thread.
+    friend class Trace_Sampler;
+
     class _PerThreadData;
 
+    // The value of _isEnabled while recording is stopped by the memory
+    // limit, which IsEnabled() reads as disabled.
+    static constexpr int _StoppedByMemoryLimit = 3;
+
+    // Stops recording if it is enabled.
+    void _StopForMemoryLimit();
+
+    // Resumes recording if it was stopped by the memory limit and the
+    // memory is back below it.
+    void _ResumeBelowMemoryLimit();
+
+    // The minimum scope durations. Threads keep their own copy so the
+    // durations can be read without locking.
+    struct _MinScopeDurations {
+        uint64_t version = 0;
+        TimeStamp duration = 0;
+        std::unordered_map<TraceCategoryId, TimeStamp> categories;
+    };
+
     // Return a pointer to existing per-thread data or create one if none
     // exists.
     TRACE_API _PerThreadData* _GetThreadData() noexcept;
@@ -415,6 +626,9 @@ private:
     TRACE_API void _MarkerEventAtTime(
         const Key& key, double ms, TraceCategoryId cat);
 
+    TRACE_API void _ScopeEvent(const Key& key,
+        TimeStamp start, TimeStamp stop, TraceCategoryId cat);
+
     // This is the fast execution path called from the TRACE_FUNCTION
     // and TRACE_SCOPE macros
     void _BeginScope(const TraceKey& key, TraceCategoryId cat)
@@ -509,25 +723,39 @@ private:
             void MarkerEventAtTime(const Key& key, double ms, TraceCategoryId cat);
 
             void BeginScope(const TraceKey& key, TraceCategoryId cat) {
-                AtomicRef lock(_writing);
+                _WriteScope lock(*this);
                 _BeginScope(key, cat);
             }
 
             void EndScope(const TraceKey& key, TraceCategoryId cat) {
-                AtomicRef lock(_writing);
+                _WriteScope lock(*this);
                 _EndScope(key, cat);
             }
 
             TRACE_API void CounterDelta(
                 const Key&, double value, TraceCategoryId cat);
 
+            void CounterDelta(
+                const TraceKey& key, double value, TraceCategoryId cat) {
+                _WriteScope lock(*this);
+                _CounterDelta(_events.load(std::memory_order_acquire),
+                    key, value, cat);
+            }
+
             TRACE_API void CounterValue(
                 const Key&, double value, TraceCategoryId cat);
 
+            void CounterValue(
+                const TraceKey& key, double value, TraceCategoryId cat) {
+                _WriteScope lock(*this);
+                _CounterValue(_events.load(std::memory_order_acquire),
+                    key, value, cat);
+            }
+
             template <typename T>
             void StoreData(
                 const TraceKey& key, const T& data, TraceCategoryId cat) {
-                AtomicRef lock(_writing);
+                _WriteScope lock(*this);
                 _events.load(std::memory_order_acquire)->EmplaceBack(
                     TraceEvent::Data, key, data, cat);
             }
@@ -535,7 +763,7 @@ private:
             template <typename T>
             void StoreLargeData(
                 const TraceKey& key, const T& data, TraceCategoryId cat) {
-                AtomicRef lock(_writing);
+                _WriteScope lock(*this);
                 EventList* events = _events.load(std::memory_order_acquire);
                 const auto* cached = events->StoreData(data);
                 events->EmplaceBack(TraceEvent::Data, key, cached, cat);
@@ -543,22 +771,67 @@ private:
 
             template <typename... Args>
             void EmplaceEvent(Args&&... args) {
-                AtomicRef lock(_writing);
+                _WriteScope lock(*this);
                 _events.load(std::memory_order_acquire)->EmplaceBack(
                     std::forward<Args>(args)...);
             }
 
+            // Stores a Timespan event, or tallies the scope if it is shorter
+            // than the minimum scope duration of \p cat.
+            void RecordScope(const TraceKey& key,
+                TimeStamp start, TimeStamp stop, TraceCategoryId cat) {
+                _WriteScope lock(*this);
+                _RecordScope(_events.load(std::memory_order_acquire),
+                    key, start, stop, cat);
+            }
+
+            void RecordScope(const Key& key,
+                TimeStamp start, TimeStamp stop, TraceCategoryId cat);
+
+            void RecordScopeStats(const TraceKey& key, TimeStamp duration) {
+                const uint64_t version =
+                    _scopeStatsVersion.load(std::memory_order_relaxed);
+                if (ARCH_UNLIKELY(version != _scopeStatsCleared.load(
+                        std::memory_order_relaxed))) {
+                    _ResetScopeStats(version);
+                }
+                _ScopeStatsCacheEntry& entry = _scopeStatsCache[
+                    (uintptr_t(key._ptr) / sizeof(TraceStaticKeyData)) %
+                    _scopeStatsCache.size()];
+                if (ARCH_UNLIKELY(entry.key != key._ptr)) {
+                    entry.key = key._ptr;
+                    entry.slot = _GetScopeStatsSlot(key._ptr);
+                }
+                entry.slot->Record(duration);
+            }
+
+            // Merges the scope statistics of this thread into \p stats.
+            void MergeScopeStats(ScopeStatsMap* stats);
+
 #ifdef PXR_PYTHON_SUPPORT_ENABLED
             void PushPyScope(const Key& key, bool enabled);
             void PopPyScope(bool enabled);
 #endif // PXR_PYTHON_SUPPORT_ENABLED
 
+            Trace_SamplerThreadData& GetSamplerData() {
+                return *_samplerData;
+            }
+
+            MemoryUsage GetMemoryUsage() const {
+                return _memoryAccounts[
+                    _memoryAccount.load(std::memory_order_acquire)].GetUsage();
+            }
+
             // These methods can be called from threads at the same time as the 
             // other methods.
             std::unique_ptr<EventList> GetCollectionData();
             void Clear();
 
         private:
+            // Swaps the event list with a new one and returns the previous
+            // list, whose spilled events are not read back.
+            std::unique_ptr<EventList> _SwapEventList();
+
             void _BeginScope(const TraceKey& key, TraceCategoryId cat) {
                 _events.load(std::memory_order_acquire)->EmplaceBack(
                     TraceEvent::Begin, key, cat);
@@ -566,22 +839,77 @@ private:
 
             void _EndScope(const TraceKey& key, TraceCategoryId cat);
 
+            void _RecordScope(EventList* events, const TraceKey& key,
+                TimeStamp start, TimeStamp stop, TraceCategoryId cat) {
+                if (ARCH_UNLIKELY(
+                        stop - start < _GetMinimumScopeDuration(cat))) {
+                    events->TallyScope(key, stop - start);
+                    return;
+                }
+                events->EmplaceBack(
+                    TraceEvent::Timespan, key, start, stop, cat);
+            }
+
+            static void _CounterDelta(EventList* events,
+                const TraceKey& key, double value, TraceCategoryId cat) {
+                const TimeStamp quantum = GetCounterDeltaQuantum();
+                if (ARCH_UNLIKELY(quantum != 0)) {
+                    events->CoalesceCounterDelta(key, value, cat, quantum);
+                    return;
+                }
+                events->EmplaceBack(TraceEvent::CounterDelta, key, value, cat);
+            }
+
+            static void _CounterValue(EventList* events,
+                const TraceKey& key, double value, TraceCategoryId cat) {
+                events->ResetCounterDeltas();
+                events->EmplaceBack(TraceEvent::CounterValue, key, value, cat);
+            }
+
+            TimeStamp _GetMinimumScopeDuration(TraceCategoryId cat) {
+                const uint64_t version =
+                    _minScopeDurationVersion.load(std::memory_order_acquire);
+                if (ARCH_UNLIKELY(version != _minScopeDurations.version)) {
+                    _UpdateMinimumScopeDurations();
+                }
+                if (ARCH_LIKELY(_minScopeDurations.categories.empty())) {
+                    return _minScopeDurations.duration;
+                }
+                const auto it = _minScopeDurations.categories.find(cat);
+                return it != _minScopeDurations.categories.end()
+                    ? it->second : _minScopeDurations.duration;
+            }
+
+            void _UpdateMinimumScopeDurations();
+
             // Flag to let other threads know that the list is being written to.
             mutable std::atomic<bool> _writing;
             std::atomic<EventList*> _events;
 
-            class AtomicRef {
+            // Flags the list as being written to, and enforces the memory
+            // limit once the event is stored.
+            class _WriteScope {
             public:
-                AtomicRef(std::atomic<bool>& b) : _bool(b) {
-                    _bool.store(true, std::memory_order_release);
+                _WriteScope(_PerThreadData& data) : _data(data) {
+                    _data._writing.store(true, std::memory_order_release);
                 }
-                ~AtomicRef() {
-                    _bool.store(false, std::memory_order_release);
+                ~_WriteScope() {
+                    if (ARCH_UNLIKELY(
+                            _data._memoryAccounts[0].IsLimitExceeded() ||
+                            _data._memoryAccounts[1].IsLimitExceeded())) {
+                        _data._EnforceMemoryLimit();
+                        return;
+                    }
+                    _data._writing.store(false, std::memory_order_release);
                 }
             private:
-                std::atomic<bool>& _bool;
+                _PerThreadData& _data;
             };
 
+            // Releases the events of the lists which exceeded the memory
+            // limit, and clears the _writing flag.
+            TRACE_API void _EnforceMemoryLimit();
+
             // An integer that is unique for each thread launched by any
             // threadDispatcher.  Each time a thread is Start-ed it get's
             // a new id.
@@ -593,13 +921,158 @@ private:
                 Key key;
             };
             std::vector<PyScope> _pyScopes;
+
+            // The statistics of the scopes of a call site recorded in
+            // metrics-only mode. They are only written by the thread which
+            // records them, without read-modify-write operations, and may be
+            // read by any thread, which may see the fields of a scope
+            // recorded concurrently partially updated.
+            class _ScopeStatsSlot {
+            public:
+                _ScopeStatsSlot() { Reset(); }
+
+                void Record(TimeStamp duration) {
+                    _Add(_count, 1);
+                    _Add(_total, duration);
+                    if (duration < _min.load(std::memory_order_relaxed)) {
+                        _min.store(duration, std::memory_order_relaxed);
+                    }
+                    if (duration > _max.load(std::memory_order_relaxed)) {
+                        _max.store(duration, std::memory_order_relaxed);
+                    }
+                    _Add(_histogram[TraceScopeStats::GetBucket(duration)], 1);
+                }
+
+                void Reset();
+                TraceScopeStats Get() const;
+
+            private:
+                static void _Add(std::atomic<uint64_t>& value, uint64_t n) {
+                    value.store(value.load(std::memory_order_relaxed) + n,
+                        std::memory_order_relaxed);
+                }
+
+                std::atomic<uint64_t> _count;
+                std::atomic<uint64_t> _total;
+                std::atomic<uint64_t> _min;
+                std::atomic<uint64_t> _max;
+                std::array<std::atomic<uint64_t>, TraceScopeStats::NumBuckets>
+                    _histogram;
+            };
+
+            // Returns the statistics of the call site of \p key, which are
+            // created the first time.
+            TRACE_API _ScopeStatsSlot* _GetScopeStatsSlot(
+                const TraceStaticKeyData* key);
+
+            // Resets the statistics cleared by ClearScopeStats().
+            TRACE_API void _ResetScopeStats(uint64_t version);
+
+            // The statistics of each call site. The map is only modified by
+            // the thread which records the scopes, with the mutex held, and
+            // its nodes are never erased.
+            tbb::spin_mutex _scopeStatsMutex;
+            std::unordered_map<const TraceStaticKeyData*, _ScopeStatsSlot>
+                _scopeStats;
+
+            // The version of ClearScopeStats() when the statistics were last
+            // reset. Statistics of an older version are not merged.
+            std::atomic<uint64_t> _scopeStatsCleared{0};
+
+            // The statistics of the call sites recorded last, indexed by
+            // key address, so that most scopes find them without a lookup.
+            struct _ScopeStatsCacheEntry {
+                const TraceStaticKeyData* key = nullptr;
+                _ScopeStatsSlot* slot = nullptr;
+            };
+            std::array<_ScopeStatsCacheEntry, 64> _scopeStatsCache;
+
+            // A copy of the minimum scope durations of the collector, updated
+            // when their version changes.
+            _MinScopeDurations _minScopeDurations;
+
+            // Samples of the stack of this thread taken by the sampler.
+            std::unique_ptr<Trace_SamplerThreadData> _samplerData;
+
+            // Accounts for the memory of an event list, and flags it when it
+            // allocates a block above the memory limit. The limit is
+            // enforced once the event is stored rather than while the block
+            // is allocated. The usage is only written by the thread writing
+            // to the list, or after it was swapped out, and may be read by
+            // any thread.
+            class _MemoryAccount : public TraceAllocationObserver {
+            public:
+                // Starts accounting for events, which must not be written
+                // to yet.
+                void Reset(EventList* events);
+
+                // Removes the memory of the list from the total of the
+                // collector, once it is no longer written to.
+                void Release();
+
+                MemoryUsage GetUsage() const;
+
+                void OnBlockAllocated() override;
+
+                bool IsLimitExceeded() const {
+                    return _limitExceeded.load(std::memory_order_relaxed);
+                }
+
+                // Releases events of the list if it exceeded the limit.
+                // Returns the spill file whose blocks must be written once
+                // the list is no longer flagged as being written to.
+                TraceEventContainer::SpillFilePtr EnforceLimit();
+
+            private:
+                void _Publish(const MemoryUsage& usage);
+
+                EventList* _events = nullptr;
+                std::atomic<bool> _limitExceeded{false};
+                std::atomic<size_t> _eventBytes{0};
+                std::atomic<size_t> _keyBytes{0};
+                std::atomic<size_t> _dataBytes{0};
+                std::atomic<size_t> _spilledBytes{0};
+            };
+
+            // The accounts of the current list and of the previous one,
+            // which may still be written to while it is swapped out.
+            _MemoryAccount _memoryAccounts[2];
+            std::atomic<int> _memoryAccount{0};
+
+            // Serializes the swaps of the event list.
+            std::mutex _swapMutex;
     };
 
     TRACE_API static std::atomic<int> _isEnabled;
+    TRACE_API static std::atomic<int> _isMetricsOnly;
+    TRACE_API static std::atomic<TimeStamp> _counterDeltaQuantum;
+
+    // The memory limit and its policy, the memory held by the events of all
+    // the threads, the number of allocations which exceeded the limit and
+    // whether recording was stopped by it since the last collection.
+    std::atomic<size_t> _memoryLimit{0};
+    std::atomic<int> _overflowPolicy{int(OverflowPolicy::Stop)};
+    std::atomic<size_t> _memoryUsage{0};
+    std::atomic<uint64_t> _overflowCount{0};
+    std::atomic<bool> _recordingPaused{false};
+
+    // Incremented when the minimum scope durations change.
+    TRACE_API static std::atomic<uint64_t> _minScopeDurationVersion;
+
+    // Incremented by ClearScopeStats(). Each thread resets its statistics
+    // when it next records a scope.
+    TRACE_API static std::atomic<uint64_t> _scopeStatsVersion;
+    mutable std::mutex _minScopeDurationsMutex;
+    _MinScopeDurations _minScopeDurations;
 
     // A list with one _PerThreadData per thread.
     TraceConcurrentList<_PerThreadData> _allPerThreadData;
 
+    // The sampler, which exists while sampling is enabled.
+    mutable std::mutex _samplerMutex;
+    std::unique_ptr<Trace_Sampler> _sampler;
+    TimeStamp _samplingInterval;
+
     std::string _label;
 
     TimeStamp _measuredScopeOverhead;
@@ -9,37 +9,58 @@
 
 #include "pxr/trace/pxr.h"
 
+#include <pxr/tf/diagnostic.h>
+
+#include <algorithm>
+
 TRACE_NAMESPACE_OPEN_SCOPE
 
 void
 TraceCounterAccumulator::Update(const TraceCollection& col)
 {
-    col.Iterate(*this);
+    col.IterateBatches(*this);
 }
 
 void
 TraceCounterAccumulator::OnBeginCollection()
 {
+    _counterDeltasById.clear();
 }
 
 void
 TraceCounterAccumulator::OnEndCollection()
 {
     // Convert the counter deltas and values to absolute values;
-    for (const _CounterDeltaMap::value_type& c : _counterDeltas) {
-        double curValue = _currentValues[c.first];
-        
-        for (const _CounterDeltaValues::value_type& v : c.second) {
-            if (v.second.isDelta) {
-                curValue += v.second.value;
+    for (_CounterDeltaMap::value_type& c : _counterDeltas) {
+        _CounterDeltaValues& values = c.second;
+        if (values.empty()) {
+            continue;
+        }
+
+        // Events of a thread are mostly ordered already. The sort is stable
+        // so that values with the same time keep the order of the events.
+        const auto byTime =
+            [](const _CounterValue& a, const _CounterValue& b) {
+                return a.time < b.time;
+            };
+        if (!std::is_sorted(values.begin(), values.end(), byTime)) {
+            std::stable_sort(values.begin(), values.end(), byTime);
+        }
+
+        double& curValue = _currentValues[c.first];
+        CounterValues& overTime = _counterValuesOverTime[c.first];
+        overTime.reserve(overTime.size() + values.size());
+        for (const _CounterValue& v : values) {
+            if (v.isDelta) {
+                curValue += v.value;
             } else {
-                curValue = v.second.value;
+                curValue = v.value;
             }
-            _counterValuesOverTime[c.first].emplace_back(v.first, curValue);
+            overTime.emplace_back(v.time, curValue);
         }
-        _currentValues[c.first] = curValue;
+        values.clear();
     }
-    _counterDeltas.clear();
+    _counterDeltasById.clear();
 }
 
 void
@@ -54,33 +75,40 @@ TraceCounterAccumulator::OnEndThread(const TraceThreadId&)
 }
 
 void
-TraceCounterAccumulator::OnEvent(
-    const TraceThreadId&, const TfToken& key, const TraceEvent& e)
+TraceCounterAccumulator::OnEvents(
+    const TraceThreadId&, const TraceCollection::EventSpan& events)
 {
-    switch (e.GetType()) {
-        case TraceEvent::EventType::CounterDelta:
-        {
-            _counterDeltas[key].insert(
-                std::make_pair(e.GetTimeStamp(),
-                    _CounterValue{e.GetCounterValue(), true}));
-            break;
+    const TraceCollection::KeyTable& keys = events.GetKeyTable();
+    for (const TraceEvent& e : events) {
+        bool isDelta = false;
+        switch (e.GetType()) {
+            case TraceEvent::EventType::CounterDelta: isDelta = true; break;
+            case TraceEvent::EventType::CounterValue: break;
+            default: continue;
         }
-        case TraceEvent::EventType::CounterValue:
-        {
-            _counterDeltas[key].insert(
-                std::make_pair(e.GetTimeStamp(),
-                    _CounterValue{e.GetCounterValue(), false}));
-            break;
+
+        // Only counter events are checked against the category, so the 
+        // common case of scope events costs a single type comparison.
+        if (!_AcceptsCategory(e.GetCategory())) {
+            continue;
         }
-        default:
-            break;
+
+        // The key table is shared by all the spans of the collection.
+        const TraceCollection::KeyId id = keys.GetKeyId(e.GetKey());
+        if (_counterDeltasById.size() < keys.GetSize()) {
+            _counterDeltasById.resize(keys.GetSize(), nullptr);
+        }
+        if (!TF_VERIFY(id < _counterDeltasById.size())) {
+            continue;
+        }
+        _CounterDeltaValues*& values = _counterDeltasById[id];
+        if (!values) {
+            values = &_counterDeltas[keys.GetToken(id)];
+        }
+        values->push_back(
+            _CounterValue{e.GetTimeStamp(), e.GetCounterValue(), isDelta});
     }
 }
-bool
-TraceCounterAccumulator::AcceptsCategory(TraceCategoryId id)
-{
-    return _AcceptsCategory(id);
-}
 
 void
 TraceCounterAccumulator::SetCurrentValues(
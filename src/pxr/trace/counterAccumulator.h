@@ -15,7 +15,6 @@
 
 #include <pxr/tf/token.h>
 
-#include <map>
 #include <unordered_map>
 #include <vector>
 
@@ -30,7 +29,7 @@ TRACE_NAMESPACE_OPEN_SCOPE
 /// SetCurrentValues().
 ///
 ///
-class TraceCounterAccumulator : private TraceCollection::Visitor {
+class TraceCounterAccumulator {
 public:
     using CounterValues = std::vector<std::pair<TraceEvent::TimeStamp, double>>;
     using CounterValuesMap =
@@ -63,25 +62,29 @@ protected:
     virtual bool _AcceptsCategory(TraceCategoryId id) = 0;
 
 private:
-    // TraceCollection::Visitor Interface
-    virtual void OnBeginCollection() override;
-    virtual void OnEndCollection() override;
-    virtual void OnBeginThread(const TraceThreadId&) override;
-    virtual void OnEndThread(const TraceThreadId&) override;
-    virtual bool AcceptsCategory(TraceCategoryId) override;
-    virtual void OnEvent(
-        const TraceThreadId&, const TfToken&, const TraceEvent&) override;
+    // TraceCollection batched visitor interface
+    friend class TraceCollection;
+    void OnBeginCollection();
+    void OnEndCollection();
+    void OnBeginThread(const TraceThreadId&);
+    void OnEndThread(const TraceThreadId&);
+    void OnEvents(const TraceThreadId&, const TraceCollection::EventSpan&);
 
     struct _CounterValue {
+        TraceEvent::TimeStamp time;
         double value;
         bool isDelta;
     };
 
-    using _CounterDeltaValues =
-        std::multimap<TraceEvent::TimeStamp, _CounterValue>;
-    using _CounterDeltaMap = std::map<TfToken, _CounterDeltaValues>;
+    // The values of a counter are appended in the order of the events and
+    // sorted by time once, at the end of the collection.
+    using _CounterDeltaValues = std::vector<_CounterValue>;
+    using _CounterDeltaMap = std::unordered_map<
+        TfToken, _CounterDeltaValues, TfToken::HashFunctor>;
 
     _CounterDeltaMap _counterDeltas;
+    // The values of the keys of the current collection, by key id.
+    std::vector<_CounterDeltaValues*> _counterDeltasById;
     CounterValuesMap _counterValuesOverTime;
     CounterMap _currentValues;
 };
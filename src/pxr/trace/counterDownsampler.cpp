@@ -0,0 +1,166 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/counterDownsampler.h"
+
+#include "pxr/trace/pxr.h"
+
+#include <algorithm>
+#include <cmath>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+using CounterValues = TraceCounterDownsampler::CounterValues;
+
+CounterValues
+_DownsampleMinMax(const CounterValues& values, size_t resolution)
+{
+    const size_t n = values.size();
+    if (n <= 2 * resolution + 2) {
+        return values;
+    }
+
+    const TraceEvent::TimeStamp start = values.front().first;
+    const double duration = double(values.back().first - start);
+    auto getBucket = [&](TraceEvent::TimeStamp time) {
+        if (duration <= 0.0) {
+            return size_t(0);
+        }
+        return std::min(resolution - 1,
+            size_t(double(time - start) / duration * resolution));
+    };
+
+    CounterValues result;
+    result.reserve(2 * resolution + 2);
+    result.push_back(values.front());
+
+    // Keeps the smallest and largest values of each bucket, in time order.
+    size_t bucket = getBucket(values[1].first);
+    size_t minIndex = 1;
+    size_t maxIndex = 1;
+    auto flush = [&]() {
+        result.push_back(values[std::min(minIndex, maxIndex)]);
+        if (minIndex != maxIndex) {
+            result.push_back(values[std::max(minIndex, maxIndex)]);
+        }
+    };
+    for (size_t i = 2; i + 1 < n; ++i) {
+        const size_t b = getBucket(values[i].first);
+        if (b != bucket) {
+            flush();
+            bucket = b;
+            minIndex = maxIndex = i;
+            continue;
+        }
+        if (values[i].second < values[minIndex].second) {
+            minIndex = i;
+        }
+        if (values[i].second > values[maxIndex].second) {
+            maxIndex = i;
+        }
+    }
+    flush();
+
+    result.push_back(values.back());
+    return result;
+}
+
+CounterValues
+_DownsampleLargestTriangleThreeBuckets(
+    const CounterValues& values, size_t resolution)
+{
+    // The first and last values take a bucket each.
+    const size_t threshold = std::max<size_t>(resolution, 3);
+    const size_t n = values.size();
+    if (n <= threshold) {
+        return values;
+    }
+
+    // Times are relative to the first value to keep their precision.
+    const TraceEvent::TimeStamp start = values.front().first;
+    auto x = [&](size_t i) { return double(values[i].first - start); };
+    auto y = [&](size_t i) { return values[i].second; };
+
+    CounterValues result;
+    result.reserve(threshold);
+    result.push_back(values.front());
+
+    const double bucketSize = double(n - 2) / double(threshold - 2);
+    size_t a = 0;
+    for (size_t i = 0; i < threshold - 2; ++i) {
+        // The average of the next bucket is the third point of the
+        // triangles.
+        const size_t nextBegin = size_t(std::floor((i + 1) * bucketSize)) + 1;
+        const size_t nextEnd = std::min(
+            size_t(std::floor((i + 2) * bucketSize)) + 1, n);
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (size_t j = nextBegin; j < nextEnd; ++j) {
+            avgX += x(j);
+            avgY += y(j);
+        }
+        const double count = double(std::max<size_t>(nextEnd - nextBegin, 1));
+        avgX /= count;
+        avgY /= count;
+
+        // Keep the value of the current bucket which forms the largest
+        // triangle with the last value kept and the average of the next
+        // bucket.
+        const size_t begin = size_t(std::floor(i * bucketSize)) + 1;
+        const size_t end = size_t(std::floor((i + 1) * bucketSize)) + 1;
+        double maxArea = -1.0;
+        size_t next = begin;
+        for (size_t j = begin; j < end; ++j) {
+            const double area = std::abs(
+                (x(a) - avgX) * (y(j) - y(a)) -
+                (x(a) - x(j)) * (avgY - y(a)));
+            if (area > maxArea) {
+                maxArea = area;
+                next = j;
+            }
+        }
+        result.push_back(values[next]);
+        a = next;
+    }
+
+    result.push_back(values.back());
+    return result;
+}
+
+} // anonymous namespace
+
+TraceCounterDownsampler::CounterValues
+TraceCounterDownsampler::Downsample(const CounterValues& values) const
+{
+    if (!IsEnabled()) {
+        return values;
+    }
+    switch (_method) {
+        case Method::MinMax:
+            return _DownsampleMinMax(values, _resolution);
+        case Method::LargestTriangleThreeBuckets:
+            return _DownsampleLargestTriangleThreeBuckets(values, _resolution);
+        case Method::None:
+            break;
+    }
+    return values;
+}
+
+TraceCounterDownsampler::CounterValuesMap
+TraceCounterDownsampler::Downsample(const CounterValuesMap& counters) const
+{
+    if (!IsEnabled()) {
+        return counters;
+    }
+    CounterValuesMap result;
+    for (const CounterValuesMap::value_type& c : counters) {
+        result.emplace(c.first, Downsample(c.second));
+    }
+    return result;
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
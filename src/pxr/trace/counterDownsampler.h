@@ -0,0 +1,93 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_COUNTER_DOWNSAMPLER_H
+#define PXR_TRACE_COUNTER_DOWNSAMPLER_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/event.h"
+
+#include <pxr/tf/token.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceCounterDownsampler
+///
+/// This class reduces the number of values of counters to a target
+/// resolution, so that counters updated at a high frequency can be exported
+/// and displayed without writing every value.
+///
+/// The resolution is the number of buckets the values of a counter are split
+/// into, e.g. the width in pixels of the view which displays it. The first
+/// and last values of a counter are always kept.
+///
+/// - \c MinMax splits the time range of the counter in buckets of equal
+///   duration and keeps the smallest and largest value of each bucket, in
+///   time order. Every peak remains visible.
+/// - \c LargestTriangleThreeBuckets splits the values in buckets of equal
+///   size and keeps the value of each bucket which forms the largest
+///   triangle with the values kept in the neighboring buckets, which
+///   preserves the shape of the curve with a single value per bucket.
+///
+/// Counters with no more values than the downsampled result would have are
+/// left unchanged.
+///
+class TraceCounterDownsampler {
+public:
+    using CounterValues =
+        std::vector<std::pair<TraceEvent::TimeStamp, double>>;
+    using CounterValuesMap =
+        std::unordered_map<TfToken, CounterValues, TfToken::HashFunctor>;
+
+    /// The downsampling algorithms.
+    enum class Method {
+        None,
+        MinMax,
+        LargestTriangleThreeBuckets,
+    };
+
+    /// Constructs a downsampler which keeps every value.
+    TraceCounterDownsampler() = default;
+
+    /// Constructs a downsampler which reduces counters to \p resolution
+    /// buckets with \p method.
+    TraceCounterDownsampler(Method method, size_t resolution)
+        : _method(method)
+        , _resolution(resolution) {}
+
+    /// Returns the downsampling algorithm.
+    Method GetMethod() const { return _method; }
+
+    /// Returns the number of buckets counters are reduced to.
+    size_t GetResolution() const { return _resolution; }
+
+    /// Returns true if counters are downsampled.
+    bool IsEnabled() const {
+        return _method != Method::None && _resolution > 0;
+    }
+
+    /// Returns the downsampled \p values, which must be sorted by time.
+    TRACE_API CounterValues Downsample(const CounterValues& values) const;
+
+    /// Returns the downsampled values of each counter of \p counters.
+    TRACE_API CounterValuesMap Downsample(
+        const CounterValuesMap& counters) const;
+
+private:
+    Method _method = Method::None;
+    size_t _resolution = 0;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_COUNTER_DOWNSAMPLER_H
@@ -31,6 +31,13 @@ TraceDataBuffer::Allocator::AllocateBlock(const size_t align,
     _next = block.get();
     _blockEnd = _next + blockSize;
     _blocks.push_back(std::move(block));
+    if (_desiredBlockSize < MaxAllocSize) {
+        _desiredBlockSize = std::min(2 * _desiredBlockSize, MaxAllocSize);
+    }
+    _allocatedBytes += blockSize;
+    if (_observer) {
+        _observer->OnBlockAllocated();
+    }
 }
 
 TRACE_NAMESPACE_CLOSE_SCOPE
@@ -10,6 +10,7 @@
 
 #include "pxr/trace/pxr.h"
 
+#include "pxr/trace/allocationObserver.h"
 #include "pxr/trace/api.h"
 
 #include <pxr/arch/hints.h>
@@ -35,7 +36,12 @@ class TraceDataBuffer {
 public:
     constexpr static size_t DefaultAllocSize = 1024;
 
-    /// Constructor. The buffer will make allocations of \p allocSize.
+    /// The largest allocation made by the buffer for small data.
+    constexpr static size_t MaxAllocSize = 64 * 1024;
+
+    /// Constructor. The buffer will make allocations of \p allocSize, each
+    /// one twice as large as the previous one up to MaxAllocSize, so that
+    /// buffers holding a lot of data make few allocations.
     ///
     TraceDataBuffer(size_t allocSize = DefaultAllocSize) : _alloc(allocSize) {}
 
@@ -61,6 +67,30 @@ public:
         return cstr;
     }
 
+    /// Returns uninitialized storage for \p count values of type \p T.
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+            "No destructors will be called");
+        return reinterpret_cast<T*>(
+            _alloc.Allocate(alignof(T), sizeof(T) * count));
+    }
+
+    /// Takes ownership of the data stored in \p other, so that pointers to
+    /// it remain valid for the lifetime of this buffer.
+    void Append(TraceDataBuffer&& other) {
+        _alloc.Append(std::move(other._alloc));
+    }
+
+    /// Returns the number of bytes of the blocks allocated by the buffer.
+    size_t GetMemoryUsage() const { return _alloc.GetMemoryUsage(); }
+
+    /// Sets the \p observer notified each time the buffer allocates a block.
+    void SetAllocationObserver(TraceAllocationObserver* observer) {
+        _alloc.SetAllocationObserver(observer);
+    }
+
 private:
     // Simple Allocator that only supports allocations, but not frees. 
     // Allocated memory is tied to the lifetime of the allocator object.
@@ -86,6 +116,22 @@ private:
             return alignedNext;
         }
 
+        void Append(Allocator&& other) {
+            for (BlockPtr& block : other._blocks) {
+                _blocks.push_back(std::move(block));
+            }
+            other._blocks.clear();
+            other._next = other._blockEnd = nullptr;
+            _allocatedBytes += other._allocatedBytes;
+            other._allocatedBytes = 0;
+        }
+
+        size_t GetMemoryUsage() const { return _allocatedBytes; }
+
+        void SetAllocationObserver(TraceAllocationObserver* observer) {
+            _observer = observer;
+        }
+
     private:
         using Byte = std::uint8_t;
 
@@ -102,6 +148,8 @@ private:
         using BlockPtr = std::unique_ptr<Byte[]>;
         std::deque<BlockPtr> _blocks;
         size_t _desiredBlockSize;
+        size_t _allocatedBytes = 0;
+        TraceAllocationObserver* _observer = nullptr;
     };
 
     Allocator _alloc;
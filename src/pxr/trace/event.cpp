@@ -76,6 +76,18 @@ TraceEvent::GetEndTimeStamp() const
     return _type != _InternalEventType::Timespan ? 0 :  _time;
 }
 
+std::vector<uintptr_t>
+TraceEvent::GetStackFrames() const
+{
+    if (_type != _InternalEventType::Sample) {
+        return {};
+    }
+    // The frames are preceded by their number.
+    const uintptr_t* frames =
+        *reinterpret_cast<const uintptr_t* const *>(&_payload);
+    return std::vector<uintptr_t>(frames + 1, frames + 1 + frames[0]);
+}
+
 TraceEvent::EventType
 TraceEvent::GetType() const {
     switch (_type) {
@@ -87,6 +99,7 @@ TraceEvent::GetType() const {
         case _InternalEventType::CounterValue: return EventType::CounterValue;
         case _InternalEventType::ScopeData: return EventType::ScopeData;
         case _InternalEventType::ScopeDataLarge: return EventType::ScopeData;
+        case _InternalEventType::Sample: return EventType::Sample;
     }
     return EventType::Unknown;
 }
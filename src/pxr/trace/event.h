@@ -12,10 +12,14 @@
 
 #include "pxr/trace/api.h"
 #include "pxr/trace/category.h"
+#include "pxr/trace/clock.h"
 #include "pxr/trace/key.h"
 
 #include <pxr/arch/timing.h>
 
+#include <cstdint>
+#include <vector>
+
 TRACE_NAMESPACE_OPEN_SCOPE
 
 class TraceEventData;
@@ -42,6 +46,7 @@ public:
     enum CounterDeltaTag { CounterDelta };
     enum CounterValueTag { CounterValue };
     enum DataTag { Data };
+    enum SampleTag { Sample };
     /// @}
 
     /// Valid event types
@@ -55,6 +60,8 @@ public:
         CounterValue, ///< The event represents the value of a counter.
         ScopeData,
         ///< The event stores data that is associated with its enclosing scope.
+        Sample,
+        ///< The event stores a sample of the stack of its thread.
     };
 
     /// The different types of data that can be stored in a TraceEvent instance.
@@ -88,6 +95,9 @@ public:
     /// Returns the data stored in a data event.
     TRACE_API TraceEventData GetData() const;
 
+    /// Returns the stack frames of a sample event, innermost first.
+    TRACE_API std::vector<uintptr_t> GetStackFrames() const;
+
     /// Returns the type of the event.
     TRACE_API EventType GetType() const;
 
@@ -100,7 +110,7 @@ public:
         _key(key),
         _category(cat),
         _type(_InternalEventType::Begin),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
     }
     
     /// Constructor for Begin events that takes a specific TimeStamp \a ts.
@@ -120,7 +130,7 @@ public:
         _key(key),
         _category(cat),
         _type(_InternalEventType::End),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
     }
     
     /// Constructor for End events that takes a specific TimeStamp \a ts.
@@ -152,7 +162,7 @@ public:
         _key(key),
         _category(cat),
         _type(_InternalEventType::Marker),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
     }
 
     /// Constructor for Mark events that takes a specific TimeStamp \a ts.
@@ -174,7 +184,7 @@ public:
         _key(key),
         _category(cat),
         _type(_InternalEventType::CounterDelta),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) double(value);
     }
 
@@ -186,7 +196,7 @@ public:
         _key(key),
         _category(cat),
         _type(_InternalEventType::CounterValue),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) double(value);
     }
 
@@ -197,7 +207,7 @@ public:
         _category(cat),
         _dataType(DataType::Boolean),
         _type(_InternalEventType::ScopeData),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) bool(data);
     }
 
@@ -206,7 +216,7 @@ public:
         _category(cat),
         _dataType(DataType::Int),
         _type(_InternalEventType::ScopeData),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) int64_t(data);
     }
 
@@ -215,7 +225,7 @@ public:
         _category(cat),
         _dataType(DataType::Int),
         _type(_InternalEventType::ScopeData),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) int64_t(data);
     }
 
@@ -224,7 +234,7 @@ public:
         _category(cat),
         _dataType(DataType::UInt),
         _type(_InternalEventType::ScopeData),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) uint64_t(data);
     }
 
@@ -233,7 +243,7 @@ public:
         _category(cat),
         _dataType(DataType::Float),
         _type(_InternalEventType::ScopeData),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) double(data);
     }
 
@@ -242,11 +252,26 @@ public:
         _category(cat),
         _dataType(DataType::String),
         _type(_InternalEventType::ScopeDataLarge),
-        _time(ArchGetTickTime()) {
+        _time(TraceClock::Now()) {
         new (&_payload) const char*(data);
     }
     /// @}
 
+    /// Constructor for Sample events taken at \p ts. \p frames must be
+    /// returned by TraceEventList::StoreStackFrames() and remain valid for
+    /// the lifetime of the event.
+    TraceEvent( SampleTag,
+                const Key& key,
+                TimeStamp ts,
+                const uintptr_t* frames,
+                TraceCategoryId cat) :
+        _key(key),
+        _category(cat),
+        _type(_InternalEventType::Sample),
+        _time(ts) {
+        new (&_payload) const uintptr_t*(frames);
+    }
+
     // Can move this, but not copy it
     TraceEvent(const TraceEvent&) = delete;
     TraceEvent& operator= (const TraceEvent&) = delete;
@@ -259,6 +284,28 @@ public:
     /// Sets the events timestamp to \p time.
     void SetTimeStamp(TimeStamp time) { _time = time; }
 private:
+    // TraceCollection copies events when slicing collections. The copy 
+    // refers to the same key and data as the original event.
+    friend class TraceCollection;
+
+    // TraceEventList coalesces counter deltas into existing events.
+    friend class TraceEventList;
+
+    void _AddToCounterValue(double delta) {
+        *reinterpret_cast<double*>(&_payload) += delta;
+    }
+
+    enum _CopyTag { _Copy };
+
+    TraceEvent(_CopyTag, const TraceEvent& other) :
+        _key(other._key),
+        _category(other._category),
+        _dataType(other._dataType),
+        _type(other._type),
+        _time(other._time),
+        _payload(other._payload) {
+    }
+
     // Valid event types. This type has more detail that the public facing
     // EventType enum.
     enum class _InternalEventType : uint8_t {
@@ -270,6 +317,7 @@ private:
         CounterValue,
         ScopeData,
         ScopeDataLarge,
+        Sample,
     };
 
     using PayloadStorage = std::aligned_storage<8, 8>::type;
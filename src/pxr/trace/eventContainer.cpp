@@ -9,17 +9,329 @@
 
 #include "pxr/trace/eventContainer.h"
 #include <pxr/tf/diagnostic.h>
+#include <pxr/arch/defines.h>
 
+#if defined(ARCH_OS_WINDOWS)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(ARCH_OS_LINUX) && defined(SYS_membarrier) && \
+    __has_include(<linux/membarrier.h>)
+#include <linux/membarrier.h>
+#define TRACE_HAS_MEMBARRIER
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <deque>
+#include <mutex>
 #include <new>
+#include <vector>
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
+namespace {
+
+// The size of the first block of a container. Each following block is twice
+// as large as the previous one.
+constexpr size_t _MinBlockSize = 512;
+
+// Blocks of up to _MinBlockSize << (_NumSizeClasses - 1) bytes, i.e. 512 KiB,
+// are pooled. Larger blocks are only used by very long lists and are freed.
+constexpr size_t _NumSizeClasses = 11;
+
+constexpr size_t _DefaultPoolCapacity = 64 * 1024 * 1024;
+
+// Blocks of at least this size are mapped directly rather than allocated
+// from the heap, when mapping is enabled.
+constexpr size_t _MinMappedBlockSize = 64 * 1024;
+
+// Mapped blocks of at least this size are aligned to it and backed by huge
+// pages when the system allows it.
+constexpr size_t _HugePageSize = 2 * 1024 * 1024;
+
+// Pooled blocks are kept apart for this many NUMA nodes. Blocks of other
+// nodes share the lists of the nodes with the same index modulo this count.
+constexpr size_t _MaxNumaNodes = 8;
+
+std::atomic<bool> _blockMapping(true);
+
+// Set once non-temporal stores have been enabled, after which every handoff
+// must be fenced.
+std::atomic<bool> _nonTemporalStoresUsed(false);
+
+// Returns true if the process can fence the stores of all its threads from
+// a single thread, registering it for _FenceProcess() if needed.
+bool
+_RegisterProcessFence()
+{
+#if !defined(ARCH_CPU_INTEL)
+    // Events are written with regular stores on other architectures.
+    return false;
+#elif defined(ARCH_OS_WINDOWS)
+    return true;
+#elif defined(TRACE_HAS_MEMBARRIER)
+    static const bool registered = syscall(SYS_membarrier,
+        MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    return registered;
+#else
+    return false;
+#endif
+}
+
+// Makes the stores of every thread of the process visible to the calling
+// thread. Non-temporal stores are weakly ordered, so the release of the
+// writing flag of a thread does not publish them. Interrupting the threads
+// that are running drains their write-combining buffers, and the others
+// have already done so when they were switched out.
+void
+_FenceProcess()
+{
+#if defined(ARCH_OS_WINDOWS)
+    FlushProcessWriteBuffers();
+#elif defined(TRACE_HAS_MEMBARRIER)
+    if (syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0)
+            != 0) {
+        TF_RUNTIME_ERROR("Failed to fence non-temporal stores");
+    }
+#endif
+}
+
+// Returns the NUMA node of the CPU the calling thread runs on.
+size_t
+_GetNumaNode()
+{
+#if defined(ARCH_OS_LINUX) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node % _MaxNumaNodes;
+    }
+#endif
+    return 0;
+}
+
+// Allocates blockSize bytes. Sets mapped to true if the memory was mapped
+// rather than allocated from the heap.
+//
+// Pages of mapped memory are only backed when first written, so they are
+// placed on the NUMA node of the thread which records the events of the
+// block, whereas heap memory may have been touched by any thread before.
+void*
+_AllocateMemory(size_t blockSize, bool* mapped)
+{
+    *mapped = false;
+#if !defined(ARCH_OS_WINDOWS)
+    if (blockSize >= _MinMappedBlockSize &&
+            _blockMapping.load(std::memory_order_relaxed)) {
+        const bool huge = blockSize >= _HugePageSize;
+        const size_t mapSize = huge ? blockSize + _HugePageSize : blockSize;
+        void* p = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            char* begin = static_cast<char*>(p);
+            if (huge) {
+                // Trim the mapping to an aligned range of blockSize bytes.
+                char* aligned = reinterpret_cast<char*>(
+                    (reinterpret_cast<uintptr_t>(begin) + _HugePageSize - 1)
+                    & ~uintptr_t(_HugePageSize - 1));
+                if (aligned != begin) {
+                    munmap(begin, aligned - begin);
+                }
+                char* end = begin + mapSize;
+                if (aligned + blockSize != end) {
+                    munmap(aligned + blockSize, end - (aligned + blockSize));
+                }
+                begin = aligned;
+#if defined(MADV_HUGEPAGE)
+                madvise(begin, blockSize, MADV_HUGEPAGE);
+#endif
+            }
+            *mapped = true;
+            return begin;
+        }
+    }
+#endif
+    return malloc(blockSize);
+}
+
+void
+_FreeMemory(void* p, size_t blockSize, bool mapped)
+{
+#if !defined(ARCH_OS_WINDOWS)
+    if (mapped) {
+        munmap(p, blockSize);
+        return;
+    }
+#endif
+    free(p);
+}
+
+// Free blocks, by NUMA node and size class. Containers are usually
+// destroyed by the thread which consumes the collections rather than by the
+// threads which recorded the events, so the pool is shared by all the
+// threads, and blocks are only reused on the node they were first written
+// on. A lock is taken once per block rather than once per event, so it is
+// rarely contended.
+class _BlockPool {
+public:
+    // Returns a free block of blockSize bytes of numaNode, or nullptr. Sets
+    // mapped to true if the block was mapped.
+    void* Acquire(size_t blockSize, size_t numaNode, bool* mapped) {
+        const size_t sizeClass = _GetSizeClass(blockSize);
+        if (sizeClass == _NumSizeClasses) {
+            return nullptr;
+        }
+        _SizeClass& c = _classes[numaNode][sizeClass];
+        std::lock_guard<std::mutex> lock(c.mutex);
+        _PooledBlock* block = c.head;
+        if (block) {
+            c.head = block->next;
+            *mapped = block->mapped;
+            _size -= blockSize;
+        }
+        return block;
+    }
+
+    // Keeps block for reuse and returns true, or returns false if the pool
+    // is full.
+    bool Release(
+        void* block, size_t blockSize, size_t numaNode, bool mapped) {
+        const size_t sizeClass = _GetSizeClass(blockSize);
+        if (sizeClass == _NumSizeClasses) {
+            return false;
+        }
+        const size_t capacity = _capacity.load(std::memory_order_relaxed);
+        size_t size = _size.load(std::memory_order_relaxed);
+        do {
+            if (size + blockSize > capacity) {
+                return false;
+            }
+        } while (!_size.compare_exchange_weak(size, size + blockSize));
+
+        _SizeClass& c = _classes[numaNode][sizeClass];
+        std::lock_guard<std::mutex> lock(c.mutex);
+        c.head = new (block) _PooledBlock{c.head, mapped};
+        return true;
+    }
+
+    void SetCapacity(size_t capacity) {
+        _capacity.store(capacity, std::memory_order_relaxed);
+
+        // Free the largest blocks first.
+        for (size_t i = _NumSizeClasses; i-- > 0 && _size > capacity; ) {
+            const size_t blockSize = _MinBlockSize << i;
+            for (size_t node = 0; node < _MaxNumaNodes; ++node) {
+                _SizeClass& c = _classes[node][i];
+                std::lock_guard<std::mutex> lock(c.mutex);
+                while (c.head && _size > capacity) {
+                    _PooledBlock* block = c.head;
+                    c.head = block->next;
+                    _size -= blockSize;
+                    _FreeMemory(block, blockSize, block->mapped);
+                }
+            }
+        }
+    }
+
+    size_t GetCapacity() const {
+        return _capacity.load(std::memory_order_relaxed);
+    }
+
+    size_t GetSize() const { return _size; }
+
+private:
+    struct _PooledBlock {
+        _PooledBlock* next;
+        bool mapped;
+    };
+
+    struct _SizeClass {
+        std::mutex mutex;
+        _PooledBlock* head = nullptr;
+    };
+
+    // Returns the size class of blockSize, or _NumSizeClasses if it is not
+    // pooled.
+    static size_t _GetSizeClass(size_t blockSize) {
+        for (size_t i = 0; i < _NumSizeClasses; ++i) {
+            if (blockSize == _MinBlockSize << i) {
+                return i;
+            }
+        }
+        return _NumSizeClasses;
+    }
+
+    _SizeClass _classes[_MaxNumaNodes][_NumSizeClasses];
+    std::atomic<size_t> _size{0};
+    std::atomic<size_t> _capacity{_DefaultPoolCapacity};
+};
+
+// The pool is never destroyed, so that containers destroyed during static
+// destruction can still release their blocks.
+_BlockPool&
+_GetBlockPool()
+{
+    static _BlockPool* pool = new _BlockPool;
+    return *pool;
+}
+
+} // anonymous namespace
+
+std::atomic<bool> TraceEventContainer::_nonTemporalStores(false);
+
+struct TraceEventContainer::_SpillFile {
+    ~_SpillFile() {
+        for (_Node* node : pending) {
+            _Node::DestroyList(node);
+        }
+        if (file) {
+            std::fclose(file);
+        }
+    }
+
+    // Guards the members below. They are written by the thread which
+    // records the events, and read by the thread which loads them back.
+    std::mutex mutex;
+    std::condition_variable written;
+
+    // Created by the first write.
+    std::FILE* file = nullptr;
+
+    // The size of each block written to the file and the number of events
+    // it held, from the oldest.
+    std::vector<std::pair<size_t, size_t>> blocks;
+
+    // The blocks waiting to be written, from the oldest.
+    std::deque<_Node*> pending;
+
+    // The number of bytes of events spilled, including the pending blocks.
+    size_t size = 0;
+
+    // The number of spilled events which were dropped.
+    size_t numLost = 0;
+
+    // Set while a block is written, without holding the mutex.
+    bool writing = false;
+
+    // Set when a write failed, after which no block is spilled.
+    bool failed = false;
+};
+
 TraceEventContainer::TraceEventContainer()
     : _nextEvent(nullptr)
     , _front(nullptr)
     , _back(nullptr)
-    , _blockSizeBytes(512)
+    , _blockSizeBytes(_MinBlockSize)
+    , _allocatedBytes(0)
+    , _observer(nullptr)
 {
     Allocate();
 }
@@ -36,6 +348,8 @@ TraceEventContainer::TraceEventContainer(TraceEventContainer&& other)
     swap(_nextEvent, other._nextEvent);
     swap(_back, other._back);
     swap(_front, other._front);
+    swap(_allocatedBytes, other._allocatedBytes);
+    swap(_spillFile, other._spillFile);
     _blockSizeBytes = other._blockSizeBytes;
 }
 
@@ -47,6 +361,9 @@ TraceEventContainer& TraceEventContainer::operator=(TraceEventContainer&& other)
     swap(_nextEvent, temp._nextEvent);
     swap(_back, temp._back);
     swap(_front, temp._front);
+    swap(_allocatedBytes, temp._allocatedBytes);
+    swap(_spillFile, temp._spillFile);
+    _blockSizeBytes = temp._blockSizeBytes;
 
     return *this;
 }
@@ -54,12 +371,19 @@ TraceEventContainer& TraceEventContainer::operator=(TraceEventContainer&& other)
 void 
 TraceEventContainer::Append(TraceEventContainer&& other)
 {
+    // The spilled events of this container are older than the events it
+    // holds in memory and stay in its file, but those of other must be
+    // joined to the list.
+    other.LoadSpilledBlocks();
     if (other.empty()) {
         return;
     }
     if (empty()) {
-        *this = std::move(other);
-        return;
+        LoadSpilledBlocks();
+        if (empty()) {
+            *this = std::move(other);
+            return;
+        }
     }
 
     // In the interest of keeping the iterator implementation simple, we
@@ -69,23 +393,25 @@ TraceEventContainer::Append(TraceEventContainer&& other)
         _Node *empty = _back;
         _back = _back->GetPrevNode();
         empty->Unlink();
+        _allocatedBytes -= empty->GetBlockSize();
         _Node::DestroyList(empty);
     }
 
     _Node::Join(_back, other._front);
     _back = other._back;
     _nextEvent = other._nextEvent;
+    _allocatedBytes += other._allocatedBytes;
     other._nextEvent = nullptr;
     other._front = nullptr;
     other._back = nullptr;
+    other._allocatedBytes = 0;
     other.Allocate();
 }
 
 void
 TraceEventContainer::Allocate()
 {
-    size_t capacity = (_blockSizeBytes - sizeof(_Node)) / sizeof(TraceEvent);
-    _Node *node = _Node::New(capacity);
+    _Node *node = _Node::New(_blockSizeBytes);
     if (!_front) {
         _front = node;
     }
@@ -97,16 +423,245 @@ TraceEventContainer::Allocate()
     char *p = reinterpret_cast<char *>(node);
     p += sizeof(_Node);
     _nextEvent = reinterpret_cast<TraceEvent *>(p);
+    _allocatedBytes += _blockSizeBytes;
     _blockSizeBytes *= 2;
+
+    if (_observer) {
+        _observer->OnBlockAllocated();
+    }
+}
+
+size_t
+TraceEventContainer::GetSpilledBytes() const
+{
+    if (!_spillFile) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(_spillFile->mutex);
+    return _spillFile->size;
+}
+
+size_t
+TraceEventContainer::DropOldestBlocks(size_t bytes)
+{
+    size_t numDropped = 0;
+    while (_allocatedBytes > bytes && _CanReleaseFront()) {
+        _Node* node = _front;
+        _front = node->GetNextNode();
+        node->Unlink();
+        numDropped += node->end() - node->begin();
+        _allocatedBytes -= node->GetBlockSize();
+        _Node::DestroyList(node);
+    }
+    _LimitBlockSize(bytes);
+    return numDropped;
+}
+
+TraceEventContainer::SpillFilePtr
+TraceEventContainer::SpillOldestBlocks(size_t bytes)
+{
+    if (!_spillFile) {
+        _spillFile = std::make_shared<_SpillFile>();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_spillFile->mutex);
+        if (_spillFile->failed) {
+            return nullptr;
+        }
+        while (_allocatedBytes > bytes && _CanReleaseFront()) {
+            _Node* node = _front;
+            _front = node->GetNextNode();
+            node->Unlink();
+            _allocatedBytes -= node->GetBlockSize();
+            _spillFile->size +=
+                (node->end() - node->begin()) * sizeof(TraceEvent);
+            _spillFile->pending.push_back(node);
+        }
+    }
+    _LimitBlockSize(bytes);
+    return _spillFile;
+}
+
+void
+TraceEventContainer::WriteSpilledBlocks(const SpillFilePtr& file)
+{
+    _SpillFile& spill = *file;
+    std::unique_lock<std::mutex> lock(spill.mutex);
+    while (!spill.pending.empty()) {
+        _Node* node = spill.pending.front();
+        spill.pending.pop_front();
+        const size_t numEvents = node->end() - node->begin();
+
+        // The block is written without holding the mutex, so that loading
+        // the blocks back only waits for this one.
+        bool ok = !spill.failed;
+        spill.writing = true;
+        lock.unlock();
+        if (ok && !spill.file) {
+            spill.file = std::tmpfile();
+        }
+        ok = ok && spill.file && std::fwrite(node->begin(),
+            sizeof(TraceEvent), numEvents, spill.file) == numEvents;
+        lock.lock();
+        spill.writing = false;
+
+        if (ok) {
+            spill.blocks.emplace_back(node->GetBlockSize(), numEvents);
+        } else {
+            // Part of the events may have been written, so nothing is
+            // written after them. The events written before are dropped
+            // too, so that the events which are read back have no gap.
+            spill.failed = true;
+            for (const auto& block : spill.blocks) {
+                spill.numLost += block.second;
+            }
+            spill.blocks.clear();
+            spill.numLost += numEvents;
+        }
+        _Node::DestroyList(node);
+        spill.written.notify_all();
+    }
+}
+
+size_t
+TraceEventContainer::LoadSpilledBlocks()
+{
+    if (!_spillFile) {
+        return 0;
+    }
+    const SpillFilePtr file = std::move(_spillFile);
+    _SpillFile& spill = *file;
+    std::unique_lock<std::mutex> lock(spill.mutex);
+    spill.written.wait(lock, [&spill]() { return !spill.writing; });
+
+    size_t numLost = spill.numLost;
+    _Node* head = nullptr;
+    _Node* tail = nullptr;
+    size_t bytes = 0;
+    const auto append = [&head, &tail, &bytes](_Node* node) {
+        if (tail) {
+            _Node::Join(tail, node);
+        } else {
+            head = node;
+        }
+        tail = node;
+        bytes += node->GetBlockSize();
+    };
+
+    if (!spill.blocks.empty()) {
+        std::rewind(spill.file);
+        for (const auto& block : spill.blocks) {
+            _Node* node = _Node::New(block.first);
+            TraceEvent* events = const_cast<TraceEvent*>(node->end());
+            if (std::fread(events, sizeof(TraceEvent), block.second,
+                    spill.file) != block.second) {
+                TF_RUNTIME_ERROR("Failed to read spilled trace events");
+                _Node::DestroyList(node);
+
+                // The events which were read back are dropped too, so that
+                // the events have no gap.
+                _Node::DestroyList(head);
+                head = nullptr;
+                tail = nullptr;
+                bytes = 0;
+                for (const auto& lost : spill.blocks) {
+                    numLost += lost.second;
+                }
+                break;
+            }
+            node->ClaimEventEntries(block.second);
+            append(node);
+        }
+        spill.blocks.clear();
+    }
+
+    // The blocks which were not written yet are newer than those of the
+    // file.
+    for (_Node* node : spill.pending) {
+        append(node);
+    }
+    spill.pending.clear();
+
+    if (tail) {
+        _Node::Join(tail, _front);
+        _front = head;
+        _allocatedBytes += bytes;
+    }
+    return numLost;
+}
+
+void
+TraceEventContainer::_LimitBlockSize(size_t bytes)
+{
+    while (_blockSizeBytes > _MinBlockSize &&
+            _allocatedBytes + _blockSizeBytes > bytes) {
+        _blockSizeBytes /= 2;
+    }
+}
+
+void
+TraceEventContainer::SetBlockPoolCapacity(size_t bytes)
+{
+    _GetBlockPool().SetCapacity(bytes);
+}
+
+size_t
+TraceEventContainer::GetBlockPoolCapacity()
+{
+    return _GetBlockPool().GetCapacity();
+}
+
+size_t
+TraceEventContainer::GetBlockPoolSize()
+{
+    return _GetBlockPool().GetSize();
+}
+
+void
+TraceEventContainer::SetBlockMappingEnabled(bool enabled)
+{
+    _blockMapping.store(enabled, std::memory_order_relaxed);
+}
+
+bool
+TraceEventContainer::IsBlockMappingEnabled()
+{
+    return _blockMapping.load(std::memory_order_relaxed);
+}
+
+bool
+TraceEventContainer::SetNonTemporalStoresEnabled(bool enabled)
+{
+    if (enabled) {
+        if (!_RegisterProcessFence()) {
+            return false;
+        }
+        _nonTemporalStoresUsed.store(true, std::memory_order_relaxed);
+    }
+    _nonTemporalStores.store(enabled, std::memory_order_relaxed);
+    return true;
+}
+
+void
+TraceEventContainer::FenceNonTemporalStores()
+{
+    if (_nonTemporalStoresUsed.load(std::memory_order_relaxed)) {
+        _FenceProcess();
+    }
 }
 
 TraceEventContainer::_Node *
-TraceEventContainer::_Node::New(size_t capacity)
+TraceEventContainer::_Node::New(size_t blockSize)
 {
-    void *p = malloc(sizeof(_Node)+sizeof(TraceEvent)*capacity);
+    const size_t numaNode = _GetNumaNode();
+    bool mapped = false;
+    void *p = _GetBlockPool().Acquire(blockSize, numaNode, &mapped);
+    if (!p) {
+        p = _AllocateMemory(blockSize, &mapped);
+    }
     TraceEvent *eventEnd = reinterpret_cast<TraceEvent*>(
         reinterpret_cast<char *>(p) + sizeof(_Node));
-    return new (p) _Node(eventEnd, capacity);
+    return new (p) _Node(eventEnd, blockSize, numaNode, mapped);
 }
 
 void
@@ -117,17 +672,26 @@ TraceEventContainer::_Node::DestroyList(_Node *head)
 
     while (head) {
         _Node *next = head->_next;
+        const size_t blockSize = head->_blockSize;
+        const size_t numaNode = head->_numaNode;
+        const bool mapped = head->_mapped;
         head->~_Node();
-        free(head);
+        if (!_GetBlockPool().Release(head, blockSize, numaNode, mapped)) {
+            _FreeMemory(head, blockSize, mapped);
+        }
         head = next;
     }
 }
 
-TraceEventContainer::_Node::_Node(TraceEvent *end, size_t capacity)
+TraceEventContainer::_Node::_Node(
+    TraceEvent *end, size_t blockSize, size_t numaNode, bool mapped)
     : _end(end)
-    , _sentinel(end+capacity)
+    , _sentinel(end + (blockSize - sizeof(_Node)) / sizeof(TraceEvent))
     , _prev(nullptr)
     , _next(nullptr)
+    , _blockSize(blockSize)
+    , _numaNode(uint32_t(numaNode))
+    , _mapped(mapped)
 {
 }
 
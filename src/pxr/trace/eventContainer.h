@@ -10,10 +10,22 @@
 
 #include "pxr/trace/pxr.h"
 
+#include "pxr/trace/allocationObserver.h"
 #include "pxr/trace/api.h"
 #include "pxr/trace/event.h"
 
+#include <pxr/arch/defines.h>
+#include <pxr/arch/hints.h>
+
+#if defined(ARCH_CPU_INTEL)
+#include <emmintrin.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <memory>
 #include <new>
 #include <utility>
 
@@ -26,6 +38,9 @@ TRACE_NAMESPACE_OPEN_SCOPE
 /// the end and supports both forward and reverse iteration.
 ///
 class TraceEventContainer {
+    // The file holding the spilled events, created by SpillOldestBlocks().
+    struct _SpillFile;
+
     // Intrusively doubly-linked list node that provides contiguous storage
     // for events.  Only appending events and iterating held events is
     // supported.
@@ -34,11 +49,12 @@ class TraceEventContainer {
     public:
         using const_iterator = const TraceEvent *;
 
-        // Allocate a new node that is able to hold capacity events.
-        static _Node* New(size_t capacity);
+        // Allocate a new node of blockSize bytes, reusing a pooled block of
+        // the NUMA node of the calling thread if possible.
+        static _Node* New(size_t blockSize);
 
         // Destroys the list starting at head, which must be the first node
-        // in its list.
+        // in its list, and returns its blocks to the pool.
         static void DestroyList(_Node *head);
 
         // Join the last and first nodes of two lists to form a new list.
@@ -77,11 +93,21 @@ class TraceEventContainer {
             ++_end;
         }
 
+        // Claims count entries which were written at end().
+        void ClaimEventEntries(size_t count) {
+            _end += count;
+        }
+
+        size_t GetBlockSize() const {
+            return _blockSize;
+        }
+
         // Remove this node from the linked list to which it belongs.
         void Unlink();
 
     private:
-        _Node(TraceEvent *end, size_t capacity);
+        _Node(TraceEvent *end, size_t blockSize, size_t numaNode,
+            bool mapped);
         ~_Node();
 
     private:
@@ -91,6 +117,9 @@ class TraceEventContainer {
                 TraceEvent *_sentinel;
                 _Node *_prev;
                 _Node *_next;
+                size_t _blockSize;
+                uint32_t _numaNode;
+                bool _mapped;
             };
             // Ensure that _Node is aligned to at least the alignment of
             // TraceEvent.
@@ -199,8 +228,13 @@ public:
     /// @{
     template < class... Args>
     TraceEvent& emplace_back(Args&&... args) {
-        TraceEvent *event =
-            new (_nextEvent++) TraceEvent(std::forward<Args>(args)...);
+        TraceEvent *event = _nextEvent++;
+        if (ARCH_UNLIKELY(
+                _nonTemporalStores.load(std::memory_order_relaxed))) {
+            _StreamEvent(event, TraceEvent(std::forward<Args>(args)...));
+        } else {
+            new (event) TraceEvent(std::forward<Args>(args)...);
+        }
         _back->ClaimEventEntry();
         if (_back->IsFull()) {
             Allocate();
@@ -227,19 +261,200 @@ public:
     bool empty() const { return begin() == end(); }
     /// @}
 
+    /// \name Block access
+    /// Events are stored in contiguous blocks. These methods call \p fn with
+    /// the \c begin and \c end pointers of every non-empty block, either 
+    /// front to back or back to front.
+    /// @{
+    template <class Fn>
+    void ForEachBlock(Fn&& fn) const {
+        for (const _Node* node = _front; node; node = node->GetNextNode()) {
+            if (node->begin() != node->end()) {
+                fn(node->begin(), node->end());
+            }
+        }
+    }
+
+    template <class Fn>
+    void ReverseForEachBlock(Fn&& fn) const {
+        for (const _Node* node = _back; node; node = node->GetPrevNode()) {
+            if (node->begin() != node->end()) {
+                fn(node->begin(), node->end());
+            }
+        }
+    }
+    /// @}
+
     /// Append the events in \p other to the end of this container. This takes 
     /// ownership of the events that were in \p other.
     TRACE_API void Append(TraceEventContainer&& other);
 
+    /// \name Block pool
+    /// The blocks of destroyed containers are kept in a pool shared by all
+    /// the threads, up to a capacity, and reused by new containers. When
+    /// collections are created periodically, this lets recording threads
+    /// store events without allocating memory once the pool holds the
+    /// blocks of a collection.
+    /// @{
+
+    /// Sets the maximum number of bytes kept in the pool, freeing the blocks
+    /// above it. A capacity of 0 disables the pool. The default is 64 MiB.
+    TRACE_API static void SetBlockPoolCapacity(size_t bytes);
+
+    /// Returns the maximum number of bytes kept in the pool.
+    TRACE_API static size_t GetBlockPoolCapacity();
+
+    /// Returns the number of bytes currently kept in the pool.
+    TRACE_API static size_t GetBlockPoolSize();
+    /// @}
+
+    /// \name Block memory
+    /// Blocks of 64 KiB or more are mapped directly from the system rather
+    /// than allocated from the heap, where the platform supports it. Their
+    /// pages are backed when the recording thread first writes to them, so
+    /// they are placed on the NUMA node of that thread, and blocks of 2 MiB
+    /// or more are aligned for, and advised to use, huge pages. Pooled
+    /// blocks are only reused on the NUMA node they were allocated on.
+    /// Blocks are allocated from the heap when mapping fails.
+    /// @{
+
+    /// Enables or disables the mapping of blocks. It is enabled by default.
+    TRACE_API static void SetBlockMappingEnabled(bool enabled);
+
+    /// Returns true if blocks are mapped.
+    TRACE_API static bool IsBlockMappingEnabled();
+    /// @}
+
+    /// \name Non-temporal stores
+    /// Events can be written with non-temporal stores, which bypass the
+    /// caches, so that recording events does not evict the working set of
+    /// the instrumented code. Reading the events back is slower, and the
+    /// stores of each thread are only guaranteed to be visible to other
+    /// threads after a call to FenceNonTemporalStores(), which the collector
+    /// makes when it hands the events of a thread over to a collection.
+    /// @{
+
+    /// Enables or disables non-temporal stores. They are disabled by
+    /// default. Returns false if they cannot be enabled on this platform,
+    /// in which case events are written with regular stores.
+    TRACE_API static bool SetNonTemporalStoresEnabled(bool enabled);
+
+    /// Returns true if events are written with non-temporal stores.
+    static bool IsNonTemporalStoresEnabled() {
+        return _nonTemporalStores.load(std::memory_order_relaxed);
+    }
+
+    /// Makes the events written with non-temporal stores by every thread
+    /// before the call visible to the calling thread. This does nothing if
+    /// non-temporal stores were never enabled.
+    TRACE_API static void FenceNonTemporalStores();
+    /// @}
+
+    /// \name Memory limit
+    /// The memory held by a container only changes when it allocates a
+    /// block, which the allocation observer is notified of. The memory can
+    /// then be limited by dropping the oldest blocks or spilling them to a
+    /// temporary file. This must not be done by the observer, since the
+    /// events being stored are still referred to, but once they are stored.
+    /// The block being written to is always kept in memory.
+    /// @{
+
+    /// Returns the number of bytes of the blocks held in memory.
+    size_t GetMemoryUsage() const { return _allocatedBytes; }
+
+    /// Returns the number of bytes of the events spilled to a file.
+    TRACE_API size_t GetSpilledBytes() const;
+
+    /// Sets the \p observer notified each time the container allocates a
+    /// block. The observer is not transferred by moves.
+    void SetAllocationObserver(TraceAllocationObserver* observer) {
+        _observer = observer;
+    }
+
+    /// Frees the oldest blocks and the events they hold until at most
+    /// \p bytes are held in memory, and makes the next blocks smaller to
+    /// stay below it. Returns the number of events dropped.
+    TRACE_API size_t DropOldestBlocks(size_t bytes);
+
+    /// A handle to the file holding the spilled events of a container.
+    using SpillFilePtr = std::shared_ptr<_SpillFile>;
+
+    /// Moves the oldest blocks to the spill file of the container until at
+    /// most \p bytes are held in memory, and makes the next blocks smaller
+    /// to stay below it. The blocks are written by WriteSpilledBlocks(), and
+    /// their events count as spilled meanwhile. Returns the spill file, or
+    /// null if it could not be written before, in which case no block is
+    /// moved.
+    TRACE_API SpillFilePtr SpillOldestBlocks(size_t bytes);
+
+    /// Writes the blocks moved to \p file by SpillOldestBlocks() and frees
+    /// them. The container is not accessed, so this can be called while
+    /// it is read by another thread, e.g. after it was collected, and the
+    /// blocks which are still waiting then are read back from memory. The
+    /// events of the blocks which cannot be written are dropped, with the
+    /// events written before them, so that only the oldest events are
+    /// missing.
+    TRACE_API static void WriteSpilledBlocks(const SpillFilePtr& file);
+
+    /// Reads the events spilled by SpillOldestBlocks() back in front of the
+    /// other events, waiting for a block being written by
+    /// WriteSpilledBlocks(). Iteration only visits the events held in
+    /// memory, so this must be called before the events are read. Returns
+    /// the number of spilled events which were dropped because they could
+    /// not be written or read back.
+    TRACE_API size_t LoadSpilledBlocks();
+    /// @}
+
 private:
     // Allocates a new block of memory for TraceEvent items.
     TRACE_API void Allocate();
 
+    // Returns true if the front block may be dropped or spilled.
+    bool _CanReleaseFront() const {
+        return _front != _back;
+    }
+
+    // Halves the size of the next block until it fits in bytes with the
+    // blocks held in memory, or is the smallest size.
+    void _LimitBlockSize(size_t bytes);
+
+    // Copies src to dst with non-temporal stores.
+    static void _StreamEvent(TraceEvent *dst, const TraceEvent &src) {
+#if defined(ARCH_CPU_INTEL) && defined(ARCH_BITS_64)
+        static_assert(sizeof(TraceEvent) % sizeof(__m128i) == 0,
+            "TraceEvent must be a multiple of 16 bytes");
+        const uintptr_t address = reinterpret_cast<uintptr_t>(dst);
+        if (address % alignof(__m128i) == 0) {
+            const __m128i *s = reinterpret_cast<const __m128i *>(&src);
+            __m128i *d = reinterpret_cast<__m128i *>(dst);
+            for (size_t i = 0; i < sizeof(TraceEvent) / sizeof(__m128i);
+                    ++i) {
+                _mm_stream_si128(d + i, _mm_loadu_si128(s + i));
+            }
+        } else {
+            const long long *s = reinterpret_cast<const long long *>(&src);
+            long long *d = reinterpret_cast<long long *>(dst);
+            for (size_t i = 0; i < sizeof(TraceEvent) / sizeof(long long);
+                    ++i) {
+                _mm_stream_si64(d + i, s[i]);
+            }
+        }
+#else
+        std::memcpy(static_cast<void *>(dst), &src, sizeof(TraceEvent));
+#endif
+    }
+
+    TRACE_API static std::atomic<bool> _nonTemporalStores;
+
     // Points to where the next event should be constructed.
     TraceEvent* _nextEvent;
     _Node* _front;
     _Node* _back;
     size_t _blockSizeBytes;
+    size_t _allocatedBytes;
+    TraceAllocationObserver* _observer;
+
+    SpillFilePtr _spillFile;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
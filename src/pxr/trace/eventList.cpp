@@ -22,7 +22,67 @@ void TraceEventList::Append(TraceEventList&& other)
     // We use splice to keep the keys in the same memory location since the 
     // events reference dynamic key by pointer.
     _caches.splice(_caches.end(), std::move(other._caches));
+    // The spilled events are loaded here so that the lost ones are counted.
+    other.LoadSpilledEvents();
+    if (_events.empty()) {
+        LoadSpilledEvents();
+    }
     _events.Append(std::move(other._events));
+    _dataCache.Append(std::move(other._dataCache));
+    for (const ScopeTallies::value_type& i : other._scopeTallies) {
+        ScopeTally& tally = _scopeTallies[i.first];
+        tally.count += i.second.count;
+        tally.duration += i.second.duration;
+    }
+    other._scopeTallies.clear();
+    // Deltas recorded after the appended events are not coalesced with them.
+    other._pendingCounterDeltas.clear();
+    _droppedEvents += other._droppedEvents;
+    other._droppedEvents = 0;
+}
+
+TraceEventList::MemoryUsage
+TraceEventList::GetMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.eventBytes = _events.GetMemoryUsage();
+    usage.dataBytes = _dataCache.GetMemoryUsage();
+    usage.spilledBytes = _events.GetSpilledBytes();
+
+    // Each key is stored in a node of its set, with the next node and the
+    // hash, and the buckets are an array of pointers. The strings of the
+    // keys are shared with the token registry and not counted.
+    for (const KeyCache& cache : _caches) {
+        usage.keyBytes +=
+            cache.size() * (sizeof(TraceDynamicKey) + 2 * sizeof(void*)) +
+            cache.bucket_count() * sizeof(void*);
+    }
+    return usage;
+}
+
+void
+TraceEventList::SetAllocationObserver(TraceAllocationObserver* observer)
+{
+    _events.SetAllocationObserver(observer);
+    _dataCache.SetAllocationObserver(observer);
+}
+
+size_t
+TraceEventList::DropOldestEvents(size_t eventBytes)
+{
+    // The pending counter deltas may be dropped.
+    ResetCounterDeltas();
+    const size_t numDropped = _events.DropOldestBlocks(eventBytes);
+    _droppedEvents += numDropped;
+    return numDropped;
+}
+
+TraceEventContainer::SpillFilePtr
+TraceEventList::SpillOldestEvents(size_t eventBytes)
+{
+    // The pending counter deltas may be moved to the file.
+    ResetCounterDeltas();
+    return _events.SpillOldestBlocks(eventBytes);
 }
 
  TRACE_NAMESPACE_CLOSE_SCOPE
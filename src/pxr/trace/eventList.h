@@ -14,8 +14,12 @@
 #include "pxr/trace/dynamicKey.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/eventContainer.h"
+#include "pxr/trace/key.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <list>
+#include <unordered_map>
 #include <unordered_set>
 
 TRACE_NAMESPACE_OPEN_SCOPE
@@ -52,6 +56,21 @@ public:
     const_reverse_iterator rend() const { return _events.rend();}
     /// @}
 
+    /// \name Block access
+    /// Calls \p fn with the \c begin and \c end pointers of each contiguous
+    /// block of events. See TraceEventContainer::ForEachBlock.
+    /// @{
+    template <class Fn>
+    void ForEachBlock(Fn&& fn) const {
+        _events.ForEachBlock(std::forward<Fn>(fn));
+    }
+
+    template <class Fn>
+    void ReverseForEachBlock(Fn&& fn) const {
+        _events.ReverseForEachBlock(std::forward<Fn>(fn));
+    }
+    /// @}
+
     /// Returns whether there are any events in the list.
     bool IsEmpty() const { return _events.empty();}
 
@@ -75,6 +94,62 @@ public:
     /// ownership of the events and keys in the appended list.
     TRACE_API void Append(TraceEventList&& other);
 
+    /// The number and total duration of scopes which were not stored as
+    /// events because they were shorter than the minimum scope duration of
+    /// the TraceCollector.
+    struct ScopeTally {
+        uint64_t count = 0;
+        TraceEvent::TimeStamp duration = 0;
+    };
+    using ScopeTallies =
+        std::unordered_map<TraceKey, ScopeTally, TraceKey::HashFunctor>;
+
+    /// Tallies a scope with \p key and \p duration instead of storing an
+    /// event for it. \p key must remain valid for the lifetime of the list.
+    void TallyScope(const TraceKey& key, TraceEvent::TimeStamp duration) {
+        ScopeTally& tally = _scopeTallies[key];
+        ++tally.count;
+        tally.duration += duration;
+    }
+
+    /// Returns the scopes tallied by TallyScope().
+    const ScopeTallies& GetScopeTallies() const { return _scopeTallies; }
+
+    /// Stores a counter delta event with \p key, \p delta and \p cat at the
+    /// current time, unless the last one stored with \p key and \p cat was
+    /// stored less than \p quantum ticks ago, in which case \p delta is
+    /// added to that event instead. \p key must remain valid for the
+    /// lifetime of the list.
+    void CoalesceCounterDelta(const TraceKey& key, double delta,
+        TraceCategoryId cat, TraceEvent::TimeStamp quantum) {
+        const TraceEvent::TimeStamp now = TraceClock::Now();
+        const auto it = _pendingCounterDeltas.find(key);
+        if (it != _pendingCounterDeltas.end()) {
+            TraceEvent* pending = it->second;
+            if (pending->GetCategory() == cat &&
+                    now - pending->GetTimeStamp() < quantum) {
+                pending->_AddToCounterValue(delta);
+                return;
+            }
+        }
+        // The memory limit is enforced once the event is stored, which
+        // releases the oldest events and resets the pending deltas.
+        TraceEvent& event = _events.emplace_back(
+            TraceEvent::CounterDelta, key, delta, cat);
+        event.SetTimeStamp(now);
+        _pendingCounterDeltas[key] = &event;
+    }
+
+    /// Makes the next counter deltas stored by CoalesceCounterDelta() start
+    /// new events, so that they are not summed across a counter value
+    /// stored in between. Keys are compared by address, so this applies to
+    /// every key rather than only to the key of the value.
+    void ResetCounterDeltas() {
+        if (!_pendingCounterDeltas.empty()) {
+            _pendingCounterDeltas.clear();
+        }
+    }
+
     /// Copy data to the buffer and return a pointer to the cached data that is 
     /// valid for the lifetime of the Eventlist.
     template < typename T>
@@ -83,6 +158,63 @@ public:
         return _dataCache.StoreData(value); 
     }
 
+    /// Copies the \p count \p frames of a stack to the buffer and returns
+    /// a pointer which can be used to construct a Sample event.
+    const uintptr_t* StoreStackFrames(const uintptr_t* frames, size_t count) {
+        uintptr_t* data = _dataCache.AllocateArray<uintptr_t>(count + 1);
+        data[0] = count;
+        std::copy(frames, frames + count, data + 1);
+        return data;
+    }
+
+    /// \name Memory limit
+    /// @{
+
+    /// The number of bytes held by a list.
+    struct MemoryUsage {
+        /// The bytes of the blocks of events held in memory.
+        size_t eventBytes = 0;
+        /// An estimate of the bytes of the cached keys.
+        size_t keyBytes = 0;
+        /// The bytes of the blocks of data stored for the events.
+        size_t dataBytes = 0;
+        /// The bytes of the events spilled to a file, which are not held in
+        /// memory.
+        size_t spilledBytes = 0;
+
+        /// Returns the number of bytes held in memory.
+        size_t GetTotal() const { return eventBytes + keyBytes + dataBytes; }
+    };
+
+    /// Returns the number of bytes held by the list.
+    TRACE_API MemoryUsage GetMemoryUsage() const;
+
+    /// Sets the \p observer notified each time the list allocates a block
+    /// of events or data.
+    TRACE_API void SetAllocationObserver(TraceAllocationObserver* observer);
+
+    /// Drops the oldest events until their blocks hold at most \p eventBytes.
+    /// Returns the number of events dropped. See
+    /// TraceEventContainer::DropOldestBlocks().
+    TRACE_API size_t DropOldestEvents(size_t eventBytes);
+
+    /// Detaches the oldest events until their blocks hold at most
+    /// \p eventBytes, to be written by
+    /// TraceEventContainer::WriteSpilledBlocks(). Returns null if an earlier
+    /// write failed. See TraceEventContainer::SpillOldestBlocks().
+    TRACE_API TraceEventContainer::SpillFilePtr
+    SpillOldestEvents(size_t eventBytes);
+
+    /// Reads the spilled events back, which must be done before the events
+    /// of the list are read. The spilled events which could not be written
+    /// or read are counted as dropped.
+    void LoadSpilledEvents() { _droppedEvents += _events.LoadSpilledBlocks(); }
+
+    /// Returns the number of events dropped by DropOldestEvents() or lost
+    /// while spilled, including those of the appended lists.
+    uint64_t GetDroppedEventCount() const { return _droppedEvents; }
+    /// @}
+
 private:
 
     TraceEventContainer _events;
@@ -97,6 +229,15 @@ private:
     std::list<KeyCache> _caches;
 
     TraceDataBuffer _dataCache;
+
+    ScopeTallies _scopeTallies;
+
+    // The last counter delta event stored by CoalesceCounterDelta() for
+    // each key.
+    std::unordered_map<TraceKey, TraceEvent*, TraceKey::HashFunctor>
+        _pendingCounterDeltas;
+
+    uint64_t _droppedEvents = 0;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
@@ -11,6 +11,24 @@
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
+TraceEventNodeRefPtr
+TraceEventNode::New(
+    const TfToken &key,
+    const TraceCategoryId category,
+    const TimeStamp beginTime,
+    const TimeStamp endTime,
+    TraceEventNodeRefPtrVector&& children,
+    const bool separateEvents)
+{
+    TraceEventNodeArenaRefPtr arena = TraceEventNodeArena::New();
+    TraceEventNodeRefPtr node = New(arena,
+        arena->AddNode(key, category, beginTime, endTime, separateEvents));
+    for (const TraceEventNodeRefPtr& c : children) {
+        node->Append(c);
+    }
+    return node;
+}
+
 TraceEventNodeRefPtr
 TraceEventNode::Append(
     const TfToken &key, 
@@ -19,43 +37,87 @@ TraceEventNode::Append(
     TimeStamp endTime,
     bool separateEvents)
 {
-    TraceEventNodeRefPtr n = 
-        TraceEventNode::New(
-            key, category, beginTime, endTime, {}, separateEvents);
-    _children.push_back(n);
-    return n;
+    std::lock_guard<std::mutex> lock(_mutex);
+    const bool childrenUpToDate = _childrenVersion == _arena->GetVersion();
+    const Index child =
+        _arena->AddNode(key, category, beginTime, endTime, separateEvents);
+    TraceEventNodeRefPtr node = New(_arena, child);
+    _AppendChild(node, childrenUpToDate);
+    return node;
 }
 
 void
 TraceEventNode::Append(TraceEventNodeRefPtr node)
 {
-    _children.push_back(node);
+    // Nodes of the same arena with no parent are linked rather than copied,
+    // unless they are the root of this node.
+    bool link = node->_arena == _arena &&
+        _arena->GetParent(node->_index) == TraceEventNodeArena::InvalidIndex;
+    for (Index i = _index; link && i != TraceEventNodeArena::InvalidIndex;
+            i = _arena->GetParent(i)) {
+        link = i != node->_index;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    const bool childrenUpToDate = _childrenVersion == _arena->GetVersion();
+    if (link) {
+        _AppendChild(node, childrenUpToDate);
+    } else {
+        _AppendChild(New(_arena,
+            _arena->CopySubtree(*node->_arena, node->_index)),
+            childrenUpToDate);
+    }
 }
 
-void 
-TraceEventNode::SetBeginAndEndTimesFromChildren()
+void
+TraceEventNode::_AppendChild(
+    const TraceEventNodeRefPtr& node, bool childrenUpToDate)
 {
-    if (_children.empty()) {
-        _beginTime = 0;
-        _endTime = 0;
-        return;
+    // Keep the views of the children up to date if they were, so that they
+    // include node itself.
+    _arena->AppendChild(_index, node->_index);
+    if (childrenUpToDate) {
+        _children.push_back(node);
+        _childrenVersion = _arena->GetVersion();
     }
+}
 
-    _beginTime = std::numeric_limits<TimeStamp>::max();
-    _endTime   = std::numeric_limits<TimeStamp>::min();
-
-    for (const TraceEventNodeRefPtr& c : _children) {
-        _beginTime = std::min(_beginTime, c->GetBeginTime());
-        _endTime   = std::max(_endTime, c->GetEndTime());
+const TraceEventNodeRefPtrVector&
+TraceEventNode::GetChildrenRef() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_childrenVersion != _arena->GetVersion()) {
+        TraceEventNodeRefPtrVector children;
+        size_t i = 0;
+        for (Index c = _arena->GetFirstChild(_index);
+                c != TraceEventNodeArena::InvalidIndex;
+                c = _arena->GetNextSibling(c), ++i) {
+            // Keep the views which were already created.
+            if (i < _children.size() && _children[i]->_index == c) {
+                children.push_back(_children[i]);
+            } else {
+                children.push_back(New(_arena, c));
+            }
+        }
+        _children = std::move(children);
+        _childrenVersion = _arena->GetVersion();
     }
-
+    return _children;
 }
 
-void
-TraceEventNode::AddAttribute(
-    const TfToken& key, const AttributeData& attr)
+const TraceEventNode::AttributeMap&
+TraceEventNode::GetAttributes() const
 {
-    _attributes.emplace(key, attr);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_attributesVersion != _arena->GetVersion()) {
+        _attributes.clear();
+        const uint32_t end = _arena->GetAttributesEnd(_index);
+        for (uint32_t a = _arena->GetAttributesBegin(_index); a < end; ++a) {
+            _attributes.emplace(
+                _arena->GetAttributeKey(a), _arena->GetAttributeData(a));
+        }
+        _attributesVersion = _arena->GetVersion();
+    }
+    return _attributes;
 }
 
-TRACE_NAMESPACE_CLOSE_SCOPE
\ No newline at end of file
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -13,12 +13,15 @@
 #include "pxr/trace/api.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/eventData.h"
+#include "pxr/trace/eventNodeArena.h"
 
 #include <pxr/tf/refBase.h>
 #include <pxr/tf/refPtr.h>
 #include <pxr/tf/token.h>
 #include <pxr/tf/declarePtrs.h>
 
+#include <map>
+#include <mutex>
 #include <vector>
 
 TRACE_NAMESPACE_OPEN_SCOPE
@@ -32,6 +35,12 @@ TF_DECLARE_REF_PTRS(TraceEventNode);
 /// represents a Begin-End trace event pair, or a single Timespan event. This is
 /// useful for timeline views of a trace.
 ///
+/// A TraceEventNode is a view of a node of a TraceEventNodeArena, which holds
+/// the data of the node and of the rest of its tree. Views of the children
+/// and the map of attributes of a node are only created when they are
+/// requested. Code which traverses large trees should use the arena
+/// directly.
+///
 
 class TraceEventNode : public TfRefBase {
 public:
@@ -39,6 +48,7 @@ public:
     using TimeStamp = TraceEvent::TimeStamp;
     using AttributeData = TraceEventData;
     using AttributeMap = std::multimap<TfToken, AttributeData>;
+    using Index = TraceEventNodeArena::Index;
 
     /// Creates a new root node.
     ///
@@ -49,51 +59,53 @@ public:
 
     /// Creates a new node with \p key, \p category, \p beginTime and 
     /// \p endTime.
-    static TraceEventNodeRefPtr New(const TfToken &key,
+    TRACE_API static TraceEventNodeRefPtr New(const TfToken &key,
                           const TraceCategoryId category,
                           const TimeStamp beginTime,
                           const TimeStamp endTime,
                           TraceEventNodeRefPtrVector&& children,
-                          const bool separateEvents) {
-        return TfCreateRefPtr(
-            new TraceEventNode(
-                key,
-                category,
-                beginTime,
-                endTime,
-                std::move(children),
-                separateEvents));
+                          const bool separateEvents);
+
+    /// Creates a view of node \p index of \p arena.
+    static TraceEventNodeRefPtr New(
+        const TraceEventNodeArenaRefPtr& arena, Index index) {
+        return TfCreateRefPtr(new TraceEventNode(arena, index));
     }
 
     /// Appends a new child node with \p key, \p category, \p beginTime and 
     /// \p endTime.
-    TraceEventNodeRefPtr Append(const TfToken &key, 
+    TRACE_API TraceEventNodeRefPtr Append(const TfToken &key, 
                                       TraceCategoryId category,
                                       TimeStamp beginTime,
                                       TimeStamp endTime,
                                       bool separateEvents);
 
-    /// Appends \p node as a child node.
-    void Append(TraceEventNodeRefPtr node);
+    /// Appends \p node as a child node. If \p node belongs to another arena,
+    /// or already has a parent, a copy of it and its descendants is appended.
+    TRACE_API void Append(TraceEventNodeRefPtr node);
 
     /// Returns the name of this node.
-    TfToken GetKey() { return _key;}
+    TfToken GetKey() const { return _arena->GetKey(_index); }
 
     /// Returns the category of this node.
-    TraceCategoryId GetCategory() const { return _category; }
+    TraceCategoryId GetCategory() const {
+        return _arena->GetCategory(_index);
+    }
 
     /// Sets this node's begin and end time to the time extents of its direct 
     /// children.
-    void SetBeginAndEndTimesFromChildren();
+    void SetBeginAndEndTimesFromChildren() {
+        _arena->SetBeginAndEndTimesFromChildren(_index);
+    }
 
     /// \name Profile Data Accessors
     /// @{
 
     /// Returns the time that this scope started.
-    TimeStamp GetBeginTime() { return _beginTime; }
+    TimeStamp GetBeginTime() const { return _arena->GetBeginTime(_index); }
 
     /// Returns the time that this scope ended.
-    TimeStamp GetEndTime()   { return _endTime; }
+    TimeStamp GetEndTime() const { return _arena->GetEndTime(_index); }
 
     /// @}
 
@@ -101,51 +113,58 @@ public:
     /// @{
 
     /// Returns references to the children of this node.
-    const TraceEventNodeRefPtrVector &GetChildrenRef() {
-        return _children;
-    }
+    TRACE_API const TraceEventNodeRefPtrVector &GetChildrenRef() const;
 
     /// @}
 
     /// Return the data associated with this node.
-    const AttributeMap& GetAttributes() const { return _attributes; }
+    TRACE_API const AttributeMap& GetAttributes() const;
 
     /// Add data to this node.
-    void AddAttribute(const TfToken& key, const AttributeData& attr);
+    void AddAttribute(const TfToken& key, const AttributeData& attr) {
+        _arena->AddAttribute(_index, key, attr);
+    }
 
     /// Returns whether this node was created from a Begin-End pair or a single
     /// Timespan event.
     bool IsFromSeparateEvents() const {
-        return _fromSeparateEvents;
+        return _arena->IsFromSeparateEvents(_index);
     }
 
+    /// Returns the arena which holds the data of this node.
+    const TraceEventNodeArenaRefPtr& GetArena() const { return _arena; }
+
+    /// Returns the index of this node in its arena.
+    Index GetIndex() const { return _index; }
+
 private:
 
-    TraceEventNode(
-        const TfToken &key,
-        TraceCategoryId category,
-        TimeStamp beginTime, 
-        TimeStamp endTime,
-        TraceEventNodeRefPtrVector&& children,
-        bool separateEvents)
-
-        : _key(key)
-        , _category(category)
-        , _beginTime(beginTime)
-        , _endTime(endTime)
-        , _children(std::move(children))
-        , _fromSeparateEvents(separateEvents)
-    {}
-
-
-    TfToken _key;
-    TraceCategoryId _category;
-    TimeStamp _beginTime;
-    TimeStamp _endTime;
-    TraceEventNodeRefPtrVector _children;
-    bool _fromSeparateEvents;
-
-    AttributeMap _attributes;
+    TraceEventNode(const TraceEventNodeArenaRefPtr& arena, Index index)
+        : _arena(arena)
+        , _index(index)
+    {
+        // The views of the children of a leaf are already up to date.
+        if (_arena->GetFirstChild(_index) ==
+                TraceEventNodeArena::InvalidIndex) {
+            _childrenVersion = _arena->GetVersion();
+        }
+    }
+
+    // Links node, which belongs to the arena of this node, as the last
+    // child of this node. The caller must hold _mutex.
+    void _AppendChild(
+        const TraceEventNodeRefPtr& node, bool childrenUpToDate);
+
+    TraceEventNodeArenaRefPtr _arena;
+    Index _index;
+
+    // Views of the children and map of attributes, created on demand and
+    // updated when the arena changes.
+    mutable std::mutex _mutex;
+    mutable TraceEventNodeRefPtrVector _children;
+    mutable AttributeMap _attributes;
+    mutable size_t _childrenVersion = size_t(-1);
+    mutable size_t _attributesVersion = size_t(-1);
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,184 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/eventNodeArena.h"
+
+#include "pxr/trace/pxr.h"
+
+#include <pxr/tf/diagnostic.h>
+
+#include <algorithm>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TraceEventNodeArena::KeyId
+TraceEventNodeArena::_GetKeyId(const TfToken& key)
+{
+    const auto it = _keyIdsByKey.emplace(key, KeyId(_keys.size())).first;
+    if (it->second == _keys.size()) {
+        _keys.push_back(key);
+    }
+    return it->second;
+}
+
+TraceEventNodeArena::Index
+TraceEventNodeArena::AddNode(
+    const TfToken& key,
+    TraceCategoryId category,
+    TimeStamp beginTime,
+    TimeStamp endTime,
+    bool separateEvents)
+{
+    if (!TF_VERIFY(_keyIds.size() < InvalidIndex)) {
+        return InvalidIndex;
+    }
+
+    const Index index = Index(_keyIds.size());
+    _keyIds.push_back(_GetKeyId(key));
+    _categories.push_back(category);
+    _beginTimes.push_back(beginTime);
+    _endTimes.push_back(endTime);
+    _parents.push_back(InvalidIndex);
+    _firstChildren.push_back(InvalidIndex);
+    _lastChildren.push_back(InvalidIndex);
+    _nextSiblings.push_back(InvalidIndex);
+    _attributesBegins.push_back(uint32_t(_attributeData.size()));
+    _attributesEnds.push_back(uint32_t(_attributeData.size()));
+    _separateEvents.push_back(separateEvents);
+    ++_version;
+    return index;
+}
+
+void
+TraceEventNodeArena::AppendChild(Index parent, Index child)
+{
+    if (!TF_VERIFY(parent < GetSize() && child < GetSize()) ||
+        !TF_VERIFY(_parents[child] == InvalidIndex &&
+                   _nextSiblings[child] == InvalidIndex)) {
+        return;
+    }
+
+    _parents[child] = parent;
+    if (_lastChildren[parent] == InvalidIndex) {
+        _firstChildren[parent] = child;
+    } else {
+        _nextSiblings[_lastChildren[parent]] = child;
+    }
+    _lastChildren[parent] = child;
+    ++_version;
+}
+
+void
+TraceEventNodeArena::_SetChildren(Index node, Index first, Index last)
+{
+    _firstChildren[node] = first;
+    _lastChildren[node] = last;
+    for (Index c = first; c != InvalidIndex; c = _nextSiblings[c]) {
+        _parents[c] = node;
+    }
+    ++_version;
+}
+
+TraceEventNodeArena::Index
+TraceEventNodeArena::CopySubtree(const TraceEventNodeArena& arena, Index node)
+{
+    if (!TF_VERIFY(node < arena.GetSize())) {
+        return InvalidIndex;
+    }
+
+    // Maps the key ids of arena to the key ids of this arena.
+    std::vector<KeyId> keyIds(arena._keys.size(), KeyId(-1));
+    auto getKeyId = [&](KeyId keyId) {
+        if (keyIds[keyId] == KeyId(-1)) {
+            keyIds[keyId] = _GetKeyId(arena._keys[keyId]);
+        }
+        return keyIds[keyId];
+    };
+
+    // The copies of the ancestors of the node being copied, up to the copy
+    // of node.
+    std::vector<std::pair<Index, Index>> parents;
+    Index result = InvalidIndex;
+    arena.ForEachInSubtree(node, [&](Index i) {
+        // The source node may be in this arena, so its fields are read
+        // before any column grows.
+        const TfToken key = arena._keys[arena._keyIds[i]];
+        const Index parent = arena._parents[i];
+        const uint32_t attributesBegin = arena._attributesBegins[i];
+        const uint32_t attributesEnd = arena._attributesEnds[i];
+
+        const Index copy = AddNode(key, arena._categories[i],
+            arena._beginTimes[i], arena._endTimes[i],
+            arena._separateEvents[i]);
+        for (uint32_t a = attributesBegin; a < attributesEnd; ++a) {
+            _attributeKeyIds.push_back(getKeyId(arena._attributeKeyIds[a]));
+            _attributeData.push_back(arena._attributeData[a]);
+        }
+        _attributesEnds[copy] = uint32_t(_attributeData.size());
+
+        if (i == node) {
+            result = copy;
+        } else {
+            while (parents.back().first != parent) {
+                parents.pop_back();
+            }
+            AppendChild(parents.back().second, copy);
+        }
+        parents.emplace_back(i, copy);
+    });
+    return result;
+}
+
+void
+TraceEventNodeArena::AddAttribute(
+    Index node, const TfToken& key, const AttributeData& data)
+{
+    if (!TF_VERIFY(node < GetSize())) {
+        return;
+    }
+
+    // The attributes of a node are contiguous, so they are moved to the end
+    // of the columns unless they are there already.
+    const uint32_t begin = _attributesBegins[node];
+    const uint32_t end = _attributesEnds[node];
+    if (end != _attributeData.size()) {
+        _attributesBegins[node] = uint32_t(_attributeData.size());
+        for (uint32_t a = begin; a < end; ++a) {
+            _attributeKeyIds.push_back(_attributeKeyIds[a]);
+            _attributeData.push_back(_attributeData[a]);
+        }
+    }
+    _attributeKeyIds.push_back(_GetKeyId(key));
+    _attributeData.push_back(data);
+    _attributesEnds[node] = uint32_t(_attributeData.size());
+    ++_version;
+}
+
+void
+TraceEventNodeArena::SetBeginAndEndTimesFromChildren(Index node)
+{
+    if (!TF_VERIFY(node < GetSize())) {
+        return;
+    }
+
+    if (_firstChildren[node] == InvalidIndex) {
+        _beginTimes[node] = 0;
+        _endTimes[node] = 0;
+        return;
+    }
+
+    TimeStamp beginTime = std::numeric_limits<TimeStamp>::max();
+    TimeStamp endTime = std::numeric_limits<TimeStamp>::min();
+    for (Index c = _firstChildren[node]; c != InvalidIndex;
+            c = _nextSiblings[c]) {
+        beginTime = std::min(beginTime, _beginTimes[c]);
+        endTime = std::max(endTime, _endTimes[c]);
+    }
+    _beginTimes[node] = beginTime;
+    _endTimes[node] = endTime;
+    ++_version;
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,192 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_EVENT_NODE_ARENA_H
+#define PXR_TRACE_EVENT_NODE_ARENA_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/category.h"
+#include "pxr/trace/event.h"
+#include "pxr/trace/eventData.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/refPtr.h>
+#include <pxr/tf/token.h>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+class Trace_EventTreeBuilder;
+
+TF_DECLARE_REF_PTRS(TraceEventNodeArena);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceEventNodeArena
+///
+/// This class stores the nodes of a TraceEventTree as a table with one column
+/// per field, rather than as one heap object per node. Nodes are identified
+/// by their index in the table, and are linked to their parent, first and
+/// last children and next sibling by index. The attributes of each node are
+/// a contiguous range of the attribute columns, and keys are stored once
+/// and referenced by id.
+///
+/// Building, traversing and destroying a tree therefore only touches a few
+/// large arrays, no matter how many nodes it has. TraceEventNode instances
+/// are views of the nodes of an arena.
+///
+class TraceEventNodeArena : public TfRefBase {
+public:
+    using Index = uint32_t;
+    using KeyId = uint32_t;
+    using TimeStamp = TraceEvent::TimeStamp;
+    using AttributeData = TraceEventData;
+
+    /// The index of missing nodes, e.g. the parent of a root node.
+    static constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
+
+    /// Creates an empty arena.
+    static TraceEventNodeArenaRefPtr New() {
+        return TfCreateRefPtr(new TraceEventNodeArena());
+    }
+
+    /// \name Construction
+    /// @{
+
+    /// Adds a node with no parent and returns its index.
+    TRACE_API Index AddNode(
+        const TfToken& key,
+        TraceCategoryId category,
+        TimeStamp beginTime,
+        TimeStamp endTime,
+        bool separateEvents);
+
+    /// Makes \p child, which must have no parent, the last child of
+    /// \p parent.
+    TRACE_API void AppendChild(Index parent, Index child);
+
+    /// Copies \p node of \p arena and its descendants to this arena, and
+    /// returns the index of the copy of \p node, which has no parent.
+    TRACE_API Index CopySubtree(const TraceEventNodeArena& arena, Index node);
+
+    /// Adds an attribute to \p node.
+    TRACE_API void AddAttribute(
+        Index node, const TfToken& key, const AttributeData& data);
+
+    /// Sets the begin and end times of \p node to the time extents of its
+    /// direct children, or to 0 if it has none.
+    TRACE_API void SetBeginAndEndTimesFromChildren(Index node);
+
+    /// @}
+
+    /// Returns the number of nodes.
+    size_t GetSize() const { return _keyIds.size(); }
+
+    /// Returns a number which changes every time the arena is modified.
+    size_t GetVersion() const { return _version; }
+
+    /// \name Node accessors
+    /// @{
+
+    KeyId GetKeyId(Index node) const { return _keyIds[node]; }
+    const TfToken& GetKey(Index node) const { return _keys[_keyIds[node]]; }
+    TraceCategoryId GetCategory(Index node) const {
+        return _categories[node];
+    }
+    TimeStamp GetBeginTime(Index node) const { return _beginTimes[node]; }
+    TimeStamp GetEndTime(Index node) const { return _endTimes[node]; }
+    bool IsFromSeparateEvents(Index node) const {
+        return _separateEvents[node];
+    }
+
+    Index GetParent(Index node) const { return _parents[node]; }
+    Index GetFirstChild(Index node) const { return _firstChildren[node]; }
+    Index GetLastChild(Index node) const { return _lastChildren[node]; }
+    Index GetNextSibling(Index node) const { return _nextSiblings[node]; }
+
+    /// Returns the range of the attribute columns which holds the attributes
+    /// of \p node, in the order they were added.
+    uint32_t GetAttributesBegin(Index node) const {
+        return _attributesBegins[node];
+    }
+    uint32_t GetAttributesEnd(Index node) const {
+        return _attributesEnds[node];
+    }
+
+    const TfToken& GetAttributeKey(uint32_t attribute) const {
+        return _keys[_attributeKeyIds[attribute]];
+    }
+    const AttributeData& GetAttributeData(uint32_t attribute) const {
+        return _attributeData[attribute];
+    }
+
+    /// Returns the key of id \p keyId.
+    const TfToken& GetKeyFromId(KeyId keyId) const { return _keys[keyId]; }
+
+    /// @}
+
+    /// Calls \p fn with \p node and each of its descendants, parents before
+    /// their children and children in order.
+    template <class Fn>
+    void ForEachInSubtree(Index node, Fn&& fn) const {
+        Index i = node;
+        while (true) {
+            fn(i);
+            if (_firstChildren[i] != InvalidIndex) {
+                i = _firstChildren[i];
+                continue;
+            }
+            while (i != node && _nextSiblings[i] == InvalidIndex) {
+                i = _parents[i];
+            }
+            if (i == node) {
+                return;
+            }
+            i = _nextSiblings[i];
+        }
+    }
+
+private:
+    TraceEventNodeArena() = default;
+
+    KeyId _GetKeyId(const TfToken& key);
+
+    // Links the list of siblings from first to last as the children of node.
+    void _SetChildren(Index node, Index first, Index last);
+
+    friend class Trace_EventTreeBuilder;
+
+    std::vector<TfToken> _keys;
+    std::unordered_map<TfToken, KeyId, TfToken::HashFunctor> _keyIdsByKey;
+
+    // Node columns.
+    std::vector<KeyId> _keyIds;
+    std::vector<TraceCategoryId> _categories;
+    std::vector<TimeStamp> _beginTimes;
+    std::vector<TimeStamp> _endTimes;
+    std::vector<Index> _parents;
+    std::vector<Index> _firstChildren;
+    std::vector<Index> _lastChildren;
+    std::vector<Index> _nextSiblings;
+    std::vector<uint32_t> _attributesBegins;
+    std::vector<uint32_t> _attributesEnds;
+    std::vector<bool> _separateEvents;
+
+    // Attribute columns.
+    std::vector<KeyId> _attributeKeyIds;
+    std::vector<AttributeData> _attributeData;
+
+    size_t _version = 0;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_EVENT_NODE_ARENA_H
@@ -0,0 +1,86 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_EVENT_TABLE_H
+#define PXR_TRACE_EVENT_TABLE_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/category.h"
+#include "pxr/trace/event.h"
+
+#include <pxr/tf/token.h>
+
+#include <cstdint>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+class TraceEventTree;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceEventTable
+///
+/// This class holds the events of a TraceEventTree as a table with one row
+/// per event and one contiguous column per field, for tools which analyze
+/// whole traces rather than walking the tree node by node.
+///
+/// Rows are in depth first order, so the parent of an event always comes
+/// before it. Keys are stored once, and the key and thread columns hold
+/// indices into the key table.
+///
+class TraceEventTable {
+public:
+    using KeyId = uint32_t;
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    /// Creates a table of the events of \p tree.
+    TRACE_API explicit TraceEventTable(const TraceEventTree& tree);
+
+    /// Returns the number of rows.
+    size_t GetSize() const { return _keyIds.size(); }
+
+    /// Returns the keys and thread names referenced by the table.
+    const std::vector<TfToken>& GetKeys() const { return _keys; }
+
+    /// Returns the id of the name of the thread of each event.
+    const std::vector<KeyId>& GetThreadIds() const { return _threadIds; }
+
+    /// Returns the id of the key of each event.
+    const std::vector<KeyId>& GetKeyIds() const { return _keyIds; }
+
+    /// Returns the begin time of each event, in ticks.
+    const std::vector<TimeStamp>& GetBeginTimes() const { return _beginTimes; }
+
+    /// Returns the end time of each event, in ticks.
+    const std::vector<TimeStamp>& GetEndTimes() const { return _endTimes; }
+
+    /// Returns the depth of each event in its thread, starting from 0.
+    const std::vector<uint32_t>& GetDepths() const { return _depths; }
+
+    /// Returns the row of the parent of each event, or -1 for the events at
+    /// depth 0.
+    const std::vector<int64_t>& GetParents() const { return _parents; }
+
+    /// Returns the category of each event.
+    const std::vector<TraceCategoryId>& GetCategories() const {
+        return _categories;
+    }
+
+private:
+    std::vector<TfToken> _keys;
+    std::vector<KeyId> _threadIds;
+    std::vector<KeyId> _keyIds;
+    std::vector<TimeStamp> _beginTimes;
+    std::vector<TimeStamp> _endTimes;
+    std::vector<uint32_t> _depths;
+    std::vector<int64_t> _parents;
+    std::vector<TraceCategoryId> _categories;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_EVENT_TABLE_H
@@ -13,6 +13,11 @@
 
 #include <pxr/js/json.h>
 
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 TRACE_NAMESPACE_OPEN_SCOPE
 
 TraceEventTreeRefPtr
@@ -40,35 +45,44 @@ TraceEventTree::Add(const TraceCollection& collection)
 void
 TraceEventTree::Merge(const TraceEventTreeRefPtr& tree)
 {
-    // Add the node to the tree.
-    for(TraceEventNodeRefPtr newThreadNode 
-            : tree->GetRoot()->GetChildrenRef()) {
+    using Index = TraceEventNodeArena::Index;
+    constexpr Index InvalidIndex = TraceEventNodeArena::InvalidIndex;
+
+    TraceEventNodeArena& arena = *_root->GetArena();
+    const TraceEventNodeArena& other = tree->GetNodeArena();
+    const Index root = _root->GetIndex();
 
-        const TraceEventNodeRefPtrVector& threadNodes =
-            _root->GetChildrenRef();
+    // Add the node to the tree.
+    for (Index newThreadNode = other.GetFirstChild(tree->GetRootIndex());
+            newThreadNode != InvalidIndex;
+            newThreadNode = other.GetNextSibling(newThreadNode)) {
 
         // Find if the tree already has a node for child thread.
-        auto it = std::find_if(
-                threadNodes.begin(), 
-                threadNodes.end(), 
-                [&](const TraceEventNodeRefPtr& node) {
-                    return node->GetKey() == newThreadNode->GetKey();
-                });
+        const TfToken& threadKey = other.GetKey(newThreadNode);
+        Index threadNode = arena.GetFirstChild(root);
+        while (threadNode != InvalidIndex &&
+               arena.GetKey(threadNode) != threadKey) {
+            threadNode = arena.GetNextSibling(threadNode);
+        }
 
-        if (it != threadNodes.end()) {
+        if (threadNode != InvalidIndex) {
             // Add the nodes thread children from child into the current tree.
-            for(TraceEventNodeRefPtr threadChild 
-                    : newThreadNode->GetChildrenRef()) {
-                (*it)->Append(threadChild);
+            for (Index threadChild = other.GetFirstChild(newThreadNode);
+                    threadChild != InvalidIndex;
+                    threadChild = other.GetNextSibling(threadChild)) {
+                arena.AppendChild(
+                    threadNode, arena.CopySubtree(other, threadChild));
             }
             // Update the thread times from the newly added children.
-            (*it)->SetBeginAndEndTimesFromChildren();
+            arena.SetBeginAndEndTimesFromChildren(threadNode);
         } else {
             // Add the thread if it wasn't already in the tree.
-            _root->Append(newThreadNode);
+            arena.AppendChild(root, arena.CopySubtree(other, newThreadNode));
         }
     }
 
+    _threadIds.insert(tree->_threadIds.begin(), tree->_threadIds.end());
+
     // Add the counter data.
     for (CounterValuesMap::value_type& p : tree->_counters) {
         CounterValuesMap::iterator it = _counters.find(p.first);
@@ -114,86 +128,119 @@ _TimeStampToChromeTraceValue(TraceEvent::TimeStamp t)
     return ArchTicksToNanoseconds(t)/1000.0;
 }
 
-// Recursively writes JSON objects representing call tree nodes to the array.
+// Returns the comma separated names of the categories of \p category.
+static
+const std::string&
+TraceEventTree_GetCategoryList(
+    TraceCategoryId category,
+    std::unordered_map<TraceCategoryId, std::string>* categoryLists)
+{
+    auto it = categoryLists->find(category);
+    if (it == categoryLists->end()) {
+        std::string categoryList("");
+        std::vector<std::string> catList = 
+            TraceCategory::GetInstance().GetCategories(category);
+        for (const std::string& catName : catList) {
+            if (categoryList.length() > 0) {
+                categoryList.append(",");
+            }
+            categoryList.append(catName);
+        }
+        it = categoryLists->emplace(category, std::move(categoryList)).first;
+    }
+    return it->second;
+}
+
+// Writes JSON objects representing the call tree nodes of the subtree of
+// \p root to the array.
 static 
 void TraceEventTree_WriteToJsonArray(
-    const TraceEventNodeRefPtr &node,
+    const TraceEventNodeArena& arena,
+    const TraceEventNodeArena::Index root,
     const int pid,
     const TraceThreadId& threadId,
+    std::unordered_map<TraceCategoryId, std::string>* categoryLists,
     JsWriter& js)
 {
-    std::string categoryList("");
-
-    // Add begin time
-    std::vector<std::string> catList = 
-        TraceCategory::GetInstance().GetCategories(node->GetCategory());
-    for (const std::string& catName : catList) {
-        if (categoryList.length() > 0) {
-            categoryList.append(",");
-        }
-        categoryList.append(catName);
-    }
-    auto writeCommonEventData = [&]() {
-        js.BeginObject();
-        js.WriteKeyValue("cat", categoryList);
-        js.WriteKeyValue("libTraceCatId",
-            static_cast<uint64_t>(node->GetCategory()));
-        js.WriteKeyValue("pid",pid);
-        js.WriteKeyValue("tid",threadId.ToString());
-        js.WriteKeyValue("name",node->GetKey().GetString());
-    };
-    writeCommonEventData();
-    js.WriteKeyValue("ts", _TimeStampToChromeTraceValue(node->GetBeginTime()));
-
-    if (!node->GetAttributes().empty()) {
-        js.WriteKey("args");
-        js.BeginObject();
-        
-        using AttributeMap = TraceEventNode::AttributeMap;
-        std::unordered_set<TfToken, TfToken::HashFunctor> visitedKeys;
-        for (const AttributeMap::value_type& it : node->GetAttributes()) {
-            if (visitedKeys.find(it.first) == visitedKeys.end()) {
-                visitedKeys.insert(it.first);
-                using AttrItr = AttributeMap::const_iterator;
-                using Range = std::pair<AttrItr,AttrItr>;
-                Range range = node->GetAttributes().equal_range(it.first);
-                if (std::distance(range.first, range.second) == 1) {
-                    js.WriteKey(range.first->first.GetString());
-                    range.first->second.WriteJson(js);
+    using Index = TraceEventNodeArena::Index;
+
+    // The attributes of a node, in the order of an AttributeMap.
+    std::vector<uint32_t> attributes;
+
+    arena.ForEachInSubtree(root, [&](Index node) {
+        const std::string& categoryList = TraceEventTree_GetCategoryList(
+            arena.GetCategory(node), categoryLists);
+        auto writeCommonEventData = [&]() {
+            js.BeginObject();
+            js.WriteKeyValue("cat", categoryList);
+            js.WriteKeyValue("libTraceCatId",
+                static_cast<uint64_t>(arena.GetCategory(node)));
+            js.WriteKeyValue("pid",pid);
+            js.WriteKeyValue("tid",threadId.ToString());
+            js.WriteKeyValue("name",arena.GetKey(node).GetString());
+        };
+        writeCommonEventData();
+        js.WriteKeyValue("ts",
+            _TimeStampToChromeTraceValue(arena.GetBeginTime(node)));
+
+        const uint32_t attributesBegin = arena.GetAttributesBegin(node);
+        const uint32_t attributesEnd = arena.GetAttributesEnd(node);
+        if (attributesBegin != attributesEnd) {
+            js.WriteKey("args");
+            js.BeginObject();
+
+            attributes.clear();
+            for (uint32_t a = attributesBegin; a < attributesEnd; ++a) {
+                attributes.push_back(a);
+            }
+            std::stable_sort(attributes.begin(), attributes.end(),
+                [&arena](uint32_t a, uint32_t b) {
+                    return arena.GetAttributeKey(a) <
+                        arena.GetAttributeKey(b);
+                });
+
+            // Attributes with the same key are written as an array.
+            for (size_t i = 0; i < attributes.size();) {
+                const TfToken& key = arena.GetAttributeKey(attributes[i]);
+                size_t end = i + 1;
+                while (end < attributes.size() &&
+                       arena.GetAttributeKey(attributes[end]) == key) {
+                    ++end;
+                }
+                js.WriteKey(key.GetString());
+                if (end - i == 1) {
+                    arena.GetAttributeData(attributes[i]).WriteJson(js);
                 } else {
-                    js.WriteKey(it.first.GetString());
-                    js.WriteArray(range.first, range.second,
-                        [](JsWriter& js, AttrItr i) {
-                            i->second.WriteJson(js);
+                    js.WriteArray(
+                        attributes.begin() + i, attributes.begin() + end,
+                        [&arena](JsWriter& js,
+                            std::vector<uint32_t>::const_iterator a) {
+                            arena.GetAttributeData(*a).WriteJson(js);
                         }
                     );
                 }
+                i = end;
             }
+            js.EndObject();
         }
-        js.EndObject();
-    }
 
-    if (!node->IsFromSeparateEvents()) 
-    {
-        js.WriteKeyValue("ph","X"); // Complete event
-        js.WriteKeyValue("dur",_TimeStampToChromeTraceValue(
-            node->GetEndTime() - node->GetBeginTime()));
-        js.EndObject();
-    } else {
-        js.WriteKeyValue("ph","B"); // begin event
-        js.EndObject();
-        
-        writeCommonEventData();
-        js.WriteKeyValue("ph","E"); // end event
-        js.WriteKeyValue("ts",
-            _TimeStampToChromeTraceValue(node->GetEndTime()));
-        js.EndObject();
-    }
-
-    // Recurse on the children
-    for (const TraceEventNodeRefPtr& c : node->GetChildrenRef()) {
-        TraceEventTree_WriteToJsonArray(c, pid, threadId, js);
-    }
+        if (!arena.IsFromSeparateEvents(node)) 
+        {
+            js.WriteKeyValue("ph","X"); // Complete event
+            js.WriteKeyValue("dur",_TimeStampToChromeTraceValue(
+                arena.GetEndTime(node) - arena.GetBeginTime(node)));
+            js.EndObject();
+        } else {
+            js.WriteKeyValue("ph","B"); // begin event
+            js.EndObject();
+            
+            writeCommonEventData();
+            js.WriteKeyValue("ph","E"); // end event
+            js.WriteKeyValue("ts",
+                _TimeStampToChromeTraceValue(arena.GetEndTime(node)));
+            js.EndObject();
+        }
+    });
 }
 
 // Writes Chrome counter events to the events array.
@@ -238,7 +285,8 @@ void TraceEventTree_WriteMarkers(
             js.WriteObject(
                 "cat", "",
                 "tid", v.second.ToString(),
-                "pid", pid,
+                "pid", v.second.GetProcessId() != 0 
+                    ? v.second.GetProcessId() : pid,
                 "name", m.first.GetString(),
                 "ph", "I", // Mark
                 "s", "t", // Scope
@@ -251,27 +299,59 @@ void TraceEventTree_WriteMarkers(
 void 
 TraceEventTree::WriteChromeTraceObject(
     JsWriter& writer, ExtraFieldFn extraFields) const
+{
+    WriteChromeTraceObject(
+        writer, TraceCounterDownsampler(), std::move(extraFields));
+}
+
+void
+TraceEventTree::WriteChromeTraceObject(
+    JsWriter& writer,
+    const TraceCounterDownsampler& downsampler,
+    ExtraFieldFn extraFields) const
 {
     writer.BeginObject();
     writer.WriteKey("traceEvents");
     writer.BeginArray();
 
-    // Chrome Trace format has a pid for each event.  We use a dummy pid.
-    const int pid = 0;
+    // Chrome Trace format has a pid for each event. Threads which do not
+    // belong to another process are written with the id of this process.
+    // Counters are written with the id of this process, since they are 
+    // accumulated across all the threads of the tree.
+    const int pid = TraceGetProcessId();
 
-    for (const TraceEventNodeRefPtr& c : _root->GetChildrenRef()) {
-        // The children of the root represent threads
-        TraceThreadId threadId(c->GetKey().GetString());
+    using Index = TraceEventNodeArena::Index;
+    constexpr Index InvalidIndex = TraceEventNodeArena::InvalidIndex;
+    const TraceEventNodeArena& arena = GetNodeArena();
+    std::unordered_map<TraceCategoryId, std::string> categoryLists;
 
-        for (const TraceEventNodeRefPtr& gc :c->GetChildrenRef()) {
+    for (Index c = arena.GetFirstChild(GetRootIndex()); c != InvalidIndex;
+            c = arena.GetNextSibling(c)) {
+        // The children of the root represent threads
+        const TfToken& threadKey = arena.GetKey(c);
+        ThreadIdMap::const_iterator it = _threadIds.find(threadKey);
+        const TraceThreadId threadId = it != _threadIds.end() 
+            ? it->second : TraceThreadId(threadKey.GetString());
+        const int threadPid = 
+            threadId.GetProcessId() != 0 ? threadId.GetProcessId() : pid;
+
+        for (Index gc = arena.GetFirstChild(c); gc != InvalidIndex;
+                gc = arena.GetNextSibling(gc)) {
             TraceEventTree_WriteToJsonArray(
+                arena,
                 gc,
-                pid,
+                threadPid,
                 threadId,
+                &categoryLists,
                 writer);
         }
     }
-    TraceEventTree_WriteCounters(pid, _counters, writer);
+    if (downsampler.IsEnabled()) {
+        TraceEventTree_WriteCounters(
+            pid, downsampler.Downsample(_counters), writer);
+    } else {
+        TraceEventTree_WriteCounters(pid, _counters, writer);
+    }
     TraceEventTree_WriteMarkers(pid, _markers, writer);
 
     writer.EndArray();
@@ -11,8 +11,10 @@
 #include "pxr/trace/pxr.h"
 
 #include "pxr/trace/api.h"
+#include "pxr/trace/counterDownsampler.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/eventNode.h"
+#include "pxr/trace/eventNodeArena.h"
 #include "pxr/trace/threads.h"
 #include <pxr/tf/refBase.h>
 #include <pxr/tf/refPtr.h>
@@ -50,6 +52,9 @@ public:
     using MarkerValuesMap =
         std::unordered_map<TfToken, MarkerValues, TfToken::HashFunctor>;
 
+    using ThreadIdMap =
+        std::unordered_map<TfToken, TraceThreadId, TfToken::HashFunctor>;
+
     /// Creates a new TraceEventTree instance from the data in \p collection 
     /// and \p initialCounterValues.
     TRACE_API static TraceEventTreeRefPtr New(
@@ -69,24 +74,58 @@ public:
             new TraceEventTree(root, std::move(counters), std::move(markers)));
     }
 
+    static TraceEventTreeRefPtr New(
+            TraceEventNodeRefPtr root, 
+            CounterValuesMap counters,
+            MarkerValuesMap markers,
+            ThreadIdMap threadIds) {
+        return TfCreateRefPtr( 
+            new TraceEventTree(root, std::move(counters), std::move(markers),
+                std::move(threadIds)));
+    }
+
     /// Returns the root node of the tree.
     const TraceEventNodeRefPtr& GetRoot() const { return _root; }
 
+    /// Returns the arena which holds the nodes of the tree.
+    const TraceEventNodeArena& GetNodeArena() const {
+        return *_root->GetArena();
+    }
+
+    /// Returns the index of the root node of the tree in its arena.
+    TraceEventNodeArena::Index GetRootIndex() const {
+        return _root->GetIndex();
+    }
+
     /// Returns the map of counter values.
     const CounterValuesMap& GetCounters() const { return _counters; }
 
     /// Returns the map of markers values.
     const MarkerValuesMap& GetMarkers() const { return _markers; }
 
+    /// Returns the ids of the threads of the tree, keyed by the key of their
+    /// node under the root. Threads missing from the map are identified by
+    /// their node key.
+    const ThreadIdMap& GetThreadIds() const { return _threadIds; }
+
     /// Return the final value of the counters in the report.
     CounterMap GetFinalCounterValues() const;
 
     /// Writes a JSON object representing the data in the call tree that 
-    /// conforms to the Chrome Trace format.
+    /// conforms to the Chrome Trace format. Events are written with the id of
+    /// the process which recorded them.
     using ExtraFieldFn = std::function<void(JsWriter&)>;
     TRACE_API void WriteChromeTraceObject(
         JsWriter& writer, ExtraFieldFn extraFields = ExtraFieldFn()) const;
 
+    /// Writes a JSON object representing the data in the call tree that
+    /// conforms to the Chrome Trace format, with the values of the counters
+    /// reduced by \p downsampler.
+    TRACE_API void WriteChromeTraceObject(
+        JsWriter& writer,
+        const TraceCounterDownsampler& downsampler,
+        ExtraFieldFn extraFields = ExtraFieldFn()) const;
+
     /// Adds the contexts of \p tree to this tree.
     TRACE_API void Merge(const TraceEventTreeRefPtr& tree);
 
@@ -104,12 +143,23 @@ private:
         , _counters(std::move(counters))
         , _markers(std::move(markers)) {}
 
-    // Root of the call tree.
+    TraceEventTree(  TraceEventNodeRefPtr root, 
+                            CounterValuesMap counters,
+                            MarkerValuesMap markers,
+                            ThreadIdMap threadIds)
+        : _root(root)
+        , _counters(std::move(counters))
+        , _markers(std::move(markers))
+        , _threadIds(std::move(threadIds)) {}
+
+    // Root of the call tree, which is a view of the arena holding the nodes.
     TraceEventNodeRefPtr _root;
     // Counter data of the trace.
     CounterValuesMap _counters;
     // Marker data of the trace.
     MarkerValuesMap _markers;
+    // Thread ids of the thread nodes.
+    ThreadIdMap _threadIds;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
@@ -11,15 +11,19 @@
 
 #include "pxr/trace/trace.h"
 
+#include <pxr/tf/stringUtils.h>
+
 #include <algorithm>
 
 TRACE_NAMESPACE_OPEN_SCOPE
 
 Trace_EventTreeBuilder::Trace_EventTreeBuilder() 
-    : _root(TraceEventNode::New())
+    : _arena(TraceEventNodeArena::New())
+    , _root(_arena->AddNode(
+        TfToken("root"), TraceCategory::Default, 0, 0, false))
 {}
 
-// Visitor interface
+// Batched visitor interface
 void
 Trace_EventTreeBuilder::OnBeginCollection()
 {
@@ -37,24 +41,24 @@ Trace_EventTreeBuilder::OnEndCollection()
     }
 }
 
-bool
-Trace_EventTreeBuilder::AcceptsCategory(TraceCategoryId id)
-{
-    return true;
-}
-
 void
 Trace_EventTreeBuilder::OnBeginThread(const TraceThreadId& threadId)
 {
     // Note, that TraceGetThreadId() returns the id of the current thread,
     // i.e. the reporting thread. Since we always report from the main
     // thread, we label the current thread "Main Thread" in the trace.
-    _threadStacks[threadId] = _PendingNodeStack();
-    {
-        _threadStacks[threadId].emplace_back(
-            TfToken(threadId.ToString()), 
-            TraceCategory::Default, 0, 0, false, true);
-    }
+    //
+    // Threads of other processes may have the same name as local threads, so
+    // their nodes are qualified by the process id.
+    const TfToken threadKey(threadId.GetProcessId() == 0 
+        ? threadId.ToString()
+        : TfStringPrintf("%s (pid %d)", 
+            threadId.ToString().c_str(), threadId.GetProcessId()));
+    _threadIds.emplace(threadKey, threadId);
+
+    _stack = &(_threadStacks[threadId] = _PendingNodeStack());
+    _stack->emplace_back(
+        threadKey, TraceCategory::Default, 0, 0, false, true);
 }
 
 void
@@ -65,56 +69,72 @@ Trace_EventTreeBuilder::OnEndThread(const TraceThreadId& threadId)
         _PendingNodeStack& stack = it->second;
 
         // Close any incomplete nodes, attach any unattached children nodes
-        TraceEventNodeRefPtr firstNode;
+        _Index firstNode = TraceEventNodeArena::InvalidIndex;
         while (!stack.empty()) {
 
             // close any timespan events left on the stack
             _PendingEventNode* backNode = &stack.back();
-            firstNode = backNode->Close();
+            firstNode = backNode->Close(*_arena);
 
             // if this was incomplete event, get Begin/End times from children
             if (!backNode->isComplete) {
-                firstNode->SetBeginAndEndTimesFromChildren();
+                _arena->SetBeginAndEndTimesFromChildren(firstNode);
             }
 
             stack.pop_back();
             if (!stack.empty()) {
-                stack.back().children.push_back(firstNode);
+                stack.back().PrependChild(*_arena, firstNode);
             }
         }
         // firstNode is now the thread root
-        firstNode->SetBeginAndEndTimesFromChildren();
-        _root->Append(firstNode);
+        _arena->SetBeginAndEndTimesFromChildren(firstNode);
+        _arena->AppendChild(_root, firstNode);
         _threadStacks.erase(it);
     }
+    _stack = nullptr;
 }
 
 void
-Trace_EventTreeBuilder::OnEvent(
-    const TraceThreadId& threadIndex, const TfToken& key, const TraceEvent& e) 
+Trace_EventTreeBuilder::OnEvents(
+    const TraceThreadId& threadIndex,
+    const TraceCollection::EventSpan& events) 
 {
-    switch(e.GetType()) {
-        case TraceEvent::EventType::Begin:
-            _OnBegin(threadIndex, key, e);
-            break;
-        case TraceEvent::EventType::End:
-            _OnEnd(threadIndex, key, e);
-            break;
-        case TraceEvent::EventType::CounterDelta:
-        case TraceEvent::EventType::CounterValue:
-            // Handled by the counter accumulator
-            break;
-        case TraceEvent::EventType::Timespan:
-            _OnTimespan(threadIndex, key, e);
-            break;
-        case TraceEvent::EventType::Marker:
-            _OnMarker(threadIndex, key, e);
-            break;
-        case TraceEvent::EventType::ScopeData:
-            _OnData(threadIndex, key, e);
-            break;
-        case TraceEvent::EventType::Unknown:
-            break;
+    const TraceCollection::KeyTable& keys = events.GetKeyTable();
+
+    // The tree is built from the last event to the first.
+    for (TraceCollection::EventSpan::const_reverse_iterator it = 
+            events.rbegin(); it != events.rend(); ++it) {
+        const TraceEvent& e = *it;
+        switch(e.GetType()) {
+            case TraceEvent::EventType::Begin:
+                _OnBegin(
+                    threadIndex, keys.GetToken(keys.GetKeyId(e.GetKey())), e);
+                break;
+            case TraceEvent::EventType::End:
+                _OnEnd(
+                    threadIndex, keys.GetToken(keys.GetKeyId(e.GetKey())), e);
+                break;
+            case TraceEvent::EventType::CounterDelta:
+            case TraceEvent::EventType::CounterValue:
+                // Handled by the counter accumulator
+                break;
+            case TraceEvent::EventType::Timespan:
+                _OnTimespan(
+                    threadIndex, keys.GetToken(keys.GetKeyId(e.GetKey())), e);
+                break;
+            case TraceEvent::EventType::Marker:
+                _OnMarker(
+                    threadIndex, keys.GetToken(keys.GetKeyId(e.GetKey())), e);
+                break;
+            case TraceEvent::EventType::ScopeData:
+                _OnData(
+                    threadIndex, keys.GetToken(keys.GetKeyId(e.GetKey())), e);
+                break;
+            case TraceEvent::EventType::Sample:
+                // Attributed to their scopes by the aggregate tree builder.
+            case TraceEvent::EventType::Unknown:
+                break;
+        }
     }
 }
 
@@ -125,7 +145,7 @@ Trace_EventTreeBuilder::_OnBegin(
 
     // For a begin event, find and modify the matching end event
     // First, search the stack for a matching End
-    _PendingNodeStack& stack = _threadStacks[threadId];
+    _PendingNodeStack& stack = *_stack;
     _PendingEventNode* prevNode = &stack.back();
     int index = stack.size()-1;
 
@@ -157,12 +177,12 @@ Trace_EventTreeBuilder::_OnBegin(
         
         // Incomplete events set their duration to match their children.
         _PendingEventNode pending(key, e.GetCategory(), 0, 0, true, false);
-        swap(pending.children, stack.back().children);
+        std::swap(pending.firstChild, stack.back().firstChild);
+        std::swap(pending.lastChild, stack.back().lastChild);
         swap(pending.attributes, stack.back().attributes);
-        TraceEventNodeRefPtr node =
-            pending.Close();
-        node->SetBeginAndEndTimesFromChildren();
-        stack.back().children.push_back(node);
+        const _Index node = pending.Close(*_arena);
+        _arena->SetBeginAndEndTimesFromChildren(node);
+        stack.back().PrependChild(*_arena, node);
     }
 }
 
@@ -170,7 +190,7 @@ void
 Trace_EventTreeBuilder::_OnEnd(
     const TraceThreadId& threadId, const TfToken& key, const TraceEvent& e)
 {
-    _PendingNodeStack& stack = _threadStacks[threadId];
+    _PendingNodeStack& stack = *_stack;
     _PendingEventNode* prevNode = &stack.back();
 
     // While this End can't be child of prevNode, pop and close prevNode
@@ -195,7 +215,7 @@ Trace_EventTreeBuilder::_OnTimespan(
 
     _PendingEventNode thisNode(key, e.GetCategory(), start, end, false, true);
 
-    _PendingNodeStack& stack = _threadStacks[threadId];
+    _PendingNodeStack& stack = *_stack;
     _PendingEventNode* prevNode = &stack.back();
 
     // while thisNode is not a child of prevNode
@@ -220,7 +240,7 @@ void
 Trace_EventTreeBuilder::_OnData(
     const TraceThreadId& threadId, const TfToken& key, const TraceEvent& e)
 {
-    _PendingNodeStack& stack = _threadStacks[threadId];
+    _PendingNodeStack& stack = *_stack;
     if (!stack.empty()) {
 
         _PendingEventNode* prevNode = &stack.back(); 
@@ -243,10 +263,10 @@ void
 Trace_EventTreeBuilder::_PopAndClose(_PendingNodeStack& stack) 
 {
     _PendingEventNode* prevNode = &stack.back();
-    TraceEventNodeRefPtr closedOldPrev = prevNode->Close();
+    const _Index closedOldPrev = prevNode->Close(*_arena);
     stack.pop_back();
     // _PendingEventNode* newPrev = &stack.back();
-    stack.back().children.push_back(closedOldPrev);
+    stack.back().PrependChild(*_arena, closedOldPrev);
 }
 Trace_EventTreeBuilder::_PendingEventNode::_PendingEventNode(
     const TfToken& key, TraceCategoryId category, TimeStamp start, 
@@ -260,29 +280,39 @@ Trace_EventTreeBuilder::_PendingEventNode::_PendingEventNode(
 {
 }
 
-TraceEventNodeRefPtr 
-Trace_EventTreeBuilder::_PendingEventNode::Close() 
+Trace_EventTreeBuilder::_Index
+Trace_EventTreeBuilder::_PendingEventNode::Close(TraceEventNodeArena& arena)
 {
     // We are now iterating backwards to build the tree,
-    // So children and attributes were encountered in reverse order
-    std::reverse(children.begin(), children.end());
-    std::reverse(attributes.begin(), attributes.end());
-
-    TraceEventNodeRefPtr node = 
-        TraceEventNode::New(key, category, start, end, 
-            std::move(children), separateEvents);
-    for (AttributeData& it : attributes) {
-        node->AddAttribute(TfToken(it.key), std::move(it.data));
+    // So attributes were encountered in reverse order. Children were
+    // prepended, so they are already in order.
+    const _Index node = 
+        arena.AddNode(key, category, start, end, separateEvents);
+    arena._SetChildren(node, firstChild, lastChild);
+    for (auto it = attributes.rbegin(); it != attributes.rend(); ++it) {
+        arena.AddAttribute(node, it->key, it->data);
     }
     return node;
 }
 
+void
+Trace_EventTreeBuilder::_PendingEventNode::PrependChild(
+    TraceEventNodeArena& arena, _Index node)
+{
+    arena._nextSiblings[node] = firstChild;
+    firstChild = node;
+    if (lastChild == TraceEventNodeArena::InvalidIndex) {
+        lastChild = node;
+    }
+}
+
 void
 Trace_EventTreeBuilder::CreateTree(const TraceCollection& collection)
 {
-    collection.ReverseIterate(*this);
+    collection.ReverseIterateBatches(*this);
     _counterAccum.Update(collection);
-    _tree = TraceEventTree::New(_root, _counterAccum.GetCounters(), _markersMap);
+    _tree = TraceEventTree::New(TraceEventNode::New(_arena, _root),
+        _counterAccum.GetCounters(), _markersMap, _threadIds);
 }
 
 bool
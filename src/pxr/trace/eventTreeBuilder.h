@@ -13,6 +13,7 @@
 #include "pxr/trace/collection.h"
 #include "pxr/trace/counterAccumulator.h"
 #include "pxr/trace/eventNode.h"
+#include "pxr/trace/eventNodeArena.h"
 #include "pxr/trace/eventTree.h"
 
 TRACE_NAMESPACE_OPEN_SCOPE
@@ -24,8 +25,7 @@ TRACE_NAMESPACE_OPEN_SCOPE
 /// This class creates a tree of TraceEventTree instances from
 /// TraceCollection instances.
 ///
-class Trace_EventTreeBuilder
-    : protected TraceCollection::Visitor {
+class Trace_EventTreeBuilder {
 public:
     /// Constructor.
     Trace_EventTreeBuilder();
@@ -43,18 +43,19 @@ public:
     }
 
 protected:
-    /// \name TraceCollection::Visitor Interface
+    /// \name TraceCollection batched visitor interface
     /// @{
-    virtual void OnBeginCollection() override;
-    virtual void OnEndCollection() override;
-    virtual bool AcceptsCategory(TraceCategoryId) override;
-    virtual void OnBeginThread(const TraceThreadId&) override;
-    virtual void OnEndThread(const TraceThreadId&) override;
-    virtual void OnEvent(
-        const TraceThreadId&, const TfToken&, const TraceEvent&) override;
+    void OnBeginCollection();
+    void OnEndCollection();
+    void OnBeginThread(const TraceThreadId&);
+    void OnEndThread(const TraceThreadId&);
+    void OnEvents(const TraceThreadId&, const TraceCollection::EventSpan&);
     /// @}
 
 private:
+    friend class TraceCollection;
+
+    using _Index = TraceEventNodeArena::Index;
 
     // Helper class for event graph creation.
     struct _PendingEventNode {
@@ -72,7 +73,11 @@ private:
                                  TimeStamp end,
                                  bool separateEvents,
                                  bool isComplete);
-        TraceEventNodeRefPtr Close();
+        _Index Close(TraceEventNodeArena& arena);
+
+        // Makes node, which is the previous sibling of the current children
+        // since events are visited backwards, the first child.
+        void PrependChild(TraceEventNodeArena& arena, _Index node);
 
         // Can move this, but not copy it
         _PendingEventNode(const _PendingEventNode&) = delete;
@@ -87,7 +92,9 @@ private:
         TimeStamp end;
         bool separateEvents;
         bool isComplete;
-        std::vector<TraceEventNodeRefPtr> children;
+        // The children are linked by their next sibling in the arena.
+        _Index firstChild = TraceEventNodeArena::InvalidIndex;
+        _Index lastChild = TraceEventNodeArena::InvalidIndex;
         std::vector<AttributeData> attributes;
     };
 
@@ -102,8 +109,11 @@ private:
 
     void _PopAndClose(_PendingNodeStack& stack); 
 
-    TraceEventNodeRefPtr _root;
+    TraceEventNodeArenaRefPtr _arena;
+    _Index _root;
     _ThreadStackMap _threadStacks;
+    // The stack of the thread currently being visited.
+    _PendingNodeStack* _stack = nullptr;
     TraceEventTreeRefPtr _tree;
 
     class _CounterAccumulator : public TraceCounterAccumulator {
@@ -113,6 +123,7 @@ private:
     _CounterAccumulator _counterAccum;
 
     TraceEventTree::MarkerValuesMap _markersMap;
+    TraceEventTree::ThreadIdMap _threadIds;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
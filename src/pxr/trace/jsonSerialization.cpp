@@ -86,6 +86,7 @@ _EventTypeToString(TraceEvent::EventType t) {
         case TraceEvent::EventType::Timespan: return "Timespan";
         case TraceEvent::EventType::ScopeData: return "Data";
         case TraceEvent::EventType::Marker: return "Marker";
+        case TraceEvent::EventType::Sample: return "Sample";
         case TraceEvent::EventType::Unknown: return "Unknown";
     }
     return "Unknown";
@@ -107,6 +108,8 @@ _EventTypeFromString(const std::string& s) {
         return TraceEvent::EventType::ScopeData;
     } else if (s == "Mark") {
         return TraceEvent::EventType::Marker;
+    } else if (s == "Sample") {
+        return TraceEvent::EventType::Sample;
     }
     return TraceEvent::EventType::Unknown;
 }
@@ -173,6 +176,19 @@ _WriteTraceEventToJSON(JsWriter& js, const TfToken& key, const TraceEvent& e)
                 "ts", _TicksToMicroSeconds(e.GetTimeStamp())
             );
             break;
+        case TraceEvent::EventType::Sample:
+            js.WriteObject(
+                "key", key.GetString(),
+                "category", static_cast<uint64_t>(e.GetCategory()),
+                "type", _EventTypeToString(e.GetType()),
+                "ts", _TicksToMicroSeconds(e.GetTimeStamp()),
+                "frames", [&e](JsWriter& js) {
+                    js.WriteArray(e.GetStackFrames(),
+                        [](JsWriter& js, uintptr_t frame) {
+                            js.WriteValue(uint64_t(frame));
+                        });
+                });
+            break;
         case TraceEvent::EventType::Unknown:
             break;
     }
@@ -323,6 +339,26 @@ _TraceEventFromJSON(
                     }
                 }
                 break;
+            case TraceEvent::EventType::Sample:
+                if (ts) {
+                    if (const JsArray* frameValues =
+                        _JsGetValue<JsArray>(js, "frames")) {
+                        std::vector<uintptr_t> frames;
+                        for (const JsValue& frame : *frameValues) {
+                            if (frame.Is<uint64_t>()) {
+                                frames.push_back(frame.Get<uint64_t>());
+                            }
+                        }
+                        unorderedEvents.emplace_back(
+                            TraceEvent::Sample,
+                            list.CacheKey(*keyStr),
+                            *ts,
+                            list.StoreStackFrames(
+                                frames.data(), frames.size()),
+                            *category);
+                    }
+                }
+                break;
         }
     }
 }
@@ -360,10 +396,11 @@ public:
         const TfToken& key, 
         const TraceEvent& event) override {
 
-        // Only convert Counter and Data events. The other types will be in the
-        // chrome format.
+        // Only convert Counter, Data and Sample events. The other types will
+        // be in the chrome format.
         switch (event.GetType()) {
             case TraceEvent::EventType::ScopeData:
+            case TraceEvent::EventType::Sample:
             case TraceEvent::EventType::CounterDelta:
             case TraceEvent::EventType::CounterValue:
                 _eventsPerThread[threadId.ToString()].emplace_back(key, &event);
@@ -390,6 +427,46 @@ private:
 
 }
 
+// The anchor is stored in microseconds like the timestamps of the events.
+static void
+_WriteClockCalibrationToJson(
+    JsWriter& js, const TraceClockCalibration& clock)
+{
+    js.WriteObject(
+        "source", clock.source,
+        "host", clock.host,
+        "ticksPerSecond", clock.ticksPerSecond,
+        "anchor", _TicksToMicroSeconds(clock.anchor),
+        "realtime", clock.realtime,
+        "monotonic", clock.monotonic,
+        "uncertainty", clock.uncertainty
+    );
+}
+
+static TraceClockCalibration
+_ClockCalibrationFromJson(const JsObject& js)
+{
+    TraceClockCalibration clock;
+    const std::string* source = _JsGetValue<std::string>(js, "source");
+    const std::string* host = _JsGetValue<std::string>(js, "host");
+    std::optional<double> anchor = _JsGetValue<double>(js, "anchor");
+    std::optional<int64_t> realtime = _JsGetValue<int64_t>(js, "realtime");
+    if (!source || !anchor || !realtime) {
+        return clock;
+    }
+    clock.source = *source;
+    clock.host = host ? *host : std::string();
+    // Timestamps are read in the ticks of this host.
+    clock.ticksPerSecond = 1.0e9 / ArchGetNanosecondsPerTick();
+    clock.anchor = _MicrosecondsToTicks(*anchor);
+    clock.realtime = *realtime;
+    clock.monotonic =
+        _JsGetValue<int64_t>(js, "monotonic").value_or(int64_t(0));
+    clock.uncertainty =
+        _JsGetValue<uint64_t>(js, "uncertainty").value_or(uint64_t(0));
+    return clock;
+}
+
 static void
 _WriteTraceEventsToJson(
     JsWriter& js,
@@ -403,11 +480,25 @@ _WriteTraceEventsToJson(
             collection->Iterate(eventsToJson);
         }
     }
-    js.WriteObject(
-        "threadEvents", [&eventsToJson] (JsWriter& js) {
-            eventsToJson.CreateThreadsObject(js);
+
+    // Collections written together are expected to share their clock, so
+    // only the first calibration is written.
+    const TraceClockCalibration* clock = nullptr;
+    for (const CollectionPtr& collection : collections) {
+        if (collection && collection->GetClockCalibration().IsValid()) {
+            clock = &collection->GetClockCalibration();
+            break;
         }
-    );
+    }
+
+    js.BeginObject();
+    js.WriteKey("threadEvents");
+    eventsToJson.CreateThreadsObject(js);
+    if (clock) {
+        js.WriteKey("clock");
+        _WriteClockCalibrationToJson(js, *clock);
+    }
+    js.EndObject();
 }
 
 bool
@@ -603,6 +694,11 @@ Trace_JSONSerialization::CollectionFromJSON(const JsValue& jsValue) {
     // Create the event lists and collection.
     if (!constMap.empty()) {
         std::unique_ptr<TraceCollection> collection(new TraceCollection());
+        if (const JsObject* clockObj = traceDataObj
+                ? _JsGetValue<JsObject>(*traceDataObj, "clock") : nullptr) {
+            collection->SetClockCalibration(
+                _ClockCalibrationFromJson(*clockObj));
+        }
         for (ChromeConstructionMap::value_type& c : constMap) {
             collection->AddToCollection(
                     TraceThreadId(c.first),
@@ -51,6 +51,9 @@ private:
 
     // TraceCollection converts TraceKeys to TfTokens for visitors.
     friend class TraceCollection;
+
+    // TraceCollector accumulates scope statistics by call site.
+    friend class TraceCollector;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
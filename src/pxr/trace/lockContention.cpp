@@ -0,0 +1,191 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/lockContention.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/aggregateNodeArena.h"
+#include "pxr/trace/mutex.h"
+
+#include <pxr/tf/stringUtils.h>
+#include <pxr/arch/timing.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <ostream>
+#include <unordered_map>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+using Index = TraceAggregateNodeArena::Index;
+
+// The contention of a mutex while the tree is walked.
+struct _LockData {
+    TraceLockContention::Lock lock;
+    std::map<std::vector<TfToken>, TraceLockContention::CallPath> callPaths;
+};
+
+using _LockMap = std::unordered_map<std::string, _LockData>;
+
+// Returns the name of the mutex if key has prefix, or an empty string.
+std::string
+_GetMutexName(const TfToken& key, const char* prefix)
+{
+    const std::string& str = key.GetString();
+    const size_t size = std::strlen(prefix);
+    if (str.size() > size && str.compare(0, size, prefix) == 0) {
+        return str.substr(size);
+    }
+    return std::string();
+}
+
+// Adds the wait and hold scopes of node and its descendants to locks. path
+// holds the keys of the ancestors of node below its thread.
+void
+_Visit(const TraceAggregateNodeArena& arena, Index node,
+    std::vector<TfToken>* path, _LockMap* locks)
+{
+    const TfToken& key = arena.GetKey(node);
+    std::string name = _GetMutexName(key, TraceLockCategory::WaitPrefix);
+    if (!name.empty()) {
+        _LockData& data = (*locks)[name];
+        data.lock.waitTime += arena.GetInclusiveTime(node);
+        data.lock.waitCount += arena.GetCount(node);
+
+        TraceLockContention::CallPath& callPath = data.callPaths[*path];
+        callPath.waitTime += arena.GetInclusiveTime(node);
+        callPath.waitCount += arena.GetCount(node);
+    } else {
+        name = _GetMutexName(key, TraceLockCategory::HoldPrefix);
+        if (!name.empty()) {
+            _LockData& data = (*locks)[name];
+            data.lock.holdTime += arena.GetInclusiveTime(node);
+            data.lock.holdCount += arena.GetCount(node);
+        }
+    }
+
+    path->push_back(key);
+    for (Index child = arena.GetFirstChild(node);
+            child != TraceAggregateNodeArena::InvalidIndex;
+            child = arena.GetNextSibling(child)) {
+        _Visit(arena, child, path, locks);
+    }
+    path->pop_back();
+}
+
+std::string
+_FormatPath(const std::vector<TfToken>& path)
+{
+    if (path.empty()) {
+        return "(no scope)";
+    }
+    std::string result;
+    for (const TfToken& key : path) {
+        if (!result.empty()) {
+            result += " > ";
+        }
+        result += key.GetString();
+    }
+    return result;
+}
+
+double
+_ToMs(TraceEvent::TimeStamp time)
+{
+    return ArchTicksToSeconds(time) * 1e3;
+}
+
+}
+
+TraceLockContention::TraceLockContention(
+    const TraceAggregateTreeRefPtr& tree)
+{
+    const TraceAggregateNodeArena& arena = tree->GetNodeArena();
+
+    // The children of the root are the threads, which are left out of the
+    // call paths.
+    _LockMap locks;
+    std::vector<TfToken> path;
+    for (Index thread = arena.GetFirstChild(tree->GetRootIndex());
+            thread != TraceAggregateNodeArena::InvalidIndex;
+            thread = arena.GetNextSibling(thread)) {
+        for (Index child = arena.GetFirstChild(thread);
+                child != TraceAggregateNodeArena::InvalidIndex;
+                child = arena.GetNextSibling(child)) {
+            _Visit(arena, child, &path, &locks);
+        }
+    }
+
+    auto byWaitTime = [](const auto& a, const auto& b) {
+        return a.waitTime > b.waitTime;
+    };
+
+    _locks.reserve(locks.size());
+    for (_LockMap::value_type& it : locks) {
+        Lock& lock = it.second.lock;
+        if (lock.waitCount == 0) {
+            continue;
+        }
+        lock.name = it.first;
+        for (auto& callPath : it.second.callPaths) {
+            callPath.second.path = callPath.first;
+            lock.callPaths.push_back(std::move(callPath.second));
+        }
+        std::stable_sort(
+            lock.callPaths.begin(), lock.callPaths.end(), byWaitTime);
+        _locks.push_back(std::move(lock));
+    }
+
+    // Ties are ordered by name so reports are stable.
+    std::sort(_locks.begin(), _locks.end(),
+        [](const Lock& a, const Lock& b) {
+            return a.waitTime != b.waitTime
+                ? a.waitTime > b.waitTime : a.name < b.name;
+        });
+}
+
+void
+TraceLockContention::Report(
+    std::ostream& s, size_t maxLocks, size_t maxCallPaths) const
+{
+    s << "\nLock contention  ==============\n";
+    if (_locks.empty()) {
+        s << "No contention recorded\n";
+        return;
+    }
+    s << "        wait        waits         hold  lock / call path\n";
+
+    const size_t numLocks =
+        maxLocks ? std::min(maxLocks, _locks.size()) : _locks.size();
+    for (size_t i = 0; i < numLocks; ++i) {
+        const Lock& lock = _locks[i];
+        s << TfStringPrintf("%9.3f ms %12d %9.3f ms  ",
+                _ToMs(lock.waitTime), lock.waitCount, _ToMs(lock.holdTime))
+          << lock.name << "\n";
+
+        const size_t numCallPaths = maxCallPaths
+            ? std::min(maxCallPaths, lock.callPaths.size())
+            : lock.callPaths.size();
+        for (size_t j = 0; j < numCallPaths; ++j) {
+            const CallPath& callPath = lock.callPaths[j];
+            s << TfStringPrintf("%9.3f ms %12d %12s    ",
+                    _ToMs(callPath.waitTime), callPath.waitCount, "")
+              << _FormatPath(callPath.path) << "\n";
+        }
+        if (numCallPaths < lock.callPaths.size()) {
+            s << TfStringPrintf("%42s", "")
+              << (lock.callPaths.size() - numCallPaths)
+              << " other call paths\n";
+        }
+    }
+    if (numLocks < _locks.size()) {
+        s << (_locks.size() - numLocks) << " other locks\n";
+    }
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
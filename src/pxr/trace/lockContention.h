@@ -0,0 +1,99 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_LOCK_CONTENTION_H
+#define PXR_TRACE_LOCK_CONTENTION_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/aggregateTree.h"
+#include "pxr/trace/event.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/token.h>
+#include <pxr/tf/weakBase.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TF_DECLARE_WEAK_AND_REF_PTRS(TraceLockContention);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceLockContention
+///
+/// Summarizes the contention of the mutexes recorded by TraceMutexWrapper in
+/// a TraceAggregateTree.
+///
+/// The wait and hold scopes of each mutex are gathered from the whole tree.
+/// The waits are also grouped by call path, the keys of the scopes which
+/// enclosed them below their thread, so the same code waiting on several
+/// threads is reported once.
+///
+/// Times are expressed in ticks, see ArchTicksToSeconds().
+///
+class TraceLockContention : public TfRefBase, public TfWeakBase {
+public:
+    using This = TraceLockContention;
+    using ThisPtr = TraceLockContentionPtr;
+    using ThisRefPtr = TraceLockContentionRefPtr;
+
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    /// A call path which waited for a mutex.
+    struct CallPath {
+        /// The keys of the scopes enclosing the waits, outermost first. The
+        /// path is empty for waits outside of any scope.
+        std::vector<TfToken> path;
+
+        TimeStamp waitTime = 0;
+        int waitCount = 0;
+    };
+
+    /// The contention of a mutex.
+    struct Lock {
+        /// The name of the mutex.
+        std::string name;
+
+        /// The total time spent waiting for the mutex.
+        TimeStamp waitTime = 0;
+        int waitCount = 0;
+
+        /// The total time the mutex was held after waiting for it.
+        TimeStamp holdTime = 0;
+        int holdCount = 0;
+
+        /// The call paths which waited, by decreasing wait time.
+        std::vector<CallPath> callPaths;
+    };
+
+    /// Summarizes the contention recorded in \p tree.
+    static ThisRefPtr New(const TraceAggregateTreeRefPtr& tree) {
+        return TfCreateRefPtr(new This(tree));
+    }
+
+    /// Returns the mutexes which were waited for, by decreasing wait time.
+    const std::vector<Lock>& GetLocks() const { return _locks; }
+
+    /// Writes a text report of the contention to \p s. Only the first
+    /// \p maxLocks mutexes and the first \p maxCallPaths call paths of each
+    /// are written, or all of them if the value is 0.
+    TRACE_API void Report(
+        std::ostream& s, size_t maxLocks = 0, size_t maxCallPaths = 0) const;
+
+private:
+    TRACE_API explicit TraceLockContention(
+        const TraceAggregateTreeRefPtr& tree);
+
+    std::vector<Lock> _locks;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_LOCK_CONTENTION_H
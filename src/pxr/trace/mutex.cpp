@@ -0,0 +1,86 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/mutex.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/dynamicKey.h"
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+struct _MutexKeys {
+    explicit _MutexKeys(const std::string& name)
+        : wait(TraceLockCategory::WaitPrefix + name)
+        , hold(TraceLockCategory::HoldPrefix + name) {}
+
+    TraceDynamicKey wait;
+    TraceDynamicKey hold;
+};
+
+}
+
+// Returns the keys of the mutexes named name. Events refer to their key data
+// until their collection is processed, which may happen after the mutex is
+// destroyed, so the keys are never released.
+static const _MutexKeys&
+_GetMutexKeys(const std::string& name)
+{
+    using KeyMap =
+        std::unordered_map<std::string, std::unique_ptr<_MutexKeys>>;
+    static std::mutex mutex;
+    static KeyMap* keys = []() {
+        TraceCategory::GetInstance().RegisterCategory(
+            TraceLockCategory::GetId(), "Lock");
+        return new KeyMap;
+    }();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<_MutexKeys>& mutexKeys = (*keys)[name];
+    if (!mutexKeys) {
+        mutexKeys.reset(new _MutexKeys(name));
+    }
+    return *mutexKeys;
+}
+
+std::atomic<bool> TraceLockCategory::_isEnabled(true);
+
+void
+TraceLockCategory::SetEnabled(bool isEnabled)
+{
+    _isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+Trace_MutexBase::Trace_MutexBase(const std::string& name)
+{
+    const _MutexKeys& keys = _GetMutexKeys(name);
+    _waitKey = &keys.wait.GetData();
+    _holdKey = &keys.hold.GetData();
+}
+
+void
+Trace_MutexBase::_RecordAcquisition(
+    TimeStamp waitStart, TimeStamp holdStart) const
+{
+    // The hold is recorded as a begin and an end event rather than a scope,
+    // so that the events recorded while the mutex is held follow its begin
+    // and are nested in it.
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.Scope<TraceLockCategory>(*_waitKey, waitStart, holdStart);
+    collector.BeginScope<TraceLockCategory>(*_holdKey);
+}
+
+void
+Trace_MutexBase::_RecordRelease() const
+{
+    TraceCollector::GetInstance().EndScope<TraceLockCategory>(*_holdKey);
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,211 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_MUTEX_H
+#define PXR_TRACE_MUTEX_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/category.h"
+#include "pxr/trace/clock.h"
+#include "pxr/trace/collector.h"
+#include "pxr/trace/staticKeyData.h"
+
+#include <pxr/arch/hints.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include <tbb/spin_mutex.h>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceLockCategory
+///
+/// The category of the scopes recorded by TraceMutexWrapper. It is enabled
+/// by default, and its scopes are only recorded while the collector is
+/// enabled.
+///
+/// When a mutex named \c N is acquired after waiting for another thread, the
+/// time spent waiting is recorded as a scope with the key \c "[wait] N" and
+/// the time it is then held as a scope with the key \c "[hold] N".
+///
+struct TraceLockCategory {
+    /// The prefix of the keys of the scopes spent waiting for a mutex.
+    static constexpr char WaitPrefix[] = "[wait] ";
+
+    /// The prefix of the keys of the scopes spent holding a mutex.
+    static constexpr char HoldPrefix[] = "[hold] ";
+
+    /// Returns the id of the category.
+    static constexpr TraceCategoryId GetId() {
+        return TraceCategory::CreateTraceCategoryId("Lock");
+    }
+
+    /// Enables or disables the category.
+    TRACE_API static void SetEnabled(bool isEnabled);
+
+    /// Returns whether the category and the collector are enabled.
+    static bool IsEnabled() {
+        return _isEnabled.load(std::memory_order_relaxed) &&
+            TraceCollector::IsEnabled();
+    }
+
+private:
+    TRACE_API static std::atomic<bool> _isEnabled;
+};
+
+// The part of TraceMutexWrapper which does not depend on the type of mutex.
+class Trace_MutexBase {
+protected:
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    TRACE_API explicit Trace_MutexBase(const std::string& name);
+
+    // Records the wait of a contended acquisition from waitStart to
+    // holdStart, and begins the scope holding the mutex.
+    TRACE_API void _RecordAcquisition(
+        TimeStamp waitStart, TimeStamp holdStart) const;
+
+    // Ends the scope holding the mutex.
+    TRACE_API void _RecordRelease() const;
+
+private:
+    const TraceStaticKeyData* _waitKey;
+    const TraceStaticKeyData* _holdKey;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceMutexWrapper
+///
+/// This class wraps a mutex of type \p Mutex to record how long threads wait
+/// for it and hold it, in the TraceLockCategory.
+///
+/// Nothing is recorded when the mutex is acquired without waiting, so an
+/// uncontended mutex costs the same as the mutex it wraps. The scopes
+/// recorded for a contended acquisition are nested in the scopes of the
+/// thread which waited, and the scopes recorded while the mutex is held are
+/// nested in its hold scope, so TraceLockContention can attribute the waits
+/// to call paths. Like scopes, a mutex should be released in the scope where
+/// it was acquired.
+///
+/// \p Mutex must provide lock(), try_lock() and unlock(). The wrapper
+/// provides the same methods, so it works with std::lock_guard and
+/// std::unique_lock, as well as a scoped_lock like the one of
+/// tbb::spin_mutex.
+///
+template <class Mutex>
+class TraceMutexWrapper : private Trace_MutexBase {
+public:
+    /// Creates a mutex whose scopes are named after \p name.
+    explicit TraceMutexWrapper(const std::string& name)
+        : Trace_MutexBase(name)
+        , _recorded(false) {}
+
+    TraceMutexWrapper(const TraceMutexWrapper&) = delete;
+    TraceMutexWrapper& operator=(const TraceMutexWrapper&) = delete;
+
+    /// Acquires the mutex, recording the wait if it is held by another
+    /// thread. The wait and the beginning of the hold are recorded once the
+    /// mutex is acquired, before the events the thread records while
+    /// holding it.
+    void lock() {
+        if (ARCH_LIKELY(_mutex.try_lock())) {
+            return;
+        }
+        if (!TraceLockCategory::IsEnabled()) {
+            _mutex.lock();
+            return;
+        }
+        const TimeStamp waitStart = TraceClock::GetStartTime();
+        _mutex.lock();
+        _RecordAcquisition(waitStart, TraceClock::GetStopTime());
+        _recorded = true;
+    }
+
+    /// Acquires the mutex if it is free and returns whether it did.
+    bool try_lock() {
+        return _mutex.try_lock();
+    }
+
+    /// Releases the mutex. The end of the hold of a contended acquisition
+    /// is recorded after the release, so it does not lengthen the wait of
+    /// other threads.
+    void unlock() {
+        if (ARCH_LIKELY(!_recorded)) {
+            _mutex.unlock();
+            return;
+        }
+        _recorded = false;
+        _mutex.unlock();
+        _RecordRelease();
+    }
+
+    /// A lock which is released when it is destroyed.
+    class scoped_lock {
+    public:
+        /// Creates a lock which does not hold a mutex.
+        scoped_lock() : _mutex(nullptr) {}
+
+        /// Acquires \p mutex.
+        explicit scoped_lock(TraceMutexWrapper& mutex) : _mutex(nullptr) {
+            acquire(mutex);
+        }
+
+        /// Releases the mutex if it is held.
+        ~scoped_lock() {
+            if (_mutex) {
+                release();
+            }
+        }
+
+        scoped_lock(const scoped_lock&) = delete;
+        scoped_lock& operator=(const scoped_lock&) = delete;
+
+        /// Acquires \p mutex.
+        void acquire(TraceMutexWrapper& mutex) {
+            mutex.lock();
+            _mutex = &mutex;
+        }
+
+        /// Acquires \p mutex if it is free and returns whether it did.
+        bool try_acquire(TraceMutexWrapper& mutex) {
+            if (mutex.try_lock()) {
+                _mutex = &mutex;
+                return true;
+            }
+            return false;
+        }
+
+        /// Releases the mutex.
+        void release() {
+            _mutex->unlock();
+            _mutex = nullptr;
+        }
+
+    private:
+        TraceMutexWrapper* _mutex;
+    };
+
+private:
+    Mutex _mutex;
+
+    // Whether the scopes of the current acquisition are recorded. Only the
+    // thread holding the mutex uses it.
+    bool _recorded;
+};
+
+/// A std::mutex which records its contention.
+using TraceMutex = TraceMutexWrapper<std::mutex>;
+
+/// A tbb::spin_mutex which records its contention.
+using TraceSpinMutex = TraceMutexWrapper<tbb::spin_mutex>;
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_MUTEX_H
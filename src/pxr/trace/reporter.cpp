@@ -11,6 +11,7 @@
 #include "pxr/trace/aggregateTree.h"
 #include "pxr/trace/collector.h"
 #include "pxr/trace/eventTree.h"
+#include "pxr/trace/lockContention.h"
 #include "pxr/trace/reporterDataSourceCollector.h"
 #include "pxr/trace/threads.h"
 
@@ -44,7 +45,10 @@ TraceReporter::TraceReporter(const string& label,
     _label(label),
     _groupByFunction(true),
     _foldRecursiveCalls(false),
-    _shouldAdjustForOverheadAndNoise(true)
+    _shouldAdjustForOverheadAndNoise(true),
+    _overflowCount(0),
+    _droppedEventCount(0),
+    _recordingPaused(false)
 {
     _aggregateTree = TraceAggregateTree::New();
     _eventTree = TraceEventTree::New();
@@ -132,36 +136,191 @@ _PrintRecursionMarker(
 
 }
 
+namespace {
+
+using _Index = TraceAggregateNodeArena::Index;
+using _ReportOptions = TraceReporter::ReportOptions;
+
+// A line of the tree view: either a node, or the sum of the children of a
+// node which were pruned when node is InvalidIndex.
+struct _ReportLine {
+    _Index node;
+    int depth;
+    // The inclusive time of the thread of the line, which percentages are
+    // relative to.
+    double threadTime;
+    double inclusive;
+    double exclusive;
+    int count;
+    size_t numOthers;
+};
+
+}
+
+static double
+_GetSortTime(
+    const TraceAggregateNodeArena &arena,
+    _Index node,
+    _ReportOptions::SortOrder sortOrder)
+{
+    if (sortOrder == _ReportOptions::SortOrder::ExclusiveTime) {
+        return arena.GetExclusiveTime(node, arena.IsRecursionHead(node));
+    }
+    return arena.GetInclusiveTime(node);
+}
+
+// Pushes the lines of the children of the node of line on stack, last
+// first, pruning them according to options.
 static void
-_PrintNodeTimes(
-    ostream &s,
-    TraceAggregateNodeRefPtr node,
-    int indent, 
-    int iterationCount)
+_PushChildLines(
+    const TraceAggregateNodeArena &arena,
+    const _ReportLine &line,
+    const _ReportOptions &options,
+    int iterationCount,
+    std::vector<_Index> &children,
+    std::vector<_ReportLine> &stack)
 {
-    // The root of the tree has id == -1, no useful stats there.
+    const int depth = line.depth + 1;
+    if (options.maxDepth > 0 && depth > options.maxDepth) {
+        return;
+    }
 
-    if (node->GetId().IsValid()) {
+    children.clear();
+    double childrenTime = 0.0;
+    for (_Index c = arena.GetFirstChild(line.node);
+            c != TraceAggregateNodeArena::InvalidIndex;
+            c = arena.GetNextSibling(c)) {
+        children.push_back(c);
+        childrenTime += arena.GetInclusiveTime(c);
+    }
+    if (children.empty()) {
+        return;
+    }
 
-        if (node->IsRecursionMarker()) {
-            _PrintRecursionMarker(s, _GetKeyName(node->GetKey()), indent);
-            return;
+    if (options.sortOrder != _ReportOptions::SortOrder::None) {
+        std::stable_sort(children.begin(), children.end(),
+            [&](_Index a, _Index b) {
+                return _GetSortTime(arena, a, options.sortOrder) >
+                       _GetSortTime(arena, b, options.sortOrder);
+            });
+    }
+
+    // Recursion markers only show where a recursive call was folded, so
+    // they are never pruned.
+    auto isPruned = [&](_Index c, double threadTime) {
+        if (arena.IsRecursionMarker(c)) {
+            return false;
         }
+        const double inclusive = arena.GetInclusiveTime(c);
+        const double ms =
+            ArchTicksToSeconds(uint64_t(inclusive)) * 1e3 / iterationCount;
+        return ms < options.minimumTime ||
+            (threadTime > 0.0 &&
+             inclusive * 100.0 / threadTime < options.minimumPercentage);
+    };
+
+    // The threads are relative to their total time.
+    const double threadTime = line.depth == 0 ? childrenTime : line.threadTime;
+    std::vector<bool> pruned(children.size());
+    size_t numKept = 0;
+    for (size_t i = 0; i < children.size(); ++i) {
+        pruned[i] = isPruned(children[i], threadTime);
+        numKept += !pruned[i] && !arena.IsRecursionMarker(children[i]);
+    }
 
-        bool r = node->IsRecursionHead();
-        _PrintLineTimes(s, node->GetInclusiveTime(), node->GetExclusiveTime(r),
-                        node->GetCount(r), _GetKeyName(node->GetKey()),
-                        indent, r, iterationCount);
+    if (options.maxChildren > 0 && numKept > options.maxChildren) {
+        // Keep the children with the largest times, in their current order.
+        const _ReportOptions::SortOrder sortOrder =
+            options.sortOrder == _ReportOptions::SortOrder::None
+            ? _ReportOptions::SortOrder::InclusiveTime : options.sortOrder;
+        std::vector<size_t> ranked;
+        for (size_t i = 0; i < children.size(); ++i) {
+            if (!pruned[i] && !arena.IsRecursionMarker(children[i])) {
+                ranked.push_back(i);
+            }
+        }
+        std::stable_sort(ranked.begin(), ranked.end(),
+            [&](size_t a, size_t b) {
+                return _GetSortTime(arena, children[a], sortOrder) >
+                       _GetSortTime(arena, children[b], sortOrder);
+            });
+        for (size_t i = options.maxChildren; i < ranked.size(); ++i) {
+            pruned[ranked[i]] = true;
+        }
     }
 
-    // sort children by inclusive time on output
-    std::vector<TraceAggregateNodeRefPtr> sortedKids;
-    for (const TraceAggregateNodeRefPtr& it : node->GetChildrenRef()) {
-        sortedKids.push_back(it);
+    _ReportLine others{TraceAggregateNodeArena::InvalidIndex, depth,
+        threadTime, 0.0, 0.0, 0, 0};
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (pruned[i]) {
+            const _Index c = children[i];
+            const bool r = arena.IsRecursionHead(c);
+            others.inclusive += arena.GetInclusiveTime(c);
+            others.exclusive += arena.GetExclusiveTime(c, r);
+            others.count += arena.GetCount(c, r);
+            ++others.numOthers;
+        }
     }
-    
-    for (const TraceAggregateNodeRefPtr& it : sortedKids) {
-        _PrintNodeTimes(s, it, indent+2, iterationCount);
+    if (others.numOthers > 0) {
+        stack.push_back(others);
+    }
+
+    for (size_t i = children.size(); i-- > 0; ) {
+        if (!pruned[i]) {
+            const _Index c = children[i];
+            stack.push_back(_ReportLine{c, depth,
+                line.depth == 0 ? double(arena.GetInclusiveTime(c))
+                                : threadTime,
+                0.0, 0.0, 0, 0});
+        }
+    }
+}
+
+static void
+_PrintNodeTimes(
+    ostream &s,
+    const TraceAggregateNodeArena &arena,
+    _Index root,
+    const _ReportOptions &options,
+    int iterationCount)
+{
+    // The tree is walked with an explicit stack, so that deep call trees
+    // cannot overflow the call stack.
+    std::vector<_Index> children;
+    std::vector<_ReportLine> stack;
+    stack.push_back(_ReportLine{root, 0, 0.0, 0.0, 0.0, 0, 0});
+    while (!stack.empty()) {
+        const _ReportLine line = stack.back();
+        stack.pop_back();
+        const int indent = 2 * line.depth;
+
+        if (line.node == TraceAggregateNodeArena::InvalidIndex) {
+            _PrintLineTimes(s, line.inclusive, line.exclusive, line.count,
+                TfStringPrintf("(%zu other%s)", line.numOthers,
+                               line.numOthers == 1 ? "" : "s"),
+                indent, false, iterationCount);
+            continue;
+        }
+
+        // The root of the tree has id == -1, no useful stats there.
+        if (arena.HasValidId(line.node)) {
+
+            if (arena.IsRecursionMarker(line.node)) {
+                _PrintRecursionMarker(
+                    s, _GetKeyName(arena.GetKey(line.node)), indent);
+                continue;
+            }
+
+            bool r = arena.IsRecursionHead(line.node);
+            _PrintLineTimes(s, arena.GetInclusiveTime(line.node),
+                            arena.GetExclusiveTime(line.node, r),
+                            arena.GetCount(line.node, r),
+                            _GetKeyName(arena.GetKey(line.node)),
+                            indent, r, iterationCount);
+        }
+
+        _PushChildLines(
+            arena, line, options, iterationCount, children, stack);
     }
 }
 
@@ -210,6 +369,19 @@ TraceReporter::Report(
     if (iterationCount > 1)
         s << "\nNumber of iterations: " << iterationCount << "\n";
 
+    if (_overflowCount > 0) {
+        s << "\n" << TraceReporterTokens->warningString
+          << " The memory limit of the collector was exceeded "
+          << _overflowCount << " times";
+        if (_recordingPaused) {
+            s << ", recording was paused";
+        }
+        if (_droppedEventCount > 0) {
+            s << ", " << _droppedEventCount << " events were dropped";
+        }
+        s << "\n";
+    }
+
     s << "\nTree view  ==============\n";
     if (iterationCount == 1)
         s << "   inclusive    exclusive        \n";
@@ -217,7 +389,8 @@ TraceReporter::Report(
         s << "  incl./iter   excl./iter       samples/iter\n";
     }
 
-    _PrintNodeTimes(s, _aggregateTree->GetRoot(), 0, iterationCount);
+    _PrintNodeTimes(s, _aggregateTree->GetNodeArena(),
+        _aggregateTree->GetRootIndex(), _reportOptions, iterationCount);
 
     s << "\n";
 }
@@ -303,7 +476,7 @@ TraceReporter::LoadReport(
     int currentIters = 1;
 
     std::vector<ParsedTree> result;
-    std::stack<TraceAggregateNodePtr> stack;
+    std::stack<TraceAggregateNodeArena::Index> stack;
     for (std::string line; std::getline(stream, line);) {
         // When finding the tree, only parse for the tree header and the 
         // iteration count.
@@ -311,7 +484,7 @@ TraceReporter::LoadReport(
             if (line == treeHeader) {
                 state = State::ReadingTree;
                 currentTree = TraceAggregateTree::New();
-                stack.push(currentTree->GetRoot());
+                stack.push(currentTree->GetRootIndex());
 
                 // By this point we've already seen the iteration count for this
                 // tree.
@@ -352,18 +525,19 @@ TraceReporter::LoadReport(
         while (stack.size() > depth+1) {
             stack.pop();
         }
-        TraceAggregateNodePtr &parent = stack.top();
+        TraceAggregateNodeArena &arena = currentTree->GetNodeArena();
 
         // Add a new node.
         // Sample count may be a double if there's >1 iterations.
         const int samples = std::round(currentIters*TfStringToDouble(match[3]));
-        stack.push(parent->Append(
-            TraceReporter::CreateValidEventId(),
-            /* key */ TfToken(match[5].str()),
+        stack.push(arena.AppendChild(
+            stack.top(),
+            /* key */ arena.AddKey(TfToken(match[5].str())),
             /* timestamp */ ArchSecondsToTicks(
                 currentIters*TfStringToDouble(match[1])/1000.0),
             /* count */ samples,
-            /* exclusiveCount */ samples));
+            /* exclusiveCount */ samples,
+            /* hasValidId */ true));
     }
 
     return result;
@@ -385,7 +559,16 @@ TraceReporter::ReportChromeTracing(std::ostream &s)
     UpdateTraceTrees();
 
     JsWriter w(s);
-    _eventTree->WriteChromeTraceObject(w);
+    _eventTree->WriteChromeTraceObject(w, _counterDownsampler);
+}
+
+void
+TraceReporter::ReportContention(std::ostream &s, size_t maxLocks)
+{
+    UpdateTraceTrees();
+
+    TraceLockContention::New(_aggregateTree)->Report(s, maxLocks);
+    s << "\n";
 }
 
 
@@ -423,6 +606,9 @@ TraceReporter::ClearTree()
 { 
     _aggregateTree->Clear();
     _eventTree = TraceEventTree::New();
+    _overflowCount = 0;
+    _droppedEventCount = 0;
+    _recordingPaused = false;
     _Clear();
 }
 
@@ -432,12 +618,36 @@ TraceReporter::GetAggregateTreeRoot()
     return _aggregateTree->GetRoot();
 }
 
+TraceAggregateTreeRefPtr
+TraceReporter::GetAggregateTree()
+{
+    return _aggregateTree;
+}
+
 TraceEventNodeRefPtr
 TraceReporter::GetEventRoot()
 {
     return _eventTree->GetRoot();
 }
 
+uint64_t
+TraceReporter::GetOverflowCount() const
+{
+    return _overflowCount;
+}
+
+uint64_t
+TraceReporter::GetDroppedEventCount() const
+{
+    return _droppedEventCount;
+}
+
+bool
+TraceReporter::WasRecordingPaused() const
+{
+    return _recordingPaused;
+}
+
 TraceEventTreeRefPtr
 TraceReporter::GetEventTree()
 {
@@ -463,6 +673,12 @@ TraceReporter::AddCounter(const TfToken &key, int index, double totalValue)
     return _aggregateTree->AddCounter(key, index, totalValue);
 }
 
+TraceCounterDownsampler::CounterValuesMap
+TraceReporter::GetCounterValues()
+{
+    return _counterDownsampler.Downsample(_eventTree->GetCounters());
+}
+
 void
 TraceReporter::SetGroupByFunction(bool groupByFunction)
 {
@@ -499,6 +715,31 @@ TraceReporter::ShouldAdjustForOverheadAndNoise() const
     return _shouldAdjustForOverheadAndNoise;
 }
 
+void
+TraceReporter::SetCounterDownsampler(
+    const TraceCounterDownsampler& downsampler)
+{
+    _counterDownsampler = downsampler;
+}
+
+const TraceCounterDownsampler&
+TraceReporter::GetCounterDownsampler() const
+{
+    return _counterDownsampler;
+}
+
+void
+TraceReporter::SetReportOptions(const ReportOptions& options)
+{
+    _reportOptions = options;
+}
+
+const TraceReporter::ReportOptions&
+TraceReporter::GetReportOptions() const
+{
+    return _reportOptions;
+}
+
 /* static */
 TraceAggregateNode::Id
 TraceReporter::CreateValidEventId() 
@@ -520,6 +761,10 @@ TraceReporter::_ProcessCollection(
 
         TraceEventTreeRefPtr newGraph = _eventTree->Add(*collection);
         _aggregateTree->Append(newGraph, *collection);
+
+        _overflowCount += collection->GetOverflowCount();
+        _droppedEventCount += collection->GetDroppedEventCount();
+        _recordingPaused |= collection->WasRecordingPaused();
     }
 }
 
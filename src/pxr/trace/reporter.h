@@ -13,6 +13,7 @@
 #include "pxr/trace/api.h"
 #include "pxr/trace/event.h"
 #include "pxr/trace/aggregateNode.h"
+#include "pxr/trace/counterDownsampler.h"
 #include "pxr/trace/reporterBase.h"
 
 #include <pxr/tf/declarePtrs.h>
@@ -80,11 +81,51 @@ public:
         return _label;
     }
 
+    /// Options which reduce the call tree written by Report() for large
+    /// traces. The default options write every node, in the order in which
+    /// the calls were first made.
+    struct ReportOptions {
+        /// The order in which the children of a node are written.
+        enum class SortOrder {
+            None,          ///< The order of the first calls.
+            InclusiveTime, ///< Decreasing inclusive time.
+            ExclusiveTime  ///< Decreasing exclusive time.
+        };
+
+        ReportOptions()
+            : sortOrder(SortOrder::None)
+            , minimumTime(0.0)
+            , minimumPercentage(0.0)
+            , maxDepth(0)
+            , maxChildren(0) {}
+
+        SortOrder sortOrder;
+
+        /// Inclusive time in milliseconds per iteration, below which a node
+        /// is rolled into the "others" line of its parent.
+        double minimumTime;
+
+        /// Percentage of the inclusive time of its thread, below which a
+        /// node is rolled into the "others" line of its parent.
+        double minimumPercentage;
+
+        /// Depth of the deepest nodes written, threads being at depth 1, or
+        /// 0 to write every depth.
+        int maxDepth;
+
+        /// Number of children written per node, or 0 to write all of them.
+        /// The children with the largest times, as given by the sort order or
+        /// by the inclusive time when unsorted, are written and the others
+        /// are rolled into an "others" line.
+        size_t maxChildren;
+    };
+
     /// \name Report Generation.
     /// @{
 
     /// Generates a report to the ostream \a s, dividing all times by 
-    /// \a iterationCount.
+    /// \a iterationCount. The call tree is pruned and sorted according to
+    /// the report options.
     TRACE_API void Report(
         std::ostream &s,
         int iterationCount=1);
@@ -93,9 +134,16 @@ public:
     TRACE_API void ReportTimes(std::ostream &s);
 
     /// Generates a timeline trace report suitable for viewing in
-    /// Chrome's trace viewer.
+    /// Chrome's trace viewer. Counter values are reduced by the counter
+    /// downsampler.
     TRACE_API void ReportChromeTracing(std::ostream &s);
 
+    /// Generates a report of the mutexes which threads waited for to the
+    /// ostream \a s, with the call paths which waited. Only the \a maxLocks
+    /// mutexes with the longest wait times are written, or all of them if it
+    /// is 0. \sa TraceLockContention \sa TraceMutexWrapper
+    TRACE_API void ReportContention(std::ostream &s, size_t maxLocks = 10);
+
     /// @}
 
     /// \name Report Loading.
@@ -123,12 +171,29 @@ public:
     /// Returns the root node of the aggregated call tree.
     TRACE_API TraceAggregateNodePtr GetAggregateTreeRoot();
 
+    /// Returns the aggregated call tree.
+    TRACE_API TraceAggregateTreeRefPtr GetAggregateTree();
+
     /// Returns the root node of the call tree.
     TRACE_API TraceEventNodeRefPtr GetEventRoot();
 
     /// Returns the event call tree
     TRACE_API TraceEventTreeRefPtr GetEventTree();
 
+    /// Returns the number of block allocations which exceeded the memory
+    /// limit of the TraceCollector while the processed collections were
+    /// recorded. \sa TraceCollector::SetMemoryLimit
+    TRACE_API uint64_t GetOverflowCount() const;
+
+    /// Returns the number of events of the processed collections which were
+    /// dropped to stay below the memory limit of the TraceCollector.
+    TRACE_API uint64_t GetDroppedEventCount() const;
+
+    /// Returns true if the TraceCollector paused recording because the
+    /// memory limit was exceeded while the processed collections were
+    /// recorded. \sa TraceCollector::OverflowPolicy
+    TRACE_API bool WasRecordingPaused() const;
+
     /// \name Counters
     /// @{
 
@@ -147,6 +212,10 @@ public:
     /// index already exists.
     TRACE_API bool AddCounter(const TfToken &key, int index, double totalValue);
 
+    /// Returns the values over time of the counters of the event tree,
+    /// reduced by the counter downsampler.
+    TRACE_API TraceCounterDownsampler::CounterValuesMap GetCounterValues();
+
     /// @}
 
     /// This fully re-builds the event and aggregate trees from whatever the 
@@ -189,6 +258,22 @@ public:
     /// noise.
     TRACE_API bool ShouldAdjustForOverheadAndNoise() const;
 
+    /// Sets the downsampler which reduces the counter values written by
+    /// ReportChromeTracing() and returned by GetCounterValues(). Every value
+    /// is kept by default.
+    TRACE_API void SetCounterDownsampler(
+        const TraceCounterDownsampler& downsampler);
+
+    /// Returns the counter downsampler.
+    TRACE_API const TraceCounterDownsampler& GetCounterDownsampler() const;
+
+    /// Sets the options which prune and sort the call tree written by
+    /// Report().
+    TRACE_API void SetReportOptions(const ReportOptions& options);
+
+    /// Returns the report options.
+    TRACE_API const ReportOptions& GetReportOptions() const;
+
     /// @}
 
     /// Creates a valid TraceAggregateNode::Id object.
@@ -213,9 +298,15 @@ private:
     bool _groupByFunction;
     bool _foldRecursiveCalls;
     bool _shouldAdjustForOverheadAndNoise;
+    TraceCounterDownsampler _counterDownsampler;
+    ReportOptions _reportOptions;
 
     TraceAggregateTreeRefPtr _aggregateTree;
     TraceEventTreeRefPtr _eventTree;
+
+    uint64_t _overflowCount;
+    uint64_t _droppedEventCount;
+    bool _recordingPaused;
 };
 
 TRACE_NAMESPACE_CLOSE_SCOPE
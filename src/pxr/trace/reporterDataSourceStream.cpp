@@ -0,0 +1,131 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/reporterDataSourceStream.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/clock.h"
+#include "pxr/trace/streamProtocol.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/defines.h>
+
+#if !defined(ARCH_OS_WINDOWS)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TraceReporterDataSourceStream::ThisRefPtr
+TraceReporterDataSourceStream::New(const std::string& socketPath)
+{
+#if defined(ARCH_OS_WINDOWS)
+    TF_RUNTIME_ERROR("Trace streaming is not supported on this platform");
+    return ThisRefPtr();
+#else
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        TF_CODING_ERROR("Invalid socket path '%s'", socketPath.c_str());
+        return ThisRefPtr();
+    }
+    strncpy(address.sun_path, socketPath.c_str(),
+        sizeof(address.sun_path) - 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        TF_RUNTIME_ERROR("Failed to create socket: %s", strerror(errno));
+        return ThisRefPtr();
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address),
+            sizeof(address)) != 0) {
+        TF_RUNTIME_ERROR("Failed to connect to '%s': %s",
+            socketPath.c_str(), strerror(errno));
+        close(fd);
+        return ThisRefPtr();
+    }
+    return ThisRefPtr(new This(fd));
+#endif
+}
+
+TraceReporterDataSourceStream::TraceReporterDataSourceStream(int socket)
+    : _socket(socket)
+    , _connected(true)
+    , _processId(0)
+    , _receivedEvents(0)
+    , _droppedEvents(0)
+{
+    _thread = std::thread(&This::_Run, this);
+}
+
+TraceReporterDataSourceStream::~TraceReporterDataSourceStream()
+{
+#if !defined(ARCH_OS_WINDOWS)
+    // Unblocks the receiving thread.
+    shutdown(_socket, SHUT_RDWR);
+    _thread.join();
+    close(_socket);
+#endif
+}
+
+void
+TraceReporterDataSourceStream::Clear()
+{
+    _pendingCollections.clear();
+}
+
+std::vector<TraceReporterDataSourceBase::CollectionPtr>
+TraceReporterDataSourceStream::ConsumeData()
+{
+    std::vector<CollectionPtr> collections;
+    CollectionPtr collection;
+    while (_pendingCollections.try_pop(collection)) {
+        collections.emplace_back(std::move(collection));
+    }
+    return collections;
+}
+
+void
+TraceReporterDataSourceStream::_Run()
+{
+#if !defined(ARCH_OS_WINDOWS)
+    // Received events are placed on the timeline of the local collector.
+    Trace_StreamDecoder decoder;
+    decoder.SetTargetClock(TraceClock::GetCalibration());
+    std::vector<std::unique_ptr<TraceCollection>> collections;
+    std::vector<char> buffer(1 << 16);
+    while (true) {
+        const ssize_t n = recv(_socket, buffer.data(), buffer.size(), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        if (!decoder.Decode(buffer.data(), size_t(n), &collections)) {
+            TF_RUNTIME_ERROR("Invalid data received from trace stream");
+            break;
+        }
+        for (std::unique_ptr<TraceCollection>& collection : collections) {
+            _pendingCollections.push(CollectionPtr(std::move(collection)));
+        }
+        collections.clear();
+        _processId.store(decoder.GetProcessId(), std::memory_order_relaxed);
+        _droppedEvents.store(
+            decoder.GetDroppedEventCount(), std::memory_order_relaxed);
+        _receivedEvents.store(
+            decoder.GetEventCount(), std::memory_order_relaxed);
+    }
+#endif
+    _connected.store(false, std::memory_order_release);
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
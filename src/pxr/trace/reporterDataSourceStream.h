@@ -0,0 +1,105 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_REPORTER_DATA_SOURCE_STREAM_H
+#define PXR_TRACE_REPORTER_DATA_SOURCE_STREAM_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/reporterDataSourceBase.h"
+
+#include <tbb/concurrent_queue.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceReporterDataSourceStream
+///
+/// This class is an implementation of TraceReporterDataSourceBase which
+/// receives TraceCollections streamed by a TraceStreamServer, usually running
+/// in another process.
+///
+/// Collections are received by a background thread and returned by the next
+/// call to ConsumeData(), so a TraceReporter using this data source can be
+/// updated periodically to follow a running process. Timestamps are converted
+/// to the TraceClock of this process when the server uses another clock
+/// source:
+///
+/// \code
+/// TraceReporterRefPtr reporter = TraceReporter::New(
+///     "Live", TraceReporterDataSourceStream::New("/tmp/trace.sock"));
+/// while (...) {
+///     reporter->UpdateTraceTrees();
+///     reporter->Report(std::cout);
+/// }
+/// \endcode
+///
+class TraceReporterDataSourceStream : public TraceReporterDataSourceBase {
+public:
+    using This = TraceReporterDataSourceStream;
+    using ThisRefPtr = std::unique_ptr<This>;
+
+    /// Creates a data source connected to the server listening on
+    /// \p socketPath. Returns a null pointer and issues an error if the
+    /// connection failed.
+    TRACE_API static ThisRefPtr New(const std::string& socketPath);
+
+    /// Disconnects from the server.
+    TRACE_API ~TraceReporterDataSourceStream() override;
+
+    /// Removes all references to TraceCollections.
+    TRACE_API void Clear() override;
+
+    /// Returns the TraceCollections received since the last call.
+    TRACE_API std::vector<CollectionPtr> ConsumeData() override;
+
+    /// Returns true while the connection to the server is open.
+    bool IsConnected() const {
+        return _connected.load(std::memory_order_acquire);
+    }
+
+    /// Returns the id of the process streaming the events, or 0 if it is
+    /// not known yet.
+    int GetProcessId() const {
+        return _processId.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the number of events received.
+    uint64_t GetReceivedEventCount() const {
+        return _receivedEvents.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the number of events the server dropped because this or
+    /// another consumer could not keep up.
+    uint64_t GetDroppedEventCount() const {
+        return _droppedEvents.load(std::memory_order_relaxed);
+    }
+
+private:
+    TraceReporterDataSourceStream(int socket);
+
+    // Receives and decodes collections until the connection is closed.
+    void _Run();
+
+    int _socket;
+    std::thread _thread;
+    tbb::concurrent_queue<CollectionPtr> _pendingCollections;
+
+    std::atomic<bool> _connected;
+    std::atomic<int> _processId;
+    std::atomic<uint64_t> _receivedEvents;
+    std::atomic<uint64_t> _droppedEvents;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_REPORTER_DATA_SOURCE_STREAM_H
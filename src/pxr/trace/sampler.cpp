@@ -0,0 +1,390 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/sampler.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/clock.h"
+#include "pxr/trace/collector.h"
+#include "pxr/trace/staticKeyData.h"
+
+#include <pxr/arch/timing.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+#if defined(ARCH_OS_LINUX)
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+static constexpr TraceStaticKeyData _sampleKey("Sample");
+
+#if defined(ARCH_OS_LINUX)
+
+// Returns the address of the instruction at which \p context was
+// interrupted, or 0 if it is not known on this platform.
+static uintptr_t
+_GetProgramCounter(void* context)
+{
+    const ucontext_t* uc = static_cast<const ucontext_t*>(context);
+#if defined(ARCH_CPU_INTEL) && defined(ARCH_BITS_64)
+    return uintptr_t(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(ARCH_CPU_ARM) && defined(ARCH_BITS_64)
+    return uintptr_t(uc->uc_mcontext.pc);
+#else
+    (void)uc;
+    return 0;
+#endif
+}
+
+// Returns the frame pointer of the code interrupted at \p context, or 0 if
+// it is not known on this platform.
+static uintptr_t
+_GetFramePointer(void* context)
+{
+    const ucontext_t* uc = static_cast<const ucontext_t*>(context);
+#if defined(ARCH_CPU_INTEL) && defined(ARCH_BITS_64)
+    return uintptr_t(uc->uc_mcontext.gregs[REG_RBP]);
+#elif defined(ARCH_CPU_ARM) && defined(ARCH_BITS_64)
+    return uintptr_t(uc->uc_mcontext.regs[29]);
+#else
+    (void)uc;
+    return 0;
+#endif
+}
+
+// The SIGPROF action which was installed before the samplers, and the
+// number of samplers which exist.
+static struct sigaction _previousAction;
+static size_t _numSamplers = 0;
+static std::mutex _handlerMutex;
+
+// Returns the clock which measures the CPU time of thread \p tid. This is
+// how the kernel encodes per-thread CPU clocks. Unlike
+// pthread_getcpuclockid(), it does not require the thread to still exist.
+static clockid_t
+_GetThreadCpuClock(pid_t tid)
+{
+    return clockid_t((~unsigned(tid) << 3) | 6);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////
+// Trace_SamplerThreadData
+
+Trace_SamplerThreadData::Trace_SamplerThreadData()
+    : _head(0)
+    , _tail(0)
+    , _samples(new TraceEventList)
+{
+#if defined(ARCH_OS_LINUX)
+    _tid = pid_t(syscall(SYS_gettid));
+
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+        void* stack = nullptr;
+        size_t size = 0;
+        if (pthread_attr_getstack(&attr, &stack, &size) == 0) {
+            _stackBegin = uintptr_t(stack);
+            _stackEnd = _stackBegin + size;
+        }
+        pthread_attr_destroy(&attr);
+    }
+#endif
+}
+
+Trace_SamplerThreadData::~Trace_SamplerThreadData()
+{
+    _StopTimer();
+}
+
+void
+Trace_SamplerThreadData::MoveSamples(TraceEventList* events)
+{
+    std::unique_ptr<TraceEventList> samples(new TraceEventList);
+    {
+        tbb::spin_mutex::scoped_lock lock(_mutex);
+        _Drain();
+        samples.swap(_samples);
+    }
+    if (!samples->IsEmpty()) {
+        events->Append(std::move(*samples));
+    }
+}
+
+void
+Trace_SamplerThreadData::_Record(uintptr_t pc, uintptr_t fp)
+{
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == _Capacity) {
+        // The sampler thread is late, so the sample is dropped.
+        return;
+    }
+
+    _Sample& sample = _ring[head % _Capacity];
+    sample.time = TraceClock::Now();
+    sample.depth = 0;
+    if (pc != 0) {
+        sample.frames[sample.depth++] = pc;
+    }
+
+    // Each frame record holds the address of the record of the caller,
+    // followed by the return address. The stack grows down, so the records
+    // of the callers are at higher addresses. Records outside of the stack
+    // of the thread are not read.
+    while (sample.depth < _MaxDepth &&
+           fp >= _stackBegin && fp + 2 * sizeof(uintptr_t) <= _stackEnd &&
+           fp % sizeof(uintptr_t) == 0) {
+        const uintptr_t* record = reinterpret_cast<const uintptr_t*>(fp);
+        if (record[1] == 0) {
+            break;
+        }
+        sample.frames[sample.depth++] = record[1];
+        if (record[0] <= fp) {
+            break;
+        }
+        fp = record[0];
+    }
+
+    _head.store(head + 1, std::memory_order_release);
+}
+
+void
+Trace_SamplerThreadData::_Drain()
+{
+    const size_t head = _head.load(std::memory_order_acquire);
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+        const _Sample& sample = _ring[tail % _Capacity];
+        _samples->EmplaceBack(TraceEvent::Sample, TraceKey(_sampleKey),
+            sample.time,
+            _samples->StoreStackFrames(sample.frames, sample.depth),
+            Trace_Sampler::Category);
+    }
+    _tail.store(tail, std::memory_order_release);
+}
+
+bool
+Trace_SamplerThreadData::_StartTimer(TraceEvent::TimeStamp interval)
+{
+#if defined(ARCH_OS_LINUX)
+    if (_hasTimer) {
+        return true;
+    }
+
+    // The ring is only written once the timer fires.
+    if (!_ring) {
+        _ring.reset(new _Sample[_Capacity]);
+    }
+
+    sigevent event = {};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_value.sival_ptr = this;
+#if defined(sigev_notify_thread_id)
+    event.sigev_notify_thread_id = _tid;
+#else
+    event._sigev_un._tid = _tid;
+#endif
+
+    // Fails if the thread has exited.
+    if (timer_create(_GetThreadCpuClock(_tid), &event, &_timer) != 0) {
+        return false;
+    }
+
+    const int64_t ns = std::max<int64_t>(ArchTicksToNanoseconds(interval), 1);
+    itimerspec spec = {};
+    spec.it_interval.tv_sec = time_t(ns / 1000000000);
+    spec.it_interval.tv_nsec = long(ns % 1000000000);
+    spec.it_value = spec.it_interval;
+    if (timer_settime(_timer, 0, &spec, nullptr) != 0) {
+        timer_delete(_timer);
+        return false;
+    }
+    _hasTimer = true;
+    return true;
+#else
+    (void)interval;
+    return false;
+#endif
+}
+
+void
+Trace_SamplerThreadData::_StopTimer()
+{
+#if defined(ARCH_OS_LINUX)
+    if (_hasTimer) {
+        timer_delete(_timer);
+        _hasTimer = false;
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+// Trace_Sampler
+
+bool
+Trace_Sampler::IsSupported()
+{
+#if defined(ARCH_OS_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(ARCH_OS_LINUX)
+
+void
+Trace_Sampler::_HandleSignal(int signal, siginfo_t* info, void* context)
+{
+    const int savedErrno = errno;
+
+    // The timer of each thread refers to its data, which is never
+    // destroyed while the collector exists, so signals which are delivered
+    // after sampling stopped are still safe to record.
+    Trace_SamplerThreadData* data = info->si_code == SI_TIMER
+        ? _FindThreadData(
+            TraceCollector::GetInstance(), info->si_value.sival_ptr)
+        : nullptr;
+    if (data) {
+        if (TraceCollector::IsEnabled()) {
+            data->_Record(
+                _GetProgramCounter(context), _GetFramePointer(context));
+        }
+    }
+    else if (_previousAction.sa_flags & SA_SIGINFO) {
+        if (_previousAction.sa_sigaction) {
+            _previousAction.sa_sigaction(signal, info, context);
+        }
+    }
+    else if (_previousAction.sa_handler != SIG_DFL &&
+             _previousAction.sa_handler != SIG_IGN) {
+        _previousAction.sa_handler(signal);
+    }
+
+    errno = savedErrno;
+}
+
+Trace_SamplerThreadData*
+Trace_Sampler::_FindThreadData(TraceCollector& collector, void* value)
+{
+    // The list of threads is only ever prepended to, so it can be read
+    // without locking.
+    for (TraceCollector::_PerThreadData& thread :
+            collector._allPerThreadData) {
+        Trace_SamplerThreadData& data = thread.GetSamplerData();
+        if (&data == value) {
+            return &data;
+        }
+    }
+    return nullptr;
+}
+
+void
+Trace_Sampler::_InstallHandler()
+{
+    std::lock_guard<std::mutex> lock(_handlerMutex);
+    if (_numSamplers++ != 0) {
+        return;
+    }
+
+    struct sigaction action = {};
+    action.sa_sigaction = &Trace_Sampler::_HandleSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &_previousAction);
+}
+
+void
+Trace_Sampler::_RestoreHandler()
+{
+    std::lock_guard<std::mutex> lock(_handlerMutex);
+    if (--_numSamplers != 0) {
+        return;
+    }
+
+    // Signals from the deleted timers may still be pending, and the default
+    // action of SIGPROF terminates the process, so they are ignored instead.
+    struct sigaction action = _previousAction;
+    if (!(action.sa_flags & SA_SIGINFO) && action.sa_handler == SIG_DFL) {
+        action.sa_handler = SIG_IGN;
+    }
+    sigaction(SIGPROF, &action, nullptr);
+}
+
+#endif
+
+Trace_Sampler::Trace_Sampler(
+    TraceCollector& collector, TraceEvent::TimeStamp interval)
+    : _collector(collector)
+    , _interval(interval)
+{
+    TraceCategory::GetInstance().RegisterCategory(Category, "Sample");
+
+#if defined(ARCH_OS_LINUX)
+    _InstallHandler();
+    _thread = std::thread(&Trace_Sampler::_Run, this);
+#endif
+}
+
+Trace_Sampler::~Trace_Sampler()
+{
+    if (_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _stopCondition.notify_one();
+        _thread.join();
+    }
+
+#if defined(ARCH_OS_LINUX)
+    // The timers of the threads were deleted by _Run().
+    _RestoreHandler();
+#endif
+}
+
+void
+Trace_Sampler::_Run()
+{
+    // Rings are drained about twice as often as they fill up on a thread
+    // which uses a whole CPU.
+    const std::chrono::nanoseconds period = std::clamp(
+        std::chrono::nanoseconds(
+            ArchTicksToNanoseconds(_interval) *
+            int64_t(Trace_SamplerThreadData::_Capacity / 2)),
+        std::chrono::nanoseconds(std::chrono::milliseconds(1)),
+        std::chrono::nanoseconds(std::chrono::milliseconds(100)));
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop) {
+        lock.unlock();
+        for (TraceCollector::_PerThreadData& thread :
+                _collector._allPerThreadData) {
+            Trace_SamplerThreadData& data = thread.GetSamplerData();
+            data._StartTimer(_interval);
+            tbb::spin_mutex::scoped_lock dataLock(data._mutex);
+            data._Drain();
+        }
+        lock.lock();
+        _stopCondition.wait_for(lock, period, [this]() { return _stop; });
+    }
+    lock.unlock();
+
+    for (TraceCollector::_PerThreadData& thread :
+            _collector._allPerThreadData) {
+        thread.GetSamplerData()._StopTimer();
+    }
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
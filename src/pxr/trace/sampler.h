@@ -0,0 +1,179 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_SAMPLER_H
+#define PXR_TRACE_SAMPLER_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/category.h"
+#include "pxr/trace/event.h"
+#include "pxr/trace/eventList.h"
+
+#include <pxr/arch/defines.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <tbb/spin_mutex.h>
+
+#if defined(ARCH_OS_LINUX)
+#include <signal.h>
+#include <sys/types.h>
+#include <time.h>
+#endif
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+class TraceCollector;
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \class Trace_SamplerThreadData
+///
+/// This class holds the samples of the stack of one thread.
+///
+/// Samples are taken by a signal handler running on the thread, so they are
+/// first written to a fixed size ring which is allocated up front. The
+/// sampler thread then moves them to an event list as Sample events, which
+/// are appended to the events of the thread when they are collected.
+///
+/// The handler only stores the addresses of the frames, which are resolved
+/// to functions when the samples are reported. It follows the frame
+/// pointers of the stack, so frames of code built without them are missing
+/// from the samples, except for the interrupted one.
+///
+class Trace_SamplerThreadData {
+public:
+    /// Creates the data of the calling thread.
+    Trace_SamplerThreadData();
+
+    ~Trace_SamplerThreadData();
+
+    Trace_SamplerThreadData(const Trace_SamplerThreadData&) = delete;
+    Trace_SamplerThreadData& operator=(
+        const Trace_SamplerThreadData&) = delete;
+
+    /// Moves the samples taken since the last call to the end of \p events.
+    /// This can be called from any thread.
+    void MoveSamples(TraceEventList* events);
+
+private:
+    friend class Trace_Sampler;
+
+    static constexpr size_t _Capacity = 256;
+    static constexpr size_t _MaxDepth = 32;
+
+    struct _Sample {
+        TraceEvent::TimeStamp time;
+        size_t depth;
+        uintptr_t frames[_MaxDepth];
+    };
+
+    // Writes a sample of the stack interrupted at \p pc, whose innermost
+    // frame record is at \p fp, to the ring. Called by the signal handler,
+    // so this must only do async-signal-safe operations.
+    void _Record(uintptr_t pc, uintptr_t fp);
+
+    // Moves the samples in the ring to _samples. _mutex must be held.
+    void _Drain();
+
+    // Starts and stops the timer which interrupts the thread every
+    // \p interval ticks of its CPU time.
+    bool _StartTimer(TraceEvent::TimeStamp interval);
+    void _StopTimer();
+
+    // The ring is written by the thread and read by the sampler thread, each
+    // of them only moving its own end.
+    std::unique_ptr<_Sample[]> _ring;
+    std::atomic<size_t> _head;
+    std::atomic<size_t> _tail;
+
+    // The bounds of the stack of the thread, which limit the frame records
+    // read by the signal handler.
+    uintptr_t _stackBegin = 0;
+    uintptr_t _stackEnd = 0;
+
+    // Guards the reading end of the ring and _samples.
+    tbb::spin_mutex _mutex;
+    std::unique_ptr<TraceEventList> _samples;
+
+#if defined(ARCH_OS_LINUX)
+    pid_t _tid;
+    timer_t _timer;
+    bool _hasTimer = false;
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \class Trace_Sampler
+///
+/// This class runs the sampling profiler of a TraceCollector.
+///
+/// While it exists, every thread which has recorded events in the collector
+/// is interrupted by SIGPROF each time it has used a sampling interval of
+/// CPU time, and its stack is recorded. A background thread starts the
+/// timers of new threads and moves the samples out of their rings.
+///
+/// The SIGPROF handler is installed while a sampler exists. Signals which
+/// are not sent by its timers are passed on to the handler which was
+/// installed before, which is restored when the last sampler is destroyed.
+///
+/// Sampling is only implemented on Linux.
+///
+class Trace_Sampler {
+public:
+    /// The category of Sample events.
+    static constexpr TraceCategoryId Category =
+        TraceCategory::CreateTraceCategoryId("Sample");
+
+    /// Starts sampling the threads of \p collector every \p interval ticks
+    /// of their CPU time.
+    Trace_Sampler(TraceCollector& collector, TraceEvent::TimeStamp interval);
+
+    /// Stops sampling. Samples which were taken remain in the threads until
+    /// they are collected.
+    ~Trace_Sampler();
+
+    Trace_Sampler(const Trace_Sampler&) = delete;
+    Trace_Sampler& operator=(const Trace_Sampler&) = delete;
+
+    /// Returns whether sampling is available on this platform.
+    static bool IsSupported();
+
+private:
+    void _Run();
+
+#if defined(ARCH_OS_LINUX)
+    static void _HandleSignal(int signal, siginfo_t* info, void* context);
+
+    // Installs the signal handler for the first sampler and restores the
+    // previous one after the last sampler.
+    static void _InstallHandler();
+    static void _RestoreHandler();
+
+    // Returns the data of a thread of \p collector whose address is
+    // \p value, or null if there is none.
+    static Trace_SamplerThreadData* _FindThreadData(
+        TraceCollector& collector, void* value);
+#endif
+
+    TraceCollector& _collector;
+    TraceEvent::TimeStamp _interval;
+
+    std::mutex _mutex;
+    std::condition_variable _stopCondition;
+    bool _stop = false;
+    std::thread _thread;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_SAMPLER_H
@@ -0,0 +1,74 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/scopeStats.h"
+
+#include "pxr/trace/pxr.h"
+
+#include <cmath>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+void
+TraceScopeStats::Merge(const TraceScopeStats& other)
+{
+    if (other._count == 0) {
+        return;
+    }
+    _count += other._count;
+    _total += other._total;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    for (size_t i = 0; i < NumBuckets; ++i) {
+        _histogram[i] += other._histogram[i];
+    }
+}
+
+TraceScopeStats::TimeStamp
+TraceScopeStats::GetPercentile(double percentile) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+    if (percentile <= 0.0) {
+        return _min;
+    }
+    if (percentile >= 100.0) {
+        return _max;
+    }
+
+    // Rank of the duration in the sorted durations, starting at 1.
+    const uint64_t rank = std::max<uint64_t>(1,
+        uint64_t(std::ceil(percentile / 100.0 * double(_count))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NumBuckets; ++i) {
+        seen += _histogram[i];
+        if (seen >= rank) {
+            // Use the middle of the bucket, within the recorded range.
+            const TimeStamp lower = GetBucketLowerBound(i);
+            const TimeStamp upper = GetBucketLowerBound(i + 1);
+            const TimeStamp value = lower + (upper - lower) / 2;
+            return std::min(std::max(value, _min), _max);
+        }
+    }
+    return _max;
+}
+
+TraceScopeStats::TimeStamp
+TraceScopeStats::GetBucketLowerBound(size_t index)
+{
+    if (index < 2 * SubBuckets) {
+        return TimeStamp(index);
+    }
+    const size_t msb = index / SubBuckets + 1;
+    if (msb > 63) {
+        return std::numeric_limits<TimeStamp>::max();
+    }
+    const TimeStamp sub = index % SubBuckets;
+    return (SubBuckets + sub) << (msb - 2);
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
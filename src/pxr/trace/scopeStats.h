@@ -0,0 +1,134 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_SCOPE_STATS_H
+#define PXR_TRACE_SCOPE_STATS_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/api.h"
+#include "pxr/trace/event.h"
+
+#include <pxr/arch/defines.h>
+
+#if defined(ARCH_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceScopeStats
+///
+/// This class accumulates statistics about the durations of a scope: the
+/// number of times it was recorded, the total, minimum and maximum durations
+/// and a logarithmic histogram from which percentiles are estimated.
+///
+/// Each power of two of the histogram is split in \c SubBuckets buckets, so
+/// estimated percentiles are within 25% of the exact value whatever the
+/// magnitude of the durations. The memory used does not depend on the number
+/// of durations recorded.
+///
+/// Durations are expressed in ticks, see ArchTicksToSeconds().
+///
+class TraceScopeStats {
+public:
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    /// Number of buckets for each power of two.
+    static constexpr size_t SubBuckets = 4;
+
+    /// Number of buckets of the histogram.
+    static constexpr size_t NumBuckets = 64 * SubBuckets;
+
+    using Histogram = std::array<uint64_t, NumBuckets>;
+
+    /// Constructor.
+    TraceScopeStats()
+        : _count(0)
+        , _total(0)
+        , _min(std::numeric_limits<TimeStamp>::max())
+        , _max(0)
+        , _histogram() {}
+
+    /// Adds a \p duration.
+    void Record(TimeStamp duration) {
+        ++_count;
+        _total += duration;
+        _min = std::min(_min, duration);
+        _max = std::max(_max, duration);
+        ++_histogram[GetBucket(duration)];
+    }
+
+    /// Adds the durations recorded in \p other.
+    TRACE_API void Merge(const TraceScopeStats& other);
+
+    /// Returns the number of durations recorded.
+    uint64_t GetCount() const { return _count; }
+
+    /// Returns the sum of the durations.
+    TimeStamp GetTotal() const { return _total; }
+
+    /// Returns the shortest duration, or 0 if none was recorded.
+    TimeStamp GetMin() const { return _count ? _min : 0; }
+
+    /// Returns the longest duration.
+    TimeStamp GetMax() const { return _max; }
+
+    /// Returns the mean duration, or 0 if none was recorded.
+    double GetMean() const {
+        return _count ? double(_total) / double(_count) : 0.0;
+    }
+
+    /// Returns an estimate of the \p percentile (between 0 and 100) of the
+    /// durations, or 0 if none was recorded.
+    TRACE_API TimeStamp GetPercentile(double percentile) const;
+
+    /// Returns the number of durations in each bucket.
+    const Histogram& GetHistogram() const { return _histogram; }
+
+    /// Returns the index of the bucket containing \p duration.
+    static size_t GetBucket(TimeStamp duration) {
+        if (duration < 2 * SubBuckets) {
+            return size_t(duration);
+        }
+        const size_t msb = _GetMostSignificantBit(duration);
+        const size_t sub = size_t(duration >> (msb - 2)) & (SubBuckets - 1);
+        return (msb - 1) * SubBuckets + sub;
+    }
+
+    /// Returns the smallest duration of the bucket at \p index.
+    TRACE_API static TimeStamp GetBucketLowerBound(size_t index);
+
+private:
+    static size_t _GetMostSignificantBit(uint64_t value) {
+#if defined(ARCH_COMPILER_MSVC)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return size_t(index);
+#else
+        return size_t(63 - __builtin_clzll(value));
+#endif
+    }
+
+    // TraceCollector reads the statistics accumulated by each thread.
+    friend class TraceCollector;
+
+    uint64_t _count;
+    TimeStamp _total;
+    TimeStamp _min;
+    TimeStamp _max;
+    Histogram _histogram;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_SCOPE_STATS_H
@@ -0,0 +1,914 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/sharedMemoryRing.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/clock.h"
+#include "pxr/trace/eventData.h"
+#include "pxr/trace/eventList.h"
+#include "pxr/trace/threads.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/mallocTag.h>
+#include <pxr/arch/defines.h>
+
+#if defined(ARCH_OS_WINDOWS)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <utility>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+constexpr uint64_t _Magic = 0x676e695265636172; // "raceRing"
+constexpr uint32_t _Version = 2;
+
+// Maximum number of events reserved in the ring at once.
+constexpr size_t _MaxBlockSize = 256;
+
+// Maximum number of processes whose clock calibration is stored.
+constexpr size_t _MaxCalibrations = 256;
+
+// How long to wait for another process to finish creating the region.
+constexpr std::chrono::seconds _OpenTimeout(5);
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+    "Shared memory requires lock free 64 bit atomics");
+
+struct _Header {
+    // Set last by the process creating the region.
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t capacity;
+    uint64_t stringTableCapacity;
+    uint64_t stringStorageSize;
+    uint64_t totalSize;
+    std::atomic<uint64_t> writeIndex;
+    std::atomic<uint64_t> storageUsed;
+    std::atomic<uint64_t> droppedEvents;
+};
+
+// An event in the ring. Fields are atomic because readers may load them
+// while they are being written; readers use the sequence number to discard
+// such events.
+struct _Record {
+    // The index of the event plus one once it is fully written, 0 while it
+    // is being written.
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> time;
+    std::atomic<uint64_t> payload;
+    // Process id in the high bits, thread name id in the low bits.
+    std::atomic<uint64_t> source;
+    // Key id in the high bits, category in the low bits.
+    std::atomic<uint64_t> key;
+    // Event type in the low byte, data type in the next byte.
+    std::atomic<uint64_t> type;
+};
+
+// The clock calibration of a process which wrote events. The fields are
+// guarded by a sequence lock: the sequence is odd while a writer updates
+// them, and readers retry if it changed while they loaded them.
+struct _CalibrationSlot {
+    // The id of the process, 0 while the slot is free.
+    std::atomic<uint64_t> processId;
+    std::atomic<uint64_t> sequence;
+    // String ids of the clock source and host name.
+    std::atomic<uint64_t> source;
+    std::atomic<uint64_t> host;
+    std::atomic<uint64_t> ticksPerSecond;
+    std::atomic<uint64_t> anchor;
+    std::atomic<uint64_t> realtime;
+    std::atomic<uint64_t> monotonic;
+    std::atomic<uint64_t> uncertainty;
+};
+
+// A string of the shared string table.
+struct _StringSlot {
+    enum State : uint32_t { Empty, Writing, Ready, Invalid };
+
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> length;
+    std::atomic<uint64_t> hash;
+    std::atomic<uint64_t> offset;
+};
+
+// An event read from or to be written to the ring.
+struct _EventRecord {
+    uint64_t time;
+    uint64_t payload;
+    uint64_t source;
+    uint64_t key;
+    uint64_t type;
+};
+
+static size_t
+_AlignUp(size_t n)
+{
+    return (n + 63) & ~size_t(63);
+}
+
+static size_t
+_RoundUpToPowerOfTwo(size_t n)
+{
+    size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static uint64_t
+_HashString(const std::string& str)
+{
+    // FNV-1a, which unlike std::hash is stable across processes and builds.
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const char c : str) {
+        hash ^= uint8_t(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+static uint64_t
+_DoubleToBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double
+_BitsToDouble(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // anonymous namespace
+
+// The mapped shared memory region.
+struct TraceSharedMemoryRing::_Region {
+    ~_Region() {
+#if defined(ARCH_OS_WINDOWS)
+        if (address) {
+            UnmapViewOfFile(address);
+        }
+        if (handle) {
+            CloseHandle(handle);
+        }
+#else
+        if (address) {
+            munmap(address, size);
+        }
+        if (isOwner) {
+            shm_unlink(systemName.c_str());
+        }
+#endif
+    }
+
+    // Sets the pointers to the parts of the region from the header.
+    void SetLayout() {
+        const size_t calibrationsOffset = _AlignUp(sizeof(_Header));
+        const size_t recordsOffset = _AlignUp(
+            calibrationsOffset + _MaxCalibrations * sizeof(_CalibrationSlot));
+        const size_t slotsOffset = _AlignUp(
+            recordsOffset + header->capacity * sizeof(_Record));
+        const size_t storageOffset = _AlignUp(
+            slotsOffset + header->stringTableCapacity * sizeof(_StringSlot));
+
+        char* base = static_cast<char*>(address);
+        calibrations =
+            reinterpret_cast<_CalibrationSlot*>(base + calibrationsOffset);
+        records = reinterpret_cast<_Record*>(base + recordsOffset);
+        slots = reinterpret_cast<_StringSlot*>(base + slotsOffset);
+        storage = base + storageOffset;
+    }
+
+    static size_t ComputeSize(const Options& options) {
+        return _AlignUp(_AlignUp(_AlignUp(_AlignUp(sizeof(_Header))
+            + _MaxCalibrations * sizeof(_CalibrationSlot))
+            + options.capacity * sizeof(_Record))
+            + options.stringTableCapacity * sizeof(_StringSlot))
+            + options.stringStorageSize;
+    }
+
+    // Returns the string with id \p id, or an empty string if the id is
+    // not valid.
+    std::string GetString(uint32_t id) const {
+        if (id == 0 || id > header->stringTableCapacity) {
+            return std::string();
+        }
+        const _StringSlot& slot = slots[id - 1];
+        if (slot.state.load(std::memory_order_acquire) != _StringSlot::Ready) {
+            return std::string();
+        }
+        return std::string(
+            storage + slot.offset.load(std::memory_order_relaxed),
+            slot.length.load(std::memory_order_relaxed));
+    }
+
+    // Returns the slot of the calibration of \p processId, claiming a free
+    // slot if \p claim is true. Returns null if there is no such slot.
+    _CalibrationSlot* FindCalibration(uint32_t processId, bool claim) const {
+        for (size_t i = 0; i < _MaxCalibrations; ++i) {
+            _CalibrationSlot& slot = calibrations[i];
+            uint64_t id = slot.processId.load(std::memory_order_acquire);
+            if (id == 0 && claim) {
+                slot.processId.compare_exchange_strong(
+                    id, processId, std::memory_order_acq_rel);
+                if (id == 0) {
+                    return &slot;
+                }
+            }
+            if (id == processId) {
+                return &slot;
+            }
+            if (id == 0) {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the calibration of the events of \p processId, or an invalid
+    // calibration if it was not stored.
+    TraceClockCalibration GetCalibration(uint32_t processId) const {
+        TraceClockCalibration calibration;
+        const _CalibrationSlot* slot = FindCalibration(processId, false);
+        if (!slot) {
+            return calibration;
+        }
+        for (;;) {
+            const uint64_t sequence =
+                slot->sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            const uint64_t source =
+                slot->source.load(std::memory_order_relaxed);
+            const uint64_t host = slot->host.load(std::memory_order_relaxed);
+            calibration.ticksPerSecond = _BitsToDouble(
+                slot->ticksPerSecond.load(std::memory_order_relaxed));
+            calibration.anchor = slot->anchor.load(std::memory_order_relaxed);
+            calibration.realtime =
+                int64_t(slot->realtime.load(std::memory_order_relaxed));
+            calibration.monotonic =
+                int64_t(slot->monotonic.load(std::memory_order_relaxed));
+            calibration.uncertainty =
+                slot->uncertainty.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->sequence.load(std::memory_order_relaxed) == sequence) {
+                calibration.source = GetString(uint32_t(source));
+                calibration.host = GetString(uint32_t(host));
+                return calibration;
+            }
+        }
+    }
+
+    void* address = nullptr;
+    size_t size = 0;
+#if defined(ARCH_OS_WINDOWS)
+    HANDLE handle = nullptr;
+#endif
+    std::string systemName;
+    bool isOwner = false;
+
+    _Header* header = nullptr;
+    _CalibrationSlot* calibrations = nullptr;
+    _Record* records = nullptr;
+    _StringSlot* slots = nullptr;
+    char* storage = nullptr;
+};
+
+TraceSharedMemoryRingRefPtr
+TraceSharedMemoryRing::New(const std::string& name, const Options& options)
+{
+    if (name.empty()) {
+        TF_CODING_ERROR("Shared memory ring requires a name");
+        return ThisRefPtr();
+    }
+    if (options.capacity == 0 || options.stringTableCapacity == 0 ||
+        options.stringStorageSize == 0) {
+        TF_CODING_ERROR("Invalid shared memory ring options: capacity %zu, "
+            "string table capacity %zu, string storage size %zu",
+            options.capacity, options.stringTableCapacity,
+            options.stringStorageSize);
+        return ThisRefPtr();
+    }
+
+    Options layout = options;
+    layout.stringTableCapacity =
+        _RoundUpToPowerOfTwo(options.stringTableCapacity);
+    const size_t size = _Region::ComputeSize(layout);
+
+    std::unique_ptr<_Region> region(new _Region);
+
+#if defined(ARCH_OS_WINDOWS)
+    region->systemName = "Local\\" + name;
+    region->handle = CreateFileMappingA(
+        INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        DWORD(uint64_t(size) >> 32), DWORD(size & 0xffffffff),
+        region->systemName.c_str());
+    if (!region->handle) {
+        TF_RUNTIME_ERROR("Failed to create shared memory '%s'",
+            name.c_str());
+        return ThisRefPtr();
+    }
+    region->isOwner = GetLastError() != ERROR_ALREADY_EXISTS;
+    region->address = MapViewOfFile(
+        region->handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!region->address) {
+        TF_RUNTIME_ERROR("Failed to map shared memory '%s'", name.c_str());
+        return ThisRefPtr();
+    }
+    MEMORY_BASIC_INFORMATION info;
+    VirtualQuery(region->address, &info, sizeof(info));
+    region->size = info.RegionSize;
+#else
+    region->systemName = name[0] == '/' ? name : "/" + name;
+    int fd = shm_open(
+        region->systemName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        region->isOwner = true;
+        if (ftruncate(fd, off_t(size)) != 0) {
+            TF_RUNTIME_ERROR("Failed to allocate %zu bytes of shared memory "
+                "'%s'", size, name.c_str());
+            close(fd);
+            shm_unlink(region->systemName.c_str());
+            return ThisRefPtr();
+        }
+        region->size = size;
+    } else {
+        fd = shm_open(region->systemName.c_str(), O_RDWR, 0600);
+        if (fd < 0) {
+            TF_RUNTIME_ERROR("Failed to open shared memory '%s'",
+                name.c_str());
+            return ThisRefPtr();
+        }
+        // The creating process may not have sized the region yet.
+        const auto deadline = std::chrono::steady_clock::now() + _OpenTimeout;
+        struct stat st;
+        while (fstat(fd, &st) == 0 && st.st_size == 0 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        region->size = size_t(st.st_size);
+        if (region->size < sizeof(_Header)) {
+            TF_RUNTIME_ERROR("Shared memory '%s' is not a trace ring",
+                name.c_str());
+            close(fd);
+            return ThisRefPtr();
+        }
+    }
+    region->address = mmap(nullptr, region->size, PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd, 0);
+    close(fd);
+    if (region->address == MAP_FAILED) {
+        region->address = nullptr;
+        TF_RUNTIME_ERROR("Failed to map shared memory '%s'", name.c_str());
+        return ThisRefPtr();
+    }
+#endif
+
+    region->header = static_cast<_Header*>(region->address);
+    _Header* header = region->header;
+    if (region->isOwner) {
+        // The region is zero filled, which is the initial state of all the
+        // atomics.
+        header->version = _Version;
+        header->headerSize = uint32_t(sizeof(_Header));
+        header->capacity = layout.capacity;
+        header->stringTableCapacity = layout.stringTableCapacity;
+        header->stringStorageSize = layout.stringStorageSize;
+        header->totalSize = size;
+        header->magic.store(_Magic, std::memory_order_release);
+    } else {
+        const auto deadline = std::chrono::steady_clock::now() + _OpenTimeout;
+        while (header->magic.load(std::memory_order_acquire) != _Magic &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (header->magic.load(std::memory_order_acquire) != _Magic ||
+            header->version != _Version ||
+            header->headerSize != sizeof(_Header) ||
+            header->totalSize > region->size) {
+            TF_RUNTIME_ERROR("Shared memory '%s' is not a compatible trace "
+                "ring", name.c_str());
+            return ThisRefPtr();
+        }
+    }
+    region->SetLayout();
+
+    return TfCreateRefPtr(new This(name, std::move(region)));
+}
+
+TraceSharedMemoryRing::TraceSharedMemoryRing(
+    const std::string& name, std::unique_ptr<_Region>&& region)
+    : _name(name)
+    , _region(std::move(region))
+    , _isOwner(_region->isOwner)
+{
+}
+
+TraceSharedMemoryRing::~TraceSharedMemoryRing()
+{
+    SetPublishing(false);
+}
+
+size_t
+TraceSharedMemoryRing::GetCapacity() const
+{
+    return _region->header->capacity;
+}
+
+uint64_t
+TraceSharedMemoryRing::GetWriteCount() const
+{
+    return _region->header->writeIndex.load(std::memory_order_acquire);
+}
+
+uint64_t
+TraceSharedMemoryRing::GetDroppedCount() const
+{
+    return _region->header->droppedEvents.load(std::memory_order_relaxed);
+}
+
+uint32_t
+TraceSharedMemoryRing::_GetStringId(const std::string& str)
+{
+    {
+        std::lock_guard<std::mutex> lock(_stringIdsMutex);
+        auto it = _stringIds.find(str);
+        if (it != _stringIds.end()) {
+            return it->second;
+        }
+    }
+
+    _Header* header = _region->header;
+    const uint64_t hash = _HashString(str);
+    const uint64_t mask = header->stringTableCapacity - 1;
+    uint32_t id = 0;
+
+    // Open addressing with linear probing. Slots are never removed, so a
+    // string is always found before the first empty slot of its probe
+    // sequence.
+    for (uint64_t probe = 0; probe <= mask && id == 0; ++probe) {
+        _StringSlot& slot = _region->slots[(hash + probe) & mask];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == _StringSlot::Empty) {
+            uint32_t expected = _StringSlot::Empty;
+            if (slot.state.compare_exchange_strong(expected,
+                    _StringSlot::Writing, std::memory_order_acq_rel)) {
+                const uint64_t offset = header->storageUsed.fetch_add(
+                    str.size(), std::memory_order_relaxed);
+                if (offset + str.size() > header->stringStorageSize) {
+                    slot.state.store(
+                        _StringSlot::Invalid, std::memory_order_release);
+                    break;
+                }
+                memcpy(_region->storage + offset, str.data(), str.size());
+                slot.hash.store(hash, std::memory_order_relaxed);
+                slot.length.store(
+                    uint32_t(str.size()), std::memory_order_relaxed);
+                slot.offset.store(offset, std::memory_order_relaxed);
+                slot.state.store(
+                    _StringSlot::Ready, std::memory_order_release);
+                id = uint32_t(((hash + probe) & mask) + 1);
+                break;
+            }
+            state = expected;
+        }
+        // Wait for another writer to finish writing the slot.
+        while (state == _StringSlot::Writing) {
+            std::this_thread::yield();
+            state = slot.state.load(std::memory_order_acquire);
+        }
+        if (state == _StringSlot::Ready &&
+            slot.hash.load(std::memory_order_relaxed) == hash &&
+            slot.length.load(std::memory_order_relaxed) == str.size() &&
+            memcmp(_region->storage + slot.offset.load(
+                std::memory_order_relaxed), str.data(), str.size()) == 0) {
+            id = uint32_t(((hash + probe) & mask) + 1);
+        }
+    }
+
+    if (id != 0) {
+        std::lock_guard<std::mutex> lock(_stringIdsMutex);
+        _stringIds.emplace(str, id);
+    }
+    return id;
+}
+
+void
+TraceSharedMemoryRing::_PublishCalibration(
+    uint32_t processId, const TraceClockCalibration& calibration)
+{
+    std::lock_guard<std::mutex> lock(_calibrationsMutex);
+    auto it = _calibrations.find(processId);
+    if (it != _calibrations.end() && it->second == calibration) {
+        return;
+    }
+
+    _CalibrationSlot* slot = _region->FindCalibration(processId, true);
+    if (!slot) {
+        return;
+    }
+    const uint64_t source = _GetStringId(calibration.source);
+    const uint64_t host = _GetStringId(calibration.host);
+
+    // Several rings, in this or other processes, may write the
+    // calibration of the same process.
+    uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    while ((sequence & 1) || !slot->sequence.compare_exchange_weak(
+            sequence, sequence + 1, std::memory_order_acquire)) {
+        std::this_thread::yield();
+        sequence = slot->sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->source.store(source, std::memory_order_relaxed);
+    slot->host.store(host, std::memory_order_relaxed);
+    slot->ticksPerSecond.store(
+        _DoubleToBits(calibration.ticksPerSecond), std::memory_order_relaxed);
+    slot->anchor.store(calibration.anchor, std::memory_order_relaxed);
+    slot->realtime.store(
+        uint64_t(calibration.realtime), std::memory_order_relaxed);
+    slot->monotonic.store(
+        uint64_t(calibration.monotonic), std::memory_order_relaxed);
+    slot->uncertainty.store(
+        calibration.uncertainty, std::memory_order_relaxed);
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+
+    _calibrations[processId] = calibration;
+}
+
+void
+TraceSharedMemoryRing::Write(const TraceCollection& collection)
+{
+    TfAutoMallocTag2 tag("Trace", "TraceSharedMemoryRing::Write");
+
+    // Encodes the events of each thread and writes them to the ring a block
+    // at a time.
+    class _Writer {
+    public:
+        _Writer(TraceSharedMemoryRing* ring,
+            const TraceClockCalibration& calibration)
+            : _ring(ring), _calibration(calibration) {}
+
+        void OnBeginCollection() {}
+        void OnEndCollection() {}
+
+        void OnBeginThread(const TraceThreadId& threadId) {
+            const uint64_t processId = uint32_t(threadId.GetProcessId() != 0
+                ? threadId.GetProcessId() : TraceGetProcessId());
+            _ring->_PublishCalibration(uint32_t(processId), _calibration);
+            _source = processId << 32 |
+                _ring->_GetStringId(threadId.ToString());
+        }
+
+        void OnEndThread(const TraceThreadId&) {
+            _Flush();
+        }
+
+        void OnEvents(
+            const TraceThreadId&, const TraceCollection::EventSpan& events) {
+            const TraceCollection::KeyTable& keyTable = events.GetKeyTable();
+            if (_keyIds.size() < keyTable.GetSize()) {
+                _keyIds.resize(keyTable.GetSize(), 0);
+            }
+
+            for (const TraceEvent& e : events) {
+                // The stack frames of samples are addresses in this process,
+                // which cannot be symbolized by the readers.
+                if (e.GetType() == TraceEvent::EventType::Sample) {
+                    continue;
+                }
+                const TraceCollection::KeyId keyId =
+                    keyTable.GetKeyId(e.GetKey());
+                uint32_t& key = _keyIds[keyId];
+                if (key == 0) {
+                    key = _ring->_GetStringId(
+                        keyTable.GetToken(keyId).GetString());
+                }
+                _EventRecord record;
+                if (key != 0 && (_source & 0xffffffff) != 0 &&
+                    _Encode(e, key, &record)) {
+                    _pending.push_back(record);
+                    if (_pending.size() == _MaxBlockSize) {
+                        _Flush();
+                    }
+                } else {
+                    ++_dropped;
+                }
+            }
+        }
+
+        ~_Writer() {
+            if (_dropped) {
+                _ring->_region->header->droppedEvents.fetch_add(
+                    _dropped, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        bool _Encode(const TraceEvent& e, uint32_t key, _EventRecord* r) {
+            r->time = e.GetTimeStamp();
+            r->payload = 0;
+            r->source = _source;
+            r->key = uint64_t(key) << 32 | e.GetCategory();
+            r->type = uint64_t(e.GetType());
+
+            switch (e.GetType()) {
+                case TraceEvent::EventType::Begin:
+                case TraceEvent::EventType::End:
+                case TraceEvent::EventType::Marker:
+                    break;
+                case TraceEvent::EventType::Timespan:
+                    r->time = e.GetEndTimeStamp();
+                    r->payload = e.GetStartTimeStamp();
+                    break;
+                case TraceEvent::EventType::CounterDelta:
+                case TraceEvent::EventType::CounterValue:
+                    r->payload = _DoubleToBits(e.GetCounterValue());
+                    break;
+                case TraceEvent::EventType::ScopeData: {
+                    const TraceEventData data = e.GetData();
+                    r->type |= uint64_t(data.GetType()) << 8;
+                    if (const bool* b = data.GetBool()) {
+                        r->payload = *b ? 1 : 0;
+                    } else if (const int64_t* i = data.GetInt()) {
+                        r->payload = uint64_t(*i);
+                    } else if (const uint64_t* u = data.GetUInt()) {
+                        r->payload = *u;
+                    } else if (const double* d = data.GetFloat()) {
+                        r->payload = _DoubleToBits(*d);
+                    } else if (const std::string* s = data.GetString()) {
+                        r->payload = _ring->_GetStringId(*s);
+                        if (r->payload == 0) {
+                            return false;
+                        }
+                    } else {
+                        return false;
+                    }
+                    break;
+                }
+                case TraceEvent::EventType::Sample:
+                case TraceEvent::EventType::Unknown:
+                    return false;
+            }
+            return true;
+        }
+
+        void _Flush() {
+            if (_pending.empty()) {
+                return;
+            }
+            _Region& region = *_ring->_region;
+            const uint64_t capacity = region.header->capacity;
+            const uint64_t first = region.header->writeIndex.fetch_add(
+                _pending.size(), std::memory_order_relaxed);
+            for (size_t i = 0; i < _pending.size(); ++i) {
+                const uint64_t index = first + i;
+                const _EventRecord& e = _pending[i];
+                _Record& r = region.records[index % capacity];
+                r.sequence.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                r.time.store(e.time, std::memory_order_relaxed);
+                r.payload.store(e.payload, std::memory_order_relaxed);
+                r.source.store(e.source, std::memory_order_relaxed);
+                r.key.store(e.key, std::memory_order_relaxed);
+                r.type.store(e.type, std::memory_order_relaxed);
+                r.sequence.store(index + 1, std::memory_order_release);
+            }
+            _pending.clear();
+        }
+
+        TraceSharedMemoryRing* _ring;
+        const TraceClockCalibration& _calibration;
+        uint64_t _source = 0;
+        std::vector<uint32_t> _keyIds;
+        std::vector<_EventRecord> _pending;
+        uint64_t _dropped = 0;
+    };
+
+    // Collections created by hand may not have a calibration, their events
+    // are assumed to be recorded with the clock of this process.
+    const TraceClockCalibration calibration =
+        collection.GetClockCalibration().IsValid()
+        ? collection.GetClockCalibration() : TraceClock::GetCalibration();
+
+    _Writer writer(this, calibration);
+    collection.IterateBatches(writer);
+}
+
+void
+TraceSharedMemoryRing::SetPublishing(bool publishing)
+{
+    if (publishing && !_noticeKey.IsValid()) {
+        _noticeKey =
+            TfNotice::Register(ThisPtr(this), &This::_OnTraceCollection);
+    } else if (!publishing && _noticeKey.IsValid()) {
+        TfNotice::Revoke(_noticeKey);
+    }
+}
+
+void
+TraceSharedMemoryRing::_OnTraceCollection(
+    const TraceCollectionAvailable& notice)
+{
+    if (notice.GetCollection()) {
+        Write(*notice.GetCollection());
+    }
+}
+
+std::unique_ptr<TraceCollection>
+TraceSharedMemoryRing::CreateCollection(uint64_t* position) const
+{
+    TfAutoMallocTag2 tag("Trace", "TraceSharedMemoryRing::CreateCollection");
+
+    const _Region& region = *_region;
+    const uint64_t capacity = region.header->capacity;
+    const uint64_t end =
+        region.header->writeIndex.load(std::memory_order_acquire);
+    uint64_t begin = position ? std::min(*position, end) : 0;
+    if (end > capacity && begin < end - capacity) {
+        begin = end - capacity;
+    }
+    if (position) {
+        *position = end;
+    }
+
+    // Timestamps are converted from the clock of the process which recorded
+    // them to the clock of this process.
+    const TraceClockCalibration calibration = TraceClock::GetCalibration();
+    std::unordered_map<uint32_t, TraceClockCalibration> calibrations;
+
+    struct _ThreadData {
+        TraceCollection::EventListPtr events;
+        std::unordered_map<uint32_t, TraceKey> keys;
+        const TraceClockCalibration* calibration = nullptr;
+    };
+    using EventType = TraceEvent::EventType;
+    using DataType = TraceEvent::DataType;
+
+    // Threads are keyed by their source, the process and thread name ids.
+    std::map<uint64_t, _ThreadData> threads;
+
+    for (uint64_t index = begin; index < end; ++index) {
+        const _Record& r = region.records[index % capacity];
+        if (r.sequence.load(std::memory_order_acquire) != index + 1) {
+            // The event is still being written or has been overwritten.
+            continue;
+        }
+        _EventRecord e;
+        e.time = r.time.load(std::memory_order_relaxed);
+        e.payload = r.payload.load(std::memory_order_relaxed);
+        e.source = r.source.load(std::memory_order_relaxed);
+        e.key = r.key.load(std::memory_order_relaxed);
+        e.type = r.type.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (r.sequence.load(std::memory_order_relaxed) != index + 1) {
+            continue;
+        }
+
+        _ThreadData& thread = threads[e.source];
+        if (!thread.events) {
+            thread.events.reset(new TraceEventList);
+
+            const uint32_t processId = uint32_t(e.source >> 32);
+            auto it = calibrations.find(processId);
+            if (it == calibrations.end()) {
+                it = calibrations.emplace(
+                    processId, region.GetCalibration(processId)).first;
+            }
+            if (it->second.IsValid() &&
+                !it->second.IsSameClock(calibration)) {
+                thread.calibration = &it->second;
+            }
+        }
+        TraceEventList& events = *thread.events;
+
+        if (thread.calibration) {
+            e.time = thread.calibration->Convert(e.time, calibration);
+            if (EventType(e.type & 0xff) == EventType::Timespan) {
+                e.payload =
+                    thread.calibration->Convert(e.payload, calibration);
+            }
+        }
+
+        const uint32_t keyId = uint32_t(e.key >> 32);
+        auto keyIt = thread.keys.find(keyId);
+        if (keyIt == thread.keys.end()) {
+            const std::string keyName = region.GetString(keyId);
+            if (keyName.empty()) {
+                continue;
+            }
+            keyIt = thread.keys.emplace(
+                keyId, events.CacheKey(keyName)).first;
+        }
+        const TraceKey& key = keyIt->second;
+        const TraceCategoryId category = TraceCategoryId(e.key & 0xffffffff);
+        switch (EventType(e.type & 0xff)) {
+            case EventType::Begin:
+                events.EmplaceBack(TraceEvent::Begin, key, e.time, category);
+                break;
+            case EventType::End:
+                events.EmplaceBack(TraceEvent::End, key, e.time, category);
+                break;
+            case EventType::Marker:
+                events.EmplaceBack(TraceEvent::Marker, key, e.time, category);
+                break;
+            case EventType::Timespan:
+                events.EmplaceBack(
+                    TraceEvent::Timespan, key, e.payload, e.time, category);
+                break;
+            case EventType::CounterDelta:
+            case EventType::CounterValue: {
+                const double value = _BitsToDouble(e.payload);
+                TraceEvent event = EventType(e.type & 0xff) ==
+                    EventType::CounterDelta
+                    ? TraceEvent(TraceEvent::CounterDelta, key, value, category)
+                    : TraceEvent(
+                        TraceEvent::CounterValue, key, value, category);
+                event.SetTimeStamp(e.time);
+                events.EmplaceBack(std::move(event));
+                break;
+            }
+            case EventType::ScopeData: {
+                std::unique_ptr<TraceEvent> event;
+                switch (DataType((e.type >> 8) & 0xff)) {
+                    case DataType::Boolean:
+                        event.reset(new TraceEvent(
+                            TraceEvent::Data, key, e.payload != 0, category));
+                        break;
+                    case DataType::Int:
+                        event.reset(new TraceEvent(
+                            TraceEvent::Data, key, int64_t(e.payload),
+                            category));
+                        break;
+                    case DataType::UInt:
+                        event.reset(new TraceEvent(
+                            TraceEvent::Data, key, e.payload, category));
+                        break;
+                    case DataType::Float:
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            _BitsToDouble(e.payload), category));
+                        break;
+                    case DataType::String:
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            events.StoreData(region.GetString(
+                                uint32_t(e.payload)).c_str()),
+                            category));
+                        break;
+                    case DataType::Invalid:
+                        break;
+                }
+                if (event) {
+                    event->SetTimeStamp(e.time);
+                    events.EmplaceBack(std::move(*event));
+                }
+                break;
+            }
+            case EventType::Sample:
+            case EventType::Unknown:
+                break;
+        }
+    }
+
+    std::unique_ptr<TraceCollection> collection(new TraceCollection);
+    collection->SetClockCalibration(calibration);
+    for (auto& thread : threads) {
+        if (thread.second.events->IsEmpty()) {
+            continue;
+        }
+        const int processId = int(thread.first >> 32);
+        const std::string threadName =
+            region.GetString(uint32_t(thread.first & 0xffffffff));
+        collection->AddToCollection(
+            TraceThreadId(threadName, processId),
+            std::move(thread.second.events));
+    }
+    return collection;
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
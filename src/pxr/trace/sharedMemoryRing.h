@@ -0,0 +1,178 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_SHARED_MEMORY_RING_H
+#define PXR_TRACE_SHARED_MEMORY_RING_H
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/api.h"
+#include "pxr/trace/clock.h"
+#include "pxr/trace/collection.h"
+#include "pxr/trace/collectionNotice.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/notice.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/refPtr.h>
+#include <pxr/tf/weakBase.h>
+#include <pxr/tf/weakPtr.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TF_DECLARE_WEAK_AND_REF_PTRS(TraceSharedMemoryRing);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceSharedMemoryRing
+///
+/// A named shared memory region which lets several processes on the same host
+/// contribute events to a single trace.
+///
+/// Each participating process opens the ring by name and writes the events
+/// of its collections into it, either explicitly with Write() or by calling
+/// SetPublishing() to write every collection produced by its TraceCollector.
+/// Any participant may then assemble a TraceCollection holding the events of
+/// all the processes with CreateCollection(). The threads of that collection
+/// carry the id of the process which recorded them, so they appear as
+/// separate processes in the Chrome trace format.
+///
+/// Events are stored in a ring of fixed capacity: when it is full, the
+/// oldest events are overwritten. Key names, thread names and string data
+/// are stored once in a string table shared by all the processes. Timestamps
+/// are stored as recorded, along with the TraceClockCalibration of each
+/// process which wrote events, so that CreateCollection() converts them to
+/// the clock of the reading process when the processes use different
+/// TraceClock sources. The calibrations of up to 256 processes are stored;
+/// the timestamps of further processes are not converted.
+///
+/// Writing is lock free and may happen concurrently from any number of
+/// threads and processes.
+///
+class TraceSharedMemoryRing : public TfRefBase, public TfWeakBase {
+public:
+    using This = TraceSharedMemoryRing;
+    using ThisPtr = TraceSharedMemoryRingPtr;
+    using ThisRefPtr = TraceSharedMemoryRingRefPtr;
+
+    /// Parameters used to create the shared memory region. They are ignored
+    /// when the region already exists.
+    struct Options {
+        Options()
+            : capacity(1 << 20)
+            , stringTableCapacity(1 << 16)
+            , stringStorageSize(4 << 20)
+        {}
+
+        /// Maximum number of events held by the ring.
+        size_t capacity;
+
+        /// Maximum number of distinct strings held by the string table.
+        size_t stringTableCapacity;
+
+        /// Number of bytes available to store the strings of the table.
+        size_t stringStorageSize;
+    };
+
+    /// Opens the shared memory ring named \p name, creating it with
+    /// \p options if it does not exist. Returns a null pointer and issues an
+    /// error if the region could not be created or opened.
+    ///
+    /// The process which created the region removes its name when the ring
+    /// is destroyed. Processes which still have the ring open may continue
+    /// to use it.
+    TRACE_API static ThisRefPtr New(
+        const std::string& name, const Options& options = Options());
+
+    /// Destructor.
+    TRACE_API ~TraceSharedMemoryRing();
+
+    /// Returns the name of the ring.
+    const std::string& GetName() const { return _name; }
+
+    /// Returns true if this ring created the shared memory region.
+    bool IsOwner() const { return _isOwner; }
+
+    /// Returns the maximum number of events held by the ring.
+    TRACE_API size_t GetCapacity() const;
+
+    /// Returns the total number of events written to the ring since it was
+    /// created, including the events which have since been overwritten.
+    TRACE_API uint64_t GetWriteCount() const;
+
+    /// Returns the number of events which could not be written because the
+    /// string table was full.
+    TRACE_API uint64_t GetDroppedCount() const;
+
+    /// Writes the events of \p collection to the ring. Events of threads
+    /// which do not have a process id are attributed to the current process.
+    TRACE_API void Write(const TraceCollection& collection);
+
+    /// If \p publishing is true, writes every collection produced by the
+    /// TraceCollector of this process to the ring.
+    ///
+    /// The collector only produces a collection when
+    /// TraceCollector::CreateCollection() is called, e.g. by the
+    /// TraceReporter when it updates its trees. Recorded events are not
+    /// visible to the readers of the ring until then, so long running
+    /// processes which publish to a ring should create a collection
+    /// periodically.
+    TRACE_API void SetPublishing(bool publishing);
+
+    /// Returns true if collections produced by the TraceCollector are
+    /// written to the ring.
+    bool IsPublishing() const { return _noticeKey.IsValid(); }
+
+    /// Returns a collection holding the events currently in the ring, from
+    /// all the processes which wrote to it.
+    ///
+    /// If \p position is not null, only the events written since
+    /// \p *position are returned, and \p *position is updated to the
+    /// position following the last event returned. Passing the same
+    /// position to successive calls returns each event once, unless it was
+    /// overwritten in between.
+    TRACE_API std::unique_ptr<TraceCollection> CreateCollection(
+        uint64_t* position = nullptr) const;
+
+private:
+    struct _Region;
+
+    TraceSharedMemoryRing(
+        const std::string& name, std::unique_ptr<_Region>&& region);
+
+    // Returns the id of \p str in the shared string table, or 0 if the
+    // table is full.
+    uint32_t _GetStringId(const std::string& str);
+
+    // Stores \p calibration as the calibration of the events of
+    // \p processId, if it changed.
+    void _PublishCalibration(
+        uint32_t processId, const TraceClockCalibration& calibration);
+
+    void _OnTraceCollection(const TraceCollectionAvailable&);
+
+    std::string _name;
+    std::unique_ptr<_Region> _region;
+    bool _isOwner;
+
+    // Ids of the strings already added to the table by this process.
+    std::mutex _stringIdsMutex;
+    std::unordered_map<std::string, uint32_t> _stringIds;
+
+    // Calibrations already stored by this ring, by process id.
+    std::mutex _calibrationsMutex;
+    std::unordered_map<uint32_t, TraceClockCalibration> _calibrations;
+
+    TfNotice::Key _noticeKey;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_SHARED_MEMORY_RING_H
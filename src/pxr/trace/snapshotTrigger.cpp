@@ -0,0 +1,343 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/snapshotTrigger.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/clock.h"
+#include "pxr/trace/collector.h"
+#include "pxr/trace/serialization.h"
+#include "pxr/trace/threads.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/mallocTag.h>
+#include <pxr/tf/stringUtils.h>
+#include <pxr/arch/timing.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+// How long the thread waits for triggers before discarding old collections.
+constexpr std::chrono::milliseconds _PollInterval(20);
+
+} // anonymous namespace
+
+TraceSnapshotTriggerRefPtr
+TraceSnapshotTrigger::New(const Options& options)
+{
+    return TfCreateRefPtr(new This(options));
+}
+
+TraceSnapshotTrigger::TraceSnapshotTrigger(const Options& options)
+    : _options(options)
+{
+    _noticeKey = TfNotice::Register(ThisPtr(this), &This::_OnTraceCollection);
+    _thread = std::thread(&This::_Run, this);
+}
+
+TraceSnapshotTrigger::~TraceSnapshotTrigger()
+{
+    TfNotice::Revoke(_noticeKey);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeUp.notify_all();
+    _thread.join();
+}
+
+void
+TraceSnapshotTrigger::AddScopeTrigger(const TfToken& key, double minDuration)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _Trigger& trigger = _triggers[key];
+    trigger.scope = true;
+    trigger.minDuration = ArchSecondsToTicks(minDuration);
+}
+
+void
+TraceSnapshotTrigger::AddMarkerTrigger(const TfToken& key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _triggers[key].marker = true;
+}
+
+void
+TraceSnapshotTrigger::RemoveTrigger(const TfToken& key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _triggers.erase(key);
+}
+
+void
+TraceSnapshotTrigger::Trigger()
+{
+    // Make sure the history holds the events recorded so far.
+    TraceCollector::GetInstance().CreateCollection();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingTriggers.push_back(TraceClock::Now());
+    }
+    _wakeUp.notify_one();
+}
+
+size_t
+TraceSnapshotTrigger::GetSnapshotCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _snapshotCount;
+}
+
+std::shared_ptr<TraceCollection>
+TraceSnapshotTrigger::GetLastSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _lastSnapshot;
+}
+
+std::string
+TraceSnapshotTrigger::GetLastSnapshotPath() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _lastSnapshotPath;
+}
+
+void
+TraceSnapshotTrigger::_OnTraceCollection(
+    const TraceCollectionAvailable& notice)
+{
+    _AddCollection(notice.GetCollection());
+}
+
+void
+TraceSnapshotTrigger::_AddCollection(
+    const std::shared_ptr<TraceCollection>& collection)
+{
+    TfAutoMallocTag2 tag("Trace", "TraceSnapshotTrigger::_AddCollection");
+
+    // Finds the events which fire a trigger and the time of the last event.
+    class _Scanner {
+    public:
+        _Scanner(TraceSnapshotTrigger* trigger) : _trigger(trigger) {}
+
+        void OnBeginCollection() {}
+        void OnEndCollection() {}
+        void OnBeginThread(const TraceThreadId& threadId) {
+            _openScopes = &_trigger->_openScopes[threadId];
+        }
+        void OnEndThread(const TraceThreadId&) {}
+
+        void OnEvents(
+            const TraceThreadId&, const TraceCollection::EventSpan& events) {
+            for (const TraceEvent& e : events) {
+                maxTime = std::max(maxTime, e.GetTimeStamp());
+            }
+            if (_trigger->_triggers.empty()) {
+                return;
+            }
+
+            // The key table is shared by all the spans of the collection.
+            const TraceCollection::KeyTable& table = events.GetKeyTable();
+            if (_triggersById.empty()) {
+                _triggersById.resize(table.GetSize(), nullptr);
+                for (size_t i = 0; i < table.GetSize(); ++i) {
+                    const auto it = _trigger->_triggers.find(
+                        table.GetToken(TraceCollection::KeyId(i)));
+                    if (it != _trigger->_triggers.end()) {
+                        _triggersById[i] = &it->second;
+                    }
+                }
+            }
+
+            for (const TraceEvent& e : events) {
+                const TraceEvent::EventType type = e.GetType();
+                if (type != TraceEvent::EventType::Timespan &&
+                    type != TraceEvent::EventType::Begin &&
+                    type != TraceEvent::EventType::End &&
+                    type != TraceEvent::EventType::Marker) {
+                    continue;
+                }
+                const TraceCollection::KeyId id = table.GetKeyId(e.GetKey());
+                const _Trigger* trigger = id < _triggersById.size()
+                    ? _triggersById[id] : nullptr;
+                if (!trigger) {
+                    continue;
+                }
+                _OnEvent(e, table.GetToken(id), *trigger);
+            }
+        }
+
+        TimeStamp maxTime = 0;
+
+    private:
+        void _OnEvent(
+            const TraceEvent& e, const TfToken& key, const _Trigger& trigger) {
+            switch (e.GetType()) {
+            case TraceEvent::EventType::Timespan:
+                if (trigger.scope && e.GetTimeStamp() - e.GetStartTimeStamp()
+                        >= trigger.minDuration) {
+                    _trigger->_pendingTriggers.push_back(e.GetTimeStamp());
+                }
+                break;
+            case TraceEvent::EventType::Begin:
+                if (trigger.scope) {
+                    _openScopes->push_back({key, e.GetTimeStamp()});
+                }
+                break;
+            case TraceEvent::EventType::End:
+                for (auto it = _openScopes->rbegin();
+                        it != _openScopes->rend(); ++it) {
+                    if (it->key == key) {
+                        if (e.GetTimeStamp() - it->start >=
+                                trigger.minDuration) {
+                            _trigger->_pendingTriggers.push_back(
+                                e.GetTimeStamp());
+                        }
+                        _openScopes->erase(std::next(it).base());
+                        break;
+                    }
+                }
+                break;
+            case TraceEvent::EventType::Marker:
+                if (trigger.marker) {
+                    _trigger->_pendingTriggers.push_back(e.GetTimeStamp());
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        TraceSnapshotTrigger* _trigger;
+        std::vector<_OpenScope>* _openScopes = nullptr;
+        std::vector<const _Trigger*> _triggersById;
+    };
+
+    bool triggered = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Snapshots sent by this trigger are not part of the history.
+        if (!collection || collection == _lastSnapshot) {
+            return;
+        }
+        const size_t numPending = _pendingTriggers.size();
+        _Scanner scanner(this);
+        collection->IterateBatches(scanner);
+        if (scanner.maxTime > 0) {
+            _history.push_back({collection, scanner.maxTime});
+        }
+        triggered = _pendingTriggers.size() > numPending;
+    }
+    if (triggered) {
+        _wakeUp.notify_one();
+    }
+}
+
+void
+TraceSnapshotTrigger::_Run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto flushInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(_options.flushInterval));
+    const Clock::duration pollInterval = _options.flushInterval > 0.0
+        ? std::min<Clock::duration>(flushInterval, _PollInterval)
+        : Clock::duration(_PollInterval);
+    Clock::time_point nextFlush = Clock::now() + flushInterval;
+
+    while (true) {
+        if (_options.flushInterval > 0.0 && Clock::now() >= nextFlush) {
+            // The collection comes back through the notice.
+            TraceCollector::GetInstance().CreateCollection();
+            nextFlush = Clock::now() + flushInterval;
+        }
+
+        std::vector<TimeStamp> triggers;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeUp.wait_for(lock, pollInterval, [this]() {
+                return _stop || !_pendingTriggers.empty();
+            });
+            if (_stop) {
+                break;
+            }
+            triggers.swap(_pendingTriggers);
+        }
+
+        std::sort(triggers.begin(), triggers.end());
+        for (TimeStamp time : triggers) {
+            _TakeSnapshot(time);
+        }
+
+        // Discard the collections which ended before the window.
+        const TimeStamp window = ArchSecondsToTicks(_options.window);
+        const TimeStamp now = TraceClock::Now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        while (!_history.empty() && _history.front().maxTime + window < now) {
+            _history.pop_front();
+        }
+    }
+}
+
+void
+TraceSnapshotTrigger::_TakeSnapshot(TimeStamp time)
+{
+    TfAutoMallocTag2 tag("Trace", "TraceSnapshotTrigger::_TakeSnapshot");
+
+    const TimeStamp window = ArchSecondsToTicks(_options.window);
+    const TimeStamp begin = time > window ? time - window : 0;
+
+    std::vector<std::shared_ptr<TraceCollection>> collections;
+    size_t index = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_snapshotCount > 0 &&
+            time < _lastSnapshotTime + ArchSecondsToTicks(_options.cooldown)) {
+            return;
+        }
+        for (const _HistoryEntry& entry : _history) {
+            if (entry.maxTime >= begin) {
+                collections.push_back(entry.collection);
+            }
+        }
+        index = _snapshotCount + 1;
+    }
+
+    std::shared_ptr<TraceCollection> snapshot(
+        TraceCollection::Slice(collections, begin, time));
+
+    std::string path;
+    if (!_options.outputDirectory.empty()) {
+        path = TfStringPrintf("%s/traceSnapshot_%d_%zu.json",
+            _options.outputDirectory.c_str(), TraceGetProcessId(), index);
+        std::ofstream out(path);
+        if (!out || !TraceSerialization::Write(out, snapshot)) {
+            TF_RUNTIME_ERROR(
+                "Failed to write trace snapshot to '%s'", path.c_str());
+            path.clear();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _lastSnapshot = snapshot;
+        _lastSnapshotPath = path;
+        _lastSnapshotTime = time;
+    }
+    if (_options.sendNotice) {
+        TraceCollectionAvailable notice(snapshot);
+        notice.Send();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_snapshotCount;
+    }
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
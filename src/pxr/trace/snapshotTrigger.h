@@ -0,0 +1,175 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_SNAPSHOT_TRIGGER_H
+#define PXR_TRACE_SNAPSHOT_TRIGGER_H
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/api.h"
+#include "pxr/trace/collection.h"
+#include "pxr/trace/collectionNotice.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/notice.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/refPtr.h>
+#include <pxr/tf/token.h>
+#include <pxr/tf/weakBase.h>
+#include <pxr/tf/weakPtr.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TF_DECLARE_WEAK_AND_REF_PTRS(TraceSnapshotTrigger);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceSnapshotTrigger
+///
+/// This class takes snapshots of the events recorded by the TraceCollector
+/// during a short window of time before a trigger, e.g. a scope which took
+/// longer than expected or a marker.
+///
+/// The trigger keeps the collections produced by the collector during the
+/// last \c Options::window seconds, periodically calling
+/// TraceCollector::CreateCollection() when \c Options::flushInterval is not
+/// zero, and discards older ones. When a trigger fires, the events of the
+/// window which ended with the trigger are gathered in a TraceCollection
+/// which is sent with a TraceCollectionAvailable notice and/or written to
+/// \c Options::outputDirectory. Triggers firing less than
+/// \c Options::cooldown seconds after the last snapshot are ignored.
+///
+/// Listeners of TraceCollectionAvailable, e.g. TraceReporter, see the events
+/// of the snapshots twice: once in the collections produced by the
+/// collector and once in the snapshots.
+///
+class TraceSnapshotTrigger : public TfRefBase, public TfWeakBase {
+public:
+    using This = TraceSnapshotTrigger;
+    using ThisPtr = TraceSnapshotTriggerPtr;
+    using ThisRefPtr = TraceSnapshotTriggerRefPtr;
+
+    using TimeStamp = TraceEvent::TimeStamp;
+
+    /// Parameters of the trigger.
+    struct Options {
+        Options()
+            : window(0.1)
+            , cooldown(1.0)
+            , flushInterval(0.01)
+            , sendNotice(true)
+        {}
+
+        /// Number of seconds of events before the trigger in a snapshot.
+        double window;
+
+        /// Minimum number of seconds between two snapshots.
+        double cooldown;
+
+        /// Number of seconds between calls to
+        /// TraceCollector::CreateCollection(), or 0 to only use the
+        /// collections created by the client code.
+        double flushInterval;
+
+        /// Whether snapshots are sent with a TraceCollectionAvailable
+        /// notice.
+        bool sendNotice;
+
+        /// If not empty, snapshots are written to this directory with
+        /// TraceSerialization::Write().
+        std::string outputDirectory;
+    };
+
+    /// Creates a trigger.
+    TRACE_API static ThisRefPtr New(const Options& options = Options());
+
+    /// Stops taking snapshots.
+    TRACE_API ~TraceSnapshotTrigger();
+
+    /// Returns the options of the trigger.
+    const Options& GetOptions() const { return _options; }
+
+    /// Takes a snapshot when a scope with \p key lasts at least
+    /// \p minDuration seconds.
+    TRACE_API void AddScopeTrigger(const TfToken& key, double minDuration);
+
+    /// Takes a snapshot when a marker with \p key is recorded.
+    TRACE_API void AddMarkerTrigger(const TfToken& key);
+
+    /// Removes the triggers added for \p key.
+    TRACE_API void RemoveTrigger(const TfToken& key);
+
+    /// Takes a snapshot of the window ending now, unless the last snapshot
+    /// was taken less than \c Options::cooldown seconds ago.
+    TRACE_API void Trigger();
+
+    /// Returns the number of snapshots taken.
+    TRACE_API size_t GetSnapshotCount() const;
+
+    /// Returns the last snapshot, or a null pointer if none was taken.
+    TRACE_API std::shared_ptr<TraceCollection> GetLastSnapshot() const;
+
+    /// Returns the path of the file the last snapshot was written to, or an
+    /// empty string.
+    TRACE_API std::string GetLastSnapshotPath() const;
+
+private:
+    TraceSnapshotTrigger(const Options& options);
+
+    void _OnTraceCollection(const TraceCollectionAvailable&);
+
+    // Adds \p collection to the history and looks for triggers in it.
+    void _AddCollection(const std::shared_ptr<TraceCollection>& collection);
+
+    // Runs the thread which flushes the collector and takes the snapshots.
+    void _Run();
+    void _TakeSnapshot(TimeStamp time);
+
+    struct _Trigger {
+        bool marker = false;
+        bool scope = false;
+        TimeStamp minDuration = 0;
+    };
+
+    // Scopes with a trigger recorded as Begin and End events.
+    struct _OpenScope {
+        TfToken key;
+        TimeStamp start;
+    };
+
+    struct _HistoryEntry {
+        std::shared_ptr<TraceCollection> collection;
+        TimeStamp maxTime;
+    };
+
+    const Options _options;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::map<TfToken, _Trigger> _triggers;
+    std::deque<_HistoryEntry> _history;
+    std::map<TraceThreadId, std::vector<_OpenScope>> _openScopes;
+    std::vector<TimeStamp> _pendingTriggers;
+    TimeStamp _lastSnapshotTime = 0;
+    size_t _snapshotCount = 0;
+    std::shared_ptr<TraceCollection> _lastSnapshot;
+    std::string _lastSnapshotPath;
+    bool _stop = false;
+
+    std::thread _thread;
+    TfNotice::Key _noticeKey;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_SNAPSHOT_TRIGGER_H
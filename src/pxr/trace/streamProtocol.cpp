@@ -0,0 +1,533 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/streamProtocol.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/eventData.h"
+#include "pxr/trace/eventList.h"
+
+#include <cstring>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+using namespace Trace_StreamProtocol;
+
+namespace {
+
+// Maximum number of events in an Events frame.
+constexpr size_t _MaxEventsPerFrame = 4096;
+
+void
+_PutVarint(uint64_t value, std::string* out)
+{
+    while (value >= 0x80) {
+        out->push_back(char(uint8_t(value) | 0x80));
+        value >>= 7;
+    }
+    out->push_back(char(value));
+}
+
+void
+_PutSigned(int64_t value, std::string* out)
+{
+    _PutVarint((uint64_t(value) << 1) ^ uint64_t(value >> 63), out);
+}
+
+void
+_PutDouble(double value, std::string* out)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        out->push_back(char(uint8_t(bits >> (8 * i))));
+    }
+}
+
+// Starts a frame of type \p type in \p out and returns the offset of its
+// size, which is filled by _EndFrame.
+size_t
+_BeginFrame(FrameType type, std::string* out)
+{
+    const size_t offset = out->size();
+    out->append(4, '\0');
+    out->push_back(char(type));
+    return offset;
+}
+
+void
+_EndFrame(size_t offset, std::string* out)
+{
+    const uint32_t size = uint32_t(out->size() - offset - 5);
+    for (int i = 0; i < 4; ++i) {
+        (*out)[offset + i] = char(uint8_t(size >> (8 * i)));
+    }
+}
+
+// Reads values from a frame payload. Reads past the end of the payload set
+// the reader in a failed state.
+class _Reader {
+public:
+    _Reader(const char* begin, const char* end) : _p(begin), _end(end) {}
+
+    bool Ok() const { return _ok; }
+    bool AtEnd() const { return _p == _end; }
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (_p == _end) {
+                _ok = false;
+                return 0;
+            }
+            const uint8_t byte = uint8_t(*_p++);
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        _ok = false;
+        return 0;
+    }
+
+    int64_t Signed() {
+        const uint64_t value = Varint();
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+
+    uint8_t Byte() {
+        if (_p == _end) {
+            _ok = false;
+            return 0;
+        }
+        return uint8_t(*_p++);
+    }
+
+    double Double() {
+        if (_end - _p < 8) {
+            _ok = false;
+            _p = _end;
+            return 0.0;
+        }
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= uint64_t(uint8_t(_p[i])) << (8 * i);
+        }
+        _p += 8;
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string String(size_t size) {
+        if (size_t(_end - _p) < size) {
+            _ok = false;
+            _p = _end;
+            return std::string();
+        }
+        std::string str(_p, size);
+        _p += size;
+        return str;
+    }
+
+private:
+    const char* _p;
+    const char* _end;
+    bool _ok = true;
+};
+
+} // anonymous namespace
+
+void
+Trace_StreamEncoder::EncodeHello(std::string* out)
+{
+    const size_t frame = _BeginFrame(FrameType::Hello, out);
+    _PutVarint(Version, out);
+    _PutVarint(uint64_t(TraceGetProcessId()), out);
+    _EndFrame(frame, out);
+}
+
+void
+Trace_StreamEncoder::EncodeDropped(uint64_t droppedEvents, std::string* out)
+{
+    const size_t frame = _BeginFrame(FrameType::Dropped, out);
+    _PutVarint(droppedEvents, out);
+    _EndFrame(frame, out);
+}
+
+void
+Trace_StreamEncoder::_EncodeClock(
+    const TraceClockCalibration& calibration, std::string* out)
+{
+    if (!calibration.IsValid() || calibration == _clock) {
+        return;
+    }
+    _clock = calibration;
+
+    const size_t frame = _BeginFrame(FrameType::Clock, out);
+    _PutVarint(calibration.source.size(), out);
+    out->append(calibration.source);
+    _PutVarint(calibration.host.size(), out);
+    out->append(calibration.host);
+    _PutDouble(calibration.ticksPerSecond, out);
+    _PutVarint(calibration.anchor, out);
+    _PutSigned(calibration.realtime, out);
+    _PutSigned(calibration.monotonic, out);
+    _PutVarint(calibration.uncertainty, out);
+    _EndFrame(frame, out);
+}
+
+uint32_t
+Trace_StreamEncoder::_GetStringId(const std::string& str, std::string* out)
+{
+    auto it = _stringIds.find(str);
+    if (it != _stringIds.end()) {
+        return it->second;
+    }
+    const uint32_t id = uint32_t(_stringIds.size());
+    _stringIds.emplace(str, id);
+
+    const size_t frame = _BeginFrame(FrameType::String, out);
+    _PutVarint(id, out);
+    _PutVarint(str.size(), out);
+    out->append(str);
+    _EndFrame(frame, out);
+    return id;
+}
+
+void
+Trace_StreamEncoder::EncodeCollection(
+    const TraceCollection& collection, std::string* out)
+{
+    // Encodes the events of each thread in frames of at most
+    // _MaxEventsPerFrame events. String frames are written before the
+    // Events frame which refers to them, so events are encoded in a separate
+    // buffer.
+    class _Visitor {
+    public:
+        _Visitor(Trace_StreamEncoder* encoder, std::string* out)
+            : _encoder(encoder), _out(out) {}
+
+        void OnBeginCollection() {}
+        void OnEndCollection() {}
+
+        void OnBeginThread(const TraceThreadId& threadId) {
+            _threadId = _encoder->_GetStringId(threadId.ToString(), _out);
+        }
+
+        void OnEndThread(const TraceThreadId&) {
+            _Flush();
+        }
+
+        void OnEvents(
+            const TraceThreadId&, const TraceCollection::EventSpan& events) {
+            const TraceCollection::KeyTable& keyTable = events.GetKeyTable();
+            if (_keyIds.size() < keyTable.GetSize()) {
+                _keyIds.resize(keyTable.GetSize(), ~uint32_t(0));
+            }
+            for (const TraceEvent& e : events) {
+                // The stack frames of samples are addresses in this process,
+                // which cannot be symbolized by the receiver.
+                if (e.GetType() == TraceEvent::EventType::Unknown ||
+                    e.GetType() == TraceEvent::EventType::Sample) {
+                    continue;
+                }
+                const TraceCollection::KeyId keyId =
+                    keyTable.GetKeyId(e.GetKey());
+                uint32_t& key = _keyIds[keyId];
+                if (key == ~uint32_t(0)) {
+                    key = _encoder->_GetStringId(
+                        keyTable.GetToken(keyId).GetString(), _out);
+                }
+                _Encode(e, key);
+                if (++_count == _MaxEventsPerFrame) {
+                    _Flush();
+                }
+            }
+        }
+
+    private:
+        void _Encode(const TraceEvent& e, uint32_t key) {
+            _events.push_back(char(e.GetType()));
+            _PutVarint(key, &_events);
+            _PutVarint(e.GetCategory(), &_events);
+            _PutSigned(int64_t(e.GetTimeStamp() - _time), &_events);
+            _time = e.GetTimeStamp();
+
+            switch (e.GetType()) {
+                case TraceEvent::EventType::Timespan:
+                    _PutVarint(
+                        e.GetEndTimeStamp() - e.GetStartTimeStamp(), &_events);
+                    break;
+                case TraceEvent::EventType::CounterDelta:
+                case TraceEvent::EventType::CounterValue:
+                    _PutDouble(e.GetCounterValue(), &_events);
+                    break;
+                case TraceEvent::EventType::ScopeData: {
+                    const TraceEventData data = e.GetData();
+                    _events.push_back(char(data.GetType()));
+                    if (const bool* b = data.GetBool()) {
+                        _events.push_back(*b ? 1 : 0);
+                    } else if (const int64_t* i = data.GetInt()) {
+                        _PutSigned(*i, &_events);
+                    } else if (const uint64_t* u = data.GetUInt()) {
+                        _PutVarint(*u, &_events);
+                    } else if (const double* d = data.GetFloat()) {
+                        _PutDouble(*d, &_events);
+                    } else if (const std::string* s = data.GetString()) {
+                        _PutVarint(_encoder->_GetStringId(*s, _out), &_events);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        void _Flush() {
+            if (_count == 0) {
+                return;
+            }
+            const size_t frame = _BeginFrame(FrameType::Events, _out);
+            _PutVarint(_threadId, _out);
+            _PutVarint(_count, _out);
+            _out->append(_events);
+            _EndFrame(frame, _out);
+            _events.clear();
+            _count = 0;
+            _time = 0;
+        }
+
+        Trace_StreamEncoder* _encoder;
+        std::string* _out;
+        uint32_t _threadId = 0;
+        std::vector<uint32_t> _keyIds;
+        std::string _events;
+        size_t _count = 0;
+        TraceEvent::TimeStamp _time = 0;
+    };
+
+    _EncodeClock(collection.GetClockCalibration(), out);
+
+    _Visitor visitor(this, out);
+    collection.IterateBatches(visitor);
+
+    const size_t frame = _BeginFrame(FrameType::EndCollection, out);
+    _EndFrame(frame, out);
+}
+
+bool
+Trace_StreamDecoder::Decode(const char* data, size_t size,
+    std::vector<std::unique_ptr<TraceCollection>>* collections)
+{
+    _buffer.append(data, size);
+
+    size_t offset = 0;
+    bool ok = true;
+    while (ok && _buffer.size() - offset >= 5) {
+        uint32_t frameSize = 0;
+        for (int i = 0; i < 4; ++i) {
+            frameSize |= uint32_t(uint8_t(_buffer[offset + i])) << (8 * i);
+        }
+        if (frameSize > MaxFrameSize) {
+            ok = false;
+            break;
+        }
+        if (_buffer.size() - offset - 5 < frameSize) {
+            break;
+        }
+        const char* payload = _buffer.data() + offset + 5;
+        ok = _DecodeFrame(uint8_t(_buffer[offset + 4]),
+            payload, payload + frameSize, collections);
+        offset += 5 + frameSize;
+    }
+    _buffer.erase(0, offset);
+    return ok;
+}
+
+bool
+Trace_StreamDecoder::_DecodeFrame(uint8_t type, const char* begin,
+    const char* end, std::vector<std::unique_ptr<TraceCollection>>* collections)
+{
+    _Reader reader(begin, end);
+    switch (FrameType(type)) {
+        case FrameType::Hello: {
+            if (reader.Varint() != Version) {
+                return false;
+            }
+            _processId = int(reader.Varint());
+            return reader.Ok();
+        }
+        case FrameType::String: {
+            const uint64_t id = reader.Varint();
+            const std::string str = reader.String(size_t(reader.Varint()));
+            if (!reader.Ok() || id != _strings.size()) {
+                return false;
+            }
+            _strings.push_back(str);
+            return true;
+        }
+        case FrameType::Events:
+            return _DecodeEvents(begin, end);
+        case FrameType::EndCollection: {
+            std::unique_ptr<TraceCollection> collection(new TraceCollection);
+            collection->SetClockCalibration(
+                _convertTimes ? _targetClock : _clock);
+            for (auto& thread : _threads) {
+                collection->AddToCollection(
+                    thread.first, std::move(thread.second.events));
+            }
+            _threads.clear();
+            collections->push_back(std::move(collection));
+            return true;
+        }
+        case FrameType::Dropped:
+            _droppedEvents = reader.Varint();
+            return reader.Ok();
+        case FrameType::Clock: {
+            TraceClockCalibration clock;
+            clock.source = reader.String(size_t(reader.Varint()));
+            clock.host = reader.String(size_t(reader.Varint()));
+            clock.ticksPerSecond = reader.Double();
+            clock.anchor = reader.Varint();
+            clock.realtime = reader.Signed();
+            clock.monotonic = reader.Signed();
+            clock.uncertainty = reader.Varint();
+            if (!reader.Ok()) {
+                return false;
+            }
+            _clock = clock;
+            _UpdateClockConversion();
+            return true;
+        }
+    }
+    // Unknown frames are skipped so that newer servers may add frame types.
+    return true;
+}
+
+void
+Trace_StreamDecoder::_UpdateClockConversion()
+{
+    _convertTimes = _clock.IsValid() && _targetClock.IsValid() &&
+        !_clock.IsSameClock(_targetClock);
+}
+
+bool
+Trace_StreamDecoder::_DecodeEvents(const char* begin, const char* end)
+{
+    _Reader reader(begin, end);
+    const uint64_t threadId = reader.Varint();
+    const uint64_t count = reader.Varint();
+    if (!reader.Ok() || threadId >= _strings.size()) {
+        return false;
+    }
+
+    _ThreadData& thread =
+        _threads[TraceThreadId(_strings[threadId], _processId)];
+    if (!thread.events) {
+        thread.events.reset(new TraceEventList);
+    }
+    TraceEventList& events = *thread.events;
+
+    using EventType = TraceEvent::EventType;
+    using DataType = TraceEvent::DataType;
+
+    TraceEvent::TimeStamp time = 0;
+    for (uint64_t i = 0; i < count && reader.Ok(); ++i) {
+        const EventType type = EventType(reader.Byte());
+        const uint64_t keyId = reader.Varint();
+        const TraceCategoryId category = TraceCategoryId(reader.Varint());
+        time += TraceEvent::TimeStamp(reader.Signed());
+        if (!reader.Ok() || keyId >= _strings.size()) {
+            return false;
+        }
+        const TraceEvent::TimeStamp eventTime = _ToTargetClock(time);
+
+        auto keyIt = thread.keys.find(uint32_t(keyId));
+        if (keyIt == thread.keys.end()) {
+            keyIt = thread.keys.emplace(
+                uint32_t(keyId), events.CacheKey(_strings[keyId])).first;
+        }
+        const TraceKey& key = keyIt->second;
+
+        switch (type) {
+            case EventType::Begin:
+                events.EmplaceBack(TraceEvent::Begin, key, eventTime, category);
+                break;
+            case EventType::End:
+                events.EmplaceBack(TraceEvent::End, key, eventTime, category);
+                break;
+            case EventType::Marker:
+                events.EmplaceBack(
+                    TraceEvent::Marker, key, eventTime, category);
+                break;
+            case EventType::Timespan: {
+                const TraceEvent::TimeStamp duration = reader.Varint();
+                events.EmplaceBack(TraceEvent::Timespan, key,
+                    _ToTargetClock(time - duration), eventTime, category);
+                break;
+            }
+            case EventType::CounterDelta: {
+                TraceEvent event(
+                    TraceEvent::CounterDelta, key, reader.Double(), category);
+                event.SetTimeStamp(eventTime);
+                events.EmplaceBack(std::move(event));
+                break;
+            }
+            case EventType::CounterValue: {
+                TraceEvent event(
+                    TraceEvent::CounterValue, key, reader.Double(), category);
+                event.SetTimeStamp(eventTime);
+                events.EmplaceBack(std::move(event));
+                break;
+            }
+            case EventType::ScopeData: {
+                std::unique_ptr<TraceEvent> event;
+                switch (DataType(reader.Byte())) {
+                    case DataType::Boolean:
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            reader.Byte() != 0, category));
+                        break;
+                    case DataType::Int:
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            reader.Signed(), category));
+                        break;
+                    case DataType::UInt:
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            reader.Varint(), category));
+                        break;
+                    case DataType::Float:
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            reader.Double(), category));
+                        break;
+                    case DataType::String: {
+                        const uint64_t id = reader.Varint();
+                        if (id >= _strings.size()) {
+                            return false;
+                        }
+                        event.reset(new TraceEvent(TraceEvent::Data, key,
+                            events.StoreData(_strings[id].c_str()),
+                            category));
+                        break;
+                    }
+                    case DataType::Invalid:
+                        break;
+                }
+                if (!event) {
+                    return false;
+                }
+                event->SetTimeStamp(eventTime);
+                events.EmplaceBack(std::move(*event));
+                break;
+            }
+            default:
+                return false;
+        }
+        ++_eventCount;
+    }
+    return reader.Ok() && reader.AtEnd();
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
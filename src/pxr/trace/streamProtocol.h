@@ -0,0 +1,154 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_STREAM_PROTOCOL_H
+#define PXR_TRACE_STREAM_PROTOCOL_H
+
+#include "pxr/trace/pxr.h"
+
+#include "pxr/trace/clock.h"
+#include "pxr/trace/collection.h"
+#include "pxr/trace/threads.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// The framed protocol used by TraceStreamServer to send collections to
+/// TraceReporterDataSourceStream.
+///
+/// Each frame is a 32 bit little endian payload size, a frame type byte and
+/// the payload. Integers in payloads are LEB128 varints, with signed values
+/// zigzag encoded, and doubles are 8 little endian bytes.
+///
+/// Strings are sent once per connection in String frames and referred to by
+/// id afterwards. A collection is sent as one or more Events frames, each
+/// holding events of a single thread with timestamps delta encoded, followed
+/// by an EndCollection frame. A Clock frame precedes the first collection
+/// and any collection whose clock calibration changed.
+///
+namespace Trace_StreamProtocol {
+
+constexpr uint32_t Version = 1;
+
+/// Frames larger than this are rejected by the decoder.
+constexpr uint32_t MaxFrameSize = 64 << 20;
+
+enum class FrameType : uint8_t {
+    Hello = 1,          ///< Protocol version and process id.
+    String = 2,         ///< String id and bytes.
+    Events = 3,         ///< Thread string id, event count and events.
+    EndCollection = 4,  ///< No payload.
+    Dropped = 5,        ///< Total number of events dropped by the server.
+    Clock = 6,          ///< Clock calibration of the next collections.
+};
+
+} // namespace Trace_StreamProtocol
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \class Trace_StreamEncoder
+///
+/// Encodes collections into frames for a single connection.
+///
+class Trace_StreamEncoder {
+public:
+    /// Appends a Hello frame for the current process to \p out.
+    void EncodeHello(std::string* out);
+
+    /// Appends the frames of \p collection to \p out.
+    void EncodeCollection(const TraceCollection& collection, std::string* out);
+
+    /// Appends a Dropped frame reporting \p droppedEvents to \p out.
+    void EncodeDropped(uint64_t droppedEvents, std::string* out);
+
+private:
+    // Appends a Clock frame to \p out if \p calibration was not sent yet.
+    void _EncodeClock(
+        const TraceClockCalibration& calibration, std::string* out);
+
+    // Returns the id of \p str, appending a String frame to \p out if it was
+    // not sent yet.
+    uint32_t _GetStringId(const std::string& str, std::string* out);
+
+    std::unordered_map<std::string, uint32_t> _stringIds;
+    TraceClockCalibration _clock;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \class Trace_StreamDecoder
+///
+/// Decodes the frames received by a single connection into collections.
+///
+class Trace_StreamDecoder {
+public:
+    /// Decodes the \p size bytes at \p data, which may end with a partial
+    /// frame, and appends the completed collections to \p collections.
+    /// Returns false if the data does not follow the protocol.
+    bool Decode(const char* data, size_t size,
+        std::vector<std::unique_ptr<TraceCollection>>* collections);
+
+    /// Returns the process id sent by the server, or 0.
+    int GetProcessId() const { return _processId; }
+
+    /// Returns the number of events the server reported as dropped.
+    uint64_t GetDroppedEventCount() const { return _droppedEvents; }
+
+    /// Returns the number of events decoded.
+    uint64_t GetEventCount() const { return _eventCount; }
+
+    /// Converts the timestamps of the decoded collections to the clock of
+    /// \p calibration, e.g. the calibration of the local TraceClock, when
+    /// the server sends the calibration of its clock.
+    void SetTargetClock(const TraceClockCalibration& calibration) {
+        _targetClock = calibration;
+        _UpdateClockConversion();
+    }
+
+    /// Returns the calibration of the clock of the server, which is invalid
+    /// if the server did not send it.
+    const TraceClockCalibration& GetClock() const { return _clock; }
+
+private:
+    bool _DecodeFrame(uint8_t type, const char* begin, const char* end,
+        std::vector<std::unique_ptr<TraceCollection>>* collections);
+    bool _DecodeEvents(const char* begin, const char* end);
+
+    // Determines whether timestamps need to be converted to the target
+    // clock.
+    void _UpdateClockConversion();
+
+    // Returns \p time, a timestamp of the server, in the target clock.
+    TraceEvent::TimeStamp _ToTargetClock(TraceEvent::TimeStamp time) const {
+        return _convertTimes ? _clock.Convert(time, _targetClock) : time;
+    }
+
+    struct _ThreadData {
+        TraceCollection::EventListPtr events;
+        std::unordered_map<uint32_t, TraceKey> keys;
+    };
+
+    std::string _buffer;
+    std::vector<std::string> _strings;
+    std::map<TraceThreadId, _ThreadData> _threads;
+    int _processId = 0;
+    uint64_t _droppedEvents = 0;
+    uint64_t _eventCount = 0;
+    TraceClockCalibration _clock;
+    TraceClockCalibration _targetClock;
+    bool _convertTimes = false;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_STREAM_PROTOCOL_H
@@ -0,0 +1,358 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include "pxr/trace/streamServer.h"
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/collector.h"
+#include "pxr/trace/streamProtocol.h"
+
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/mallocTag.h>
+#include <pxr/arch/defines.h>
+
+#if !defined(ARCH_OS_WINDOWS)
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+// How long the sender thread waits for collections before checking for new
+// consumers.
+constexpr std::chrono::milliseconds _PollInterval(20);
+
+// Counts the events of a collection.
+class _EventCounter {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        count += events.size();
+    }
+
+    size_t count = 0;
+};
+
+size_t
+_CountEvents(const TraceCollection& collection)
+{
+    _EventCounter counter;
+    collection.IterateBatches(counter);
+    return counter.count;
+}
+
+#if !defined(ARCH_OS_WINDOWS)
+// Writes \p size bytes to \p fd. Returns false if the consumer is gone.
+bool
+_WriteAll(int fd, const char* data, size_t size)
+{
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    while (size > 0) {
+        const ssize_t n = send(fd, data, size, flags);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= size_t(n);
+    }
+    return true;
+}
+#endif
+
+} // anonymous namespace
+
+struct TraceStreamServer::_Client {
+    int socket;
+    Trace_StreamEncoder encoder;
+    uint64_t reportedDroppedEvents = 0;
+};
+
+TraceStreamServerRefPtr
+TraceStreamServer::New(const std::string& socketPath, const Options& options)
+{
+#if defined(ARCH_OS_WINDOWS)
+    TF_RUNTIME_ERROR("Trace streaming is not supported on this platform");
+    return ThisRefPtr();
+#else
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        TF_CODING_ERROR("Invalid socket path '%s'", socketPath.c_str());
+        return ThisRefPtr();
+    }
+    strncpy(address.sun_path, socketPath.c_str(),
+        sizeof(address.sun_path) - 1);
+
+    // Replace a socket left by a previous server.
+    struct stat st;
+    if (stat(socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(socketPath.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        TF_RUNTIME_ERROR("Failed to create socket: %s", strerror(errno));
+        return ThisRefPtr();
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(fd, 8) != 0) {
+        TF_RUNTIME_ERROR("Failed to listen on '%s': %s",
+            socketPath.c_str(), strerror(errno));
+        close(fd);
+        return ThisRefPtr();
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    return TfCreateRefPtr(new This(socketPath, options, fd));
+#endif
+}
+
+TraceStreamServer::TraceStreamServer(
+    const std::string& socketPath, const Options& options, int socket)
+    : _socketPath(socketPath)
+    , _options(options)
+    , _socket(socket)
+    , _clientCount(0)
+{
+    _thread = std::thread(&This::_Run, this);
+    _noticeKey = TfNotice::Register(ThisPtr(this), &This::_OnTraceCollection);
+}
+
+TraceStreamServer::~TraceStreamServer()
+{
+    TfNotice::Revoke(_noticeKey);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _dataAvailable.notify_all();
+    _spaceAvailable.notify_all();
+    _thread.join();
+
+#if !defined(ARCH_OS_WINDOWS)
+    for (const std::unique_ptr<_Client>& client : _clients) {
+        close(client->socket);
+    }
+    close(_socket);
+    unlink(_socketPath.c_str());
+#endif
+}
+
+size_t
+TraceStreamServer::GetClientCount() const
+{
+    return _clientCount.load(std::memory_order_relaxed);
+}
+
+TraceStreamServer::Stats
+TraceStreamServer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void
+TraceStreamServer::_OnTraceCollection(const TraceCollectionAvailable& notice)
+{
+    Publish(notice.GetCollection());
+}
+
+void
+TraceStreamServer::Publish(const std::shared_ptr<TraceCollection>& collection)
+{
+    if (!collection || GetClientCount() == 0) {
+        return;
+    }
+    const size_t numEvents = _CountEvents(*collection);
+    if (numEvents == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto hasRoom = [this, numEvents]() {
+        // A collection larger than the queue is accepted when the queue is
+        // empty.
+        return _stop || _pendingEvents == 0 ||
+            _pendingEvents + numEvents <= _options.maxPendingEvents;
+    };
+
+    if (!hasRoom()) {
+        // The sender thread publishes the collections it flushes, so it must
+        // never wait for itself.
+        if (_options.backpressure == Backpressure::Drop ||
+            std::this_thread::get_id() == _thread.get_id()) {
+            ++_stats.droppedCollections;
+            _stats.droppedEvents += numEvents;
+            return;
+        }
+
+        ++_stats.pauses;
+        const auto start = std::chrono::steady_clock::now();
+        _spaceAvailable.wait(lock, hasRoom);
+        _stats.pausedSeconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        if (_stop) {
+            return;
+        }
+    }
+
+    _pending.push_back(collection);
+    _pendingEvents += numEvents;
+    lock.unlock();
+    _dataAvailable.notify_one();
+}
+
+void
+TraceStreamServer::_Run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto flushInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(_options.flushInterval));
+    Clock::time_point nextFlush = Clock::now() + flushInterval;
+
+    while (true) {
+        _AcceptClients();
+
+        if (_options.flushInterval > 0.0 && !_clients.empty() &&
+            Clock::now() >= nextFlush) {
+            // Seals the event lists of all the threads. The collection comes
+            // back through the notice.
+            TraceCollector::GetInstance().CreateCollection();
+            nextFlush = Clock::now() + flushInterval;
+        }
+
+        std::vector<std::shared_ptr<TraceCollection>> collections;
+        uint64_t droppedEvents = 0;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _dataAvailable.wait_for(lock, _PollInterval, [this]() {
+                return _stop || !_pending.empty();
+            });
+            if (_stop) {
+                break;
+            }
+            collections.swap(_pending);
+            _pendingEvents = 0;
+            droppedEvents = _stats.droppedEvents;
+        }
+        _spaceAvailable.notify_all();
+
+        _Send(collections, droppedEvents);
+    }
+}
+
+void
+TraceStreamServer::_AcceptClients()
+{
+#if !defined(ARCH_OS_WINDOWS)
+    while (true) {
+        const int fd = accept(_socket, nullptr, nullptr);
+        if (fd < 0) {
+            break;
+        }
+        // Sockets accepted from a non blocking socket are non blocking on
+        // some platforms.
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+#if defined(SO_NOSIGPIPE)
+        const int noSigPipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE,
+            &noSigPipe, sizeof(noSigPipe));
+#endif
+        std::unique_ptr<_Client> client(new _Client);
+        client->socket = fd;
+        std::string hello;
+        client->encoder.EncodeHello(&hello);
+        if (_WriteAll(fd, hello.data(), hello.size())) {
+            _clients.push_back(std::move(client));
+        } else {
+            close(fd);
+        }
+    }
+    _clientCount.store(_clients.size(), std::memory_order_relaxed);
+#endif
+}
+
+void
+TraceStreamServer::_Send(
+    const std::vector<std::shared_ptr<TraceCollection>>& collections,
+    uint64_t droppedEvents)
+{
+#if !defined(ARCH_OS_WINDOWS)
+    TfAutoMallocTag2 tag("Trace", "TraceStreamServer::_Send");
+
+    uint64_t sentBytes = 0;
+    std::string buffer;
+    for (auto it = _clients.begin(); it != _clients.end(); ) {
+        _Client& client = **it;
+        buffer.clear();
+        if (client.reportedDroppedEvents != droppedEvents) {
+            client.encoder.EncodeDropped(droppedEvents, &buffer);
+            client.reportedDroppedEvents = droppedEvents;
+        }
+        bool connected = true;
+        for (const std::shared_ptr<TraceCollection>& collection : collections) {
+            client.encoder.EncodeCollection(*collection, &buffer);
+            // Send large batches as they are encoded.
+            if (buffer.size() >= (1 << 20)) {
+                connected = _WriteAll(client.socket, buffer.data(),
+                    buffer.size());
+                sentBytes += buffer.size();
+                buffer.clear();
+                if (!connected) {
+                    break;
+                }
+            }
+        }
+        if (connected && !buffer.empty()) {
+            connected = _WriteAll(client.socket, buffer.data(), buffer.size());
+            sentBytes += buffer.size();
+        }
+        if (connected) {
+            ++it;
+        } else {
+            close(client.socket);
+            it = _clients.erase(it);
+        }
+    }
+    _clientCount.store(_clients.size(), std::memory_order_relaxed);
+
+    size_t sentEvents = 0;
+    if (!_clients.empty()) {
+        for (const std::shared_ptr<TraceCollection>& c : collections) {
+            sentEvents += _CountEvents(*c);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!collections.empty() && !_clients.empty()) {
+        _stats.sentCollections += collections.size();
+        _stats.sentEvents += sentEvents;
+    }
+    _stats.sentBytes += sentBytes;
+#endif
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,164 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_STREAM_SERVER_H
+#define PXR_TRACE_STREAM_SERVER_H
+
+#include "pxr/trace/pxr.h"
+#include "pxr/trace/api.h"
+#include "pxr/trace/collection.h"
+#include "pxr/trace/collectionNotice.h"
+
+#include <pxr/tf/declarePtrs.h>
+#include <pxr/tf/notice.h>
+#include <pxr/tf/refBase.h>
+#include <pxr/tf/refPtr.h>
+#include <pxr/tf/weakBase.h>
+#include <pxr/tf/weakPtr.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+TF_DECLARE_WEAK_AND_REF_PTRS(TraceStreamServer);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TraceStreamServer
+///
+/// This class streams the events recorded by the TraceCollector to local
+/// consumers over a Unix domain socket while the process is running.
+///
+/// The server listens on a socket path and sends every TraceCollection
+/// produced by the collector to the connected consumers. Each collection
+/// holds the event lists sealed by the collector since the previous one, so
+/// the server periodically calls TraceCollector::CreateCollection() when
+/// \c Options::flushInterval is not zero. TraceReporterDataSourceStream
+/// receives the events on the consumer side.
+///
+/// Collections are queued and sent by a background thread. When consumers
+/// are slower than the process records events, the queue reaches
+/// \c Options::maxPendingEvents and the server either drops collections or
+/// pauses the thread publishing them, depending on \c Options::backpressure.
+/// Both are counted in the Stats of the server.
+///
+/// Unix domain sockets are not supported on Windows, where New() fails.
+///
+class TraceStreamServer : public TfRefBase, public TfWeakBase {
+public:
+    using This = TraceStreamServer;
+    using ThisPtr = TraceStreamServerPtr;
+    using ThisRefPtr = TraceStreamServerRefPtr;
+
+    /// What the server does with collections published while its queue is
+    /// full.
+    enum class Backpressure {
+        Drop,   ///< Drop the collection.
+        Block,  ///< Wait until the queue has room for the collection.
+    };
+
+    /// Parameters of the server.
+    struct Options {
+        Options()
+            : backpressure(Backpressure::Drop)
+            , maxPendingEvents(1 << 20)
+            , flushInterval(0.1)
+        {}
+
+        /// What to do with collections published while the queue is full.
+        Backpressure backpressure;
+
+        /// Maximum number of events waiting to be sent.
+        size_t maxPendingEvents;
+
+        /// Number of seconds between calls to
+        /// TraceCollector::CreateCollection() while consumers are
+        /// connected, or 0 to only send collections created by the client
+        /// code.
+        double flushInterval;
+    };
+
+    /// Counters describing the activity of the server.
+    struct Stats {
+        uint64_t sentCollections = 0;
+        uint64_t sentEvents = 0;
+        uint64_t sentBytes = 0;
+        uint64_t droppedCollections = 0;
+        uint64_t droppedEvents = 0;
+        /// Number of times publishing waited for room in the queue.
+        uint64_t pauses = 0;
+        /// Total number of seconds spent waiting for room in the queue.
+        double pausedSeconds = 0.0;
+    };
+
+    /// Creates a server listening on \p socketPath. An existing socket at
+    /// that path is replaced. Returns a null pointer and issues an error if
+    /// the socket could not be created.
+    TRACE_API static ThisRefPtr New(
+        const std::string& socketPath, const Options& options = Options());
+
+    /// Stops the server, disconnects the consumers and removes the socket.
+    TRACE_API ~TraceStreamServer();
+
+    /// Returns the path of the socket.
+    const std::string& GetSocketPath() const { return _socketPath; }
+
+    /// Returns the options of the server.
+    const Options& GetOptions() const { return _options; }
+
+    /// Returns the number of connected consumers.
+    TRACE_API size_t GetClientCount() const;
+
+    /// Returns the counters of the server.
+    TRACE_API Stats GetStats() const;
+
+    /// Queues \p collection to be sent to the connected consumers. This is
+    /// called for every collection produced by the TraceCollector.
+    /// Collections published while no consumer is connected are discarded.
+    TRACE_API void Publish(const std::shared_ptr<TraceCollection>& collection);
+
+private:
+    struct _Client;
+
+    TraceStreamServer(
+        const std::string& socketPath, const Options& options, int socket);
+
+    void _OnTraceCollection(const TraceCollectionAvailable&);
+
+    // Runs the thread which accepts consumers and sends the collections.
+    void _Run();
+    void _AcceptClients();
+    void _Send(const std::vector<std::shared_ptr<TraceCollection>>&,
+        uint64_t droppedEvents);
+
+    const std::string _socketPath;
+    const Options _options;
+    int _socket;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _dataAvailable;
+    std::condition_variable _spaceAvailable;
+    std::vector<std::shared_ptr<TraceCollection>> _pending;
+    size_t _pendingEvents = 0;
+    bool _stop = false;
+    Stats _stats;
+
+    // Only accessed by the sender thread, except for the count.
+    std::vector<std::unique_ptr<_Client>> _clients;
+    std::atomic<size_t> _clientCount;
+
+    std::thread _thread;
+    TfNotice::Key _noticeKey;
+};
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_STREAM_SERVER_H
@@ -8,8 +8,15 @@
 #include "pxr/trace/threads.h"
 
 #include "pxr/trace/pxr.h"
+#include <pxr/arch/defines.h>
 #include <pxr/arch/threads.h>
 
+#if defined(ARCH_OS_WINDOWS)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 #include <sstream>
 
 TRACE_NAMESPACE_OPEN_SCOPE
@@ -29,10 +36,15 @@ TraceThreadId::TraceThreadId(const std::string& s)
     : _id(s)
 {}
 
+TraceThreadId::TraceThreadId(const std::string& s, int processId)
+    : _id(s)
+    , _processId(processId)
+{}
+
 bool
 TraceThreadId::operator==(const TraceThreadId& rhs) const
 {
-    return _id == rhs._id;
+    return _id == rhs._id && _processId == rhs._processId;
 }
 
 bool
@@ -41,9 +53,22 @@ TraceThreadId::operator<(const TraceThreadId& rhs) const
     // Because thread ids are stored in a string, sort the shorter strings to 
     // the front of the list. This results is a numerically sorted list rather
     // than an alphabetically sorted one, assuming all the thread ids are in 
-    // the form of "Thread XXX" or "XXX".
+    // the form of "Thread XXX" or "XXX". Threads are grouped by process.
+    if (_processId != rhs._processId) {
+        return _processId < rhs._processId;
+    }
     return _id.length() != rhs._id.length() ? 
         _id.length() < rhs._id.length() : _id < rhs._id;
 }
 
+int
+TraceGetProcessId()
+{
+#if defined(ARCH_OS_WINDOWS)
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
 TRACE_NAMESPACE_CLOSE_SCOPE
\ No newline at end of file
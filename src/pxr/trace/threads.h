@@ -30,9 +30,17 @@ public:
     /// Constructor which creates an identifier from \p id.
     TRACE_API explicit TraceThreadId(const std::string& id);
 
+    /// Constructor which creates an identifier from \p id for a thread of 
+    /// the process with id \p processId.
+    TRACE_API TraceThreadId(const std::string& id, int processId);
+
     /// Returns the string representation of the id.
     const std::string& ToString() const { return _id; }
 
+    /// Returns the id of the process the thread belongs to, or 0 if the 
+    /// thread belongs to the current process.
+    int GetProcessId() const { return _processId; }
+
     /// Equality operator.
     TRACE_API bool operator==(const TraceThreadId&) const;
 
@@ -40,12 +48,16 @@ public:
     TRACE_API bool operator<(const TraceThreadId&) const;
 private:
     std::string _id;
+    int _processId = 0;
 };
 
 inline TraceThreadId TraceGetThreadId() {
     return  TraceThreadId();
 }
 
+/// Returns the id of the current process.
+TRACE_API int TraceGetProcessId();
+
 TRACE_NAMESPACE_CLOSE_SCOPE
 
 #endif // PXR_TRACE_THREADS_H
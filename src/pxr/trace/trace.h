@@ -13,6 +13,7 @@
 #include "pxr/trace/pxr.h"
 
 #include "pxr/trace/api.h"
+#include "pxr/trace/clock.h"
 #include "pxr/trace/collector.h"
 
 #include <pxr/tf/preprocessorUtilsLite.h>
@@ -192,36 +193,42 @@ public:
     ///
     explicit TraceScopeAuto(const TraceStaticKeyData& key) noexcept
         : _key(&key)
-        , _intervalTimer(/*start=*/TraceCollector::IsEnabled()) {
+        , _isStarted(TraceCollector::IsEnabled())
+        , _startTime(_isStarted ? TraceClock::GetStartTime() : 0) {
     }
 
-    /// Constructor that also records scope arguments.
+    /// Constructor that also records scope arguments. The arguments are not
+    /// recorded in metrics-only mode, see TraceCollector::SetMetricsOnly().
     ///
     template < typename... Args>
     TraceScopeAuto(const TraceStaticKeyData& key, Args&&... args)
         : _key(&key)
-        , _intervalTimer(/*start=*/false) {
+        , _isStarted(false)
+        , _startTime(0) {
         if (TraceCollector::IsEnabled()) {
-            _intervalTimer.Start();
-            TraceCollector
-                ::GetInstance().ScopeArgs(std::forward<Args>(args)...);
+            _isStarted = true;
+            _startTime = TraceClock::GetStartTime();
+            // Arguments are not kept in metrics-only mode.
+            if (!TraceCollector::IsMetricsOnly()) {
+                TraceCollector
+                    ::GetInstance().ScopeArgs(std::forward<Args>(args)...);
+            }
         }
     }
 
     /// Destructor.
     ///
     ~TraceScopeAuto() noexcept {
-        if (_intervalTimer.IsStarted()) {
-            TraceCollector::TimeStamp stopTicks =
-                _intervalTimer.GetCurrentTicks();
-            TraceCollector::Scope(
-                *_key, _intervalTimer.GetStartTicks(), stopTicks);
+        if (_isStarted) {
+            TraceCollector::TimeStamp stopTime = TraceClock::GetStopTime();
+            TraceCollector::Scope(*_key, _startTime, stopTime);
         }
     }
     
 private:
     const TraceStaticKeyData* const _key;
-    ArchIntervalTimer _intervalTimer;
+    bool _isStarted;
+    TraceCollector::TimeStamp _startTime;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -13,28 +13,11 @@ from pxr import Tf
 Tf.PreparePythonModule()
 del Tf
 
-import contextlib
-
-@contextlib.contextmanager
-def TraceScope(label):
-    """A context manager that calls BeginEvent on the global collector on enter 
-    and EndEvent on exit."""
-    try:
-        collector = Collector()
-        eventId = collector.BeginEvent(label)
-        yield
-    finally:
-        collector.EndEvent(label)
-
-del contextlib
-
 def TraceFunction(obj):
     """A decorator that enables tracing the function that it decorates.
     If you decorate with 'TraceFunction' the function will be traced in the
     global collector."""
     
-    collector = Collector()
-    
     def decorate(func):
         import inspect
 
@@ -56,11 +39,11 @@ def TraceFunction(obj):
             moduleLabel,
             classLabel,
             func.__name__)
-        def invoke(*args, **kwargs):
-            with TraceScope(label):
-                return func(*args, **kwargs)
 
-        invoke.__name__ = func.__name__
+        # The label is turned into a key once here, so that calls only
+        # record the scope.
+        invoke = TracedFunction(func, label)
+
         # Make sure wrapper function gets attributes of wrapped function.
         import functools
         return functools.update_wrapper(invoke, func)
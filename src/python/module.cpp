@@ -14,9 +14,15 @@ TRACE_NAMESPACE_USING_DIRECTIVE
 TF_WRAP_MODULE
 {
     TF_WRAP( Collector );
+    TF_WRAP( Column );
     TF_WRAP( AggregateNode );
+    TF_WRAP( AggregateTable );
     TF_WRAP( AggregateTree );
+    TF_WRAP( AggregateTreeDiff );
+    TF_WRAP( CounterDownsampler );
+    TF_WRAP( EventTable );
     TF_WRAP( Reporter );
+    TF_WRAP( Scope );
 
     TF_WRAP( TestTrace );
 }
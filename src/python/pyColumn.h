@@ -0,0 +1,83 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#ifndef PXR_TRACE_PY_COLUMN_H
+#define PXR_TRACE_PY_COLUMN_H
+
+#include <pxr/trace/pxr.h>
+
+#include <pxr/boost/python/extract.hpp>
+#include <pxr/boost/python/handle.hpp>
+#include <pxr/boost/python/object.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+// A column of a table, exposed to Python with the buffer protocol so that
+// memoryview and NumPy use its memory without copying it. The column keeps
+// the Python object which owns its memory alive.
+class Trace_PyColumn {
+public:
+    template <class T>
+    Trace_PyColumn(
+        const pxr_boost::python::object& owner,
+        const std::vector<T>& values)
+        : _owner(owner)
+        , _data(values.data())
+        , _size(Py_ssize_t(values.size()))
+        , _itemSize(Py_ssize_t(sizeof(T)))
+        , _format(_GetFormat<T>()) {}
+
+    Py_ssize_t GetSize() const { return _size; }
+
+    // Fills view as the buffer protocol requires.
+    int GetBuffer(PyObject* self, Py_buffer* view, int flags);
+
+private:
+    template <class T>
+    static const char* _GetFormat() {
+        static_assert(std::is_integral<T>::value &&
+                      (sizeof(T) == 4 || sizeof(T) == 8),
+                      "Unsupported column type");
+        if (std::is_signed<T>::value) {
+            return sizeof(T) == 4 ? "i" : "q";
+        }
+        return sizeof(T) == 4 ? "I" : "Q";
+    }
+
+    pxr_boost::python::object _owner;
+    const void* _data;
+    Py_ssize_t _size;
+    Py_ssize_t _itemSize;
+    const char* _format;
+};
+
+// Returns a memoryview of values, which must be owned by owner.
+template <class T>
+pxr_boost::python::object
+Trace_MakePyColumn(
+    const pxr_boost::python::object& owner,
+    const std::vector<T>& values)
+{
+    using namespace pxr_boost::python;
+    const object column(Trace_PyColumn(owner, values));
+    return object(handle<>(PyMemoryView_FromObject(column.ptr())));
+}
+
+// Returns the column of the table self given by Getter.
+template <class Table, class T, const std::vector<T>& (Table::*Getter)() const>
+pxr_boost::python::object
+Trace_GetPyColumn(const pxr_boost::python::object& self)
+{
+    const Table& table = pxr_boost::python::extract<const Table&>(self);
+    return Trace_MakePyColumn(self, (table.*Getter)());
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+#endif // PXR_TRACE_PY_COLUMN_H
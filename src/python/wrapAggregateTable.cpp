@@ -0,0 +1,65 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/pxr.h>
+
+#include <pxr/trace/aggregateTable.h>
+
+#include <pxr/trace/aggregateTree.h>
+
+#include "pyColumn.h"
+
+#include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/list.hpp>
+#include <pxr/boost/python/make_constructor.hpp>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using namespace pxr_boost::python;
+
+static TraceAggregateTable*
+_New(const TraceAggregateTreePtr& tree)
+{
+    return new TraceAggregateTable(*tree);
+}
+
+static list
+_GetKeys(const TraceAggregateTable& self)
+{
+    list keys;
+    for (const TfToken& key : self.GetKeys()) {
+        keys.append(key.GetString());
+    }
+    return keys;
+}
+
+void wrapAggregateTable()
+{
+    using This = TraceAggregateTable;
+
+    class_<This, noncopyable>("AggregateTable", no_init)
+        .def("__init__", make_constructor(&::_New))
+        .def("__len__", &This::GetSize)
+        .add_property("keys", &::_GetKeys)
+        .add_property("threadIds",
+            &Trace_GetPyColumn<This, This::KeyId, &This::GetThreadIds>)
+        .add_property("keyIds",
+            &Trace_GetPyColumn<This, This::KeyId, &This::GetKeyIds>)
+        .add_property("depths",
+            &Trace_GetPyColumn<This, uint32_t, &This::GetDepths>)
+        .add_property("parents",
+            &Trace_GetPyColumn<This, int64_t, &This::GetParents>)
+        .add_property("inclusiveTimes",
+            &Trace_GetPyColumn<This, This::TimeStamp,
+                               &This::GetInclusiveTimes>)
+        .add_property("exclusiveTimes",
+            &Trace_GetPyColumn<This, This::TimeStamp,
+                               &This::GetExclusiveTimes>)
+        .add_property("counts",
+            &Trace_GetPyColumn<This, int, &This::GetCounts>)
+        .add_property("exclusiveCounts",
+            &Trace_GetPyColumn<This, int, &This::GetExclusiveCounts>)
+        ;
+}
@@ -0,0 +1,197 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/pxr.h>
+
+#include <pxr/trace/aggregateTreeDiff.h>
+
+#include <pxr/tf/makePyConstructor.h>
+#include <pxr/tf/pyPtrHelpers.h>
+#include <pxr/tf/pyResultConversions.h>
+
+#include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/enum.hpp>
+#include <pxr/boost/python/extract.hpp>
+#include <pxr/boost/python/scope.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using namespace pxr_boost::python;
+
+static TraceAggregateTreeDiff::Options
+_MakeOptions(double threshold, double minimumTime, double significance)
+{
+    TraceAggregateTreeDiff::Options options;
+    options.threshold = threshold;
+    options.minimumTime = minimumTime;
+    options.significance = significance;
+    return options;
+}
+
+// Accepts either a single aggregate tree or a sequence of parsed trees, as
+// returned by Reporter.LoadReport.
+static std::vector<TraceReporter::ParsedTree>
+_ExtractTrees(const object& obj)
+{
+    extract<TraceAggregateTreePtr> tree(obj);
+    if (tree.check()) {
+        return {TraceReporter::ParsedTree{
+            TraceAggregateTreeRefPtr(tree()), 1}};
+    }
+
+    std::vector<TraceReporter::ParsedTree> trees;
+    const size_t size = len(obj);
+    for (size_t i = 0; i < size; ++i) {
+        trees.push_back(extract<TraceReporter::ParsedTree>(obj[i]));
+    }
+    return trees;
+}
+
+static TraceAggregateTreeDiffRefPtr
+_New(const object& baseline,
+     const object& candidate,
+     double threshold,
+     double minimumTime,
+     double significance)
+{
+    return TraceAggregateTreeDiff::New(
+        _ExtractTrees(baseline), _ExtractTrees(candidate),
+        _MakeOptions(threshold, minimumTime, significance));
+}
+
+static void
+_Report(const TraceAggregateTreeDiffPtr& self, bool changedOnly)
+{
+    self->Report(std::cout, changedOnly);
+}
+
+static void
+_ReportToFile(
+    const TraceAggregateTreeDiffPtr& self,
+    const std::string& fileName,
+    bool changedOnly)
+{
+    std::ofstream os(fileName.c_str());
+    self->Report(os, changedOnly);
+}
+
+static std::string
+_GetJson(const TraceAggregateTreeDiffPtr& self)
+{
+    std::ostringstream os;
+    self->ReportJson(os);
+    return os.str();
+}
+
+static void
+_ReportJsonToFile(
+    const TraceAggregateTreeDiffPtr& self,
+    const std::string& fileName)
+{
+    std::ofstream os(fileName.c_str());
+    self->ReportJson(os);
+}
+
+static std::vector<TraceAggregateTreeDiff::Entry>
+_GetEntries(const TraceAggregateTreeDiffPtr& self)
+{
+    return self->GetEntries();
+}
+
+static std::vector<TraceAggregateTreeDiff::Entry>
+_GetRegressions(const TraceAggregateTreeDiffPtr& self)
+{
+    return self->GetEntries(TraceAggregateTreeDiff::Status::Regression);
+}
+
+static std::vector<std::string>
+_GetPath(const TraceAggregateTreeDiff::Entry& self)
+{
+    std::vector<std::string> path;
+    for (const TfToken& key : self.path) {
+        path.push_back(key.GetString());
+    }
+    return path;
+}
+
+void wrapAggregateTreeDiff()
+{
+    using This = TraceAggregateTreeDiff;
+    using ThisPtr = TraceAggregateTreeDiffPtr;
+
+    scope diff_class =
+        class_<This, ThisPtr, noncopyable>("AggregateTreeDiff", no_init)
+        .def(TfPyRefAndWeakPtr())
+        .def(TfMakePyConstructor(_New),
+            (arg("baseline"),
+             arg("candidate"),
+             arg("threshold") = 0.05,
+             arg("minimumTime") = 0.0,
+             arg("significance") = 2.0))
+
+        .add_property("baselineRunCount", &This::GetBaselineRunCount)
+        .add_property("candidateRunCount", &This::GetCandidateRunCount)
+
+        .add_property("entries",
+            make_function(&::_GetEntries,
+                          return_value_policy<TfPySequenceToList>()))
+        .add_property("regressions",
+            make_function(&::_GetRegressions,
+                          return_value_policy<TfPySequenceToList>()))
+
+        .def("HasRegressions", &This::HasRegressions)
+
+        .def("Report", &::_Report,
+             (arg("changedOnly")=true))
+
+        .def("Report", &::_ReportToFile,
+             (arg("fileName"),
+              arg("changedOnly")=true))
+
+        .def("GetJson", &::_GetJson)
+        .def("ReportJson", &::_ReportJsonToFile,
+             (arg("fileName")))
+        ;
+
+    enum_<This::Status>("Status")
+        .value("Unchanged", This::Status::Unchanged)
+        .value("Regression", This::Status::Regression)
+        .value("Improvement", This::Status::Improvement)
+        .value("Added", This::Status::Added)
+        .value("Removed", This::Status::Removed)
+        ;
+
+    class_<This::Measurement>("Measurement", no_init)
+        .def_readonly("inclusiveTime", &This::Measurement::inclusiveTime)
+        .def_readonly("exclusiveTime", &This::Measurement::exclusiveTime)
+        .def_readonly("count", &This::Measurement::count)
+        .def_readonly("inclusiveTimeStdDev",
+            &This::Measurement::inclusiveTimeStdDev)
+        ;
+
+    class_<This::Entry>("Entry", no_init)
+        .add_property("path",
+            make_function(&::_GetPath,
+                          return_value_policy<TfPySequenceToList>()))
+        .add_property("key",
+            make_function(&This::Entry::GetKey,
+                          return_value_policy<return_by_value>()))
+        .def_readonly("baseline", &This::Entry::baseline)
+        .def_readonly("candidate", &This::Entry::candidate)
+        .def_readonly("score", &This::Entry::score)
+        .def_readonly("hasScore", &This::Entry::hasScore)
+        .def_readonly("status", &This::Entry::status)
+        .add_property("inclusiveDelta", &This::Entry::GetInclusiveDelta)
+        .add_property("exclusiveDelta", &This::Entry::GetExclusiveDelta)
+        .add_property("countDelta", &This::Entry::GetCountDelta)
+        .add_property("relativeDelta", &This::Entry::GetRelativeDelta)
+        ;
+}
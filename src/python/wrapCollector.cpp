@@ -133,6 +133,9 @@ void wrapCollector()
         .add_property("pythonTracingEnabled",
                       &This::IsPythonTracingEnabled,
                       &This::SetPythonTracingEnabled)
+        .add_property("samplingEnabled",
+                      &This::IsSamplingEnabled,
+                      &This::SetSamplingEnabled)
         ;
     
     def("GetElapsedSeconds", GetElapsedSeconds);
@@ -0,0 +1,69 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/pxr.h>
+
+#include "pyColumn.h"
+
+#include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/extract.hpp>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using namespace pxr_boost::python;
+
+TRACE_NAMESPACE_OPEN_SCOPE
+
+int
+Trace_PyColumn::GetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Trace columns are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+
+    // Empty vectors may have no storage, but buffers need an address.
+    static const char empty = 0;
+
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = const_cast<void*>(_data ? _data : &empty);
+    view->len = _size * _itemSize;
+    view->readonly = 1;
+    view->itemsize = _itemSize;
+    view->format =
+        (flags & PyBUF_FORMAT) ? const_cast<char*>(_format) : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &_size : nullptr;
+    view->strides =
+        (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &_itemSize : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+TRACE_NAMESPACE_CLOSE_SCOPE
+
+static int
+_GetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    Trace_PyColumn& column = extract<Trace_PyColumn&>(self);
+    return column.GetBuffer(self, view, flags);
+}
+
+void wrapColumn()
+{
+    using This = Trace_PyColumn;
+
+    object cls = class_<This>("Column", no_init)
+        .def("__len__", &This::GetSize)
+        ;
+
+    // boost.python does not support the buffer protocol, so it is added to
+    // the type of the class.
+    static PyBufferProcs bufferProcs = { &_GetBuffer, nullptr };
+    reinterpret_cast<PyTypeObject*>(cls.ptr())->tp_as_buffer = &bufferProcs;
+}
@@ -0,0 +1,65 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/pxr.h>
+
+#include <pxr/trace/counterDownsampler.h>
+
+#include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/enum.hpp>
+#include <pxr/boost/python/extract.hpp>
+#include <pxr/boost/python/list.hpp>
+#include <pxr/boost/python/scope.hpp>
+#include <pxr/boost/python/tuple.hpp>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using namespace pxr_boost::python;
+
+// Downsamples a sequence of (time, value) pairs and returns a list of
+// (time, value) tuples.
+static list
+_Downsample(const TraceCounterDownsampler& self, const object& values)
+{
+    TraceCounterDownsampler::CounterValues counterValues;
+    const size_t size = len(values);
+    counterValues.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        const object item = values[i];
+        counterValues.emplace_back(
+            extract<TraceEvent::TimeStamp>(item[0]),
+            extract<double>(item[1]));
+    }
+
+    list result;
+    for (const auto& v : self.Downsample(counterValues)) {
+        result.append(make_tuple(v.first, v.second));
+    }
+    return result;
+}
+
+void wrapCounterDownsampler()
+{
+    using This = TraceCounterDownsampler;
+
+    scope downsampler_class =
+        class_<This>("CounterDownsampler")
+        .def(init<This::Method, size_t>(
+            (arg("method"), arg("resolution"))))
+
+        .add_property("method", &This::GetMethod)
+        .add_property("resolution", &This::GetResolution)
+        .def("IsEnabled", &This::IsEnabled)
+
+        .def("Downsample", &::_Downsample, (arg("values")))
+        ;
+
+    enum_<This::Method>("Method")
+        .value("None_", This::Method::None)
+        .value("MinMax", This::Method::MinMax)
+        .value("LargestTriangleThreeBuckets",
+            This::Method::LargestTriangleThreeBuckets)
+        ;
+}
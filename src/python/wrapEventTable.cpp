@@ -0,0 +1,51 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/pxr.h>
+
+#include <pxr/trace/eventTable.h>
+
+#include "pyColumn.h"
+
+#include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/list.hpp>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using namespace pxr_boost::python;
+
+static list
+_GetKeys(const TraceEventTable& self)
+{
+    list keys;
+    for (const TfToken& key : self.GetKeys()) {
+        keys.append(key.GetString());
+    }
+    return keys;
+}
+
+void wrapEventTable()
+{
+    using This = TraceEventTable;
+
+    class_<This, noncopyable>("EventTable", no_init)
+        .def("__len__", &This::GetSize)
+        .add_property("keys", &::_GetKeys)
+        .add_property("threadIds",
+            &Trace_GetPyColumn<This, This::KeyId, &This::GetThreadIds>)
+        .add_property("keyIds",
+            &Trace_GetPyColumn<This, This::KeyId, &This::GetKeyIds>)
+        .add_property("beginTimes",
+            &Trace_GetPyColumn<This, This::TimeStamp, &This::GetBeginTimes>)
+        .add_property("endTimes",
+            &Trace_GetPyColumn<This, This::TimeStamp, &This::GetEndTimes>)
+        .add_property("depths",
+            &Trace_GetPyColumn<This, uint32_t, &This::GetDepths>)
+        .add_property("parents",
+            &Trace_GetPyColumn<This, int64_t, &This::GetParents>)
+        .add_property("categories",
+            &Trace_GetPyColumn<This, TraceCategoryId, &This::GetCategories>)
+        ;
+}
@@ -9,7 +9,10 @@
 
 #include <pxr/trace/reporter.h>
 
+#include <pxr/trace/aggregateTable.h>
 #include <pxr/trace/aggregateTree.h>
+#include <pxr/trace/eventTable.h>
+#include <pxr/trace/eventTree.h>
 #include <pxr/trace/reporterDataSourceCollector.h>
 
 #include <pxr/tf/makePyConstructor.h>
@@ -17,7 +20,12 @@
 #include <pxr/tf/pyResultConversions.h>
 
 #include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/dict.hpp>
+#include <pxr/boost/python/enum.hpp>
+#include <pxr/boost/python/list.hpp>
+#include <pxr/boost/python/manage_new_object.hpp>
 #include <pxr/boost/python/scope.hpp>
+#include <pxr/boost/python/tuple.hpp>
 
 #include <iostream>
 #include <fstream>
@@ -70,6 +78,43 @@ _ReportChromeTracingToFile(
     self->ReportChromeTracing(os);
 }
 
+static void
+_ReportContention(
+    const TraceReporterPtr &self,
+    size_t maxLocks)
+{
+    self->ReportContention(std::cout, maxLocks);
+}
+
+// Returns a dict of counter names to lists of (time, value) tuples.
+static dict
+_GetCounterValues(const TraceReporterPtr &self)
+{
+    dict result;
+    for (const auto& c : self->GetCounterValues()) {
+        list values;
+        for (const auto& v : c.second) {
+            values.append(make_tuple(v.first, v.second));
+        }
+        result[c.first.GetString()] = values;
+    }
+    return result;
+}
+
+// Returns a table of the events of the event tree.
+static TraceEventTable*
+_GetEventTable(const TraceReporterPtr &self)
+{
+    return new TraceEventTable(*self->GetEventTree());
+}
+
+// Returns a table of the nodes of the aggregate tree.
+static TraceAggregateTable*
+_GetAggregateTable(const TraceReporterPtr &self)
+{
+    return new TraceAggregateTable(*self->GetAggregateTree());
+}
+
 static std::vector<TraceReporter::ParsedTree> 
 _LoadReport(
     const std::string &fileName)
@@ -114,6 +159,9 @@ void wrapReporter()
         .def("ReportChromeTracing", &::_ReportChromeTracing)
         .def("ReportChromeTracingToFile", &::_ReportChromeTracingToFile)
 
+        .def("ReportContention", &::_ReportContention,
+             (arg("maxLocks")=10))
+
         .def("LoadReport", &::_LoadReport, 
             (arg("fileName")),
             return_value_policy<TfPySequenceToList>())
@@ -123,6 +171,13 @@ void wrapReporter()
 
         .def("UpdateTraceTrees", &This::UpdateTraceTrees)
 
+        .def("GetCounterValues", &::_GetCounterValues)
+
+        .def("GetEventTable", &::_GetEventTable,
+             return_value_policy<manage_new_object>())
+        .def("GetAggregateTable", &::_GetAggregateTable,
+             return_value_policy<manage_new_object>())
+
         .def("ClearTree", &This::ClearTree)
 
         .add_property("groupByFunction",
@@ -135,6 +190,16 @@ void wrapReporter()
             &This::ShouldAdjustForOverheadAndNoise,
             &This::SetShouldAdjustForOverheadAndNoise)
 
+        .add_property("counterDownsampler",
+            make_function(&This::GetCounterDownsampler,
+                          return_value_policy<return_by_value>()),
+            &This::SetCounterDownsampler)
+
+        .add_property("reportOptions",
+            make_function(&This::GetReportOptions,
+                          return_value_policy<return_by_value>()),
+            &This::SetReportOptions)
+
         .add_static_property("globalReporter", &This::GetGlobalReporter)
         ;
 
@@ -146,4 +211,23 @@ void wrapReporter()
             return_value_policy<TfPyRefPtrFactory<>>()))
         .def_readonly("iterationCount", &This::ParsedTree::iterationCount)
         ;
+
+    {
+        using Options = This::ReportOptions;
+
+        scope options_class =
+            class_<Options>("ReportOptions")
+            .def_readwrite("sortOrder", &Options::sortOrder)
+            .def_readwrite("minimumTime", &Options::minimumTime)
+            .def_readwrite("minimumPercentage", &Options::minimumPercentage)
+            .def_readwrite("maxDepth", &Options::maxDepth)
+            .def_readwrite("maxChildren", &Options::maxChildren)
+            ;
+
+        enum_<Options::SortOrder>("SortOrder")
+            .value("None_", Options::SortOrder::None)
+            .value("InclusiveTime", Options::SortOrder::InclusiveTime)
+            .value("ExclusiveTime", Options::SortOrder::ExclusiveTime)
+            ;
+    }
 };
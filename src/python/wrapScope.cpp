@@ -0,0 +1,257 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/pxr.h>
+
+#include <pxr/trace/clock.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/dynamicKey.h>
+
+#include <pxr/boost/python/class.hpp>
+#include <pxr/boost/python/handle.hpp>
+#include <pxr/boost/python/scope.hpp>
+
+#include <structmember.h>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using namespace pxr_boost::python;
+
+using TimeStamp = TraceCollector::TimeStamp;
+
+namespace {
+
+// A context manager which records a scope event from its enter to its exit.
+// Labels may be built dynamically, so the key is cached by the event list of
+// the thread like other dynamic keys, and released with it. Its token is
+// created once, so scopes which are entered often can be created once and
+// reused, including by several threads.
+class _Scope {
+public:
+    explicit _Scope(const std::string& label)
+        : _key(label) {}
+
+    void Enter() {
+        // The start is pushed even when the collector is disabled, so that
+        // each exit finds the start of its enter.
+        _starts.emplace_back(std::this_thread::get_id(),
+            TraceCollector::IsEnabled() ? TraceClock::GetStartTime() : 0);
+    }
+
+    void Exit() {
+        // The calls are serialized by the GIL.
+        const std::thread::id thread = std::this_thread::get_id();
+        for (auto it = _starts.rbegin(); it != _starts.rend(); ++it) {
+            if (it->first == thread) {
+                const TimeStamp start = it->second;
+                _starts.erase(std::next(it).base());
+                if (start != 0) {
+                    TraceCollector::GetInstance().ScopeEvent(
+                        _key, start, TraceClock::GetStopTime());
+                }
+                return;
+            }
+        }
+    }
+
+private:
+    TraceDynamicKey _key;
+
+    // The start of each scope which was entered and not exited yet, with
+    // its thread, or 0 if the collector was disabled.
+    std::vector<std::pair<std::thread::id, TimeStamp>> _starts;
+};
+
+// A callable which records a scope event around each call to a function,
+// like TRACE_FUNCTION does for C++ functions. It is a Python type rather
+// than a wrapped class so that the garbage collector can traverse the
+// function, which often refers back to the callable, e.g. through the
+// closure of a recursive function.
+struct _TracedFunction {
+    PyObject_HEAD
+    PyObject* function;
+    PyObject* dict;
+    PyObject* weakrefs;
+    TraceDynamicKey* key;
+};
+
+}
+
+static object
+_EnterScope(const object& self)
+{
+    _Scope& scope = extract<_Scope&>(self);
+    scope.Enter();
+    return self;
+}
+
+static bool
+_ExitScope(_Scope& self, const object&, const object&, const object&)
+{
+    self.Exit();
+    return false;
+}
+
+static PyObject*
+_NewTracedFunction(PyTypeObject* type, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = {"function", "label", nullptr};
+    PyObject* function;
+    const char* label;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Os:TracedFunction",
+            const_cast<char**>(keywords), &function, &label)) {
+        return nullptr;
+    }
+
+    _TracedFunction* self =
+        reinterpret_cast<_TracedFunction*>(type->tp_alloc(type, 0));
+    if (!self) {
+        return nullptr;
+    }
+    Py_INCREF(function);
+    self->function = function;
+    self->key = new TraceDynamicKey(label);
+    return reinterpret_cast<PyObject*>(self);
+}
+
+static int
+_TraverseTracedFunction(PyObject* obj, visitproc visit, void* arg)
+{
+    _TracedFunction* self = reinterpret_cast<_TracedFunction*>(obj);
+    Py_VISIT(Py_TYPE(obj));
+    Py_VISIT(self->function);
+    Py_VISIT(self->dict);
+    return 0;
+}
+
+static int
+_ClearTracedFunction(PyObject* obj)
+{
+    _TracedFunction* self = reinterpret_cast<_TracedFunction*>(obj);
+    Py_CLEAR(self->function);
+    Py_CLEAR(self->dict);
+    return 0;
+}
+
+static void
+_DeallocTracedFunction(PyObject* obj)
+{
+    _TracedFunction* self = reinterpret_cast<_TracedFunction*>(obj);
+    PyTypeObject* type = Py_TYPE(obj);
+    PyObject_GC_UnTrack(obj);
+    if (self->weakrefs) {
+        PyObject_ClearWeakRefs(obj);
+    }
+    _ClearTracedFunction(obj);
+
+    // The events recorded with the key hold their own copy of it.
+    delete self->key;
+    type->tp_free(obj);
+    Py_DECREF(type);
+}
+
+static PyObject*
+_CallTracedFunction(PyObject* obj, PyObject* args, PyObject* kwargs)
+{
+    _TracedFunction* self = reinterpret_cast<_TracedFunction*>(obj);
+    if (!self->function) {
+        PyErr_SetString(PyExc_ReferenceError, "The function was cleared");
+        return nullptr;
+    }
+    if (!TraceCollector::IsEnabled()) {
+        return PyObject_Call(self->function, args, kwargs);
+    }
+
+    // The scope is recorded even when the function raises.
+    const TimeStamp start = TraceClock::GetStartTime();
+    PyObject* result = PyObject_Call(self->function, args, kwargs);
+    TraceCollector::GetInstance().ScopeEvent(
+        *self->key, start, TraceClock::GetStopTime());
+    return result;
+}
+
+// Binds the traced function to obj when it is accessed as a method.
+static PyObject*
+_GetTracedFunction(PyObject* obj, PyObject* instance, PyObject*)
+{
+    if (!instance || instance == Py_None) {
+        Py_INCREF(obj);
+        return obj;
+    }
+    return PyMethod_New(obj, instance);
+}
+
+static PyObject*
+_GetFunction(PyObject* obj, void*)
+{
+    _TracedFunction* self = reinterpret_cast<_TracedFunction*>(obj);
+    PyObject* function = self->function ? self->function : Py_None;
+    Py_INCREF(function);
+    return function;
+}
+
+static object
+_CreateTracedFunctionType()
+{
+    static PyGetSetDef getSets[] = {
+        {const_cast<char*>("function"), &_GetFunction, nullptr,
+         const_cast<char*>("The traced function."), nullptr},
+        {const_cast<char*>("__dict__"), &PyObject_GenericGetDict,
+         &PyObject_GenericSetDict, nullptr, nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+    static PyMemberDef members[] = {
+        {const_cast<char*>("__dictoffset__"), T_PYSSIZET,
+         offsetof(_TracedFunction, dict), READONLY, nullptr},
+        {const_cast<char*>("__weaklistoffset__"), T_PYSSIZET,
+         offsetof(_TracedFunction, weakrefs), READONLY, nullptr},
+        {nullptr, 0, 0, 0, nullptr}
+    };
+    static PyType_Slot slots[] = {
+        {Py_tp_doc, const_cast<char*>(
+            "A callable that records a scope on the global collector around "
+            "each call to a function.")},
+        {Py_tp_new, reinterpret_cast<void*>(&_NewTracedFunction)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(&_DeallocTracedFunction)},
+        {Py_tp_traverse, reinterpret_cast<void*>(&_TraverseTracedFunction)},
+        {Py_tp_clear, reinterpret_cast<void*>(&_ClearTracedFunction)},
+        {Py_tp_call, reinterpret_cast<void*>(&_CallTracedFunction)},
+        {Py_tp_descr_get, reinterpret_cast<void*>(&_GetTracedFunction)},
+        {Py_tp_getset, getSets},
+        {Py_tp_members, members},
+        {0, nullptr}
+    };
+    static PyType_Spec spec = {
+        "pxr.Trace.TracedFunction",
+        sizeof(_TracedFunction),
+        0,
+        Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+        slots
+    };
+
+    PyObject* type = PyType_FromSpec(&spec);
+    if (!type) {
+        throw_error_already_set();
+    }
+    return object(handle<>(type));
+}
+
+void wrapScope()
+{
+    class_<_Scope, noncopyable>("TraceScope",
+        "A context manager that records a scope on the global collector "
+        "from its enter to its exit.",
+        init<std::string>(arg("label")))
+        .def("__enter__", &::_EnterScope)
+        .def("__exit__", &::_ExitScope)
+        ;
+
+    scope().attr("TracedFunction") = _CreateTracedFunctionType();
+}
@@ -0,0 +1,195 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/aggregateNode.h>
+#include <pxr/trace/aggregateNodeArena.h>
+#include <pxr/trace/aggregateTree.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Index = TraceAggregateNodeArena::Index;
+static const Index InvalidIndex = TraceAggregateNodeArena::InvalidIndex;
+
+static std::vector<std::string>
+GetKeysInSubtree(const TraceAggregateNodeArena& arena, Index node)
+{
+    std::vector<std::string> keys;
+    arena.ForEachInSubtree(node, [&](Index i) {
+        keys.push_back(arena.GetKey(i).GetString());
+    });
+    return keys;
+}
+
+static void
+TestArena()
+{
+    std::cout << "Testing arena\n";
+
+    TraceAggregateNodeArenaRefPtr arena = TraceAggregateNodeArena::New();
+    const Index root = arena->AddNode(
+        arena->AddKey(TfToken("root")), 0, 0, 1, false);
+    const Index a = arena->AppendChild(
+        root, arena->AddKey(TfToken("A")), 10, 1, 1, true);
+    const Index b = arena->AppendChild(
+        root, arena->AddKey(TfToken("B")), 20, 1, 1, true);
+    const Index c = arena->AppendChild(
+        a, arena->AddKey(TfToken("C")), 4, 1, 1, true);
+
+    // Calls with the same key are aggregated into one node.
+    TF_AXIOM(arena->AppendChild(
+        root, arena->AddKey(TfToken("A")), 5, 2, 2, true) == a);
+    TF_AXIOM(arena->GetSize() == 4);
+    TF_AXIOM(arena->GetInclusiveTime(a) == 15);
+    TF_AXIOM(arena->GetExclusiveTime(a) == 11);
+    TF_AXIOM(arena->GetCount(a) == 3);
+    TF_AXIOM(arena->GetExclusiveCount(a) == 3);
+    TF_AXIOM(arena->FindChild(root, TfToken("B")) == b);
+    TF_AXIOM(arena->FindChild(a, TfToken("C")) == c);
+    TF_AXIOM(arena->FindChild(b, TfToken("C")) == InvalidIndex);
+    TF_AXIOM(arena->FindChild(root, TfToken("D")) == InvalidIndex);
+    TF_AXIOM(arena->GetNumChildren(root) == 2);
+    TF_AXIOM(arena->GetChildOrdinal(b) == 1);
+    TF_AXIOM((GetKeysInSubtree(*arena, root) ==
+        std::vector<std::string>{"root", "A", "C", "B"}));
+
+    // Children are found among many siblings and parents.
+    for (int i = 0; i < 1000; ++i) {
+        const TfToken key("K" + std::to_string(i));
+        arena->AppendChild(b, arena->AddKey(key), 1, 1, 1, true);
+        arena->AppendChild(c, arena->AddKey(key), 1, 1, 1, true);
+    }
+    TF_AXIOM(arena->GetNumChildren(b) == 1000);
+    TF_AXIOM(arena->GetKey(arena->FindChild(c, TfToken("K123"))) == "K123");
+    TF_AXIOM(arena->GetParent(arena->FindChild(b, TfToken("K999"))) == b);
+
+    // Inclusive counter values accumulate the values of the descendants.
+    arena->AppendExclusiveCounterValue(c, 2, 3.0);
+    arena->AppendExclusiveCounterValue(a, 2, 1.0);
+    arena->AppendExclusiveCounterValue(b, 0, 5.0);
+    arena->CalculateInclusiveCounterValues(root);
+    TF_AXIOM(arena->GetInclusiveCounterValue(root, 2) == 4.0);
+    TF_AXIOM(arena->GetInclusiveCounterValue(a, 2) == 4.0);
+    TF_AXIOM(arena->GetExclusiveCounterValue(a, 2) == 1.0);
+    TF_AXIOM(arena->GetInclusiveCounterValue(root, 0) == 5.0);
+    TF_AXIOM(arena->GetInclusiveCounterValue(b, 2) == 0.0);
+    TF_AXIOM(arena->GetInclusiveCounterValue(root, 1) == 0.0);
+
+    // Subtrees are merged into the children with the same key, and copied
+    // otherwise.
+    TraceAggregateNodeArenaRefPtr other = TraceAggregateNodeArena::New();
+    const Index otherRoot = other->AddNode(
+        other->AddKey(TfToken("root")), 0, 0, 1, false);
+    const Index otherA = other->AppendChild(
+        otherRoot, other->AddKey(TfToken("A")), 6, 1, 1, true);
+    other->AppendChild(otherA, other->AddKey(TfToken("C")), 2, 1, 1, true);
+    other->AppendChild(otherA, other->AddKey(TfToken("E")), 3, 1, 1, true);
+    other->AppendExclusiveCounterValue(otherA, 2, 2.0);
+    TF_AXIOM(arena->AppendSubtree(root, *other, otherA) == a);
+    TF_AXIOM(arena->GetInclusiveTime(a) == 21);
+    TF_AXIOM(arena->GetCount(a) == 4);
+    TF_AXIOM(arena->GetInclusiveTime(c) == 6);
+    TF_AXIOM(arena->GetKey(arena->GetLastChild(a)) == "E");
+    TF_AXIOM(arena->GetExclusiveCounterValue(a, 2) == 3.0);
+
+    const Index d = arena->AppendSubtree(b, *other, otherA);
+    TF_AXIOM(arena->GetParent(d) == b);
+    TF_AXIOM((GetKeysInSubtree(*arena, d) ==
+        std::vector<std::string>{"A", "C", "E"}));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestNodeViews()
+{
+    std::cout << "Testing node views\n";
+
+    const TraceAggregateNode::Id id = TraceReporter::CreateValidEventId();
+    TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+    TraceAggregateNodePtr root = tree->GetRoot();
+    TraceAggregateNodePtr a = root->Append(id, TfToken("A"), 10);
+    TF_AXIOM(a);
+    TF_AXIOM(root->GetChildrenRef().size() == 1);
+    TF_AXIOM(root->GetChildrenRef()[0] == a);
+    TF_AXIOM(root->GetChild("A") == a);
+    TF_AXIOM(root->Append(id, TfToken("A"), 5) == a);
+    TF_AXIOM(a->GetInclusiveTime() == 15);
+    TF_AXIOM(a->GetCount() == 2);
+    TF_AXIOM(a->GetId().IsValid());
+    TF_AXIOM(!root->GetId().IsValid());
+
+    // Views see the changes made through the arena and other views.
+    TraceAggregateNodeArena& arena = tree->GetNodeArena();
+    arena.AppendChild(tree->GetRootIndex(), arena.AddKey(TfToken("B")),
+        20, 1, 1, true);
+    a->Append(id, TfToken("C"), 4);
+    TF_AXIOM(root->GetChildrenRef().size() == 2);
+    TF_AXIOM(root->GetChildrenRef()[0] == a);
+    TF_AXIOM(root->GetChildrenRef()[1]->GetKey() == "B");
+    TF_AXIOM(root->GetChildrenRef()[0]->GetChildrenRef().size() == 1);
+    TF_AXIOM(a->GetExclusiveTime() == 11);
+
+    a->SetExpanded(true);
+    TF_AXIOM(root->GetChild("A")->IsExpanded());
+
+    // Nodes of other trees are merged or copied.
+    TraceAggregateNodeRefPtr other = TraceAggregateNode::New(
+        id, TfToken("A"), 6);
+    other->Append(id, TfToken("D"), 2);
+    root->Append(other);
+    TF_AXIOM(root->GetChildrenRef().size() == 2);
+    TF_AXIOM(a->GetInclusiveTime() == 21);
+    TF_AXIOM(a->GetChildrenRef().size() == 2);
+    TF_AXIOM(a->GetChild("D")->GetArena() == root->GetArena());
+
+    TraceAggregateNodeRefPtr e = TraceAggregateNode::New(
+        id, TfToken("E"), 1);
+    root->Append(e);
+    TF_AXIOM(root->GetChildrenRef().size() == 3);
+    TF_AXIOM(root->GetChild("E") != e);
+    TF_AXIOM(root->GetChild("E")->GetInclusiveTime() == 1);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestRecursion()
+{
+    std::cout << "Testing recursion\n";
+
+    const TraceAggregateNode::Id id = TraceReporter::CreateValidEventId();
+    TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+    TraceAggregateNodePtr f = tree->GetRoot()->Append(id, TfToken("F"), 10);
+    TraceAggregateNodePtr g = f->Append(id, TfToken("G"), 8);
+    TraceAggregateNodePtr f2 = g->Append(id, TfToken("F"), 6);
+    f2->Append(id, TfToken("H"), 2);
+
+    tree->GetRoot()->MarkRecursiveChildren();
+    TF_AXIOM(f->IsRecursionHead());
+    TF_AXIOM(f2->IsRecursionMarker());
+    TF_AXIOM(f->GetCount(true) == 2);
+    TF_AXIOM(f->GetExclusiveTime(true) == 6);
+
+    // The calls made by the recursive call are merged into the head.
+    TF_AXIOM(f->GetChildrenRef().size() == 2);
+    TF_AXIOM(f->GetChild("H"));
+    TF_AXIOM(f->GetChild("H")->GetCount(true) == 1);
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestArena();
+    TestNodeViews();
+    TestRecursion();
+}
@@ -0,0 +1,232 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/aggregateTreeDiff.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/timing.h>
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Status = TraceAggregateTreeDiff::Status;
+
+static TraceEvent::TimeStamp
+Ms(double ms)
+{
+    return ArchSecondsToTicks(ms / 1e3);
+}
+
+// Creates a tree with a Main scope calling A and B, and C if \p withC is
+// true. Times are in milliseconds.
+static TraceAggregateTreeRefPtr
+CreateTree(double a, double b, bool withC = false)
+{
+    const TraceAggregateNode::Id id = TraceReporter::CreateValidEventId();
+    TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+    TraceAggregateNodeRefPtr main = tree->GetRoot()->Append(
+        id, TfToken("Main"), Ms(a + b + (withC ? 1.0 : 0.0) + 1.0));
+    main->Append(id, TfToken("A"), Ms(a));
+    main->Append(id, TfToken("B"), Ms(b), 2, 2);
+    if (withC) {
+        main->Append(id, TfToken("C"), Ms(1.0));
+    }
+    return tree;
+}
+
+static const TraceAggregateTreeDiff::Entry&
+FindEntry(const TraceAggregateTreeDiffRefPtr& diff, const std::string& key)
+{
+    for (const TraceAggregateTreeDiff::Entry& entry : diff->GetEntries()) {
+        if (entry.GetKey() == key) {
+            return entry;
+        }
+    }
+    TF_FATAL_ERROR("Missing entry %s", key.c_str());
+    return diff->GetEntries().front();
+}
+
+static bool
+IsClose(double a, double b)
+{
+    return std::fabs(a - b) < 1e-6;
+}
+
+static void
+TestSingleRun()
+{
+    std::cout << "Testing single run diff\n";
+
+    TraceAggregateTreeDiffRefPtr diff = TraceAggregateTreeDiff::New(
+        CreateTree(10.0, 20.0), CreateTree(10.2, 30.0, true));
+
+    TF_AXIOM(diff->GetBaselineRunCount() == 1);
+    TF_AXIOM(diff->GetCandidateRunCount() == 1);
+    TF_AXIOM(diff->GetEntries().size() == 4);
+
+    // Entries are in depth first order and aligned by path.
+    const TraceAggregateTreeDiff::Entry& main = diff->GetEntries().front();
+    TF_AXIOM(main.GetKey() == "Main");
+    TF_AXIOM(main.GetDepth() == 1);
+    TF_AXIOM(diff->GetEntries()[1].path ==
+        std::vector<TfToken>({TfToken("Main"), TfToken("A")}));
+
+    const TraceAggregateTreeDiff::Entry& a = FindEntry(diff, "A");
+    TF_AXIOM(a.status == Status::Unchanged);
+    TF_AXIOM(!a.hasScore);
+
+    const TraceAggregateTreeDiff::Entry& b = FindEntry(diff, "B");
+    TF_AXIOM(b.status == Status::Regression);
+    TF_AXIOM(IsClose(b.GetInclusiveDelta(), 10.0));
+    TF_AXIOM(IsClose(b.GetRelativeDelta(), 0.5));
+    TF_AXIOM(IsClose(b.baseline.count, 2.0));
+    TF_AXIOM(IsClose(b.GetCountDelta(), 0.0));
+
+    TF_AXIOM(FindEntry(diff, "C").status == Status::Added);
+    TF_AXIOM(diff->HasRegressions());
+    TF_AXIOM(diff->GetEntries(Status::Regression).size() == 2);
+
+    // The reverse diff reports an improvement and a removal.
+    TraceAggregateTreeDiffRefPtr reverse = TraceAggregateTreeDiff::New(
+        CreateTree(10.2, 30.0, true), CreateTree(10.0, 20.0));
+    TF_AXIOM(!reverse->HasRegressions());
+    TF_AXIOM(FindEntry(reverse, "B").status == Status::Improvement);
+    TF_AXIOM(FindEntry(reverse, "C").status == Status::Removed);
+
+    // Changes below the minimum time are not flagged.
+    TraceAggregateTreeDiff::Options options;
+    options.minimumTime = 20.0;
+    TF_AXIOM(!TraceAggregateTreeDiff::New(
+        CreateTree(10.0, 20.0), CreateTree(10.2, 30.0), options)
+            ->HasRegressions());
+
+    // Added nodes above the minimum time count as regressions.
+    TraceAggregateTreeDiffRefPtr added = TraceAggregateTreeDiff::New(
+        CreateTree(10.0, 20.0), CreateTree(10.0, 20.0, true));
+    TF_AXIOM(added->GetEntries(Status::Regression).empty());
+    TF_AXIOM(added->HasRegressions());
+    options.minimumTime = 1.0;
+    TF_AXIOM(!TraceAggregateTreeDiff::New(
+        CreateTree(10.0, 20.0), CreateTree(10.0, 20.0, true), options)
+            ->HasRegressions());
+
+    std::ostringstream report;
+    diff->Report(report);
+    std::cout << report.str();
+    TF_AXIOM(report.str().find("regression") != std::string::npos);
+    TF_AXIOM(report.str().find("count delta") != std::string::npos);
+    TF_AXIOM(report.str().find("  | B") != std::string::npos);
+    // Unchanged leaves are omitted.
+    TF_AXIOM(report.str().find("  | A") == std::string::npos);
+    TF_AXIOM(report.str().find(
+        "2 regressions, 0 improvements, 1 added, 0 removed")
+        != std::string::npos);
+
+    std::ostringstream json;
+    diff->ReportJson(json);
+    std::cout << json.str() << "\n";
+    TF_AXIOM(json.str().find("\"hasRegressions\":true") != std::string::npos);
+    TF_AXIOM(json.str().find("\"path\":[\"Main\",\"B\"]")
+        != std::string::npos);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestMultipleRuns()
+{
+    std::cout << "Testing multiple run diff\n";
+
+    using ParsedTrees = std::vector<TraceReporter::ParsedTree>;
+
+    // The mean of B changes by 10% but the runs are noisy.
+    ParsedTrees noisyBaseline = {
+        {CreateTree(10.0, 10.0), 1},
+        {CreateTree(10.0, 14.0), 1},
+        {CreateTree(10.0, 6.0), 1}};
+    ParsedTrees noisyCandidate = {
+        {CreateTree(10.0, 15.0), 1},
+        {CreateTree(10.0, 7.0), 1},
+        {CreateTree(10.0, 11.0), 1}};
+    TraceAggregateTreeDiffRefPtr noisy = TraceAggregateTreeDiff::New(
+        noisyBaseline, noisyCandidate);
+    const TraceAggregateTreeDiff::Entry& noisyB = FindEntry(noisy, "B");
+    TF_AXIOM(noisyB.hasScore);
+    TF_AXIOM(IsClose(noisyB.GetRelativeDelta(), 0.1));
+    TF_AXIOM(IsClose(noisyB.baseline.inclusiveTimeStdDev, 4.0));
+    TF_AXIOM(std::fabs(noisyB.score) < 2.0);
+    TF_AXIOM(noisyB.status == Status::Unchanged);
+
+    // The same change with consistent runs is significant.
+    ParsedTrees stableBaseline = {
+        {CreateTree(10.0, 10.1), 1},
+        {CreateTree(10.0, 9.9), 1}};
+    ParsedTrees stableCandidate = {
+        {CreateTree(10.0, 11.1), 1},
+        {CreateTree(10.0, 10.9), 1}};
+    TraceAggregateTreeDiffRefPtr stable = TraceAggregateTreeDiff::New(
+        stableBaseline, stableCandidate);
+    const TraceAggregateTreeDiff::Entry& stableB = FindEntry(stable, "B");
+    TF_AXIOM(stableB.hasScore);
+    TF_AXIOM(stableB.score > 2.0);
+    TF_AXIOM(stableB.status == Status::Regression);
+
+    // A change between runs without spread is exact.
+    TraceAggregateTreeDiffRefPtr exact = TraceAggregateTreeDiff::New(
+        {{CreateTree(10.0, 10.0), 1}, {CreateTree(10.0, 10.0), 1}},
+        {{CreateTree(10.0, 11.0), 1}, {CreateTree(10.0, 11.0), 1}});
+    const TraceAggregateTreeDiff::Entry& exactB = FindEntry(exact, "B");
+    TF_AXIOM(std::isinf(exactB.score) && exactB.score > 0.0);
+    TF_AXIOM(exactB.status == Status::Regression);
+    TF_AXIOM(FindEntry(exact, "A").score == 0.0);
+    std::ostringstream json;
+    exact->ReportJson(json);
+    TF_AXIOM(json.str().find("\"exact\":true") != std::string::npos);
+    TF_AXIOM(json.str().find("\"score\":0.0,\"exact\":false")
+        != std::string::npos);
+
+    // Times are divided by the iteration count of each tree.
+    ParsedTrees iterated = {{CreateTree(20.0, 40.0), 2}};
+    TraceAggregateTreeDiffRefPtr same = TraceAggregateTreeDiff::New(
+        {{CreateTree(10.0, 20.0), 1}}, iterated);
+    TF_AXIOM(!same->HasRegressions());
+    TF_AXIOM(IsClose(FindEntry(same, "B").candidate.inclusiveTime, 20.0));
+    TF_AXIOM(IsClose(FindEntry(same, "B").candidate.count, 1.0));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestDeepTree()
+{
+    std::cout << "Testing deep tree diff\n";
+
+    const int depth = 2000;
+    const TraceAggregateNode::Id id = TraceReporter::CreateValidEventId();
+    TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+    TraceAggregateNodeRefPtr node = tree->GetRoot();
+    for (int i = 0; i < depth; ++i) {
+        node = node->Append(id, TfToken("Node"), Ms(1.0));
+    }
+
+    TraceAggregateTreeDiffRefPtr diff = TraceAggregateTreeDiff::New(
+        tree, tree);
+    TF_AXIOM(diff->GetEntries().size() == size_t(depth));
+    TF_AXIOM(diff->GetEntries().back().GetDepth() == size_t(depth));
+    TF_AXIOM(!diff->HasRegressions());
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestSingleRun();
+    TestMultipleRuns();
+    TestDeepTree();
+}
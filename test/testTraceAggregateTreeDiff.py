@@ -0,0 +1,103 @@
+# Copyright 2026 Jeremy Retailleau
+#
+# Licensed under the terms set forth in the LICENSE.txt file available at
+# https://openusd.org/license.
+
+import unittest
+
+from pxr import Trace
+
+Status = Trace.AggregateTreeDiff.Status
+
+def CreateTree(a, b, withC=False):
+    """
+    Returns a tree with a Main scope calling A and B twice, and C if withC is
+    True. Times are in milliseconds.
+    """
+    main = Trace.AggregateNode(
+        'Main', a + b + (1.0 if withC else 0.0) + 1.0)
+    main.Append(Trace.AggregateNode('A', a))
+    main.Append(Trace.AggregateNode('B', b, 2, 2))
+    if withC:
+        main.Append(Trace.AggregateNode('C', 1.0))
+
+    tree = Trace.AggregateTree()
+    tree.root.Append(main)
+    return tree
+
+def GetEntries(diff):
+    return {entry.key: entry for entry in diff.entries}
+
+class TestTraceAggregateTreeDiff(unittest.TestCase):
+    def test_Regression(self):
+        diff = Trace.AggregateTreeDiff(
+            CreateTree(10.0, 20.0), CreateTree(10.2, 30.0, withC=True))
+        self.assertEqual(diff.baselineRunCount, 1)
+        self.assertEqual(diff.candidateRunCount, 1)
+        self.assertEqual(
+            [entry.path for entry in diff.entries],
+            [['Main'], ['Main', 'A'], ['Main', 'B'], ['Main', 'C']])
+
+        entries = GetEntries(diff)
+        self.assertAlmostEqual(entries['Main'].inclusiveDelta, 11.2, places=3)
+        self.assertAlmostEqual(entries['Main'].exclusiveDelta, 0.0, places=3)
+        self.assertEqual(entries['Main'].status, Status.Regression)
+
+        self.assertAlmostEqual(entries['A'].inclusiveDelta, 0.2, places=3)
+        self.assertEqual(entries['A'].status, Status.Unchanged)
+
+        b = entries['B']
+        self.assertAlmostEqual(b.baseline.inclusiveTime, 20.0, places=3)
+        self.assertAlmostEqual(b.candidate.inclusiveTime, 30.0, places=3)
+        self.assertAlmostEqual(b.inclusiveDelta, 10.0, places=3)
+        self.assertAlmostEqual(b.exclusiveDelta, 10.0, places=3)
+        self.assertAlmostEqual(b.relativeDelta, 0.5, places=3)
+        self.assertEqual(b.baseline.count, 2)
+        self.assertEqual(b.countDelta, 0)
+        self.assertEqual(b.status, Status.Regression)
+
+        c = entries['C']
+        self.assertAlmostEqual(c.inclusiveDelta, 1.0, places=3)
+        self.assertEqual(c.countDelta, 1)
+        self.assertEqual(c.relativeDelta, 0.0)
+        self.assertEqual(c.status, Status.Added)
+
+        self.assertTrue(diff.HasRegressions())
+        self.assertEqual(
+            sorted(entry.key for entry in diff.regressions), ['B', 'Main'])
+
+    def test_Improvement(self):
+        # The reverse diff has the opposite deltas.
+        diff = Trace.AggregateTreeDiff(
+            CreateTree(10.2, 30.0, withC=True), CreateTree(10.0, 20.0))
+        entries = GetEntries(diff)
+
+        self.assertAlmostEqual(
+            entries['Main'].inclusiveDelta, -11.2, places=3)
+        self.assertEqual(entries['Main'].status, Status.Improvement)
+
+        b = entries['B']
+        self.assertAlmostEqual(b.inclusiveDelta, -10.0, places=3)
+        self.assertAlmostEqual(b.exclusiveDelta, -10.0, places=3)
+        self.assertAlmostEqual(b.relativeDelta, -1.0 / 3.0, places=3)
+        self.assertEqual(b.status, Status.Improvement)
+
+        c = entries['C']
+        self.assertAlmostEqual(c.inclusiveDelta, -1.0, places=3)
+        self.assertEqual(c.countDelta, -1)
+        self.assertEqual(c.status, Status.Removed)
+
+        self.assertFalse(diff.HasRegressions())
+        self.assertEqual(diff.regressions, [])
+
+    def test_MinimumTime(self):
+        # Changes below the minimum time are not flagged.
+        diff = Trace.AggregateTreeDiff(
+            CreateTree(10.0, 20.0), CreateTree(10.2, 30.0),
+            minimumTime=20.0)
+        self.assertAlmostEqual(
+            GetEntries(diff)['B'].inclusiveDelta, 10.0, places=3)
+        self.assertFalse(diff.HasRegressions())
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,242 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/clock.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/reporterDataSourceCollector.h>
+#include <pxr/trace/serialization.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using TimeStamp = TraceClock::TimeStamp;
+
+// Collects the Timespan events of a collection.
+class TimespanCollector {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        for (const TraceEvent& e : events) {
+            if (e.GetType() == TraceEvent::EventType::Timespan) {
+                spans.emplace_back(e.GetStartTimeStamp(), e.GetEndTimeStamp());
+            }
+        }
+    }
+
+    std::vector<std::pair<TimeStamp, TimeStamp>> spans;
+};
+
+static int64_t
+GetRealtime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void
+VirtualScope()
+{
+    TRACE_FUNCTION();
+    TraceClock::AdvanceVirtualTime(500);
+}
+
+static void
+TestVirtualClock()
+{
+    std::cout << "Testing virtual clock\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    TF_AXIOM(TraceClock::GetSource() == TraceClock::Source::Tick);
+    TF_AXIOM(TraceClock::SetSource(TraceClock::Source::Virtual));
+    TF_AXIOM(TraceClock::GetSource() == TraceClock::Source::Virtual);
+    TraceClock::SetVirtualTime(1000);
+    TF_AXIOM(TraceClock::Now() == 1000);
+
+    collector.SetEnabled(true);
+    VirtualScope();
+    VirtualScope();
+    collector.SetEnabled(false);
+
+    std::vector<TraceReporterDataSourceBase::CollectionPtr> collections =
+        source->ConsumeData();
+    TF_AXIOM(collections.size() == 1);
+    TimespanCollector timespans;
+    collections[0]->IterateBatches(timespans);
+    TF_AXIOM(timespans.spans.size() == 2);
+    TF_AXIOM(timespans.spans[0] == std::make_pair(TimeStamp(1000),
+        TimeStamp(1500)));
+    TF_AXIOM(timespans.spans[1] == std::make_pair(TimeStamp(1500),
+        TimeStamp(2000)));
+
+    const TraceClockCalibration& calibration =
+        collections[0]->GetClockCalibration();
+    TF_AXIOM(calibration.IsValid());
+    TF_AXIOM(calibration.source == "Virtual");
+    TF_AXIOM(calibration.uncertainty == 0);
+
+    // Virtual clocks are never the same clock.
+    TF_AXIOM(!calibration.IsSameClock(calibration));
+
+    TF_AXIOM(TraceClock::SetSource(TraceClock::Source::Tick));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestSources()
+{
+    std::cout << "Testing clock sources\n";
+
+    for (TraceClock::Source source : {
+            TraceClock::Source::Tick,
+            TraceClock::Source::Monotonic,
+            TraceClock::Source::MonotonicRaw}) {
+        if (!TraceClock::IsSourceAvailable(source)) {
+            std::cout << "  " << TraceClock::GetSourceName(source)
+                      << ": not available\n";
+            continue;
+        }
+        TF_AXIOM(TraceClock::SetSource(source));
+
+        // Timestamps are ticks and do not go backwards.
+        TimeStamp last = TraceClock::Now();
+        for (int i = 0; i < 1000; ++i) {
+            const TimeStamp now = TraceClock::Now();
+            TF_AXIOM(now >= last);
+            last = now;
+        }
+        const TimeStamp start = TraceClock::Now();
+        const auto wallStart = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - wallStart <
+                std::chrono::milliseconds(20)) {
+        }
+        const double elapsed = ArchTicksToSeconds(TraceClock::Now() - start);
+        TF_AXIOM(elapsed > 0.015 && elapsed < 0.5);
+
+        // The calibration relates timestamps to the wall clock.
+        const TraceClockCalibration calibration = TraceClock::Calibrate();
+        TF_AXIOM(calibration.IsValid());
+        TF_AXIOM(calibration.source == TraceClock::GetSourceName(source));
+        TF_AXIOM(calibration.host == TraceClock::GetHostName());
+        TF_AXIOM(TraceClock::GetCalibration() == calibration);
+        const int64_t realtime =
+            calibration.GetRealtime(TraceClock::Now());
+        TF_AXIOM(std::llabs(realtime - GetRealtime()) < 5000000);
+        TF_AXIOM(calibration.GetTimeStamp(
+            calibration.GetRealtime(calibration.anchor)) ==
+            calibration.anchor);
+
+        std::cout << "  " << calibration.source << ": uncertainty "
+                  << calibration.uncertainty << " ns\n";
+    }
+
+    TF_AXIOM(TraceClock::SetSource(TraceClock::Source::Tick));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestConvert()
+{
+    std::cout << "Testing timestamp conversion\n";
+
+    TraceClockCalibration a;
+    a.source = "Tick";
+    a.host = "a";
+    a.ticksPerSecond = 1.0e9;
+    a.anchor = 1000000;
+    a.realtime = 5000000000;
+
+    // The same instant on a clock running twice as fast, anchored later.
+    TraceClockCalibration b = a;
+    b.host = "b";
+    b.ticksPerSecond = 2.0e9;
+    b.anchor = 7000000;
+    b.realtime = 5001000000;
+
+    TF_AXIOM(!a.IsSameClock(b));
+    TF_AXIOM(a.Convert(a.anchor, b) == 5000000);
+    TF_AXIOM(a.Convert(a.anchor + 1000, b) == 5002000);
+    TF_AXIOM(b.Convert(a.Convert(123456789, b), a) == 123456789);
+
+    // Clocks of the same source on the same host are shared.
+    b.host = a.host;
+    b.source = a.source;
+    TF_AXIOM(a.IsSameClock(b));
+    TF_AXIOM(a.Convert(123456789, b) == 123456789);
+
+    // Unknown calibrations leave timestamps unchanged.
+    TF_AXIOM(a.Convert(42, TraceClockCalibration()) == 42);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestSerialization()
+{
+    std::cout << "Testing calibration serialization\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    collector.SetEnabled(true);
+    VirtualScope();
+    collector.SetEnabled(false);
+
+    std::vector<TraceReporterDataSourceBase::CollectionPtr> collections =
+        source->ConsumeData();
+    TF_AXIOM(collections.size() == 1);
+    const TraceClockCalibration& written =
+        collections[0]->GetClockCalibration();
+    TF_AXIOM(written.IsValid());
+
+    std::stringstream stream;
+    TF_AXIOM(TraceSerialization::Write(stream, collections[0]));
+    std::unique_ptr<TraceCollection> collection =
+        TraceSerialization::Read(stream);
+    TF_AXIOM(collection);
+
+    const TraceClockCalibration& read = collection->GetClockCalibration();
+    TF_AXIOM(read.IsValid());
+    TF_AXIOM(read.source == written.source);
+    TF_AXIOM(read.host == written.host);
+    TF_AXIOM(read.realtime == written.realtime);
+    TF_AXIOM(read.monotonic == written.monotonic);
+    TF_AXIOM(read.uncertainty == written.uncertainty);
+    // The anchor is stored in microseconds.
+    TF_AXIOM(std::llabs(ArchTicksToNanoseconds(read.anchor) -
+        ArchTicksToNanoseconds(written.anchor)) <= 1);
+    TF_AXIOM(read.IsSameClock(written));
+
+    // Slices keep the calibration.
+    TF_AXIOM(collections[0]->Slice(0, ~TimeStamp(0)).GetClockCalibration()
+        == written);
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestVirtualClock();
+    TestSources();
+    TestConvert();
+    TestSerialization();
+}
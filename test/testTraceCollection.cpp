@@ -0,0 +1,365 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collection.h>
+#include <pxr/trace/eventList.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <iostream>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+static std::unique_ptr<TraceEventList>
+CreateTestEvents(const std::vector<std::string>& keys)
+{
+    std::unique_ptr<TraceEventList> events(new TraceEventList);
+    TraceEvent::TimeStamp ts = 0;
+    for (const std::string& key : keys) {
+        events->EmplaceBack(
+            TraceEvent::Begin, events->CacheKey(key), ++ts,
+            TraceCategory::Default);
+        events->EmplaceBack(
+            TraceEvent::End, events->CacheKey(key), ++ts,
+            TraceCategory::Default);
+    }
+    return events;
+}
+
+// Records the key ids and tokens handed to the visitor.
+class KeyRecorder : public TraceCollection::Visitor {
+public:
+    void OnBeginCollection() override {}
+    void OnEndCollection() override {}
+    void OnBeginThread(const TraceThreadId&) override {}
+    void OnEndThread(const TraceThreadId&) override {}
+    bool AcceptsCategory(TraceCategoryId) override { return true; }
+
+    void OnEvent(
+        const TraceThreadId&, const TfToken&, const TraceEvent&) override {
+        // Should not be called since OnKeyedEvent is overridden.
+        TF_AXIOM(false);
+    }
+
+    void OnKeyedEvent(
+        const TraceThreadId&,
+        TraceCollection::KeyId keyId,
+        const TfToken& key,
+        const TraceEvent&) override {
+        ids.push_back(keyId);
+        tokens.push_back(key);
+    }
+
+    std::vector<TraceCollection::KeyId> ids;
+    std::vector<TfToken> tokens;
+};
+
+static void
+TestKeyTable()
+{
+    std::cout << "Testing key table\n";
+
+    TraceCollection collection;
+    collection.AddToCollection(
+        TraceThreadId("Thread 1"), CreateTestEvents({"A", "B", "A"}));
+    collection.AddToCollection(
+        TraceThreadId("Thread 2"), CreateTestEvents({"B", "C"}));
+
+    const TraceCollection::KeyTable& table = collection.GetKeyTable();
+    TF_AXIOM(table.GetSize() == 3);
+
+    KeyRecorder first;
+    collection.Iterate(first);
+    TF_AXIOM(first.ids.size() == 10);
+
+    // Every id resolves to the token the visitor received and ids are
+    // consistent across threads.
+    for (size_t i = 0; i < first.ids.size(); ++i) {
+        TF_AXIOM(first.ids[i] != TraceCollection::KeyTable::InvalidKeyId);
+        TF_AXIOM(table.GetToken(first.ids[i]) == first.tokens[i]);
+    }
+    TF_AXIOM(first.ids[0] == first.ids[4]);
+    TF_AXIOM(first.ids[2] == first.ids[6]);
+    TF_AXIOM(first.ids[0] != first.ids[2]);
+
+    // Ids are stable across iterations and directions.
+    KeyRecorder reverse;
+    collection.ReverseIterate(reverse);
+    TF_AXIOM(reverse.ids.size() == first.ids.size());
+    TF_AXIOM(reverse.ids.back() == first.ids[3]);
+
+    // Adding events keeps existing ids and extends the table.
+    collection.AddToCollection(
+        TraceThreadId("Thread 1"), CreateTestEvents({"D", "A"}));
+    TF_AXIOM(&collection.GetKeyTable() == &table);
+    TF_AXIOM(table.GetSize() == 4);
+
+    KeyRecorder extended;
+    collection.Iterate(extended);
+    TF_AXIOM(extended.ids.size() == 14);
+    TF_AXIOM(extended.ids[0] == first.ids[0]);
+    TF_AXIOM(table.GetToken(extended.ids[6]) == TfToken("D"));
+    TF_AXIOM(extended.ids[8] == first.ids[0]);
+
+    std::cout << " PASSED\n";
+}
+
+// Records events in the order they are visited, one at a time.
+class EventRecorder : public TraceCollection::Visitor {
+public:
+    void OnBeginCollection() override {}
+    void OnEndCollection() override {}
+    void OnBeginThread(const TraceThreadId&) override {}
+    void OnEndThread(const TraceThreadId&) override {}
+    bool AcceptsCategory(TraceCategoryId id) override {
+        return filter.empty() || id == filter.front();
+    }
+    void OnEvent(
+        const TraceThreadId&, const TfToken&, const TraceEvent& e) override {
+        events.push_back(&e);
+    }
+
+    TraceCollection::CategoryFilter filter;
+    std::vector<const TraceEvent*> events;
+};
+
+// Records events in the order they are visited, a span at a time. This 
+// class does not derive from BatchVisitor so calls are statically 
+// dispatched.
+class SpanRecorder {
+public:
+    explicit SpanRecorder(bool reverse) : _reverse(reverse) {}
+
+    void OnBeginCollection() { ++collections; }
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) { ++threads; }
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& span) {
+        TF_AXIOM(!span.empty());
+        ++spans;
+        if (_reverse) {
+            for (auto it = span.rbegin(); it != span.rend(); ++it) {
+                events.push_back(&*it);
+            }
+        } else {
+            for (const TraceEvent& e : span) {
+                events.push_back(&e);
+            }
+        }
+    }
+
+    int collections = 0;
+    int threads = 0;
+    int spans = 0;
+    std::vector<const TraceEvent*> events;
+
+private:
+    bool _reverse;
+};
+
+// Counts events through the virtual interface.
+class CountingBatchVisitor : public TraceCollection::BatchVisitor {
+public:
+    void OnBeginCollection() override {}
+    void OnEndCollection() override {}
+    void OnBeginThread(const TraceThreadId&) override {}
+    void OnEndThread(const TraceThreadId&) override {}
+    void OnEvents(
+        const TraceThreadId&,
+        const TraceCollection::EventSpan& span) override {
+        count += span.size();
+    }
+
+    size_t count = 0;
+};
+
+static void
+TestBatches()
+{
+    std::cout << "Testing batched iteration\n";
+
+    constexpr TraceCategoryId otherCategory = 
+        TraceCategory::CreateTraceCategoryId("OtherCategory");
+
+    // Enough events to span many blocks, with alternating runs of 
+    // categories.
+    TraceCollection collection;
+    for (const char* thread : {"Thread 1", "Thread 2"}) {
+        std::unique_ptr<TraceEventList> events(new TraceEventList);
+        for (int i = 0; i < 1000; ++i) {
+            events->EmplaceBack(
+                TraceEvent::Marker, events->CacheKey("M"), i,
+                (i / 7) % 2 ? otherCategory : TraceCategory::Default);
+        }
+        collection.AddToCollection(TraceThreadId(thread), std::move(events));
+    }
+
+    EventRecorder forward;
+    collection.Iterate(forward);
+    EventRecorder reverse;
+    collection.ReverseIterate(reverse);
+
+    SpanRecorder forwardSpans(false);
+    collection.IterateBatches(forwardSpans);
+    TF_AXIOM(forwardSpans.collections == 1);
+    TF_AXIOM(forwardSpans.threads == 2);
+    TF_AXIOM(forwardSpans.spans > 2);
+    TF_AXIOM(forwardSpans.events == forward.events);
+
+    SpanRecorder reverseSpans(true);
+    collection.ReverseIterateBatches(reverseSpans);
+    TF_AXIOM(reverseSpans.events.size() == reverse.events.size());
+
+    // Threads are visited in the same order in both directions, events
+    // within each thread are reversed.
+    TF_AXIOM(reverseSpans.events == reverse.events);
+
+    // The category filter matches AcceptsCategory.
+    for (bool doReverse : {false, true}) {
+        EventRecorder filtered;
+        filtered.filter = {otherCategory};
+        SpanRecorder filteredSpans(doReverse);
+        if (doReverse) {
+            collection.ReverseIterate(filtered);
+            collection.ReverseIterateBatches(filteredSpans, filtered.filter);
+        } else {
+            collection.Iterate(filtered);
+            collection.IterateBatches(filteredSpans, filtered.filter);
+        }
+        TF_AXIOM(!filtered.events.empty());
+        TF_AXIOM(filteredSpans.events == filtered.events);
+    }
+
+    CountingBatchVisitor counter;
+    TraceCollection::BatchVisitor& virtualVisitor = counter;
+    collection.IterateBatches(virtualVisitor);
+    TF_AXIOM(counter.count == 2000);
+
+    std::cout << " PASSED\n";
+}
+
+// Appends the nodes named \p key below \p node to \p nodes, in order.
+static void
+FindNodes(
+    const TraceEventNodeRefPtr& node,
+    const std::string& key,
+    std::vector<TraceEventNodeRefPtr>* nodes)
+{
+    for (const TraceEventNodeRefPtr& child : node->GetChildrenRef()) {
+        if (child->GetKey() == key) {
+            nodes->push_back(child);
+        }
+        FindNodes(child, key, nodes);
+    }
+}
+
+static void
+TestSlice()
+{
+    std::cout << "Testing slices\n";
+
+    // An outer scope containing enough short scopes to span many chunks of
+    // the time index, and a timespan covering all of them.
+    TraceCollection collection;
+    {
+        std::unique_ptr<TraceEventList> events(new TraceEventList);
+        const TraceKey outer = events->CacheKey("Outer");
+        const TraceKey inner = events->CacheKey("Inner");
+        events->EmplaceBack(
+            TraceEvent::Begin, outer, 0, TraceCategory::Default);
+        for (int i = 0; i < 2000; ++i) {
+            events->EmplaceBack(
+                TraceEvent::Begin, inner, 10*i, TraceCategory::Default);
+            events->EmplaceBack(
+                TraceEvent::End, inner, 10*i + 5, TraceCategory::Default);
+        }
+        events->EmplaceBack(TraceEvent::Timespan, events->CacheKey("Span"),
+            2, 29999, TraceCategory::Default);
+        events->EmplaceBack(
+            TraceEvent::End, outer, 30000, TraceCategory::Default);
+        collection.AddToCollection(TraceThreadId("Thread 1"), 
+            std::move(events));
+    }
+
+    TraceCollection slice = collection.Slice(10003, 10052);
+
+    // Only events near the range are visited.
+    CountingBatchVisitor counter;
+    slice.IterateBatches(counter);
+    TF_AXIOM(counter.count < 600);
+
+    TraceEventTreeRefPtr tree = TraceEventTree::New(slice);
+    std::vector<TraceEventNodeRefPtr> outer, inner, span;
+    FindNodes(tree->GetRoot(), "Outer", &outer);
+    FindNodes(tree->GetRoot(), "Inner", &inner);
+    FindNodes(tree->GetRoot(), "Span", &span);
+
+    TF_AXIOM(outer.size() == 1);
+    TF_AXIOM(outer[0]->GetBeginTime() == 10003);
+    TF_AXIOM(outer[0]->GetEndTime() == 10052);
+
+    TF_AXIOM(span.size() == 1);
+    TF_AXIOM(span[0]->GetBeginTime() == 10003);
+    TF_AXIOM(span[0]->GetEndTime() == 10052);
+
+    // Scopes overlapping the boundaries are clipped.
+    TF_AXIOM(inner.size() == 6);
+    TF_AXIOM(inner.front()->GetBeginTime() == 10003);
+    TF_AXIOM(inner.front()->GetEndTime() == 10005);
+    TF_AXIOM(inner[1]->GetBeginTime() == 10010);
+    TF_AXIOM(inner[1]->GetEndTime() == 10015);
+    TF_AXIOM(inner.back()->GetBeginTime() == 10050);
+    TF_AXIOM(inner.back()->GetEndTime() == 10052);
+
+    // Slicing a slice.
+    TraceCollection subSlice = slice.Slice(10011, 10012);
+    std::vector<TraceEventNodeRefPtr> subInner;
+    FindNodes(TraceEventTree::New(subSlice)->GetRoot(), "Inner", &subInner);
+    TF_AXIOM(subInner.size() == 1);
+    TF_AXIOM(subInner[0]->GetBeginTime() == 10011);
+    TF_AXIOM(subInner[0]->GetEndTime() == 10012);
+
+    // A range covering the whole collection yields the same events.
+    TraceCollection whole = collection.Slice(0, 30000);
+    EventRecorder original;
+    collection.Iterate(original);
+    EventRecorder sliced;
+    whole.Iterate(sliced);
+    TF_AXIOM(original.events == sliced.events);
+
+    // Ranges ending at or after the last timestamp include the last chunk.
+    const TraceEvent::TimeStamp ends[] = {30000, ~TraceEvent::TimeStamp(0)};
+    for (const TraceEvent::TimeStamp end : ends) {
+        TraceCollection tail = collection.Slice(19990, end);
+        std::vector<TraceEventNodeRefPtr> tailOuter, tailInner;
+        TraceEventTreeRefPtr tailTree = TraceEventTree::New(tail);
+        FindNodes(tailTree->GetRoot(), "Outer", &tailOuter);
+        FindNodes(tailTree->GetRoot(), "Inner", &tailInner);
+        TF_AXIOM(tailOuter.size() == 1);
+        TF_AXIOM(tailOuter[0]->GetEndTime() == 30000);
+        TF_AXIOM(tailInner.size() == 1);
+        TF_AXIOM(tailInner[0]->GetBeginTime() == 19990);
+        TF_AXIOM(tailInner[0]->GetEndTime() == 19995);
+    }
+
+    // Ranges without events.
+    TF_AXIOM(collection.Slice(40000, 50000).GetKeyTable().GetSize() == 0);
+    std::vector<TraceEventNodeRefPtr> gap;
+    FindNodes(TraceEventTree::New(collection.Slice(10006, 10008))->GetRoot(),
+        "Inner", &gap);
+    TF_AXIOM(gap.empty());
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestKeyTable();
+    TestBatches();
+    TestSlice();
+}
@@ -0,0 +1,192 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collectionGenerator.h>
+#include <pxr/trace/collection.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/errorMark.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Shape = TraceCollectionGenerator::Shape;
+
+// A generated event, with the values which depend on the shape and seed.
+struct Event {
+    TraceEvent::EventType type;
+    std::string key;
+    TraceEvent::TimeStamp time;
+
+    bool operator==(const Event& other) const {
+        return type == other.type && key == other.key && time == other.time;
+    }
+};
+
+// Records the events of each thread and checks that scopes are nested.
+class EventRecorder : public TraceCollection::Visitor {
+public:
+    void OnBeginCollection() override {}
+    void OnEndCollection() override {}
+    void OnBeginThread(const TraceThreadId&) override {
+        TF_AXIOM(_stack.empty());
+    }
+    void OnEndThread(const TraceThreadId&) override {
+        TF_AXIOM(_stack.empty());
+    }
+    bool AcceptsCategory(TraceCategoryId) override { return true; }
+    void OnEvent(const TraceThreadId& threadId, const TfToken& key,
+        const TraceEvent& e) override {
+        std::vector<Event>& thread = events[threadId.ToString()];
+        TF_AXIOM(thread.empty() || thread.back().time < e.GetTimeStamp());
+        thread.push_back({e.GetType(), key.GetString(), e.GetTimeStamp()});
+
+        switch (e.GetType()) {
+            case TraceEvent::EventType::Begin:
+                _stack.push_back(key.GetString());
+                maxDepth = std::max(maxDepth, _stack.size());
+                break;
+            case TraceEvent::EventType::End:
+                TF_AXIOM(!_stack.empty() && _stack.back() == key.GetString());
+                _stack.pop_back();
+                break;
+            case TraceEvent::EventType::CounterDelta:
+                TF_AXIOM(!_stack.empty());
+                TF_AXIOM(e.GetCounterValue() == 1.0);
+                ++counters;
+                break;
+            default:
+                TF_AXIOM(false);
+        }
+    }
+
+    size_t GetEventCount() const {
+        size_t count = 0;
+        for (const auto& thread : events) {
+            count += thread.second.size();
+        }
+        return count;
+    }
+
+    std::map<std::string, std::vector<Event>> events;
+    size_t maxDepth = 0;
+    size_t counters = 0;
+
+private:
+    std::vector<std::string> _stack;
+};
+
+static EventRecorder
+Record(const Shape& shape)
+{
+    std::unique_ptr<TraceCollection> collection =
+        TraceCollectionGenerator::Generate(shape);
+    TF_AXIOM(collection);
+
+    EventRecorder recorder;
+    collection->Iterate(recorder);
+    return recorder;
+}
+
+static void
+TestShape()
+{
+    std::cout << "Testing shape\n";
+
+    Shape shape;
+    shape.numThreads = 3;
+    shape.iterations = 5;
+    shape.depth = 4;
+    shape.fanOut = 3;
+    shape.countersPerScope = 2.0;
+
+    // Every scope holds exactly 2 counter deltas.
+    const EventRecorder recorder = Record(shape);
+    TF_AXIOM(recorder.events.size() == 3);
+    TF_AXIOM(recorder.maxDepth == 4);
+    TF_AXIOM(recorder.GetEventCount() ==
+        size_t(TraceCollectionGenerator::GetExpectedEventCount(shape)));
+    TF_AXIOM(recorder.counters == 3 * 5 * (1 + 3 + 9 + 27) * 2);
+
+    // Without counters, each scope has a begin and an end event.
+    shape.countersPerScope = 0.0;
+    shape.fanOut = 0;
+    const EventRecorder flat = Record(shape);
+    TF_AXIOM(flat.maxDepth == 1);
+    TF_AXIOM(flat.counters == 0);
+    TF_AXIOM(flat.GetEventCount() == 3 * 5 * 2);
+    TF_AXIOM(TraceCollectionGenerator::GetExpectedEventCount(shape) ==
+        3 * 5 * 2);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestSeed()
+{
+    std::cout << "Testing seed\n";
+
+    Shape shape;
+    shape.countersPerScope = 0.5;
+
+    // The same seed generates the same events.
+    const EventRecorder first = Record(shape);
+    TF_AXIOM(first.events == Record(shape).events);
+
+    shape.seed = 1;
+    TF_AXIOM(first.events != Record(shape).events);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestDeepTree()
+{
+    std::cout << "Testing deep tree\n";
+
+    // The tree is deeper than the call stack would allow with recursion.
+    Shape shape;
+    shape.numThreads = 1;
+    shape.iterations = 1;
+    shape.depth = 1000000;
+    shape.fanOut = 1;
+    shape.numKeys = 1;
+
+    const EventRecorder recorder = Record(shape);
+    TF_AXIOM(recorder.maxDepth == 1000000);
+    TF_AXIOM(recorder.GetEventCount() == 2000000);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestInvalidShape()
+{
+    std::cout << "Testing invalid shape\n";
+
+    Shape shape;
+    shape.depth = 0;
+
+    TfErrorMark mark;
+    TF_AXIOM(!TraceCollectionGenerator::Generate(shape));
+    TF_AXIOM(!mark.IsClean());
+    mark.Clear();
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char* argv[])
+{
+    TestShape();
+    TestSeed();
+    TestDeepTree();
+    TestInvalidShape();
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/counterDownsampler.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Downsampler = TraceCounterDownsampler;
+using CounterValues = Downsampler::CounterValues;
+
+// Returns a slow sine wave with a single spike at \p spike.
+static CounterValues
+MakeSeries(size_t size, size_t spike)
+{
+    CounterValues values;
+    for (size_t i = 0; i < size; ++i) {
+        const double value = i == spike ? 1000.0 : std::sin(i * 0.001);
+        values.emplace_back(10 * i, value);
+    }
+    return values;
+}
+
+static bool
+IsSorted(const CounterValues& values)
+{
+    return std::is_sorted(values.begin(), values.end(),
+        [](const CounterValues::value_type& a,
+           const CounterValues::value_type& b) {
+            return a.first < b.first;
+        });
+}
+
+static bool
+Contains(const CounterValues& values, double value)
+{
+    return std::any_of(values.begin(), values.end(),
+        [value](const CounterValues::value_type& v) {
+            return v.second == value;
+        });
+}
+
+static void
+TestMinMax()
+{
+    std::cout << "Testing min/max downsampling\n";
+
+    const CounterValues values = MakeSeries(100000, 12345);
+    const CounterValues result =
+        Downsampler(Downsampler::Method::MinMax, 100).Downsample(values);
+    std::cout << "  " << values.size() << " -> " << result.size() << "\n";
+
+    TF_AXIOM(result.size() <= 2 * 100 + 2);
+    TF_AXIOM(result.size() > 100);
+    TF_AXIOM(result.front() == values.front());
+    TF_AXIOM(result.back() == values.back());
+    TF_AXIOM(IsSorted(result));
+    TF_AXIOM(Contains(result, 1000.0));
+
+    // A single bucket keeps the extremes of the whole series.
+    const double maxValue = std::max_element(values.begin(), values.end(),
+        [](const CounterValues::value_type& a,
+           const CounterValues::value_type& b) {
+            return a.second < b.second;
+        })->second;
+    const CounterValues single =
+        Downsampler(Downsampler::Method::MinMax, 1).Downsample(values);
+    TF_AXIOM(single.size() <= 4);
+    TF_AXIOM(Contains(single, maxValue));
+
+    // Short series are unchanged.
+    const CounterValues shortValues = MakeSeries(150, 10);
+    TF_AXIOM(Downsampler(Downsampler::Method::MinMax, 100)
+        .Downsample(shortValues) == shortValues);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestLargestTriangleThreeBuckets()
+{
+    std::cout << "Testing largest-triangle-three-buckets downsampling\n";
+
+    const CounterValues values = MakeSeries(100000, 54321);
+    const CounterValues result = Downsampler(
+        Downsampler::Method::LargestTriangleThreeBuckets, 500)
+        .Downsample(values);
+    std::cout << "  " << values.size() << " -> " << result.size() << "\n";
+
+    TF_AXIOM(result.size() == 500);
+    TF_AXIOM(result.front() == values.front());
+    TF_AXIOM(result.back() == values.back());
+    TF_AXIOM(IsSorted(result));
+    TF_AXIOM(Contains(result, 1000.0));
+
+    // Short series are unchanged.
+    const CounterValues shortValues = MakeSeries(400, 10);
+    TF_AXIOM(Downsampler(Downsampler::Method::LargestTriangleThreeBuckets, 500)
+        .Downsample(shortValues) == shortValues);
+
+    // Disabled downsamplers keep every value.
+    TF_AXIOM(!Downsampler().IsEnabled());
+    TF_AXIOM(Downsampler().Downsample(values) == values);
+    TF_AXIOM(!Downsampler(Downsampler::Method::MinMax, 0).IsEnabled());
+
+    std::cout << " PASSED\n";
+}
+
+static size_t
+CountCounterEvents(const std::string& json)
+{
+    size_t count = 0;
+    for (size_t pos = json.find("\"ph\":\"C\""); pos != std::string::npos;
+            pos = json.find("\"ph\":\"C\"", pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+static void
+TestReporter()
+{
+    std::cout << "Testing reporter downsampling\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterPtr reporter = TraceReporter::GetGlobalReporter();
+    collector.SetEnabled(true);
+    for (int i = 0; i < 20000; ++i) {
+        TRACE_COUNTER_VALUE("Counter", i == 5000 ? 1000.0 : i % 7);
+    }
+    collector.SetEnabled(false);
+
+    std::stringstream full;
+    reporter->ReportChromeTracing(full);
+    TF_AXIOM(CountCounterEvents(full.str()) == 20000);
+    TF_AXIOM(reporter->GetCounterValues().at(TfToken("Counter")).size()
+        == 20000);
+
+    reporter->SetCounterDownsampler(
+        Downsampler(Downsampler::Method::MinMax, 50));
+    TF_AXIOM(reporter->GetCounterDownsampler().GetResolution() == 50);
+
+    std::stringstream downsampled;
+    reporter->ReportChromeTracing(downsampled);
+    const size_t count = CountCounterEvents(downsampled.str());
+    std::cout << "  20000 -> " << count << "\n";
+    TF_AXIOM(count <= 2 * 50 + 2);
+
+    const CounterValues values =
+        reporter->GetCounterValues().at(TfToken("Counter"));
+    TF_AXIOM(values.size() == count);
+    TF_AXIOM(Contains(values, 1000.0));
+
+    // The event tree keeps every value.
+    TF_AXIOM(reporter->GetEventTree()->GetCounters()
+        .at(TfToken("Counter")).size() == 20000);
+
+    reporter->SetCounterDownsampler(Downsampler());
+    reporter->ClearTree();
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestMinMax();
+    TestLargestTriangleThreeBuckets();
+    TestReporter();
+}
@@ -0,0 +1,313 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+// Measures the cost of recording high frequency counter deltas with and
+// without coalescing, and the cost of accumulating counter values.
+//
+// Usage: testTraceCounterPerf [THREADS [DELTAS_PER_THREAD [OUTPUT]]]
+//
+// Deltas are recorded from THREADS threads (default 4) for each quantum.
+// The accumulation of the recorded counters by TraceCounterAccumulator is
+// compared with a reference implementation which inserts every value into a
+// std::multimap, as TraceCounterAccumulator used to. The results are
+// written as JSON to OUTPUT (default counterperf.json).
+
+#include <pxr/trace/trace.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/counterAccumulator.h>
+#include <pxr/trace/reporterDataSourceCollector.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/stopwatch.h>
+#include <pxr/arch/timing.h>
+#include <pxr/js/json.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using CollectionPtr = TraceReporterDataSourceBase::CollectionPtr;
+
+// Accumulates the counters of every category.
+class Accumulator : public TraceCounterAccumulator {
+protected:
+    bool _AcceptsCategory(TraceCategoryId) override { return true; }
+};
+
+// Accumulates counters by inserting every value into a std::multimap.
+class MultimapAccumulator {
+public:
+    void OnBeginCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        const TraceCollection::KeyTable& keys = events.GetKeyTable();
+        for (const TraceEvent& e : events) {
+            bool isDelta = false;
+            switch (e.GetType()) {
+                case TraceEvent::EventType::CounterDelta:
+                    isDelta = true;
+                    break;
+                case TraceEvent::EventType::CounterValue:
+                    break;
+                default:
+                    continue;
+            }
+            const TfToken& key = keys.GetToken(keys.GetKeyId(e.GetKey()));
+            _deltas[key].insert(std::make_pair(
+                e.GetTimeStamp(), _Value{e.GetCounterValue(), isDelta}));
+        }
+    }
+
+    void OnEndCollection() {
+        for (const auto& c : _deltas) {
+            double curValue = currentValues[c.first];
+            for (const auto& v : c.second) {
+                curValue = v.second.isDelta
+                    ? curValue + v.second.value : v.second.value;
+                counters[c.first].emplace_back(v.first, curValue);
+            }
+            currentValues[c.first] = curValue;
+        }
+        _deltas.clear();
+    }
+
+    TraceCounterAccumulator::CounterValuesMap counters;
+    TraceCounterAccumulator::CounterMap currentValues;
+
+private:
+    struct _Value {
+        double value;
+        bool isDelta;
+    };
+    std::map<TfToken, std::multimap<TraceEvent::TimeStamp, _Value>> _deltas;
+};
+
+// Counts the counter events of a collection.
+class CounterEventCounter {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        for (const TraceEvent& e : events) {
+            if (e.GetType() == TraceEvent::EventType::CounterDelta) {
+                ++count;
+            }
+        }
+    }
+
+    size_t count = 0;
+};
+
+static void
+RecordDeltas(int threadIndex, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        switch ((i + threadIndex) % 4) {
+            case 0: TRACE_COUNTER_DELTA("Counter A", 1); break;
+            case 1: TRACE_COUNTER_DELTA("Counter B", 1); break;
+            case 2: TRACE_COUNTER_DELTA("Counter C", -1); break;
+            case 3: TRACE_COUNTER_DELTA("Counter D", 2); break;
+        }
+    }
+}
+
+struct RecordResult {
+    double quantum;
+    int threads;
+    size_t deltas;
+    size_t events;
+    double seconds;
+
+    double GetNanosecondsPerDelta() const {
+        return seconds * threads / deltas * 1e9;
+    }
+};
+
+struct AccumulateResult {
+    std::string implementation;
+    double quantum;
+    size_t events;
+    double seconds;
+};
+
+static CollectionPtr
+Record(double quantum, int numThreads, size_t deltasPerThread,
+    RecordResult* result)
+{
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.Clear();
+    collector.SetCounterDeltaQuantum(ArchSecondsToTicks(quantum));
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+    collector.SetEnabled(true);
+
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            ++ready;
+            while (!go) {
+                std::this_thread::yield();
+            }
+            RecordDeltas(t, deltasPerThread);
+        });
+    }
+    while (ready != numThreads) {
+        std::this_thread::yield();
+    }
+
+    TfStopwatch watch;
+    watch.Start();
+    go = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    watch.Stop();
+
+    collector.SetEnabled(false);
+    collector.SetCounterDeltaQuantum(0);
+    std::vector<CollectionPtr> collections = source->ConsumeData();
+    TF_AXIOM(collections.size() == 1);
+
+    CounterEventCounter counter;
+    collections[0]->IterateBatches(counter);
+
+    result->quantum = quantum;
+    result->threads = numThreads;
+    result->deltas = deltasPerThread * numThreads;
+    result->events = counter.count;
+    result->seconds = watch.GetSeconds();
+    return collections[0];
+}
+
+template <class Fn>
+static double
+Time(Fn&& fn, int repeat)
+{
+    TfStopwatch watch;
+    for (int i = 0; i < repeat; ++i) {
+        watch.Start();
+        fn();
+        watch.Stop();
+    }
+    return watch.GetSeconds() / repeat;
+}
+
+static void
+CompareCounters(const TraceCounterAccumulator::CounterValuesMap& a,
+    const TraceCounterAccumulator::CounterValuesMap& b)
+{
+    TF_AXIOM(a.size() == b.size());
+    for (const auto& c : a) {
+        const auto it = b.find(c.first);
+        TF_AXIOM(it != b.end());
+        TF_AXIOM(it->second == c.second);
+    }
+}
+
+static void
+WriteResults(std::ostream& s, const std::vector<RecordResult>& records,
+    const std::vector<AccumulateResult>& accumulations)
+{
+    JsWriter js(s, JsWriter::Style::Pretty);
+    js.BeginObject();
+    js.WriteKeyValue("benchmark", "testTraceCounterPerf");
+    js.WriteKey("recording");
+    js.WriteArray(records, [](JsWriter& js, const RecordResult& r) {
+        js.WriteObject(
+            "quantum", r.quantum,
+            "threads", r.threads,
+            "deltas", uint64_t(r.deltas),
+            "events", uint64_t(r.events),
+            "seconds", r.seconds,
+            "nsPerDelta", r.GetNanosecondsPerDelta());
+    });
+    js.WriteKey("accumulation");
+    js.WriteArray(accumulations,
+        [](JsWriter& js, const AccumulateResult& r) {
+            js.WriteObject(
+                "implementation", r.implementation,
+                "quantum", r.quantum,
+                "events", uint64_t(r.events),
+                "seconds", r.seconds,
+                "nsPerEvent", r.seconds / r.events * 1e9);
+        });
+    js.EndObject();
+    s << "\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    const int numThreads = argc > 1 ? std::max(1, atoi(argv[1])) : 4;
+    const size_t deltasPerThread = argc > 2 ?
+        std::max(1, atoi(argv[2])) : 200000;
+    const std::string output = argc > 3 ? argv[3] : "counterperf.json";
+
+    // Quanta in seconds.
+    const std::vector<double> quanta = { 0.0, 1.0e-6, 1.0e-4 };
+
+    std::vector<RecordResult> records;
+    std::vector<AccumulateResult> accumulations;
+    for (double quantum : quanta) {
+        RecordResult r;
+        CollectionPtr collection =
+            Record(quantum, numThreads, deltasPerThread, &r);
+        records.push_back(r);
+        printf("record     quantum: %8.0e  deltas: %9zu  events: %9zu  "
+            "ns/delta: %8.2f\n",
+            r.quantum, r.deltas, r.events, r.GetNanosecondsPerDelta());
+
+        if (quantum == 0.0) {
+            TF_AXIOM(r.events == r.deltas);
+        } else {
+            TF_AXIOM(r.events <= r.deltas);
+        }
+
+        // Both accumulators must produce the same values.
+        Accumulator vectors;
+        vectors.Update(*collection);
+        MultimapAccumulator multimap;
+        collection->IterateBatches(multimap);
+        CompareCounters(vectors.GetCounters(), multimap.counters);
+        for (const auto& c : multimap.currentValues) {
+            TF_AXIOM(vectors.GetCurrentValues().at(c.first) == c.second);
+        }
+
+        const int repeat = 5;
+        const double multimapSeconds = Time([&]() {
+            MultimapAccumulator accumulator;
+            collection->IterateBatches(accumulator);
+        }, repeat);
+        const double vectorSeconds = Time([&]() {
+            Accumulator accumulator;
+            accumulator.Update(*collection);
+        }, repeat);
+
+        accumulations.push_back(
+            {"multimap", quantum, r.events, multimapSeconds});
+        accumulations.push_back(
+            {"TraceCounterAccumulator", quantum, r.events, vectorSeconds});
+        printf("accumulate quantum: %8.0e  events: %9zu  "
+            "multimap: %8.2f ms  TraceCounterAccumulator: %8.2f ms\n",
+            quantum, r.events, multimapSeconds * 1e3, vectorSeconds * 1e3);
+    }
+
+    std::ofstream file(output.c_str());
+    WriteResults(file, records, accumulations);
+    return 0;
+}
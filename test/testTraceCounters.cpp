@@ -158,6 +158,25 @@ int main(int argc, char* argv[]) {
     TestTimelineCounterValues(TfToken("Counter C"), {5.0,4.0,2.0});
     TestTimelineCounterValues(TfToken("Counter D"), {1.0,3.0,-5.0});
 
+    // Deltas recorded within the quantum are coalesced into a single event.
+    reporter->ClearTree();
+    collector->SetCounterDeltaQuantum(ArchSecondsToTicks(3600.0));
+    collector->SetEnabled(true);
+    for (int i = 0; i < 100; ++i) {
+        TRACE_COUNTER_DELTA("Counter F", 2);
+        TRACE_COUNTER_DELTA_DYNAMIC("Counter G", -1);
+    }
+    TRACE_COUNTER_VALUE("Counter F", 1);
+    TRACE_COUNTER_DELTA("Counter F", 3);
+    collector->SetEnabled(false);
+    collector->SetCounterDeltaQuantum(0);
+    reporter->UpdateTraceTrees();
+
+    TestAggregateCounterValue(TfToken("Counter F"), 4.0);
+    TestAggregateCounterValue(TfToken("Counter G"), -100.0);
+    TestAggregateCounterDelta(TfToken("Counter G"), -100.0);
+    TestTimelineCounterValues(TfToken("Counter F"), {200.0,1.0,4.0});
+    TestTimelineCounterValues(TfToken("Counter G"), {-100.0});
 
     return 0;
 }
\ No newline at end of file
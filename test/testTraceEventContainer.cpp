@@ -10,6 +10,8 @@
 #include <pxr/trace/collectionNotice.h>
 
 #include <iostream>
+#include <iterator>
+#include <thread>
 
 TRACE_NAMESPACE_USING_DIRECTIVE
 
@@ -133,6 +135,112 @@ _TestReverseIteration(
     }   
 }
 
+static void
+_TestBlockPool()
+{
+    const size_t capacity = TraceEventContainer::GetBlockPoolCapacity();
+    TraceEventContainer::SetBlockPoolCapacity(0);
+    TF_AXIOM(TraceEventContainer::GetBlockPoolSize() == 0);
+    TraceEventContainer::SetBlockPoolCapacity(1 << 20);
+
+    // The blocks of destroyed lists are kept in the pool.
+    CreateAppendedList();
+    const size_t pooled = TraceEventContainer::GetBlockPoolSize();
+    TF_AXIOM(pooled > 0);
+
+    // New lists reuse them.
+    {
+        std::shared_ptr<TraceEventList> events = CreateAppendedList();
+        TF_AXIOM(TraceEventContainer::GetBlockPoolSize() < pooled);
+        TF_AXIOM(std::distance(events->begin(), events->end()) == 8 * 200);
+    }
+    TF_AXIOM(TraceEventContainer::GetBlockPoolSize() == pooled);
+
+    // Lowering the capacity frees blocks.
+    TraceEventContainer::SetBlockPoolCapacity(pooled / 2);
+    TF_AXIOM(TraceEventContainer::GetBlockPoolSize() <= pooled / 2);
+
+    // Blocks are not kept above the capacity.
+    TraceEventContainer::SetBlockPoolCapacity(0);
+    CreateAppendedList();
+    TF_AXIOM(TraceEventContainer::GetBlockPoolSize() == 0);
+
+    TraceEventContainer::SetBlockPoolCapacity(capacity);
+}
+
+static size_t
+_CountLongList()
+{
+    TraceEventList events;
+    const TraceKey key = events.CacheKey("Long List");
+    for (int i = 0; i < 200000; ++i) {
+        events.EmplaceBack(TraceEvent::CounterDelta, key, double(i),
+            TraceCategory::Default);
+    }
+
+    size_t count = 0;
+    double sum = 0.0;
+    for (const TraceEvent& e : events) {
+        sum += e.GetCounterValue();
+        ++count;
+    }
+    TF_AXIOM(sum == 199999.0 * 200000.0 / 2.0);
+    return count;
+}
+
+static void
+_TestBlockMapping()
+{
+    // Long lists use blocks large enough to be mapped, which must behave
+    // like heap blocks.
+    TF_AXIOM(TraceEventContainer::IsBlockMappingEnabled());
+    TF_AXIOM(_CountLongList() == 200000);
+
+    TraceEventContainer::SetBlockMappingEnabled(false);
+    TF_AXIOM(_CountLongList() == 200000);
+    TraceEventContainer::SetBlockMappingEnabled(true);
+
+    // Mapped blocks are pooled and reused.
+    TF_AXIOM(_CountLongList() == 200000);
+}
+
+static void
+_TestNonTemporalStores()
+{
+    TF_AXIOM(!TraceEventContainer::IsNonTemporalStoresEnabled());
+    if (!TraceEventContainer::SetNonTemporalStoresEnabled(true)) {
+        TF_AXIOM(!TraceEventContainer::IsNonTemporalStoresEnabled());
+        return;
+    }
+    TF_AXIOM(TraceEventContainer::IsNonTemporalStoresEnabled());
+
+    // Events streamed by this thread are read back in order.
+    TF_AXIOM(_CountLongList() == 200000);
+
+    // Events streamed by another thread are visible after the fence.
+    TraceEventList events;
+    const TraceKey key = events.CacheKey("Streamed");
+    std::thread writer([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            events.EmplaceBack(TraceEvent::CounterValue, key, double(i),
+                TraceCategory::Default);
+        }
+    });
+    writer.join();
+    TraceEventContainer::FenceNonTemporalStores();
+
+    int i = 0;
+    for (const TraceEvent& e : events) {
+        TF_AXIOM(e.GetKey() == key);
+        TF_AXIOM(e.GetType() == TraceEvent::EventType::CounterValue);
+        TF_AXIOM(e.GetCounterValue() == double(i++));
+    }
+    TF_AXIOM(i == 1000);
+
+    TF_AXIOM(TraceEventContainer::SetNonTemporalStoresEnabled(false));
+    TF_AXIOM(!TraceEventContainer::IsNonTemporalStoresEnabled());
+}
+
 int
 main(int argc, char *argv[]) 
 {
@@ -162,5 +270,9 @@ main(int argc, char *argv[])
     _TestForwardIteration(appendedEventList);
     _TestReverseIteration(appendedEventList);
 
+    _TestBlockPool();
+    _TestBlockMapping();
+    _TestNonTemporalStores();
+
     std::cout << " PASSED\n";
 }
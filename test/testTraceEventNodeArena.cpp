@@ -0,0 +1,181 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/eventNode.h>
+#include <pxr/trace/eventNodeArena.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Index = TraceEventNodeArena::Index;
+static const Index InvalidIndex = TraceEventNodeArena::InvalidIndex;
+
+static std::vector<std::string>
+GetKeysInSubtree(const TraceEventNodeArena& arena, Index node)
+{
+    std::vector<std::string> keys;
+    arena.ForEachInSubtree(node, [&](Index i) {
+        keys.push_back(arena.GetKey(i).GetString());
+    });
+    return keys;
+}
+
+static void
+TestArena()
+{
+    std::cout << "Testing arena\n";
+
+    TraceEventNodeArenaRefPtr arena = TraceEventNodeArena::New();
+    const Index root =
+        arena->AddNode(TfToken("root"), TraceCategory::Default, 0, 0, false);
+    const Index a =
+        arena->AddNode(TfToken("A"), TraceCategory::Default, 10, 20, false);
+    const Index b =
+        arena->AddNode(TfToken("B"), TraceCategory::Default, 30, 50, true);
+    const Index c =
+        arena->AddNode(TfToken("C"), TraceCategory::Default, 12, 18, false);
+    arena->AppendChild(root, a);
+    arena->AppendChild(root, b);
+    arena->AppendChild(a, c);
+
+    TF_AXIOM(arena->GetSize() == 4);
+    TF_AXIOM(arena->GetParent(c) == a);
+    TF_AXIOM(arena->GetFirstChild(root) == a);
+    TF_AXIOM(arena->GetLastChild(root) == b);
+    TF_AXIOM(arena->GetNextSibling(a) == b);
+    TF_AXIOM(arena->GetNextSibling(b) == InvalidIndex);
+    TF_AXIOM(arena->IsFromSeparateEvents(b));
+    TF_AXIOM((GetKeysInSubtree(*arena, root) ==
+        std::vector<std::string>{"root", "A", "C", "B"}));
+    TF_AXIOM((GetKeysInSubtree(*arena, a) ==
+        std::vector<std::string>{"A", "C"}));
+
+    arena->SetBeginAndEndTimesFromChildren(root);
+    TF_AXIOM(arena->GetBeginTime(root) == 10);
+    TF_AXIOM(arena->GetEndTime(root) == 50);
+
+    // Attributes stay contiguous when they are added out of order.
+    arena->AddAttribute(a, TfToken("x"), TraceEventData(int64_t(1)));
+    arena->AddAttribute(c, TfToken("y"), TraceEventData(2.0));
+    arena->AddAttribute(a, TfToken("x"), TraceEventData(int64_t(3)));
+    TF_AXIOM(arena->GetAttributesEnd(a) - arena->GetAttributesBegin(a) == 2);
+    TF_AXIOM(*arena->GetAttributeData(
+        arena->GetAttributesBegin(a)).GetInt() == 1);
+    TF_AXIOM(*arena->GetAttributeData(
+        arena->GetAttributesBegin(a) + 1).GetInt() == 3);
+    TF_AXIOM(arena->GetAttributeKey(arena->GetAttributesBegin(c)) == "y");
+
+    // Subtrees are copied with their attributes, within an arena or to
+    // another one.
+    const Index copy = arena->CopySubtree(*arena, a);
+    TF_AXIOM(arena->GetParent(copy) == InvalidIndex);
+    TF_AXIOM((GetKeysInSubtree(*arena, copy) ==
+        std::vector<std::string>{"A", "C"}));
+
+    TraceEventNodeArenaRefPtr other = TraceEventNodeArena::New();
+    const Index otherCopy = other->CopySubtree(*arena, root);
+    TF_AXIOM(other->GetSize() == 4);
+    TF_AXIOM((GetKeysInSubtree(*other, otherCopy) ==
+        std::vector<std::string>{"root", "A", "C", "B"}));
+    const Index otherA = other->GetFirstChild(otherCopy);
+    TF_AXIOM(other->GetAttributesEnd(otherA) -
+        other->GetAttributesBegin(otherA) == 2);
+    TF_AXIOM(other->GetEndTime(other->GetFirstChild(otherA)) == 18);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestNodeViews()
+{
+    std::cout << "Testing node views\n";
+
+    TraceEventNodeRefPtr root = TraceEventNode::New();
+    TraceEventNodeRefPtr a =
+        root->Append(TfToken("A"), TraceCategory::Default, 10, 20, false);
+    TF_AXIOM(root->GetChildrenRef().size() == 1);
+    TF_AXIOM(root->GetChildrenRef()[0] == a);
+
+    // Views see the changes made through other views.
+    TraceEventNodeRefPtr b =
+        root->Append(TfToken("B"), TraceCategory::Default, 30, 40, true);
+    a->Append(TfToken("C"), TraceCategory::Default, 12, 18, false);
+    TF_AXIOM(root->GetChildrenRef().size() == 2);
+    TF_AXIOM(root->GetChildrenRef()[0] == a);
+    TF_AXIOM(root->GetChildrenRef()[1]->GetKey() == "B");
+    TF_AXIOM(root->GetChildrenRef()[0]->GetChildrenRef().size() == 1);
+
+    a->AddAttribute(TfToken("x"), TraceEventData(int64_t(1)));
+    a->AddAttribute(TfToken("x"), TraceEventData(int64_t(2)));
+    TF_AXIOM(a->GetAttributes().count(TfToken("x")) == 2);
+
+    root->SetBeginAndEndTimesFromChildren();
+    TF_AXIOM(root->GetBeginTime() == 10);
+    TF_AXIOM(root->GetEndTime() == 40);
+
+    // Nodes of other arenas are copied.
+    TraceEventNodeRefPtr d = TraceEventNode::New(
+        TfToken("D"), TraceCategory::Default, 50, 60, {}, false);
+    root->Append(d);
+    TF_AXIOM(root->GetChildrenRef().size() == 3);
+    TF_AXIOM(root->GetChildrenRef()[2]->GetArena() == root->GetArena());
+    TF_AXIOM(root->GetChildrenRef()[2]->GetEndTime() == 60);
+
+    // Nodes which already have a parent are copied rather than moved.
+    b->Append(a);
+    TF_AXIOM(root->GetChildrenRef()[0] == a);
+    TF_AXIOM(b->GetChildrenRef().size() == 1);
+    TF_AXIOM(b->GetChildrenRef()[0] != a);
+    TF_AXIOM(b->GetChildrenRef()[0]->GetAttributes().size() == 2);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestMerge()
+{
+    std::cout << "Testing merge\n";
+
+    TraceEventNodeRefPtr root1 = TraceEventNode::New();
+    TraceEventNodeRefPtr thread1 = root1->Append(
+        TfToken("Thread 1"), TraceCategory::Default, 0, 0, false);
+    thread1->Append(TfToken("A"), TraceCategory::Default, 10, 20, false);
+    thread1->SetBeginAndEndTimesFromChildren();
+    TraceEventTreeRefPtr tree = TraceEventTree::New(root1, {}, {});
+
+    TraceEventNodeRefPtr root2 = TraceEventNode::New();
+    TraceEventNodeRefPtr thread1b = root2->Append(
+        TfToken("Thread 1"), TraceCategory::Default, 0, 0, false);
+    thread1b->Append(TfToken("B"), TraceCategory::Default, 30, 40, false)
+        ->Append(TfToken("C"), TraceCategory::Default, 32, 38, false);
+    TraceEventNodeRefPtr thread2 = root2->Append(
+        TfToken("Thread 2"), TraceCategory::Default, 0, 0, false);
+    thread2->Append(TfToken("D"), TraceCategory::Default, 5, 8, false);
+
+    tree->Merge(TraceEventTree::New(root2, {}, {}));
+
+    const TraceEventNodeArena& arena = tree->GetNodeArena();
+    TF_AXIOM((GetKeysInSubtree(arena, tree->GetRootIndex()) ==
+        std::vector<std::string>{
+            "root", "Thread 1", "A", "B", "C", "Thread 2", "D"}));
+    TF_AXIOM(thread1->GetBeginTime() == 10);
+    TF_AXIOM(thread1->GetEndTime() == 40);
+    TF_AXIOM(tree->GetRoot()->GetChildrenRef().size() == 2);
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestArena();
+    TestNodeViews();
+    TestMerge();
+}
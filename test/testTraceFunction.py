@@ -0,0 +1,103 @@
+# Copyright 2026 Jeremy Retailleau
+#
+# Licensed under the terms set forth in the LICENSE.txt file available at
+# https://openusd.org/license.
+
+import gc
+import unittest
+import weakref
+
+from pxr import Trace
+
+@Trace.TraceFunction
+def Add(x, y=2):
+    """Adds x and y."""
+    return x + y
+
+class Object(object):
+    @Trace.TraceFunction
+    def Method(self, value):
+        return (self, value)
+
+@Trace.TraceFunction
+def Raise():
+    raise ValueError('Raise')
+
+class TestTraceFunction(unittest.TestCase):
+    def setUp(self):
+        self.collector = Trace.Collector()
+        self.reporter = Trace.Reporter.globalReporter
+        self.reporter.ClearTree()
+
+    def GetCounts(self):
+        self.reporter.UpdateTraceTrees()
+        counts = {}
+        def visit(node):
+            counts[node.key] = counts.get(node.key, 0) + node.count
+            for child in node.children:
+                visit(child)
+        for thread in self.reporter.aggregateTreeRoot.children:
+            for child in thread.children:
+                visit(child)
+        return counts
+
+    def test_Function(self):
+        self.assertEqual(Add.__name__, 'Add')
+        self.assertEqual(Add.__doc__, 'Adds x and y.')
+        self.assertIs(Add.__wrapped__, Add.function)
+
+        self.collector.enabled = True
+        self.assertEqual(Add(1), 3)
+        self.assertEqual(Add(1, y=5), 6)
+        obj = Object()
+        self.assertEqual(obj.Method(4), (obj, 4))
+        self.assertEqual(Object.Method(obj, 5), (obj, 5))
+        with self.assertRaises(ValueError):
+            Raise()
+        self.collector.enabled = False
+
+        counts = self.GetCounts()
+        self.assertEqual(counts['Python func: __main__.Add'], 2)
+        self.assertEqual(counts['Python func: __main__.Method'], 2)
+        self.assertEqual(counts['Python func: __main__.Raise'], 1)
+
+    def test_Collect(self):
+        # A recursive function refers to itself through its closure, which
+        # the garbage collector must be able to break.
+        def Create():
+            @Trace.TraceFunction
+            def Recurse(n):
+                return 0 if n == 0 else Recurse(n - 1)
+            return Recurse
+
+        self.collector.enabled = True
+        recurse = Create()
+        self.assertEqual(recurse(3), 0)
+        self.collector.enabled = False
+
+        ref = weakref.ref(recurse)
+        del recurse
+        gc.collect()
+        self.assertIsNone(ref())
+        self.assertEqual(
+            self.GetCounts()['Python func: __main__.Recurse'], 4)
+
+    def test_Scope(self):
+        scope = Trace.TraceScope('Reused')
+
+        self.collector.enabled = True
+        with Trace.TraceScope('Outer'):
+            for i in range(3):
+                with scope:
+                    pass
+        with self.assertRaises(ValueError):
+            with scope:
+                raise ValueError('Raise')
+        self.collector.enabled = False
+
+        counts = self.GetCounts()
+        self.assertEqual(counts['Outer'], 1)
+        self.assertEqual(counts['Reused'], 4)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,486 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collector.h>
+#include <pxr/trace/eventContainer.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/reporterDataSourceCollector.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using OverflowPolicy = TraceCollector::OverflowPolicy;
+
+constexpr static TraceStaticKeyData CounterKey("Counter");
+
+constexpr size_t MemoryLimit = 1024 * 1024;
+constexpr int NumValues = 1000000;
+
+// Counts the blocks allocated by a container.
+struct BlockCounter : public TraceAllocationObserver {
+    void OnBlockAllocated() override { ++count; }
+    int count = 0;
+};
+
+// Returns the values of the CounterValue events of container.
+static std::vector<double>
+GetValues(const TraceEventContainer& container)
+{
+    std::vector<double> values;
+    for (const TraceEvent& e : container) {
+        values.push_back(e.GetCounterValue());
+    }
+    return values;
+}
+
+// Returns the values of the CounterValue and CounterDelta events of a
+// collection.
+class ValueReader {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        for (const TraceEvent& e : events) {
+            if (e.GetType() == TraceEvent::EventType::CounterValue) {
+                values.push_back(e.GetCounterValue());
+            } else if (e.GetType() == TraceEvent::EventType::CounterDelta) {
+                deltas.push_back(e.GetCounterValue());
+            }
+        }
+    }
+
+    std::vector<double> values;
+    std::vector<double> deltas;
+};
+
+// Returns true if values are consecutive integers ending at last.
+static bool
+IsConsecutive(const std::vector<double>& values, double last)
+{
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] != last - double(values.size() - 1 - i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Records the values from 0 to NumValues - 1 on the calling thread.
+static void
+RecordValues()
+{
+    TraceCollector& collector = TraceCollector::GetInstance();
+    for (int i = 0; i < NumValues; ++i) {
+        collector.RecordCounterValue(TraceKey(CounterKey), double(i));
+    }
+}
+
+// Returns the collection of the events recorded since the last call.
+static std::shared_ptr<TraceCollection>
+GetCollection(TraceReporterDataSourceCollector& source)
+{
+    std::vector<TraceReporterDataSourceBase::CollectionPtr> collections =
+        source.ConsumeData();
+    TF_AXIOM(collections.size() == 1);
+    return collections[0];
+}
+
+static std::vector<double>
+GetValues(const TraceCollection& collection)
+{
+    ValueReader reader;
+    collection.IterateBatches(reader);
+    return reader.values;
+}
+
+static std::vector<double>
+GetDeltas(const TraceCollection& collection)
+{
+    ValueReader reader;
+    collection.IterateBatches(reader);
+    return reader.deltas;
+}
+
+static void
+TestContainer()
+{
+    std::cout << "Testing container\n";
+
+    TraceEventContainer container;
+    BlockCounter blocks;
+    container.SetAllocationObserver(&blocks);
+
+    const size_t initialBytes = container.GetMemoryUsage();
+    TF_AXIOM(initialBytes > 0);
+
+    const TraceKey key(CounterKey);
+    const int numEvents = 10000;
+    for (int i = 0; i < numEvents; ++i) {
+        container.emplace_back(TraceEvent::CounterValue, key, double(i),
+            TraceCategory::Default);
+    }
+    TF_AXIOM(blocks.count > 0);
+    TF_AXIOM(container.GetMemoryUsage() >= numEvents * sizeof(TraceEvent));
+    TF_AXIOM(container.GetSpilledBytes() == 0);
+
+    // The most recent block is kept, and the others are written to the
+    // file.
+    TraceEventContainer::SpillFilePtr spillFile =
+        container.SpillOldestBlocks(0);
+    TF_AXIOM(spillFile);
+    TF_AXIOM(container.GetSpilledBytes() > 0);
+    TraceEventContainer::WriteSpilledBlocks(spillFile);
+    std::vector<double> values = GetValues(container);
+    TF_AXIOM(!values.empty() && values.size() < size_t(numEvents));
+    TF_AXIOM(IsConsecutive(values, numEvents - 1));
+
+    // Events are still stored after spilling, and spilled again.
+    for (int i = numEvents; i < 2 * numEvents; ++i) {
+        container.emplace_back(TraceEvent::CounterValue, key, double(i),
+            TraceCategory::Default);
+    }
+    TF_AXIOM(container.SpillOldestBlocks(0) == spillFile);
+
+    // The spilled events are read back in order, including those which were
+    // not written yet.
+    size_t usage = container.GetMemoryUsage();
+    TF_AXIOM(container.LoadSpilledBlocks() == 0);
+    TF_AXIOM(container.GetSpilledBytes() == 0);
+    TF_AXIOM(container.GetMemoryUsage() > usage);
+    usage = container.GetMemoryUsage();
+    values = GetValues(container);
+    TF_AXIOM(values.size() == size_t(2 * numEvents));
+    TF_AXIOM(IsConsecutive(values, 2 * numEvents - 1));
+
+    const size_t numDropped = container.DropOldestBlocks(0);
+    TF_AXIOM(numDropped > 0);
+    TF_AXIOM(container.GetMemoryUsage() < usage);
+    values = GetValues(container);
+    TF_AXIOM(values.size() + numDropped == size_t(2 * numEvents));
+    TF_AXIOM(IsConsecutive(values, 2 * numEvents - 1));
+
+    // The observer is not moved with the events.
+    blocks.count = 0;
+    TraceEventContainer moved(std::move(container));
+    for (int i = 0; i < numEvents; ++i) {
+        moved.emplace_back(TraceEvent::CounterValue, key, double(i),
+            TraceCategory::Default);
+    }
+    TF_AXIOM(blocks.count == 0);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestAccounting()
+{
+    std::cout << "Testing accounting\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+    TF_AXIOM(collector.GetMemoryLimit() == 0);
+
+    collector.SetEnabled(true);
+    RecordValues();
+    collector.SetEnabled(false);
+
+    const TraceCollector::MemoryUsage usage = collector.GetMemoryUsage();
+    TF_AXIOM(usage.eventBytes >= NumValues * sizeof(TraceEvent));
+    TF_AXIOM(usage.keyBytes > 0);
+    TF_AXIOM(usage.spilledBytes == 0);
+    TF_AXIOM(usage.GetTotal() ==
+        usage.eventBytes + usage.keyBytes + usage.dataBytes);
+
+    size_t eventBytes = 0;
+    for (const auto& thread : collector.GetMemoryUsagePerThread()) {
+        eventBytes += thread.second.eventBytes;
+    }
+    TF_AXIOM(eventBytes == usage.eventBytes);
+
+    std::shared_ptr<TraceCollection> collection = GetCollection(*source);
+    TF_AXIOM(GetValues(*collection).size() == size_t(NumValues));
+    TF_AXIOM(collection->GetOverflowCount() == 0);
+    TF_AXIOM(collection->GetDroppedEventCount() == 0);
+    TF_AXIOM(!collection->WasRecordingPaused());
+
+    // The memory of the collected events is no longer accounted for.
+    TF_AXIOM(collector.GetMemoryUsage().eventBytes < usage.eventBytes / 100);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestStop()
+{
+    std::cout << "Testing stop policy\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::Stop);
+    TF_AXIOM(collector.GetMemoryLimit() == MemoryLimit);
+    TF_AXIOM(collector.GetOverflowPolicy() == OverflowPolicy::Stop);
+
+    collector.SetEnabled(true);
+    RecordValues();
+    TF_AXIOM(!TraceCollector::IsEnabled());
+
+    // Recording resumes once the events are collected.
+    std::shared_ptr<TraceCollection> collection = GetCollection(*source);
+    TF_AXIOM(TraceCollector::IsEnabled());
+    collector.SetEnabled(false);
+
+    // The first events were recorded.
+    const std::vector<double> values = GetValues(*collection);
+    TF_AXIOM(!values.empty() && values.size() < size_t(NumValues));
+    TF_AXIOM(values.front() == 0);
+    TF_AXIOM(IsConsecutive(values, values.back()));
+    TF_AXIOM(collection->GetOverflowCount() > 0);
+    TF_AXIOM(collection->GetDroppedEventCount() == 0);
+    TF_AXIOM(collection->WasRecordingPaused());
+
+    // Slices keep the overflow count of the collections they are taken
+    // from.
+    const TraceEvent::TimeStamp end = ~TraceEvent::TimeStamp(0);
+    const TraceCollection slice = collection->Slice(0, end);
+    TF_AXIOM(slice.GetOverflowCount() == collection->GetOverflowCount());
+    TF_AXIOM(slice.WasRecordingPaused());
+    collector.SetEnabled(true);
+    RecordValues();
+    collector.SetEnabled(false);
+    std::shared_ptr<TraceCollection> second = GetCollection(*source);
+    TF_AXIOM(second->GetOverflowCount() > 0);
+    const std::unique_ptr<TraceCollection> joined = TraceCollection::Slice(
+        {collection, second}, 0, end);
+    TF_AXIOM(joined->GetOverflowCount() ==
+        collection->GetOverflowCount() + second->GetOverflowCount());
+    TF_AXIOM(joined->WasRecordingPaused());
+
+    // The counter is reset by the collection.
+    std::shared_ptr<TraceCollection> next = GetCollection(*source);
+    TF_AXIOM(next->GetOverflowCount() == 0);
+    TF_AXIOM(!next->WasRecordingPaused());
+
+    // Recording also resumes when the limit is removed.
+    collector.SetEnabled(true);
+    RecordValues();
+    TF_AXIOM(!TraceCollector::IsEnabled());
+    collector.SetMemoryLimit(0);
+    TF_AXIOM(TraceCollector::IsEnabled());
+    collector.SetEnabled(false);
+    collector.Clear();
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestDropOldest()
+{
+    std::cout << "Testing drop oldest policy\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::DropOldest);
+    collector.SetEnabled(true);
+    RecordValues();
+    TF_AXIOM(TraceCollector::IsEnabled());
+    collector.SetEnabled(false);
+    TF_AXIOM(collector.GetMemoryUsage().GetTotal() <= MemoryLimit);
+
+    // The last events were kept.
+    std::shared_ptr<TraceCollection> collection = GetCollection(*source);
+    const std::vector<double> values = GetValues(*collection);
+    TF_AXIOM(!values.empty());
+    TF_AXIOM(IsConsecutive(values, NumValues - 1));
+    TF_AXIOM(collection->GetOverflowCount() > 0);
+    TF_AXIOM(values.size() + collection->GetDroppedEventCount() ==
+        size_t(NumValues));
+    TF_AXIOM(!collection->WasRecordingPaused());
+
+    collector.SetMemoryLimit(0);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestSpill()
+{
+    std::cout << "Testing spill policy\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::Spill);
+    collector.SetEnabled(true);
+    RecordValues();
+    collector.SetEnabled(false);
+
+    const TraceCollector::MemoryUsage usage = collector.GetMemoryUsage();
+    TF_AXIOM(usage.GetTotal() <= MemoryLimit);
+    TF_AXIOM(usage.spilledBytes > 0);
+
+    // Every event is collected, in order.
+    std::shared_ptr<TraceCollection> collection = GetCollection(*source);
+    const std::vector<double> values = GetValues(*collection);
+    TF_AXIOM(values.size() == size_t(NumValues));
+    TF_AXIOM(IsConsecutive(values, NumValues - 1));
+    TF_AXIOM(collection->GetOverflowCount() > 0);
+    TF_AXIOM(collection->GetDroppedEventCount() == 0);
+    TF_AXIOM(collector.GetMemoryUsage().spilledBytes == 0);
+
+    // Spilled events are discarded by Clear().
+    collector.SetEnabled(true);
+    RecordValues();
+    collector.SetEnabled(false);
+    TF_AXIOM(collector.GetMemoryUsage().spilledBytes > 0);
+    collector.Clear();
+    TF_AXIOM(collector.GetMemoryUsage().spilledBytes == 0);
+
+    collector.SetMemoryLimit(0);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestCounterDeltas()
+{
+    std::cout << "Testing counter deltas\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    // The deltas span many blocks, and are coalesced a few at a time with
+    // the quantum.
+    for (const TraceCollector::TimeStamp quantum :
+            {TraceCollector::TimeStamp(0), TraceCollector::TimeStamp(10)}) {
+        collector.SetCounterDeltaQuantum(quantum);
+
+        // Dropped deltas are counted, and the others are not altered.
+        collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::DropOldest);
+        collector.SetEnabled(true);
+        for (int i = 0; i < NumValues; ++i) {
+            TRACE_COUNTER_DELTA("Delta", 1.0);
+        }
+        collector.SetEnabled(false);
+
+        std::shared_ptr<TraceCollection> collection = GetCollection(*source);
+        std::vector<double> deltas = GetDeltas(*collection);
+        TF_AXIOM(!deltas.empty());
+        TF_AXIOM(collection->GetDroppedEventCount() > 0);
+        double sum = 0.0;
+        for (const double delta : deltas) {
+            TF_AXIOM(delta >= 1.0);
+            sum += delta;
+        }
+        TF_AXIOM(sum < NumValues);
+        if (quantum == 0) {
+            TF_AXIOM(sum == double(deltas.size()));
+            TF_AXIOM(deltas.size() + collection->GetDroppedEventCount() ==
+                size_t(NumValues));
+        }
+
+        // Every spilled delta is read back.
+        collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::Spill);
+        collector.SetEnabled(true);
+        for (int i = 0; i < NumValues; ++i) {
+            TRACE_COUNTER_DELTA("Delta", 1.0);
+        }
+        collector.SetEnabled(false);
+        TF_AXIOM(collector.GetMemoryUsage().spilledBytes > 0);
+
+        collection = GetCollection(*source);
+        deltas = GetDeltas(*collection);
+        TF_AXIOM(collection->GetDroppedEventCount() == 0);
+        sum = 0.0;
+        for (const double delta : deltas) {
+            TF_AXIOM(delta >= 1.0);
+            sum += delta;
+        }
+        TF_AXIOM(sum == NumValues);
+        TF_AXIOM(quantum != 0 || deltas.size() == size_t(NumValues));
+    }
+
+    collector.SetCounterDeltaQuantum(0);
+    collector.SetMemoryLimit(0);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestReport()
+{
+    std::cout << "Testing report\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterRefPtr reporter = TraceReporter::New(
+        "Test", TraceReporterDataSourceCollector::New());
+
+    collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::DropOldest);
+    collector.SetEnabled(true);
+    RecordValues();
+    collector.SetEnabled(false);
+    collector.SetMemoryLimit(0);
+
+    std::ostringstream report;
+    reporter->Report(report);
+    std::cout << report.str();
+    TF_AXIOM(reporter->GetOverflowCount() > 0);
+    TF_AXIOM(reporter->GetDroppedEventCount() > 0);
+    TF_AXIOM(!reporter->WasRecordingPaused());
+    TF_AXIOM(report.str().find("WARNING:") != std::string::npos);
+    TF_AXIOM(report.str().find("events were dropped") != std::string::npos);
+
+    reporter->ClearTree();
+    TF_AXIOM(reporter->GetOverflowCount() == 0);
+    TF_AXIOM(reporter->GetDroppedEventCount() == 0);
+
+    // No events are dropped when recording is paused.
+    collector.SetMemoryLimit(MemoryLimit, OverflowPolicy::Stop);
+    collector.SetEnabled(true);
+    RecordValues();
+    collector.SetEnabled(false);
+    collector.SetMemoryLimit(0);
+
+    report.str("");
+    reporter->Report(report);
+    std::cout << report.str();
+    TF_AXIOM(reporter->GetOverflowCount() > 0);
+    TF_AXIOM(reporter->GetDroppedEventCount() == 0);
+    TF_AXIOM(reporter->WasRecordingPaused());
+    TF_AXIOM(report.str().find("recording was paused") != std::string::npos);
+    TF_AXIOM(report.str().find("events were dropped") == std::string::npos);
+
+    reporter->ClearTree();
+    TF_AXIOM(!reporter->WasRecordingPaused());
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestContainer();
+    TestAccounting();
+    TestStop();
+    TestDropOldest();
+    TestSpill();
+    TestCounterDeltas();
+    TestReport();
+}
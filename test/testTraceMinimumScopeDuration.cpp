@@ -0,0 +1,167 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/aggregateTree.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/trace/reporterDataSourceCollector.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+struct PerfCategory {
+    static constexpr TraceCategoryId GetId() {
+        return TraceCategory::CreateTraceCategoryId("MinimumDurationPerf");
+    }
+    static bool IsEnabled() { return TraceCollector::IsEnabled(); }
+};
+
+constexpr static TraceStaticKeyData ShortKey("Short");
+constexpr static TraceStaticKeyData LongKey("Long");
+constexpr static TraceStaticKeyData PerfKey("Perf");
+
+// Counts the Timespan events of a collection by key.
+class TimespanCounter {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        const TraceCollection::KeyTable& table = events.GetKeyTable();
+        for (const TraceEvent& e : events) {
+            if (e.GetType() == TraceEvent::EventType::Timespan) {
+                ++counts[table.GetToken(table.GetKeyId(e.GetKey()))];
+            }
+        }
+    }
+
+    std::map<TfToken, size_t> counts;
+};
+
+// Records \p numScopes of each key on \p numThreads threads. Short scopes
+// last 10 ticks and long ones 1000 ticks.
+static void
+RecordScopes(int numThreads, int numScopes)
+{
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.SetEnabled(true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&collector, numScopes]() {
+            TraceEvent::TimeStamp time = 1000;
+            for (int i = 0; i < numScopes; ++i) {
+                TraceCollector::Scope(LongKey, time, time + 1000);
+                TraceCollector::Scope(ShortKey, time, time + 10);
+                collector.Scope<PerfCategory>(PerfKey, time, time + 10);
+                time += 2000;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    collector.SetEnabled(false);
+}
+
+// Returns the collection of the events recorded since the last call.
+static std::shared_ptr<TraceCollection>
+GetCollection(TraceReporterDataSourceCollector& source)
+{
+    std::vector<TraceReporterDataSourceBase::CollectionPtr> collections =
+        source.ConsumeData();
+    TF_AXIOM(collections.size() == 1);
+    return collections[0];
+}
+
+static void
+TestMinimumScopeDuration()
+{
+    std::cout << "Testing minimum scope duration\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    TF_AXIOM(collector.GetMinimumScopeDuration() == 0);
+    collector.SetMinimumScopeDuration(100);
+    TF_AXIOM(collector.GetMinimumScopeDuration() == 100);
+    TF_AXIOM(collector.GetMinimumScopeDuration(PerfCategory::GetId()) == 100);
+
+    const int numThreads = 4;
+    const int numScopes = 1000;
+    RecordScopes(numThreads, numScopes);
+
+    std::shared_ptr<TraceCollection> collection = GetCollection(*source);
+
+    // Only the long scopes are stored.
+    TimespanCounter counter;
+    collection->IterateBatches(counter);
+    TF_AXIOM(counter.counts.size() == 1);
+    TF_AXIOM(counter.counts[TfToken("Long")] == numThreads * numScopes);
+
+    // Short scopes are tallied.
+    TraceCollection::ScopeTallyMap tallies = collection->GetScopeTallies();
+    TF_AXIOM(tallies.size() == 2);
+    TF_AXIOM(tallies[TfToken("Short")].count == numThreads * numScopes);
+    TF_AXIOM(tallies[TfToken("Short")].duration ==
+        uint64_t(numThreads * numScopes * 10));
+    TF_AXIOM(tallies[TfToken("Perf")].count == numThreads * numScopes);
+
+    // The total time of the keys is accurate.
+    TraceEventTreeRefPtr eventTree = TraceEventTree::New(*collection);
+    TraceAggregateTreeRefPtr aggregateTree = TraceAggregateTree::New();
+    aggregateTree->Append(eventTree, *collection);
+    const TraceAggregateTree::EventTimes& times =
+        aggregateTree->GetEventTimes();
+    TF_AXIOM(times.at(TfToken("Long")) ==
+        uint64_t(numThreads * numScopes * 1000));
+    TF_AXIOM(times.at(TfToken("Short")) ==
+        uint64_t(numThreads * numScopes * 10));
+
+    // Slices have no tallies.
+    TF_AXIOM(collection->Slice(0, ~uint64_t(0)).GetScopeTallies().empty());
+
+    std::cout << " PASSED\n";
+
+    std::cout << "Testing minimum scope duration per category\n";
+
+    // The category overrides the global duration.
+    collector.SetMinimumScopeDuration(PerfCategory::GetId(), 0);
+    TF_AXIOM(collector.GetMinimumScopeDuration(PerfCategory::GetId()) == 0);
+    RecordScopes(1, 10);
+    collection = GetCollection(*source);
+    counter.counts.clear();
+    collection->IterateBatches(counter);
+    TF_AXIOM(counter.counts[TfToken("Perf")] == 10);
+    TF_AXIOM(counter.counts.count(TfToken("Short")) == 0);
+
+    collector.ResetMinimumScopeDuration(PerfCategory::GetId());
+    TF_AXIOM(collector.GetMinimumScopeDuration(PerfCategory::GetId()) == 100);
+
+    // Every scope is stored once the duration is reset.
+    collector.SetMinimumScopeDuration(0);
+    RecordScopes(1, 10);
+    collection = GetCollection(*source);
+    counter.counts.clear();
+    collection->IterateBatches(counter);
+    TF_AXIOM(counter.counts.size() == 3);
+    TF_AXIOM(collection->GetScopeTallies().empty());
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestMinimumScopeDuration();
+}
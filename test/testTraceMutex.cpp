@@ -0,0 +1,274 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/aggregateTree.h>
+#include <pxr/trace/lockContention.h>
+#include <pxr/trace/mutex.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/timing.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Lock = TraceLockContention::Lock;
+
+static TraceEvent::TimeStamp
+Ms(double ms)
+{
+    return ArchSecondsToTicks(ms / 1e3);
+}
+
+static const Lock*
+FindLock(const TraceLockContentionRefPtr& contention, const std::string& name)
+{
+    for (const Lock& lock : contention->GetLocks()) {
+        if (lock.name == name) {
+            return &lock;
+        }
+    }
+    return nullptr;
+}
+
+static void
+TestTree()
+{
+    std::cout << "Testing tree\n";
+
+    // Two threads wait for A in Main, and one of them waits for B while
+    // holding A.
+    const TraceAggregateNode::Id id = TraceReporter::CreateValidEventId();
+    TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+    TraceAggregateNodeRefPtr main1 = tree->GetRoot()
+        ->Append(id, TfToken("Thread 1"), Ms(20.0))
+        ->Append(id, TfToken("Main"), Ms(20.0));
+    main1->Append(id, TfToken("[wait] A"), Ms(2.0), 2, 2);
+    main1->Append(id, TfToken("[hold] A"), Ms(5.0))
+        ->Append(id, TfToken("[wait] B"), Ms(1.0));
+    TraceAggregateNodeRefPtr main2 = tree->GetRoot()
+        ->Append(id, TfToken("Thread 2"), Ms(20.0))
+        ->Append(id, TfToken("Main"), Ms(20.0));
+    main2->Append(id, TfToken("[wait] A"), Ms(3.0));
+    main2->Append(id, TfToken("Other"), Ms(1.0))
+        ->Append(id, TfToken("[wait] A"), Ms(4.0));
+    main2->Append(id, TfToken("[hold] C"), Ms(1.0));
+
+    TraceLockContentionRefPtr contention = TraceLockContention::New(tree);
+
+    // C was never waited for, and locks are ordered by wait time.
+    TF_AXIOM(contention->GetLocks().size() == 2);
+    const Lock& a = contention->GetLocks()[0];
+    const Lock& b = contention->GetLocks()[1];
+    TF_AXIOM(a.name == "A" && b.name == "B");
+
+    TF_AXIOM(a.waitTime == Ms(9.0));
+    TF_AXIOM(a.waitCount == 4);
+    TF_AXIOM(a.holdTime == Ms(5.0));
+    TF_AXIOM(a.holdCount == 1);
+
+    // The waits of the threads in Main are merged.
+    TF_AXIOM(a.callPaths.size() == 2);
+    TF_AXIOM(a.callPaths[0].path ==
+        std::vector<TfToken>({TfToken("Main")}));
+    TF_AXIOM(a.callPaths[0].waitTime == Ms(5.0));
+    TF_AXIOM(a.callPaths[0].waitCount == 3);
+    TF_AXIOM(a.callPaths[1].path ==
+        std::vector<TfToken>({TfToken("Main"), TfToken("Other")}));
+
+    TF_AXIOM(b.callPaths.size() == 1);
+    TF_AXIOM(b.callPaths[0].path ==
+        std::vector<TfToken>({TfToken("Main"), TfToken("[hold] A")}));
+
+    std::ostringstream report;
+    contention->Report(report, 1, 1);
+    std::cout << report.str();
+    TF_AXIOM(report.str().find("Main > Other") == std::string::npos);
+    TF_AXIOM(report.str().find("1 other call paths") != std::string::npos);
+    TF_AXIOM(report.str().find("1 other locks") != std::string::npos);
+
+    std::cout << " PASSED\n";
+}
+
+// Holds mutex in a scope while another thread waits for it in a scope.
+template <class Mutex>
+static void
+Contend(Mutex& mutex)
+{
+    std::atomic<bool> held(false);
+    std::thread holder([&]() {
+        TRACE_SCOPE("Holder");
+        std::lock_guard<Mutex> lock(mutex);
+        held = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    while (!held) {}
+    {
+        TRACE_SCOPE("Waiter");
+        typename Mutex::scoped_lock lock(mutex);
+    }
+    holder.join();
+}
+
+template <class Mutex>
+static void
+TestContention(const std::string& name)
+{
+    std::cout << "Testing contention of " << name << "\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterPtr reporter = TraceReporter::GetGlobalReporter();
+    reporter->ClearTree();
+
+    Mutex mutex(name);
+
+    // Nothing is recorded while collection is disabled.
+    Contend(mutex);
+
+    collector.SetEnabled(true);
+
+    // Nothing is recorded for a mutex which is not contended.
+    for (int i = 0; i < 100; ++i) {
+        std::lock_guard<Mutex> lock(mutex);
+    }
+    TF_AXIOM(mutex.try_lock());
+    mutex.unlock();
+
+    Contend(mutex);
+    collector.SetEnabled(false);
+    reporter->UpdateTraceTrees();
+
+    TraceLockContentionRefPtr contention =
+        TraceLockContention::New(reporter->GetAggregateTree());
+    TF_AXIOM(contention->GetLocks().size() == 1);
+    const Lock* lock = FindLock(contention, name);
+    TF_AXIOM(lock);
+    TF_AXIOM(lock->waitCount == 1);
+    TF_AXIOM(lock->waitTime > 0);
+    TF_AXIOM(lock->holdCount == 1);
+    TF_AXIOM(lock->callPaths.size() == 1);
+    TF_AXIOM(lock->callPaths[0].path ==
+        std::vector<TfToken>({TfToken("Waiter")}));
+
+    std::ostringstream report;
+    reporter->ReportContention(report);
+    std::cout << report.str();
+    TF_AXIOM(report.str().find(name) != std::string::npos);
+    TF_AXIOM(report.str().find("Waiter") != std::string::npos);
+
+    std::cout << " PASSED\n";
+}
+
+template <class Mutex>
+static void
+TestNestedContention(const std::string& name)
+{
+    std::cout << "Testing nested contention of " << name << "\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterPtr reporter = TraceReporter::GetGlobalReporter();
+    reporter->ClearTree();
+
+    const std::string outerName = name + " Outer";
+    const std::string innerName = name + " Inner";
+    Mutex outer(outerName);
+    Mutex inner(innerName);
+
+    collector.SetEnabled(true);
+
+    // The waiter waits for the outer mutex, then for the inner one in a
+    // scope nested in the hold of the outer mutex. The scopes of the inner
+    // mutex are recorded before the ones of the outer mutex.
+    std::atomic<bool> held(false);
+    std::thread holder([&]() {
+        TRACE_SCOPE("Holder");
+        outer.lock();
+        inner.lock();
+        held = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        outer.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        inner.unlock();
+    });
+    while (!held) {}
+    {
+        TRACE_SCOPE("Waiter");
+        std::lock_guard<Mutex> outerLock(outer);
+        {
+            TRACE_SCOPE("Nested");
+            std::lock_guard<Mutex> innerLock(inner);
+        }
+    }
+    holder.join();
+
+    collector.SetEnabled(false);
+    reporter->UpdateTraceTrees();
+
+    TraceLockContentionRefPtr contention =
+        TraceLockContention::New(reporter->GetAggregateTree());
+    TF_AXIOM(contention->GetLocks().size() == 2);
+
+    const Lock* outerLock = FindLock(contention, outerName);
+    TF_AXIOM(outerLock);
+    TF_AXIOM(outerLock->callPaths.size() == 1);
+    TF_AXIOM(outerLock->callPaths[0].path ==
+        std::vector<TfToken>({TfToken("Waiter")}));
+
+    const Lock* innerLock = FindLock(contention, innerName);
+    TF_AXIOM(innerLock);
+    TF_AXIOM(innerLock->callPaths.size() == 1);
+    TF_AXIOM(innerLock->callPaths[0].path ==
+        std::vector<TfToken>({TfToken("Waiter"),
+            TfToken(TraceLockCategory::HoldPrefix + outerName),
+            TfToken("Nested")}));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestCategory()
+{
+    std::cout << "Testing category\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterPtr reporter = TraceReporter::GetGlobalReporter();
+    reporter->ClearTree();
+
+    TraceMutex mutex("Disabled");
+
+    // Nothing is recorded while the category is disabled.
+    collector.SetEnabled(true);
+    TraceLockCategory::SetEnabled(false);
+    TF_AXIOM(!TraceLockCategory::IsEnabled());
+    Contend(mutex);
+    TraceLockCategory::SetEnabled(true);
+    TF_AXIOM(TraceLockCategory::IsEnabled());
+    collector.SetEnabled(false);
+    TF_AXIOM(!TraceLockCategory::IsEnabled());
+    reporter->UpdateTraceTrees();
+
+    TraceLockContentionRefPtr contention =
+        TraceLockContention::New(reporter->GetAggregateTree());
+    TF_AXIOM(contention->GetLocks().empty());
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestTree();
+    TestContention<TraceMutex>("TraceMutex");
+    TestContention<TraceSpinMutex>("TraceSpinMutex");
+    TestNestedContention<TraceMutex>("TraceMutex");
+    TestNestedContention<TraceSpinMutex>("TraceSpinMutex");
+    TestCategory();
+}
@@ -0,0 +1,194 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+// Measures how much recording events slows down the code being traced,
+// rather than the cost of recording them.
+//
+// Usage: testTracePerturbationPerf [CHUNKS [OUTPUT]]
+//
+// The instrumented kernel chases pointers through a random cycle over a
+// working set that fits in the caches, with a scope recorded around each
+// chunk of accesses. It runs CHUNKS chunks (default 200000) untraced, and
+// traced with regular and with non-temporal stores. The perturbation of a
+// chunk is its traced duration minus its untraced duration and minus the
+// duration of an empty scope, i.e. the time lost to the caches evicted by
+// the events. The results are written as JSON to OUTPUT (default
+// perturbationperf.json).
+
+#include <pxr/trace/trace.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/eventContainer.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/stopwatch.h>
+#include <pxr/js/json.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+// The number of accesses of each chunk of the kernel.
+static const size_t AccessesPerChunk = 64;
+
+// Chases pointers through a random cycle over a working set.
+class Kernel {
+public:
+    explicit Kernel(size_t bytes)
+        : _next(bytes / sizeof(uint32_t)) {
+        std::vector<uint32_t> order(_next.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin() + 1, order.end(), std::mt19937(42));
+        for (size_t i = 0; i < order.size(); ++i) {
+            _next[order[i]] = order[(i + 1) % order.size()];
+        }
+    }
+
+    uint32_t Run(uint32_t index) const {
+        for (size_t i = 0; i < AccessesPerChunk; ++i) {
+            index = _next[index];
+        }
+        return index;
+    }
+
+private:
+    std::vector<uint32_t> _next;
+};
+
+enum class Mode {
+    Untraced,
+    Regular,
+    NonTemporal,
+};
+
+static const char*
+GetModeName(Mode mode)
+{
+    switch (mode) {
+        case Mode::Untraced: return "untraced";
+        case Mode::Regular: return "regular";
+        case Mode::NonTemporal: return "nonTemporal";
+    }
+    return "";
+}
+
+// Returns the number of seconds per chunk to run \p chunks chunks of
+// \p kernel, or of empty scopes if \p kernel is null, in \p mode.
+static double
+Run(const Kernel* kernel, size_t chunks, Mode mode)
+{
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.Clear();
+    if (mode == Mode::NonTemporal) {
+        TF_AXIOM(TraceEventContainer::SetNonTemporalStoresEnabled(true));
+    }
+    collector.SetEnabled(mode != Mode::Untraced);
+
+    static volatile uint32_t sink = 0;
+    uint32_t index = 0;
+    TfStopwatch watch;
+    watch.Start();
+    for (size_t i = 0; i < chunks; ++i) {
+        TRACE_SCOPE("Chunk");
+        if (kernel) {
+            index = kernel->Run(index);
+        }
+    }
+    watch.Stop();
+    sink = index;
+
+    collector.SetEnabled(false);
+    TraceEventContainer::SetNonTemporalStoresEnabled(false);
+    collector.Clear();
+    return watch.GetSeconds() / chunks;
+}
+
+struct Result {
+    size_t workingSet;
+    std::string mode;
+    double nsPerChunk;
+    double nsPerScope;
+    double nsPerturbation;
+};
+
+static void
+WriteResults(std::ostream& s, size_t chunks,
+    const std::vector<Result>& results)
+{
+    JsWriter js(s, JsWriter::Style::Pretty);
+    js.BeginObject();
+    js.WriteKeyValue("benchmark", "testTracePerturbationPerf");
+    js.WriteKeyValue("chunks", uint64_t(chunks));
+    js.WriteKeyValue("accessesPerChunk", uint64_t(AccessesPerChunk));
+    js.WriteKey("results");
+    js.WriteArray(results, [](JsWriter& js, const Result& r) {
+        js.WriteObject(
+            "workingSet", uint64_t(r.workingSet),
+            "mode", r.mode,
+            "nsPerChunk", r.nsPerChunk,
+            "nsPerScope", r.nsPerScope,
+            "nsPerturbation", r.nsPerturbation);
+    });
+    js.EndObject();
+    s << "\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    const size_t chunks = argc > 1 ? std::max(1, atoi(argv[1])) : 200000;
+    const std::string output = argc > 2 ? argv[2] : "perturbationperf.json";
+
+    const bool nonTemporal =
+        TraceEventContainer::SetNonTemporalStoresEnabled(true);
+    TraceEventContainer::SetNonTemporalStoresEnabled(false);
+    if (!nonTemporal) {
+        printf("Non-temporal stores are not supported on this platform\n");
+    }
+
+    std::vector<Mode> modes = { Mode::Regular };
+    if (nonTemporal) {
+        modes.push_back(Mode::NonTemporal);
+    }
+
+    // Working sets which fit in the L1 and L2 caches, and in a slice of the
+    // L3 cache.
+    const std::vector<size_t> workingSets = {
+        16 * 1024, 256 * 1024, 2 * 1024 * 1024 };
+
+    std::vector<Result> results;
+    for (size_t bytes : workingSets) {
+        const Kernel kernel(bytes);
+
+        // Warm up the caches.
+        Run(&kernel, chunks, Mode::Untraced);
+        const double untraced = Run(&kernel, chunks, Mode::Untraced);
+        results.push_back(
+            {bytes, GetModeName(Mode::Untraced), untraced * 1e9, 0.0, 0.0});
+        printf("working set: %8zu  %-12s ns/chunk: %8.2f\n",
+            bytes, GetModeName(Mode::Untraced), untraced * 1e9);
+
+        for (Mode mode : modes) {
+            const double scope = Run(nullptr, chunks, mode);
+            const double traced = Run(&kernel, chunks, mode);
+            const double perturbation = traced - untraced - scope;
+            results.push_back({bytes, GetModeName(mode), traced * 1e9,
+                scope * 1e9, perturbation * 1e9});
+            printf("working set: %8zu  %-12s ns/chunk: %8.2f  "
+                "ns/scope: %8.2f  perturbation: %8.2f ns\n",
+                bytes, GetModeName(mode), traced * 1e9, scope * 1e9,
+                perturbation * 1e9);
+        }
+    }
+
+    std::ofstream file(output.c_str());
+    WriteResults(file, chunks, results);
+    return 0;
+}
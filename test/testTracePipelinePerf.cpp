@@ -0,0 +1,285 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+// Measures each stage of processing synthetic collections of various shapes.
+//
+// Usage: testTracePipelinePerf [SCALE [OUTPUT]]
+//
+// SCALE (default 1) multiplies the number of top level scopes of every
+// shape. The results are written as JSON to OUTPUT (default
+// pipelineperf.json).
+
+#include <pxr/trace/aggregateTree.h>
+#include <pxr/trace/collectionGenerator.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/reporterDataSourceCollection.h>
+#include <pxr/trace/serialization.h>
+#include <pxr/tf/stopwatch.h>
+#include <pxr/arch/defines.h>
+#include <pxr/arch/timing.h>
+#include <pxr/js/json.h>
+
+#if defined(ARCH_OS_DARWIN)
+#include <mach/mach.h>
+#endif
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+// Returns the value in bytes of the kB field \p name of /proc/self/status, or
+// zero if it is not available.
+static size_t
+ReadProcStatusBytes(const std::string& name)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, name.size(), name) == 0 &&
+            line.size() > name.size() && line[name.size()] == ':') {
+            return size_t(std::stoull(line.substr(name.size() + 1))) * 1024;
+        }
+    }
+    return 0;
+}
+
+// Resets the peak resident memory of the process to its current resident
+// memory. Returns false if the peak cannot be reset on this platform.
+static bool
+ResetPeakResidentMemory()
+{
+#if defined(ARCH_OS_LINUX)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return clearRefs.good() && ReadProcStatusBytes("VmHWM") != 0;
+#else
+    return false;
+#endif
+}
+
+// Returns the peak resident memory of the process since the last call to
+// ResetPeakResidentMemory() in bytes.
+static size_t
+GetPeakResidentMemory()
+{
+    return ReadProcStatusBytes("VmHWM");
+}
+
+// Returns the current resident memory of the process in bytes, or zero if it
+// is not available on this platform.
+static size_t
+GetResidentMemory()
+{
+#if defined(ARCH_OS_LINUX)
+    return ReadProcStatusBytes("VmRSS");
+#elif defined(ARCH_OS_DARWIN)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+            reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return size_t(info.resident_size);
+#else
+    return 0;
+#endif
+}
+
+// Counts the events of a collection.
+class EventCounter {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& span) {
+        count += span.size();
+    }
+
+    size_t count = 0;
+};
+
+struct StageResult {
+    std::string shape;
+    std::string stage;
+    size_t events;
+    double seconds;
+    // The peak resident memory during the stage if it could be measured,
+    // otherwise the change in resident memory over the stage.
+    int64_t rss;
+    bool rssIsPeak;
+};
+
+static std::vector<StageResult> results;
+
+static void
+RunStage(
+    const std::string& shape,
+    const std::string& stage,
+    size_t events,
+    const std::function<void()>& fn)
+{
+    const bool rssIsPeak = ResetPeakResidentMemory();
+    const size_t rssBefore = GetResidentMemory();
+
+    TfStopwatch watch;
+    watch.Start();
+    fn();
+    watch.Stop();
+
+    const int64_t rss = rssIsPeak
+        ? int64_t(GetPeakResidentMemory())
+        : int64_t(GetResidentMemory()) - int64_t(rssBefore);
+
+    results.push_back(
+        {shape, stage, events, watch.GetSeconds(), rss, rssIsPeak});
+    const StageResult& r = results.back();
+    printf("%-18s %-16s events: %10zu  seconds: %9.4f  events/sec: %12.0f  "
+        "%s: %8.1f MB\n",
+        r.shape.c_str(), r.stage.c_str(), r.events, r.seconds,
+        r.events / r.seconds, r.rssIsPeak ? "peak RSS" : "RSS delta",
+        r.rss / (1024.0 * 1024.0));
+}
+
+static void
+RunPipeline(
+    const std::string& name, const TraceCollectionGenerator::Shape& shape)
+{
+    std::shared_ptr<TraceCollection> collection;
+    const size_t expectedEvents =
+        size_t(TraceCollectionGenerator::GetExpectedEventCount(shape));
+    RunStage(name, "generate", expectedEvents, [&]() {
+        collection = TraceCollectionGenerator::Generate(shape);
+    });
+    TF_AXIOM(collection);
+
+    EventCounter counter;
+    collection->IterateBatches(counter);
+    const size_t events = counter.count;
+    if (shape.countersPerScope == std::floor(shape.countersPerScope)) {
+        TF_AXIOM(events == expectedEvents);
+    }
+
+    TraceEventTreeRefPtr eventTree;
+    RunStage(name, "eventTree", events, [&]() {
+        eventTree = TraceEventTree::New(*collection);
+    });
+
+    TraceAggregateTreeRefPtr aggregateTree = TraceAggregateTree::New();
+    RunStage(name, "aggregateTree", events, [&]() {
+        aggregateTree->Append(eventTree, *collection);
+    });
+
+    RunStage(name, "adjustOverhead", events, [&]() {
+        aggregateTree->GetRoot()->AdjustForOverheadAndNoise(
+            10, ArchGetTickQuantum());
+    });
+
+    RunStage(name, "markRecursive", events, [&]() {
+        aggregateTree->GetRoot()->MarkRecursiveChildren();
+    });
+
+    std::stringstream json;
+    RunStage(name, "jsonWrite", events, [&]() {
+        TF_AXIOM(TraceSerialization::Write(json, collection));
+    });
+
+    RunStage(name, "jsonRead", events, [&]() {
+        TF_AXIOM(TraceSerialization::Read(json));
+    });
+
+    std::stringstream report;
+    RunStage(name, "report", events, [&]() {
+        TraceReporterRefPtr reporter = TraceReporter::New("Pipeline",
+            TraceReporterDataSourceCollection::New(collection));
+        reporter->Report(report);
+    });
+
+    RunStage(name, "loadReport", events, [&]() {
+        TF_AXIOM(!TraceReporter::LoadReport(report).empty());
+    });
+}
+
+static void
+WriteResults(std::ostream& s)
+{
+    JsWriter js(s, JsWriter::Style::Pretty);
+    js.BeginObject();
+    js.WriteKeyValue("benchmark", "testTracePipelinePerf");
+    js.WriteKey("results");
+    js.WriteArray(results, [](JsWriter& js, const StageResult& r) {
+        js.WriteObject(
+            "shape", r.shape,
+            "stage", r.stage,
+            "events", uint64_t(r.events),
+            "seconds", r.seconds,
+            "eventsPerSecond", r.events / r.seconds,
+            r.rssIsPeak ? "peakRssBytes" : "rssDeltaBytes", r.rss);
+    });
+    js.EndObject();
+    s << "\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    const int scale = argc > 1 ? std::max(1, atoi(argv[1])) : 1;
+    const std::string output = argc > 2 ? argv[2] : "pipelineperf.json";
+
+    using Shape = TraceCollectionGenerator::Shape;
+    std::vector<std::pair<std::string, Shape>> shapes;
+
+    Shape base;
+    base.iterations = 50 * scale;
+    shapes.emplace_back("base", base);
+
+    Shape deep = base;
+    deep.depth = 12;
+    deep.fanOut = 2;
+    deep.iterations = 4 * scale;
+    shapes.emplace_back("deep", deep);
+
+    Shape wide = base;
+    wide.depth = 2;
+    wide.fanOut = 256;
+    shapes.emplace_back("wide", wide);
+
+    Shape manyThreads = base;
+    manyThreads.numThreads = 64;
+    manyThreads.iterations = 4 * scale;
+    shapes.emplace_back("manyThreads", manyThreads);
+
+    Shape manyKeys = base;
+    manyKeys.numKeys = 100000;
+    shapes.emplace_back("manyKeys", manyKeys);
+
+    Shape recursive = base;
+    recursive.numKeys = 2;
+    shapes.emplace_back("recursive", recursive);
+
+    Shape counters = base;
+    counters.countersPerScope = 4.0;
+    counters.numCounters = 16;
+    shapes.emplace_back("counters", counters);
+
+    for (const auto& shape : shapes) {
+        RunPipeline(shape.first, shape.second);
+    }
+
+    std::ofstream file(output.c_str());
+    WriteResults(file);
+    return 0;
+}
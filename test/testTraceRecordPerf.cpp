@@ -0,0 +1,251 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+// Measures the cost of recording events into the TraceCollector from many
+// threads at once.
+//
+// Usage: testTraceRecordPerf [MAX_THREADS [EVENTS_PER_THREAD [OUTPUT]]]
+//
+// Thread counts are swept in powers of two up to MAX_THREADS (default 4) for
+// each event type. The results are written as JSON to OUTPUT (default
+// recordperf.json).
+
+#include <pxr/trace/trace.h>
+#include <pxr/trace/collector.h>
+#include <pxr/tf/stopwatch.h>
+#include <pxr/tf/stringUtils.h>
+#include <pxr/js/json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+// A workload records \p n operations from thread \p threadIndex and returns
+// the number of events it recorded.
+using Workload = size_t (*)(int threadIndex, size_t n);
+
+static size_t
+RecordStaticScopes(int, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        TRACE_SCOPE("Static Scope");
+    }
+    return n;
+}
+
+static size_t
+RecordDynamicScopes(int threadIndex, size_t n)
+{
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; ++i) {
+        keys.push_back(TfStringPrintf("Dynamic Scope %d %d", threadIndex, i));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        TRACE_SCOPE_DYNAMIC(keys[i % keys.size()]);
+    }
+    return 2 * n;
+}
+
+static size_t
+RecordStringData(int threadIndex, size_t n)
+{
+    static constexpr TraceStaticKeyData dataKey("String Data");
+    const std::string value =
+        TfStringPrintf("A string stored by thread %d", threadIndex);
+    TraceCollector& collector = TraceCollector::GetInstance();
+    for (size_t i = 0; i < n; ++i) {
+        TRACE_SCOPE("Data Scope");
+        collector.StoreData(dataKey, value);
+    }
+    return 2 * n;
+}
+
+static size_t
+RecordCounters(int, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        TRACE_COUNTER_DELTA("Counter", 1);
+    }
+    return n;
+}
+
+// Records scopes the way Trace.TraceScope does from Python, with a dynamic
+// key built from the label of each scope.
+static size_t
+RecordPythonScopes(int, size_t n)
+{
+    const std::string label = "Python func: __main__.Scope";
+    TraceCollector& collector = TraceCollector::GetInstance();
+    for (size_t i = 0; i < n; ++i) {
+        const TraceDynamicKey key(label);
+        collector.BeginEvent(key);
+        collector.EndEvent(key);
+    }
+    return 2 * n;
+}
+
+struct Benchmark {
+    const char* eventType;
+    Workload workload;
+    // Whether collections are created while the workload runs.
+    bool concurrentCollections;
+};
+
+struct Result {
+    std::string eventType;
+    int threads;
+    size_t eventsPerThread;
+    size_t events;
+    size_t collections;
+    double seconds;
+    double bytesPerEvent;
+
+    double GetEventsPerSecond() const { return events / seconds; }
+
+    // The average cost of an event for the thread recording it.
+    double GetNanosecondsPerEvent() const {
+        return seconds * threads / events * 1e9;
+    }
+};
+
+static Result
+Run(const Benchmark& benchmark, int numThreads, size_t opsPerThread)
+{
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.Clear();
+    collector.SetEnabled(true);
+
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::atomic<bool> done(false);
+    std::vector<size_t> events(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            ++ready;
+            while (!go) {
+                std::this_thread::yield();
+            }
+            events[t] = benchmark.workload(t, opsPerThread);
+        });
+    }
+
+    size_t collections = 0;
+    std::thread consumer;
+    if (benchmark.concurrentCollections) {
+        consumer = std::thread([&]() {
+            while (!done) {
+                collector.CreateCollection();
+                ++collections;
+            }
+        });
+    }
+
+    while (ready != numThreads) {
+        std::this_thread::yield();
+    }
+
+    TfStopwatch watch;
+    watch.Start();
+    go = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    watch.Stop();
+
+    done = true;
+    if (consumer.joinable()) {
+        consumer.join();
+    }
+
+    // The collector accounts for the blocks holding the events, their keys
+    // and their data. Collections created concurrently take events out of
+    // the collector, so the accounting only covers the events recorded when
+    // there are none.
+    const size_t memory = benchmark.concurrentCollections
+        ? 0 : collector.GetMemoryUsage().GetTotal();
+    collector.SetEnabled(false);
+    collector.Clear();
+
+    Result result;
+    result.eventType = benchmark.eventType;
+    result.threads = numThreads;
+    result.eventsPerThread = 0;
+    result.events = 0;
+    for (size_t n : events) {
+        result.events += n;
+    }
+    result.eventsPerThread = result.events / numThreads;
+    result.collections = collections;
+    result.seconds = watch.GetSeconds();
+    result.bytesPerEvent = double(memory) / result.events;
+    return result;
+}
+
+static void
+WriteResults(std::ostream& s, const std::vector<Result>& results)
+{
+    JsWriter js(s, JsWriter::Style::Pretty);
+    js.BeginObject();
+    js.WriteKeyValue("benchmark", "testTraceRecordPerf");
+    js.WriteKey("results");
+    js.WriteArray(results, [](JsWriter& js, const Result& r) {
+        js.WriteObject(
+            "eventType", r.eventType,
+            "threads", r.threads,
+            "eventsPerThread", uint64_t(r.eventsPerThread),
+            "events", uint64_t(r.events),
+            "collections", uint64_t(r.collections),
+            "seconds", r.seconds,
+            "eventsPerSecond", r.GetEventsPerSecond(),
+            "nsPerEvent", r.GetNanosecondsPerEvent(),
+            "bytesPerEvent", r.bytesPerEvent);
+    });
+    js.EndObject();
+    s << "\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    const int maxThreads = argc > 1 ? std::max(1, atoi(argv[1])) : 4;
+    const size_t opsPerThread = argc > 2 ?
+        std::max(1, atoi(argv[2])) : 100000;
+    const std::string output = argc > 3 ? argv[3] : "recordperf.json";
+
+    const std::vector<Benchmark> benchmarks = {
+        {"static_scope", RecordStaticScopes, false},
+        {"dynamic_scope", RecordDynamicScopes, false},
+        {"string_data", RecordStringData, false},
+        {"counter_delta", RecordCounters, false},
+        {"python_scope", RecordPythonScopes, false},
+        {"static_scope_concurrent_collection", RecordStaticScopes, true},
+    };
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : benchmarks) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            results.push_back(Run(benchmark, threads, opsPerThread));
+            const Result& r = results.back();
+            printf("%-36s threads: %3d  events/sec: %12.0f  "
+                "ns/event: %8.2f  bytes/event: %7.2f\n",
+                r.eventType.c_str(), r.threads, r.GetEventsPerSecond(),
+                r.GetNanosecondsPerEvent(), r.bytesPerEvent);
+            TF_AXIOM(r.events > 0);
+        }
+    }
+
+    std::ofstream file(output.c_str());
+    WriteResults(file, results);
+    return 0;
+}
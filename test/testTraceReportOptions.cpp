@@ -0,0 +1,208 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collection.h>
+#include <pxr/trace/eventList.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/reporterDataSourceCollection.h>
+#include <pxr/trace/threads.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/timing.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+using Options = TraceReporter::ReportOptions;
+
+// The width of the time and count columns of the tree view.
+static const size_t LabelColumn = 43;
+
+static TraceEvent::TimeStamp
+Ms(double ms)
+{
+    return ArchSecondsToTicks(ms / 1e3);
+}
+
+static void
+AddScope(TraceEventList& events, const char* key, double begin, double end)
+{
+    events.EmplaceBack(TraceEvent::Begin, events.CacheKey(key), Ms(begin),
+        TraceCategory::Default);
+    events.EmplaceBack(TraceEvent::End, events.CacheKey(key), Ms(end),
+        TraceCategory::Default);
+}
+
+// Creates a reporter for a thread with a Main scope of 100 ms calling C, A,
+// D and B, A calling A1 and A2. Times are in milliseconds.
+static TraceReporterRefPtr
+CreateReporter()
+{
+    std::unique_ptr<TraceEventList> events(new TraceEventList);
+    events->EmplaceBack(TraceEvent::Begin, events->CacheKey("Main"), Ms(0.0),
+        TraceCategory::Default);
+    AddScope(*events, "C", 0.0, 1.0);
+    events->EmplaceBack(TraceEvent::Begin, events->CacheKey("A"), Ms(1.0),
+        TraceCategory::Default);
+    AddScope(*events, "A1", 1.0, 41.0);
+    AddScope(*events, "A2", 41.0, 46.0);
+    events->EmplaceBack(TraceEvent::End, events->CacheKey("A"), Ms(51.0),
+        TraceCategory::Default);
+    AddScope(*events, "D", 51.0, 51.5);
+    AddScope(*events, "B", 51.5, 81.5);
+    events->EmplaceBack(TraceEvent::End, events->CacheKey("Main"), Ms(100.0),
+        TraceCategory::Default);
+
+    std::shared_ptr<TraceCollection> collection(new TraceCollection);
+    collection->AddToCollection(TraceThreadId("Thread 1"), std::move(events));
+
+    TraceReporterRefPtr reporter = TraceReporter::New(
+        "Test", TraceReporterDataSourceCollection::New(collection));
+    reporter->SetShouldAdjustForOverheadAndNoise(false);
+    return reporter;
+}
+
+// Returns the lines of the tree view written with options.
+static std::vector<std::string>
+Report(const TraceReporterRefPtr& reporter, const Options& options)
+{
+    reporter->SetReportOptions(options);
+    std::ostringstream os;
+    reporter->Report(os);
+
+    std::vector<std::string> lines;
+    std::istringstream is(os.str());
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.size() > LabelColumn) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+// Returns the labels of lines, without their indentation.
+static std::vector<std::string>
+GetLabels(const std::vector<std::string>& lines)
+{
+    std::vector<std::string> labels;
+    for (const std::string& line : lines) {
+        labels.push_back(
+            line.substr(line.find_first_not_of(" |", LabelColumn)));
+    }
+    return labels;
+}
+
+static const std::string&
+FindLine(const std::vector<std::string>& lines, const std::string& label)
+{
+    for (const std::string& line : lines) {
+        if (line.size() >= label.size() &&
+            line.compare(line.size() - label.size(), label.size(), label)
+                == 0) {
+            return line;
+        }
+    }
+    TF_FATAL_ERROR("Missing line %s", label.c_str());
+    return lines.front();
+}
+
+static void
+TestDefault()
+{
+    std::cout << "Testing default options\n";
+
+    TraceReporterRefPtr reporter = CreateReporter();
+    const std::vector<std::string> lines = Report(reporter, Options());
+    TF_AXIOM((GetLabels(lines) == std::vector<std::string>{
+        "Thread 1", "Main", "C", "A", "A1", "A2", "D", "B"}));
+    TF_AXIOM(FindLine(lines, "A2").find("    5.000 ms ") == 0);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestSort()
+{
+    std::cout << "Testing sort\n";
+
+    TraceReporterRefPtr reporter = CreateReporter();
+    Options options;
+    options.sortOrder = Options::SortOrder::InclusiveTime;
+    TF_AXIOM((GetLabels(Report(reporter, options)) ==
+        std::vector<std::string>{
+            "Thread 1", "Main", "A", "A1", "A2", "B", "C", "D"}));
+
+    options.sortOrder = Options::SortOrder::ExclusiveTime;
+    TF_AXIOM((GetLabels(Report(reporter, options)) ==
+        std::vector<std::string>{
+            "Thread 1", "Main", "B", "A", "A1", "A2", "C", "D"}));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestThresholds()
+{
+    std::cout << "Testing thresholds\n";
+
+    TraceReporterRefPtr reporter = CreateReporter();
+    Options options;
+    options.minimumTime = 2.0;
+    std::vector<std::string> lines = Report(reporter, options);
+    TF_AXIOM((GetLabels(lines) == std::vector<std::string>{
+        "Thread 1", "Main", "A", "A1", "A2", "B", "(2 others)"}));
+
+    // The pruned nodes are summed in the others line.
+    const std::string& others = FindLine(lines, "(2 others)");
+    TF_AXIOM(others.find("    1.500 ms     1.500 ms       2 samples") == 0);
+
+    // Percentages are relative to the time of the thread.
+    options.minimumTime = 0.0;
+    options.minimumPercentage = 10.0;
+    lines = Report(reporter, options);
+    TF_AXIOM((GetLabels(lines) == std::vector<std::string>{
+        "Thread 1", "Main", "A", "A1", "(1 other)", "B", "(2 others)"}));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestLimits()
+{
+    std::cout << "Testing limits\n";
+
+    TraceReporterRefPtr reporter = CreateReporter();
+    Options options;
+    options.maxChildren = 1;
+    TF_AXIOM((GetLabels(Report(reporter, options)) ==
+        std::vector<std::string>{
+            "Thread 1", "Main", "A", "A1", "(1 other)", "(3 others)"}));
+
+    // Children are kept in their order unless they are sorted.
+    options.maxChildren = 2;
+    TF_AXIOM((GetLabels(Report(reporter, options)) ==
+        std::vector<std::string>{
+            "Thread 1", "Main", "A", "A1", "A2", "B", "(2 others)"}));
+
+    options.maxChildren = 0;
+    options.maxDepth = 3;
+    TF_AXIOM((GetLabels(Report(reporter, options)) ==
+        std::vector<std::string>{"Thread 1", "Main", "C", "A", "D", "B"}));
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestDefault();
+    TestSort();
+    TestThresholds();
+    TestLimits();
+}
@@ -6,6 +6,7 @@
 // Modified by Jeremy Retailleau.
 
 #include <pxr/trace/trace.h>
+#include <pxr/trace/aggregateTree.h>
 #include <pxr/trace/eventTree.h>
 #include <pxr/trace/reporter.h>
 #include <pxr/trace/reporterDataSourceCollector.h>
@@ -14,6 +15,8 @@
 #include <pxr/tf/stringUtils.h>
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 TRACE_NAMESPACE_USING_DIRECTIVE
 
@@ -54,6 +57,39 @@ CreateTrace(int N, int R)
     return collection;
 }
 
+// Creates a trace of N scopes with many distinct call paths, which stresses
+// the aggregate tree rather than the event tree.
+std::shared_ptr<TraceCollection>
+CreateWideTrace(int N)
+{
+    std::vector<TraceDynamicKey> outerKeys;
+    for (int i = 0; i < 1000; ++i) {
+        outerKeys.emplace_back("Outer " + std::to_string(i));
+    }
+    std::vector<TraceDynamicKey> innerKeys;
+    for (int i = 0; i < 97; ++i) {
+        innerKeys.emplace_back("Inner " + std::to_string(i));
+    }
+
+    std::unique_ptr<TraceReporterDataSourceCollector> dataSrc =
+        TraceReporterDataSourceCollector::New();
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.SetEnabled(true);
+    for (int i = 0; i < N/2; i++) {
+        const TraceDynamicKey& outer = outerKeys[i % outerKeys.size()];
+        const TraceDynamicKey& inner = innerKeys[i % innerKeys.size()];
+        collector.BeginEvent(outer);
+        collector.BeginEvent(inner);
+        collector.EndEvent(inner);
+        collector.EndEvent(outer);
+    }
+    collector.SetEnabled(false);
+    std::shared_ptr<TraceCollection> collection = 
+        dataSrc->ConsumeData()[0];
+    TraceReporter::GetGlobalReporter()->ClearTree();
+    return collection;
+}
+
 int main(int argc, char* argv[])
 {
     FILE *statsFile = fopen("perfstats.raw", "w");
@@ -106,7 +142,72 @@ int main(int argc, char* argv[])
                 << watch.GetSeconds()
                 << " scopes/msec: " << float(size)/watch.GetMilliseconds()
                 << std::endl;
+
+            // The event tree is built and dropped on its own, since
+            // releasing large trees used to be a significant cost.
+            watch.Reset();
+            watch.Start();
+            TraceEventTreeRefPtr eventTree = TraceEventTree::New(*collection);
+            watch.Stop();
+            WriteStats( statsFile,
+                        TfStringPrintf("event tree R %d N %d", R, size),
+                        watch);
+
+            watch.Reset();
+            watch.Start();
+            eventTree = TraceEventTreeRefPtr();
+            watch.Stop();
+            WriteStats( statsFile,
+                        TfStringPrintf("event tree release R %d N %d", R, size),
+                        watch);
+            std::cout << "Event Tree Release N: " << size << " time: "
+                << watch.GetSeconds() << std::endl;
+        }
+    }
+
+    // Building, merging and releasing aggregate trees with many distinct
+    // call paths.
+    for (size_t i = 0; i < maxTestSize; ++i) {
+        int size = testSizes[i];
+        auto collection = CreateWideTrace(size);
+        TraceEventTreeRefPtr eventTree = TraceEventTree::New(*collection);
+
+        watch.Reset();
+        watch.Start();
+        TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+        tree->Append(eventTree, *collection);
+        watch.Stop();
+        WriteStats( statsFile,
+                    TfStringPrintf("aggregate tree N %d", size),
+                    watch);
+        std::cout << "Aggregate Tree N: " << size << " time: "
+            << watch.GetSeconds() << std::endl;
+
+        TraceAggregateTreeRefPtr other = TraceAggregateTree::New();
+        other->Append(eventTree, *collection);
+        watch.Reset();
+        watch.Start();
+        for (const TraceAggregateNodeRefPtr& child
+                : other->GetRoot()->GetChildrenRef()) {
+            tree->GetRoot()->Append(child);
         }
+        watch.Stop();
+        WriteStats( statsFile,
+                    TfStringPrintf("aggregate tree merge N %d", size),
+                    watch);
+        std::cout << "Aggregate Tree Merge N: " << size << " time: "
+            << watch.GetSeconds() << std::endl;
+
+        watch.Reset();
+        watch.Start();
+        tree = TraceAggregateTreeRefPtr();
+        other = TraceAggregateTreeRefPtr();
+        watch.Stop();
+        WriteStats( statsFile,
+                    TfStringPrintf("aggregate tree release N %d", size),
+                    watch);
+        std::cout << "Aggregate Tree Release N: " << size << " time: "
+            << watch.GetSeconds() << std::endl;
     }
     fclose(statsFile);
     return 0;
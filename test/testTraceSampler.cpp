@@ -0,0 +1,292 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collection.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/eventList.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/reporterDataSourceCollection.h>
+#include <pxr/trace/serialization.h>
+#include <pxr/trace/threads.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/defines.h>
+#include <pxr/arch/timing.h>
+
+#if defined(ARCH_OS_LINUX)
+#include <signal.h>
+#endif
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+static const std::string SamplePrefix = "[sample] ";
+
+static TraceEvent::TimeStamp
+Ms(double ms)
+{
+    return ArchSecondsToTicks(ms / 1e3);
+}
+
+// Returns the number of samples among the children of node.
+static int
+CountSamples(const TraceAggregateNodePtr& node)
+{
+    int count = 0;
+    for (const TraceAggregateNodeRefPtr& child : node->GetChildrenRef()) {
+        if (child->GetKey().GetString().compare(
+                0, SamplePrefix.size(), SamplePrefix) == 0) {
+            TF_AXIOM(child->GetInclusiveTime() == 0);
+            count += child->GetCount();
+        }
+    }
+    return count;
+}
+
+// Returns the descendant of node with key, or null.
+static TraceAggregateNodePtr
+FindNode(const TraceAggregateNodePtr& node, const std::string& key)
+{
+    if (node->GetKey().GetString() == key) {
+        return node;
+    }
+    for (const TraceAggregateNodeRefPtr& child : node->GetChildrenRef()) {
+        if (TraceAggregateNodePtr found = FindNode(child, key)) {
+            return found;
+        }
+    }
+    return TraceAggregateNodePtr();
+}
+
+// Counts the Sample events of a collection.
+class SampleCounter : public TraceCollection::Visitor {
+public:
+    void OnBeginCollection() override {}
+    void OnEndCollection() override {}
+    void OnBeginThread(const TraceThreadId&) override {}
+    void OnEndThread(const TraceThreadId&) override {}
+    bool AcceptsCategory(TraceCategoryId) override { return true; }
+    void OnEvent(
+        const TraceThreadId&, const TfToken&, const TraceEvent& e) override {
+        if (e.GetType() == TraceEvent::EventType::Sample) {
+            frames.push_back(e.GetStackFrames());
+        }
+    }
+
+    std::vector<std::vector<uintptr_t>> frames;
+};
+
+static void
+TestAttribution()
+{
+    std::cout << "Testing attribution\n";
+
+    // Samples are attributed to the innermost scope which encloses them,
+    // whatever their order in the list.
+    std::unique_ptr<TraceEventList> events(new TraceEventList);
+    events->EmplaceBack(TraceEvent::Timespan, events->CacheKey("Inner"),
+        Ms(2.0), Ms(4.0), TraceCategory::Default);
+    events->EmplaceBack(TraceEvent::Timespan, events->CacheKey("Outer"),
+        Ms(1.0), Ms(10.0), TraceCategory::Default);
+    const uintptr_t frames[] = { uintptr_t(&Ms), uintptr_t(&CountSamples) };
+    for (double ms : {3.0, 5.0, 2.5, 12.0, 6.0}) {
+        events->EmplaceBack(TraceEvent::Sample, events->CacheKey("Sample"),
+            Ms(ms), events->StoreStackFrames(frames, 2),
+            TraceCategory::Default);
+    }
+
+    std::shared_ptr<TraceCollection> collection(new TraceCollection);
+    collection->AddToCollection(TraceThreadId("Thread 1"), std::move(events));
+    TraceReporterRefPtr reporter = TraceReporter::New(
+        "Test", TraceReporterDataSourceCollection::New(collection));
+    reporter->UpdateTraceTrees();
+
+    const TraceAggregateNodePtr root = reporter->GetAggregateTreeRoot();
+    const TraceAggregateNodePtr thread = FindNode(root, "Thread 1");
+    const TraceAggregateNodePtr outer = FindNode(root, "Outer");
+    const TraceAggregateNodePtr inner = FindNode(root, "Inner");
+    TF_AXIOM(thread && outer && inner);
+    TF_AXIOM(CountSamples(inner) == 2);
+    TF_AXIOM(CountSamples(outer) == 2);
+    TF_AXIOM(CountSamples(thread) == 1);
+
+    // The samples do not change the times of the scopes.
+    TF_AXIOM(outer->GetInclusiveTime() == Ms(9.0));
+    TF_AXIOM(outer->GetExclusiveTime() == Ms(7.0));
+
+    // The samples of a function are merged in one node.
+    TF_AXIOM(inner->GetChildrenRef().size() == 1);
+    TF_AXIOM(inner->GetChildrenRef()[0]->GetCount() == 2);
+
+    // The frames survive serialization.
+    std::stringstream stream;
+    TF_AXIOM(TraceSerialization::Write(stream, collection));
+    std::unique_ptr<TraceCollection> read = TraceSerialization::Read(stream);
+    TF_AXIOM(read);
+    SampleCounter counter;
+    read->Iterate(counter);
+    TF_AXIOM(counter.frames.size() == 5);
+    for (const std::vector<uintptr_t>& f : counter.frames) {
+        TF_AXIOM((f == std::vector<uintptr_t>(frames, frames + 2)));
+    }
+
+    // A sample before a later child is in the exclusive time of its parent.
+    std::unique_ptr<TraceEventList> lateEvents(new TraceEventList);
+    lateEvents->EmplaceBack(TraceEvent::Timespan,
+        lateEvents->CacheKey("Inner"), Ms(6.0), Ms(8.0),
+        TraceCategory::Default);
+    lateEvents->EmplaceBack(TraceEvent::Timespan,
+        lateEvents->CacheKey("Outer"), Ms(1.0), Ms(10.0),
+        TraceCategory::Default);
+    lateEvents->EmplaceBack(TraceEvent::Sample,
+        lateEvents->CacheKey("Sample"), Ms(3.0),
+        lateEvents->StoreStackFrames(frames, 2), TraceCategory::Default);
+
+    std::shared_ptr<TraceCollection> late(new TraceCollection);
+    late->AddToCollection(TraceThreadId("Thread 1"), std::move(lateEvents));
+    TraceReporterRefPtr lateReporter = TraceReporter::New(
+        "Test", TraceReporterDataSourceCollection::New(late));
+    lateReporter->UpdateTraceTrees();
+
+    const TraceAggregateNodePtr lateRoot =
+        lateReporter->GetAggregateTreeRoot();
+    TF_AXIOM(CountSamples(FindNode(lateRoot, "Outer")) == 1);
+    TF_AXIOM(CountSamples(FindNode(lateRoot, "Inner")) == 0);
+
+    std::cout << " PASSED\n";
+}
+
+// Spins for ms milliseconds in a scope.
+static void
+Spin(double ms)
+{
+    TRACE_FUNCTION();
+    const uint64_t end = ArchGetTickTime() + Ms(ms);
+    while (ArchGetTickTime() < end) {}
+}
+
+static void
+TestSampling()
+{
+    std::cout << "Testing sampling\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterPtr reporter = TraceReporter::GetGlobalReporter();
+    TF_AXIOM(!collector.IsSamplingEnabled());
+    TF_AXIOM(collector.GetSamplingInterval() == Ms(1.0));
+
+    collector.SetEnabled(true);
+    collector.SetSamplingInterval(Ms(0.5));
+    collector.SetSamplingEnabled(true);
+    TF_AXIOM(collector.IsSamplingEnabled());
+    TF_AXIOM(collector.GetSamplingInterval() == Ms(0.5));
+
+    // The first event registers the thread, whose timer is started by the
+    // sampler thread. CPU timers fire on scheduler ticks, which may be as
+    // long as 10 ms.
+    Spin(50.0);
+    Spin(300.0);
+
+    collector.SetSamplingEnabled(false);
+    collector.SetEnabled(false);
+    TF_AXIOM(!collector.IsSamplingEnabled());
+    reporter->UpdateTraceTrees();
+
+    const TraceAggregateNodePtr spin = FindNode(
+        reporter->GetAggregateTreeRoot(), "Spin");
+    TF_AXIOM(spin);
+    const int samples = CountSamples(spin);
+    std::cout << " " << samples << " samples\n";
+    TF_AXIOM(samples > 10);
+
+    // No samples are recorded while collection is disabled.
+    reporter->ClearTree();
+    collector.SetSamplingEnabled(true);
+    Spin(50.0);
+    collector.SetSamplingEnabled(false);
+    reporter->UpdateTraceTrees();
+    TF_AXIOM(reporter->GetAggregateTreeRoot()->GetChildrenRef().empty());
+
+    collector.SetSamplingInterval(Ms(1.0));
+
+    std::cout << " PASSED\n";
+}
+
+#if defined(ARCH_OS_LINUX)
+
+static std::atomic<int> hostSignals(0);
+
+static void
+HandleHostSignal(int)
+{
+    ++hostSignals;
+}
+
+static void
+TestPreviousHandler()
+{
+    std::cout << "Testing previous signal handler\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterPtr reporter = TraceReporter::GetGlobalReporter();
+    reporter->ClearTree();
+
+    struct sigaction action = {};
+    action.sa_handler = &HandleHostSignal;
+    sigemptyset(&action.sa_mask);
+    TF_AXIOM(sigaction(SIGPROF, &action, nullptr) == 0);
+
+    collector.SetEnabled(true);
+    collector.SetSamplingInterval(Ms(0.5));
+    collector.SetSamplingEnabled(true);
+
+    // Signals which are not sent by the sampler are passed on, and the
+    // samples are not.
+    raise(SIGPROF);
+    TF_AXIOM(hostSignals == 1);
+    Spin(50.0);
+    Spin(100.0);
+    TF_AXIOM(hostSignals == 1);
+
+    // Changing the interval keeps the handler of the sampler installed.
+    collector.SetSamplingInterval(Ms(1.0));
+    struct sigaction current;
+    TF_AXIOM(sigaction(SIGPROF, nullptr, &current) == 0);
+    TF_AXIOM(current.sa_handler != &HandleHostSignal);
+
+    collector.SetSamplingEnabled(false);
+    collector.SetEnabled(false);
+    reporter->UpdateTraceTrees();
+    TF_AXIOM(CountSamples(FindNode(
+        reporter->GetAggregateTreeRoot(), "Spin")) > 0);
+
+    // The previous handler is restored when sampling stops.
+    TF_AXIOM(sigaction(SIGPROF, nullptr, &current) == 0);
+    TF_AXIOM(current.sa_handler == &HandleHostSignal);
+    raise(SIGPROF);
+    TF_AXIOM(hostSignals == 2);
+
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGPROF, &action, nullptr);
+
+    std::cout << " PASSED\n";
+}
+
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    TestAttribution();
+#if defined(ARCH_OS_LINUX)
+    TestSampling();
+    TestPreviousHandler();
+#endif
+}
@@ -0,0 +1,219 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collector.h>
+#include <pxr/trace/reporterDataSourceCollector.h>
+#include <pxr/trace/scopeStats.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+static void
+TestHistogram()
+{
+    std::cout << "Testing histogram\n";
+
+    // Bucket bounds are contiguous.
+    for (size_t i = 0; i + 1 < TraceScopeStats::NumBuckets - 4; ++i) {
+        const TraceScopeStats::TimeStamp lower =
+            TraceScopeStats::GetBucketLowerBound(i);
+        const TraceScopeStats::TimeStamp upper =
+            TraceScopeStats::GetBucketLowerBound(i + 1);
+        TF_AXIOM(lower < upper);
+        TF_AXIOM(TraceScopeStats::GetBucket(lower) == i);
+        TF_AXIOM(TraceScopeStats::GetBucket(upper - 1) == i);
+    }
+
+    TraceScopeStats stats;
+    TF_AXIOM(stats.GetCount() == 0);
+    TF_AXIOM(stats.GetMin() == 0);
+    TF_AXIOM(stats.GetPercentile(50.0) == 0);
+
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        stats.Record(i);
+    }
+    TF_AXIOM(stats.GetCount() == 10000);
+    TF_AXIOM(stats.GetTotal() == 10000 * 10001 / 2);
+    TF_AXIOM(stats.GetMin() == 1);
+    TF_AXIOM(stats.GetMax() == 10000);
+    TF_AXIOM(stats.GetPercentile(0.0) == 1);
+    TF_AXIOM(stats.GetPercentile(100.0) == 10000);
+
+    // Estimates are within the precision of the buckets.
+    for (double p : {10.0, 50.0, 90.0, 99.0, 99.9}) {
+        const double exact = p * 100.0;
+        const double estimate = double(stats.GetPercentile(p));
+        std::cout << "  p" << p << ": " << estimate << "\n";
+        TF_AXIOM(estimate > exact * 0.8 && estimate < exact * 1.2);
+    }
+
+    // Merging is the same as recording everything in the same stats.
+    TraceScopeStats a, b;
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        (i % 3 ? a : b).Record(i);
+    }
+    a.Merge(b);
+    a.Merge(TraceScopeStats());
+    TF_AXIOM(a.GetCount() == stats.GetCount());
+    TF_AXIOM(a.GetTotal() == stats.GetTotal());
+    TF_AXIOM(a.GetMin() == stats.GetMin());
+    TF_AXIOM(a.GetMax() == stats.GetMax());
+    TF_AXIOM(a.GetHistogram() == stats.GetHistogram());
+
+    std::cout << " PASSED\n";
+}
+
+// Counts the events of the collections produced by the collector.
+class EventCounter {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        count += events.size();
+    }
+
+    size_t count = 0;
+};
+
+static size_t
+CountEvents(TraceReporterDataSourceCollector& source)
+{
+    TraceCollector::GetInstance().CreateCollection();
+    EventCounter counter;
+    for (const auto& collection : source.ConsumeData()) {
+        collection->IterateBatches(counter);
+    }
+    return counter.count;
+}
+
+static void
+InnerScope()
+{
+    TRACE_FUNCTION();
+}
+
+static void
+OuterScope()
+{
+    TRACE_SCOPE("Outer Scope");
+    InnerScope();
+}
+
+// Records a scope with an argument.
+static void
+ArgsScope()
+{
+    static constexpr TraceStaticKeyData key("Args Scope");
+    static constexpr TraceStaticKeyData argKey("Arg");
+    TraceScopeAuto scope(key, TraceKey(argKey), 1);
+}
+
+static void
+TestMetricsOnly()
+{
+    std::cout << "Testing metrics-only recording\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    TraceReporterDataSourceCollector::ThisRefPtr source =
+        TraceReporterDataSourceCollector::New();
+
+    collector.SetMetricsOnly(true);
+    collector.SetEnabled(true);
+
+    const int numThreads = 4;
+    const int numScopes = 10000;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < numScopes; ++i) {
+                OuterScope();
+            }
+        });
+    }
+
+    // Statistics can be read while recording.
+    std::thread reader([&]() {
+        while (!done) {
+            TraceCollector::ScopeStatsMap stats = collector.GetScopeStats();
+            auto it = stats.find(TfToken("Outer Scope"));
+            if (it != stats.end()) {
+                TF_AXIOM(it->second.GetCount() <= numThreads * numScopes);
+                TF_AXIOM(it->second.GetPercentile(99.0) <=
+                    it->second.GetMax());
+            }
+        }
+    });
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+
+    // The arguments of the scopes are not stored, but other events are.
+    ArgsScope();
+    TRACE_MARKER("Marker");
+
+    collector.SetEnabled(false);
+    collector.SetMetricsOnly(false);
+
+    // No events were recorded for the scopes.
+    TF_AXIOM(CountEvents(*source) == 1);
+
+    TraceCollector::ScopeStatsMap stats = collector.GetScopeStats();
+    TF_AXIOM(stats.size() == 3);
+    TF_AXIOM(stats[TfToken("Args Scope")].GetCount() == 1);
+    const TraceScopeStats& outer = stats[TfToken("Outer Scope")];
+    const TraceScopeStats& inner = stats[TfToken("InnerScope")];
+    TF_AXIOM(outer.GetCount() == numThreads * numScopes);
+    TF_AXIOM(inner.GetCount() == numThreads * numScopes);
+    TF_AXIOM(outer.GetTotal() >= inner.GetTotal());
+    TF_AXIOM(outer.GetMin() <= outer.GetPercentile(50.0));
+    TF_AXIOM(outer.GetPercentile(50.0) <= outer.GetPercentile(99.0));
+    TF_AXIOM(outer.GetPercentile(99.0) <= outer.GetMax());
+    std::cout << "  Outer Scope: mean " << outer.GetMean() << " p99 "
+              << outer.GetPercentile(99.0) << " ticks\n";
+
+    // Events are recorded again once the mode is disabled.
+    collector.SetEnabled(true);
+    OuterScope();
+    collector.SetEnabled(false);
+    TF_AXIOM(CountEvents(*source) == 2);
+    TF_AXIOM(collector.GetScopeStats()[TfToken("Outer Scope")].GetCount()
+        == numThreads * numScopes);
+
+    collector.ClearScopeStats();
+    TF_AXIOM(collector.GetScopeStats().empty());
+
+    // Scopes are counted from zero after the statistics are cleared.
+    collector.SetMetricsOnly(true);
+    collector.SetEnabled(true);
+    OuterScope();
+    collector.SetEnabled(false);
+    collector.SetMetricsOnly(false);
+    stats = collector.GetScopeStats();
+    TF_AXIOM(stats.size() == 2);
+    TF_AXIOM(stats[TfToken("Outer Scope")].GetCount() == 1);
+    TF_AXIOM(stats[TfToken("InnerScope")].GetCount() == 1);
+    collector.ClearScopeStats();
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestHistogram();
+    TestMetricsOnly();
+}
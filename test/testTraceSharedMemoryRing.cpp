@@ -0,0 +1,412 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/sharedMemoryRing.h>
+#include <pxr/trace/clock.h>
+#include <pxr/trace/trace.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/eventData.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/stringUtils.h>
+#include <pxr/arch/defines.h>
+#include <pxr/js/json.h>
+
+#if !defined(ARCH_OS_WINDOWS)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+#include <set>
+#include <sstream>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+// Returns a ring name which is unique to this run of the test.
+static std::string
+GetRingName(const std::string& suffix)
+{
+    return TfStringPrintf("testTraceSharedMemoryRing_%d_%s",
+        TraceGetProcessId(), suffix.c_str());
+}
+
+// Counts the events of each type and thread of a collection.
+class EventCounter : public TraceCollection::Visitor {
+public:
+    void OnBeginCollection() override {}
+    void OnEndCollection() override {}
+    void OnBeginThread(const TraceThreadId& threadId) override {
+        threads.insert(threadId);
+    }
+    void OnEndThread(const TraceThreadId&) override {}
+    bool AcceptsCategory(TraceCategoryId) override { return true; }
+    void OnEvent(const TraceThreadId& threadId, const TfToken& key,
+        const TraceEvent& e) override {
+        ++counts[e.GetType()];
+        ++total;
+        if (e.GetType() == TraceEvent::EventType::ScopeData) {
+            const TraceEventData data = e.GetData();
+            if (const std::string* s = data.GetString()) {
+                strings.insert(*s);
+            }
+        }
+        if (e.GetType() == TraceEvent::EventType::CounterDelta) {
+            counterSum += e.GetCounterValue();
+        }
+        if (key == TfToken("Span")) {
+            TF_AXIOM(e.GetStartTimeStamp() == 100);
+            TF_AXIOM(e.GetEndTimeStamp() == 200);
+        }
+    }
+
+    std::set<TraceThreadId> threads;
+    std::map<TraceEvent::EventType, size_t> counts;
+    std::set<std::string> strings;
+    double counterSum = 0.0;
+    size_t total = 0;
+};
+
+static std::unique_ptr<TraceCollection>
+CreateTestCollection()
+{
+    std::unique_ptr<TraceCollection> collection(new TraceCollection);
+    TraceCollection::EventListPtr events(new TraceEventList);
+    const TraceKey scope = events->CacheKey("Scope");
+    const TraceKey counter = events->CacheKey("Counter");
+    const TraceKey data = events->CacheKey("Data");
+    const TraceKey span = events->CacheKey("Span");
+
+    events->EmplaceBack(TraceEvent::Begin, scope, 10, TraceCategory::Default);
+    events->EmplaceBack(TraceEvent::CounterDelta, counter, 2.5,
+        TraceCategory::Default);
+    events->EmplaceBack(TraceEvent::Data, data,
+        events->StoreData(std::string("String Data").c_str()),
+        TraceCategory::Default);
+    events->EmplaceBack(TraceEvent::Data, data, int64_t(-3),
+        TraceCategory::Default);
+    events->EmplaceBack(TraceEvent::Timespan, span,
+        TraceEvent::TimeStamp(100), TraceEvent::TimeStamp(200),
+        TraceCategory::Default);
+    events->EmplaceBack(TraceEvent::End, scope, 300, TraceCategory::Default);
+    collection->AddToCollection(TraceThreadId("Thread 1"), std::move(events));
+    return collection;
+}
+
+static void
+TestWriteAndRead()
+{
+    std::cout << "Testing write and read\n";
+
+    TraceSharedMemoryRingRefPtr ring =
+        TraceSharedMemoryRing::New(GetRingName("basic"));
+    TF_AXIOM(ring);
+    TF_AXIOM(ring->IsOwner());
+
+    // A second participant opens the same region.
+    TraceSharedMemoryRingRefPtr other =
+        TraceSharedMemoryRing::New(GetRingName("basic"));
+    TF_AXIOM(other);
+    TF_AXIOM(!other->IsOwner());
+
+    ring->Write(*CreateTestCollection());
+    TF_AXIOM(other->GetWriteCount() == 6);
+
+    std::unique_ptr<TraceCollection> collection = other->CreateCollection();
+    EventCounter counter;
+    collection->Iterate(counter);
+    TF_AXIOM(counter.total == 6);
+    TF_AXIOM(counter.threads.size() == 1);
+    TF_AXIOM(counter.threads.begin()->ToString() == "Thread 1");
+    TF_AXIOM(counter.threads.begin()->GetProcessId() == TraceGetProcessId());
+    TF_AXIOM(counter.counts[TraceEvent::EventType::ScopeData] == 2);
+    TF_AXIOM(counter.strings.count("String Data") == 1);
+    TF_AXIOM(counter.counterSum == 2.5);
+
+    // Reading from a position only returns new events.
+    uint64_t position = 0;
+    TF_AXIOM(ring->CreateCollection(&position));
+    TF_AXIOM(position == 6);
+    ring->Write(*CreateTestCollection());
+    EventCounter newEvents;
+    ring->CreateCollection(&position)->Iterate(newEvents);
+    TF_AXIOM(newEvents.total == 6);
+    TF_AXIOM(position == 12);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestOverwrite()
+{
+    std::cout << "Testing overwrite\n";
+
+    TraceSharedMemoryRing::Options options;
+    options.capacity = 8;
+    options.stringTableCapacity = 8;
+    options.stringStorageSize = 64;
+    TraceSharedMemoryRingRefPtr ring =
+        TraceSharedMemoryRing::New(GetRingName("small"), options);
+    TF_AXIOM(ring);
+    TF_AXIOM(ring->GetCapacity() == 8);
+
+    ring->Write(*CreateTestCollection());
+    ring->Write(*CreateTestCollection());
+    TF_AXIOM(ring->GetWriteCount() == 12);
+
+    // Only the most recent events remain.
+    EventCounter counter;
+    ring->CreateCollection()->Iterate(counter);
+    TF_AXIOM(counter.total == 8);
+
+    // The string table holds 8 strings, so the events of the keys which do
+    // not fit are dropped.
+    TraceCollection collection;
+    TraceCollection::EventListPtr events(new TraceEventList);
+    for (int i = 0; i < 8; ++i) {
+        events->EmplaceBack(TraceEvent::Marker,
+            events->CacheKey(TfStringPrintf("Marker %d", i)),
+            TraceEvent::TimeStamp(i), TraceCategory::Default);
+    }
+    collection.AddToCollection(TraceThreadId("Thread 2"), std::move(events));
+    ring->Write(collection);
+    TF_AXIOM(ring->GetDroppedCount() > 0);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestCalibration()
+{
+    std::cout << "Testing calibration\n";
+
+    TraceSharedMemoryRingRefPtr ring =
+        TraceSharedMemoryRing::New(GetRingName("calibration"));
+    TF_AXIOM(ring);
+
+    // The events of a process on another host are converted to the clock
+    // of this process when read.
+    const TraceClockCalibration local = TraceClock::GetCalibration();
+    TraceClockCalibration remote = local;
+    remote.host = "Other Host";
+    remote.anchor = local.anchor + 1000000000;
+    TF_AXIOM(!remote.IsSameClock(local));
+
+    const TraceEvent::TimeStamp time = remote.anchor + 5000;
+    TraceCollection collection;
+    collection.SetClockCalibration(remote);
+    TraceCollection::EventListPtr events(new TraceEventList);
+    events->EmplaceBack(TraceEvent::Timespan, events->CacheKey("Converted"),
+        time, time + 100, TraceCategory::Default);
+    const int remoteProcessId = 1;
+    collection.AddToCollection(
+        TraceThreadId("Remote Thread", remoteProcessId), std::move(events));
+    ring->Write(collection);
+
+    // The events of this process are not converted.
+    ring->Write(*CreateTestCollection());
+
+    class SpanReader : public EventCounter {
+    public:
+        void OnEvent(const TraceThreadId& threadId, const TfToken& key,
+            const TraceEvent& e) override {
+            EventCounter::OnEvent(threadId, key, e);
+            if (key == TfToken("Converted")) {
+                TF_AXIOM(threadId.GetProcessId() == remoteProcessId);
+                start = e.GetStartTimeStamp();
+                end = e.GetEndTimeStamp();
+            }
+        }
+        TraceEvent::TimeStamp start = 0;
+        TraceEvent::TimeStamp end = 0;
+    };
+    SpanReader reader;
+    std::unique_ptr<TraceCollection> read = ring->CreateCollection();
+    TF_AXIOM(read->GetClockCalibration() == local);
+    read->Iterate(reader);
+    TF_AXIOM(reader.total == 7);
+    TF_AXIOM(reader.start == remote.Convert(time, local));
+    TF_AXIOM(reader.end == remote.Convert(time + 100, local));
+    TF_AXIOM(reader.start != time);
+
+    std::cout << " PASSED\n";
+}
+
+#if !defined(ARCH_OS_WINDOWS)
+static void
+TestPeriodicPublishing()
+{
+    std::cout << "Testing periodic publishing\n";
+
+    const std::string name = GetRingName("periodic");
+    TraceSharedMemoryRingRefPtr ring = TraceSharedMemoryRing::New(name);
+    TF_AXIOM(ring);
+
+    // Each writer waits for the parent on its own pipe before each step, and
+    // reports the end of the step through a pipe shared by the writers.
+    const int numWriters = 2;
+    const int numRounds = 2;
+    const int scopesPerRound = 10;
+    int toParent[2];
+    TF_AXIOM(pipe(toParent) == 0);
+    int toWriters[numWriters][2];
+    for (int i = 0; i < numWriters; ++i) {
+        TF_AXIOM(pipe(toWriters[i]) == 0);
+        const pid_t pid = fork();
+        TF_AXIOM(pid >= 0);
+        if (pid == 0) {
+            // Reads fail instead of blocking if the parent exits.
+            close(toWriters[i][1]);
+            close(toParent[0]);
+
+            TraceSharedMemoryRingRefPtr worker =
+                TraceSharedMemoryRing::New(name);
+            if (!worker) {
+                _exit(1);
+            }
+            worker->SetPublishing(true);
+            TraceCollector& collector = TraceCollector::GetInstance();
+            collector.SetEnabled(true);
+            char c = 0;
+            for (int round = 0; round < numRounds; ++round) {
+                if (read(toWriters[i][0], &c, 1) != 1) {
+                    _exit(1);
+                }
+                for (int j = 0; j < scopesPerRound; ++j) {
+                    TRACE_SCOPE("Periodic Scope");
+                }
+                if (write(toParent[1], "r", 1) != 1 ||
+                    read(toWriters[i][0], &c, 1) != 1) {
+                    _exit(1);
+                }
+                // Events reach the ring when a collection is created.
+                collector.CreateCollection();
+                if (write(toParent[1], "p", 1) != 1) {
+                    _exit(1);
+                }
+            }
+            collector.SetEnabled(false);
+            _exit(0);
+        }
+    }
+
+    // Lets each writer run its next step and waits for them to finish it.
+    auto runWriters = [&]() {
+        for (int i = 0; i < numWriters; ++i) {
+            TF_AXIOM(write(toWriters[i][1], "c", 1) == 1);
+        }
+        for (int i = 0; i < numWriters; ++i) {
+            char c = 0;
+            TF_AXIOM(read(toParent[0], &c, 1) == 1);
+        }
+    };
+
+    uint64_t position = 0;
+    for (int round = 0; round < numRounds; ++round) {
+        // The writers recorded their events but did not publish them yet.
+        runWriters();
+        EventCounter recorded;
+        ring->CreateCollection(&position)->Iterate(recorded);
+        TF_AXIOM(recorded.total == 0);
+
+        runWriters();
+        EventCounter published;
+        ring->CreateCollection(&position)->Iterate(published);
+        TF_AXIOM(published.total == size_t(numWriters * scopesPerRound));
+        TF_AXIOM(published.threads.size() == size_t(numWriters));
+    }
+
+    for (int i = 0; i < numWriters; ++i) {
+        int status = 0;
+        TF_AXIOM(wait(&status) > 0);
+        TF_AXIOM(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        close(toWriters[i][0]);
+        close(toWriters[i][1]);
+    }
+    close(toParent[0]);
+    close(toParent[1]);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestMultipleProcesses()
+{
+    std::cout << "Testing multiple processes\n";
+
+    const std::string name = GetRingName("processes");
+    TraceSharedMemoryRingRefPtr ring = TraceSharedMemoryRing::New(name);
+    TF_AXIOM(ring);
+
+    const int numProcesses = 3;
+    const int scopesPerProcess = 100;
+    std::set<int> pids;
+    for (int i = 0; i < numProcesses; ++i) {
+        const pid_t pid = fork();
+        TF_AXIOM(pid >= 0);
+        if (pid == 0) {
+            // Each worker records through its own collector and publishes
+            // its collections to the ring.
+            TraceSharedMemoryRingRefPtr worker =
+                TraceSharedMemoryRing::New(name);
+            if (!worker || worker->IsOwner()) {
+                _exit(1);
+            }
+            worker->SetPublishing(true);
+            TraceCollector& collector = TraceCollector::GetInstance();
+            collector.SetEnabled(true);
+            for (int j = 0; j < scopesPerProcess; ++j) {
+                TRACE_SCOPE("Worker Scope");
+            }
+            collector.SetEnabled(false);
+            collector.CreateCollection();
+            _exit(0);
+        }
+        pids.insert(int(pid));
+    }
+    for (int i = 0; i < numProcesses; ++i) {
+        int status = 0;
+        TF_AXIOM(wait(&status) > 0);
+        TF_AXIOM(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    std::unique_ptr<TraceCollection> collection = ring->CreateCollection();
+    EventCounter counter;
+    collection->Iterate(counter);
+    TF_AXIOM(counter.total == size_t(numProcesses * scopesPerProcess));
+    std::set<int> recordedPids;
+    for (const TraceThreadId& threadId : counter.threads) {
+        recordedPids.insert(threadId.GetProcessId());
+    }
+    TF_AXIOM(recordedPids == pids);
+
+    // The Chrome trace has one main thread per process.
+    TraceEventTreeRefPtr tree = TraceEventTree::New(*collection);
+    TF_AXIOM(tree->GetRoot()->GetChildrenRef().size() == size_t(numProcesses));
+    std::ostringstream chrome;
+    JsWriter writer(chrome);
+    tree->WriteChromeTraceObject(writer);
+    std::cout << chrome.str().substr(0, 200) << "...\n";
+    for (const int pid : pids) {
+        TF_AXIOM(chrome.str().find(TfStringPrintf("\"pid\":%d", pid))
+            != std::string::npos);
+    }
+    TF_AXIOM(chrome.str().find("\"pid\":0") == std::string::npos);
+
+    std::cout << " PASSED\n";
+}
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    TestWriteAndRead();
+    TestOverwrite();
+    TestCalibration();
+#if !defined(ARCH_OS_WINDOWS)
+    TestPeriodicPublishing();
+    TestMultipleProcesses();
+#endif
+}
@@ -0,0 +1,221 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/collector.h>
+#include <pxr/trace/serialization.h>
+#include <pxr/trace/snapshotTrigger.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/arch/timing.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+// Collects the keys and the time range of the events of a collection.
+class EventScanner {
+public:
+    void OnBeginCollection() {}
+    void OnEndCollection() {}
+    void OnBeginThread(const TraceThreadId&) {}
+    void OnEndThread(const TraceThreadId&) {}
+    void OnEvents(
+        const TraceThreadId&, const TraceCollection::EventSpan& events) {
+        const TraceCollection::KeyTable& table = events.GetKeyTable();
+        for (const TraceEvent& e : events) {
+            ++counts[table.GetToken(table.GetKeyId(e.GetKey()))];
+            minTime = std::min(minTime, e.GetTimeStamp());
+            maxTime = std::max(maxTime, e.GetTimeStamp());
+        }
+    }
+
+    std::map<TfToken, size_t> counts;
+    TraceEvent::TimeStamp minTime = ~TraceEvent::TimeStamp(0);
+    TraceEvent::TimeStamp maxTime = 0;
+};
+
+static EventScanner
+Scan(const std::shared_ptr<TraceCollection>& collection)
+{
+    EventScanner scanner;
+    collection->IterateBatches(scanner);
+    return scanner;
+}
+
+// Waits up to a few seconds for \p trigger to take \p count snapshots.
+static bool
+WaitForSnapshots(const TraceSnapshotTriggerRefPtr& trigger, size_t count)
+{
+    for (int i = 0; i < 500; ++i) {
+        if (trigger->GetSnapshotCount() >= count) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+static void
+SlowScope()
+{
+    TRACE_FUNCTION();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+static void
+FastScope()
+{
+    TRACE_FUNCTION();
+}
+
+static void
+TestScopeTrigger()
+{
+    std::cout << "Testing scope trigger\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.SetEnabled(true);
+
+    TraceSnapshotTrigger::Options options;
+    options.window = 0.2;
+    options.cooldown = 60.0;
+    TraceSnapshotTriggerRefPtr trigger = TraceSnapshotTrigger::New(options);
+    trigger->AddScopeTrigger(TfToken("SlowScope"), 0.02);
+
+    // Fast scopes do not trigger snapshots.
+    for (int i = 0; i < 1000; ++i) {
+        FastScope();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TF_AXIOM(trigger->GetSnapshotCount() == 0);
+    TF_AXIOM(!trigger->GetLastSnapshot());
+
+    // Events older than the window are not part of the snapshot.
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const TraceEvent::TimeStamp start = ArchGetTickTime();
+    FastScope();
+    SlowScope();
+    const TraceEvent::TimeStamp end = ArchGetTickTime();
+
+    TF_AXIOM(WaitForSnapshots(trigger, 1));
+    std::shared_ptr<TraceCollection> snapshot = trigger->GetLastSnapshot();
+    TF_AXIOM(snapshot);
+    EventScanner scanner = Scan(snapshot);
+    TF_AXIOM(scanner.counts[TfToken("SlowScope")] == 1);
+    TF_AXIOM(scanner.counts[TfToken("FastScope")] == 1);
+    TF_AXIOM(scanner.maxTime <= end);
+    TF_AXIOM(scanner.minTime >= start - ArchSecondsToTicks(options.window));
+    TF_AXIOM(trigger->GetLastSnapshotPath().empty());
+
+    // Slow scopes during the cooldown do not trigger snapshots.
+    SlowScope();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TF_AXIOM(trigger->GetSnapshotCount() == 1);
+    TF_AXIOM(trigger->GetLastSnapshot() == snapshot);
+
+    // Removed triggers do not fire.
+    options.cooldown = 0.0;
+    trigger = TraceSnapshotTrigger::New(options);
+    trigger->AddScopeTrigger(TfToken("SlowScope"), 0.02);
+    trigger->RemoveTrigger(TfToken("SlowScope"));
+    SlowScope();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TF_AXIOM(trigger->GetSnapshotCount() == 0);
+
+    trigger = nullptr;
+    collector.SetEnabled(false);
+    collector.Clear();
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestMarkerTrigger()
+{
+    std::cout << "Testing marker trigger\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.SetEnabled(true);
+
+    TraceSnapshotTrigger::Options options;
+    options.cooldown = 0.0;
+    options.sendNotice = false;
+    TraceSnapshotTriggerRefPtr trigger = TraceSnapshotTrigger::New(options);
+    trigger->AddMarkerTrigger(TfToken("Frame Dropped"));
+
+    FastScope();
+    TRACE_MARKER("Frame Dropped");
+    TF_AXIOM(WaitForSnapshots(trigger, 1));
+    EventScanner scanner = Scan(trigger->GetLastSnapshot());
+    TF_AXIOM(scanner.counts[TfToken("FastScope")] == 1);
+    TF_AXIOM(scanner.counts[TfToken("Frame Dropped")] == 1);
+
+    // Other markers do not trigger snapshots.
+    TRACE_MARKER("Frame Done");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TF_AXIOM(trigger->GetSnapshotCount() == 1);
+
+    TRACE_MARKER("Frame Dropped");
+    TF_AXIOM(WaitForSnapshots(trigger, 2));
+
+    trigger = nullptr;
+    collector.SetEnabled(false);
+    collector.Clear();
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestManualTrigger()
+{
+    std::cout << "Testing manual trigger\n";
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.SetEnabled(true);
+
+    // Collections are only created by the trigger itself.
+    TraceSnapshotTrigger::Options options;
+    options.window = 10.0;
+    options.flushInterval = 0.0;
+    options.outputDirectory = ".";
+    TraceSnapshotTriggerRefPtr trigger = TraceSnapshotTrigger::New(options);
+
+    for (int i = 0; i < 10; ++i) {
+        FastScope();
+    }
+    trigger->Trigger();
+    TF_AXIOM(WaitForSnapshots(trigger, 1));
+
+    const std::string path = trigger->GetLastSnapshotPath();
+    TF_AXIOM(!path.empty());
+    std::ifstream in(path);
+    std::unique_ptr<TraceCollection> collection =
+        TraceSerialization::Read(in);
+    TF_AXIOM(collection);
+    EventScanner scanner;
+    collection->IterateBatches(scanner);
+    TF_AXIOM(scanner.counts[TfToken("FastScope")] == 10);
+    in.close();
+    std::remove(path.c_str());
+
+    trigger = nullptr;
+    collector.SetEnabled(false);
+    collector.Clear();
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestScopeTrigger();
+    TestMarkerTrigger();
+    TestManualTrigger();
+}
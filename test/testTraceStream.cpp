@@ -0,0 +1,261 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/streamServer.h>
+#include <pxr/trace/reporterDataSourceStream.h>
+#include <pxr/trace/collectionGenerator.h>
+#include <pxr/trace/collector.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/trace/reporter.h>
+#include <pxr/trace/trace.h>
+#include <pxr/tf/diagnostic.h>
+#include <pxr/tf/stringUtils.h>
+#include <pxr/arch/defines.h>
+
+#if !defined(ARCH_OS_WINDOWS)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+#if !defined(ARCH_OS_WINDOWS)
+
+// Returns a socket path which is unique to this run of the test.
+static std::string
+GetSocketPath(const std::string& suffix)
+{
+    return TfStringPrintf("/tmp/testTraceStream_%d_%s.sock",
+        TraceGetProcessId(), suffix.c_str());
+}
+
+// Waits up to 10 seconds for \p condition to become true.
+static bool
+WaitFor(const std::function<bool()>& condition)
+{
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+static void
+TestLiveReport()
+{
+    std::cout << "Testing live report\n";
+
+    TraceStreamServer::Options options;
+    options.flushInterval = 0.01;
+    TraceStreamServerRefPtr server =
+        TraceStreamServer::New(GetSocketPath("live"), options);
+    TF_AXIOM(server);
+
+    TraceReporterDataSourceStream::ThisRefPtr source =
+        TraceReporterDataSourceStream::New(server->GetSocketPath());
+    TF_AXIOM(source);
+    TraceReporterDataSourceStream* stream = source.get();
+    TraceReporterRefPtr reporter =
+        TraceReporter::New("Live", std::move(source));
+    TF_AXIOM(WaitFor([&]() { return server->GetClientCount() == 1; }));
+
+    TraceCollector& collector = TraceCollector::GetInstance();
+    collector.SetEnabled(true);
+
+    const int numThreads = 4;
+    const int numScopes = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < numScopes; ++i) {
+                TRACE_SCOPE("Outer");
+                {
+                    TRACE_SCOPE("Inner");
+                    TRACE_COUNTER_DELTA("Stream Counter", 1);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    collector.SetEnabled(false);
+
+    // Events arrive while the reporter is updated. The aggregate tree has a
+    // node for each thread.
+    auto countScopes = [&](const char* name) {
+        int count = 0;
+        for (const TraceAggregateNodeRefPtr& thread :
+                reporter->GetAggregateTreeRoot()->GetChildrenRef()) {
+            if (TraceAggregateNodeRefPtr outer = thread->GetChild("Outer")) {
+                TraceAggregateNodeRefPtr node =
+                    outer->GetKey() == name ? outer : outer->GetChild(name);
+                count += node ? node->GetCount() : 0;
+            }
+        }
+        return count;
+    };
+    TF_AXIOM(WaitFor([&]() {
+        reporter->UpdateTraceTrees();
+        return countScopes("Outer") == numThreads * numScopes;
+    }));
+    TF_AXIOM(countScopes("Inner") == numThreads * numScopes);
+    TF_AXIOM(reporter->GetEventTree()->GetFinalCounterValues().at(
+        TfToken("Stream Counter")) == numThreads * numScopes);
+
+    TF_AXIOM(stream->IsConnected());
+    TF_AXIOM(stream->GetProcessId() == TraceGetProcessId());
+    TF_AXIOM(stream->GetDroppedEventCount() == 0);
+
+    const TraceStreamServer::Stats stats = server->GetStats();
+    TF_AXIOM(stats.sentEvents == stream->GetReceivedEventCount());
+    TF_AXIOM(stats.droppedEvents == 0);
+    std::cout << "  sent " << stats.sentEvents << " events in "
+              << stats.sentCollections << " collections, "
+              << stats.sentBytes << " bytes\n";
+
+    // The data source sees the end of the stream.
+    server.Reset();
+    TF_AXIOM(WaitFor([&]() { return !stream->IsConnected(); }));
+
+    std::cout << " PASSED\n";
+}
+
+// Connects to the server without reading anything.
+static int
+ConnectStalledClient(const std::string& socketPath)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(),
+        sizeof(address.sun_path) - 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    TF_AXIOM(fd >= 0);
+    TF_AXIOM(connect(fd, reinterpret_cast<sockaddr*>(&address),
+        sizeof(address)) == 0);
+    return fd;
+}
+
+static TraceCollectionGenerator::Shape
+GetShape()
+{
+    TraceCollectionGenerator::Shape shape;
+    shape.numThreads = 1;
+    shape.iterations = 10;
+    shape.depth = 3;
+    shape.fanOut = 4;
+    return shape;
+}
+
+static void
+TestDrop()
+{
+    std::cout << "Testing drop on a stalled consumer\n";
+
+    TraceStreamServer::Options options;
+    options.backpressure = TraceStreamServer::Backpressure::Drop;
+    options.maxPendingEvents = 1000;
+    options.flushInterval = 0.0;
+    TraceStreamServerRefPtr server =
+        TraceStreamServer::New(GetSocketPath("drop"), options);
+    TF_AXIOM(server);
+
+    const int fd = ConnectStalledClient(server->GetSocketPath());
+    TF_AXIOM(WaitFor([&]() { return server->GetClientCount() == 1; }));
+
+    // The socket buffer fills up, then the queue, then collections are
+    // dropped.
+    std::shared_ptr<TraceCollection> collection =
+        TraceCollectionGenerator::Generate(GetShape());
+    for (int i = 0; i < 100000 && server->GetStats().droppedEvents == 0; ++i) {
+        server->Publish(collection);
+    }
+    const TraceStreamServer::Stats stats = server->GetStats();
+    std::cout << "  dropped " << stats.droppedEvents << " events in "
+              << stats.droppedCollections << " collections\n";
+    TF_AXIOM(stats.droppedEvents > 0);
+    TF_AXIOM(stats.droppedCollections > 0);
+    TF_AXIOM(stats.pauses == 0);
+
+    // The server notices that the consumer is gone.
+    close(fd);
+    TF_AXIOM(WaitFor([&]() { return server->GetClientCount() == 0; }));
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestBlock()
+{
+    std::cout << "Testing block on a slow consumer\n";
+
+    TraceStreamServer::Options options;
+    options.backpressure = TraceStreamServer::Backpressure::Block;
+    options.maxPendingEvents = 1000;
+    options.flushInterval = 0.0;
+    TraceStreamServerRefPtr server =
+        TraceStreamServer::New(GetSocketPath("block"), options);
+    TF_AXIOM(server);
+
+    TraceReporterDataSourceStream::ThisRefPtr source =
+        TraceReporterDataSourceStream::New(server->GetSocketPath());
+    TF_AXIOM(source);
+    TF_AXIOM(WaitFor([&]() { return server->GetClientCount() == 1; }));
+
+    std::shared_ptr<TraceCollection> collection =
+        TraceCollectionGenerator::Generate(GetShape());
+    const int numCollections = 200;
+    for (int i = 0; i < numCollections; ++i) {
+        server->Publish(collection);
+    }
+
+    // Every event is received.
+    const uint64_t expected = numCollections *
+        uint64_t(TraceCollectionGenerator::GetExpectedEventCount(GetShape()));
+    TF_AXIOM(WaitFor([&]() {
+        return source->GetReceivedEventCount() == expected;
+    }));
+    TF_AXIOM(server->GetStats().sentEvents == expected);
+
+    size_t received = 0;
+    for (const auto& c : source->ConsumeData()) {
+        TF_AXIOM(c);
+        ++received;
+    }
+    TF_AXIOM(received == size_t(numCollections));
+
+    const TraceStreamServer::Stats stats = server->GetStats();
+    std::cout << "  paused " << stats.pauses << " times for "
+              << stats.pausedSeconds << " seconds\n";
+    TF_AXIOM(stats.droppedEvents == 0);
+    TF_AXIOM(source->GetDroppedEventCount() == 0);
+
+    std::cout << " PASSED\n";
+}
+
+#endif
+
+int
+main(int argc, char *argv[])
+{
+#if !defined(ARCH_OS_WINDOWS)
+    TestLiveReport();
+    TestDrop();
+    TestBlock();
+#endif
+}
@@ -0,0 +1,74 @@
+# Copyright 2026 Jeremy Retailleau
+#
+# Licensed under the terms set forth in the LICENSE.txt file available at
+# https://openusd.org/license.
+
+import unittest
+
+from pxr import Trace
+
+class TestTraceTableColumns(unittest.TestCase):
+    def setUp(self):
+        gc = Trace.Collector()
+        self.reporter = Trace.Reporter.globalReporter
+        self.reporter.ClearTree()
+
+        gc.enabled = True
+        gc.BeginEventAtTime('Main', 0.0)
+        for ts in (1.0, 3.0):
+            gc.BeginEventAtTime('A', ts)
+            gc.EndEventAtTime('A', ts + 1.0)
+        gc.EndEventAtTime('Main', 10.0)
+        gc.enabled = False
+        self.reporter.UpdateTraceTrees()
+
+    def test_EventTable(self):
+        table = self.reporter.GetEventTable()
+        self.assertEqual(len(table), 3)
+
+        keys = [table.keys[k] for k in table.keyIds.tolist()]
+        self.assertEqual(keys, ['Main', 'A', 'A'])
+        self.assertEqual(table.depths.tolist(), [0, 1, 1])
+        self.assertEqual(table.parents.tolist(), [-1, 0, 0])
+        self.assertEqual(len(set(table.threadIds.tolist())), 1)
+
+        begin = table.beginTimes.tolist()
+        end = table.endTimes.tolist()
+        self.assertTrue(all(b < e for b, e in zip(begin, end)))
+        self.assertLess(begin[1], begin[2])
+
+    def test_AggregateTable(self):
+        table = self.reporter.GetAggregateTable()
+        self.assertEqual(len(table), 2)
+
+        keys = [table.keys[k] for k in table.keyIds.tolist()]
+        self.assertEqual(keys, ['Main', 'A'])
+        self.assertEqual(table.counts.tolist(), [1, 2])
+        self.assertEqual(table.parents.tolist(), [-1, 0])
+
+        inclusive = table.inclusiveTimes.tolist()
+        exclusive = table.exclusiveTimes.tolist()
+        self.assertEqual(exclusive[0], inclusive[0] - inclusive[1])
+
+    def test_Columns(self):
+        table = self.reporter.GetEventTable()
+        column = table.parents
+        self.assertEqual(column.format, 'q')
+        self.assertEqual(column.shape, (3,))
+        self.assertTrue(column.readonly)
+
+        # Columns keep their table alive.
+        del table
+        self.assertEqual(column.tolist(), [-1, 0, 0])
+
+        try:
+            import numpy
+        except ImportError:
+            return
+        array = numpy.asarray(self.reporter.GetEventTable().depths)
+        self.assertEqual(array.dtype, numpy.uint32)
+        self.assertEqual(array.tolist(), [0, 1, 1])
+        self.assertFalse(array.flags.writeable)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,135 @@
+// Copyright 2026 Jeremy Retailleau
+//
+// Licensed under the terms set forth in the LICENSE.txt file available at
+// https://openusd.org/license.
+
+#include <pxr/trace/aggregateTable.h>
+#include <pxr/trace/aggregateTree.h>
+#include <pxr/trace/collection.h>
+#include <pxr/trace/eventList.h>
+#include <pxr/trace/eventTable.h>
+#include <pxr/trace/eventTree.h>
+#include <pxr/tf/diagnostic.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+TRACE_NAMESPACE_USING_DIRECTIVE
+
+static void
+AddScope(TraceEventList& events, const char* key,
+         TraceEvent::TimeStamp begin, TraceEvent::TimeStamp end)
+{
+    events.EmplaceBack(TraceEvent::Begin, events.CacheKey(key), begin,
+        TraceCategory::Default);
+    events.EmplaceBack(TraceEvent::End, events.CacheKey(key), end,
+        TraceCategory::Default);
+}
+
+// Creates a collection with Main calling A twice and B on Thread 1, and A
+// on Thread 2.
+static std::unique_ptr<TraceCollection>
+CreateCollection()
+{
+    std::unique_ptr<TraceEventList> events1(new TraceEventList);
+    events1->EmplaceBack(TraceEvent::Begin, events1->CacheKey("Main"), 0,
+        TraceCategory::Default);
+    AddScope(*events1, "A", 10, 20);
+    AddScope(*events1, "A", 30, 45);
+    events1->EmplaceBack(TraceEvent::Begin, events1->CacheKey("B"), 50,
+        TraceCategory::Default);
+    AddScope(*events1, "A", 55, 60);
+    events1->EmplaceBack(TraceEvent::End, events1->CacheKey("B"), 70,
+        TraceCategory::Default);
+    events1->EmplaceBack(TraceEvent::End, events1->CacheKey("Main"), 100,
+        TraceCategory::Default);
+
+    std::unique_ptr<TraceEventList> events2(new TraceEventList);
+    AddScope(*events2, "A", 5, 8);
+
+    std::unique_ptr<TraceCollection> collection(new TraceCollection);
+    collection->AddToCollection(TraceThreadId("Thread 1"), std::move(events1));
+    collection->AddToCollection(TraceThreadId("Thread 2"), std::move(events2));
+    return collection;
+}
+
+template <class Table>
+static std::vector<std::string>
+GetKeys(const Table& table)
+{
+    std::vector<std::string> keys;
+    for (const uint32_t keyId : table.GetKeyIds()) {
+        keys.push_back(table.GetKeys()[keyId].GetString());
+    }
+    return keys;
+}
+
+template <class Table>
+static std::vector<std::string>
+GetThreads(const Table& table)
+{
+    std::vector<std::string> threads;
+    for (const uint32_t threadId : table.GetThreadIds()) {
+        threads.push_back(table.GetKeys()[threadId].GetString());
+    }
+    return threads;
+}
+
+static void
+TestEventTable()
+{
+    std::cout << "Testing event table\n";
+
+    const TraceEventTable table(*TraceEventTree::New(*CreateCollection()));
+    TF_AXIOM(table.GetSize() == 6);
+    TF_AXIOM((GetKeys(table) ==
+        std::vector<std::string>{"Main", "A", "A", "B", "A", "A"}));
+    TF_AXIOM((GetThreads(table) == std::vector<std::string>{
+        "Thread 1", "Thread 1", "Thread 1", "Thread 1", "Thread 1",
+        "Thread 2"}));
+    TF_AXIOM(table.GetKeyIds()[1] == table.GetKeyIds()[5]);
+    TF_AXIOM((table.GetBeginTimes() ==
+        std::vector<TraceEvent::TimeStamp>{0, 10, 30, 50, 55, 5}));
+    TF_AXIOM((table.GetEndTimes() ==
+        std::vector<TraceEvent::TimeStamp>{100, 20, 45, 70, 60, 8}));
+    TF_AXIOM((table.GetDepths() == std::vector<uint32_t>{0, 1, 1, 1, 2, 0}));
+    TF_AXIOM((table.GetParents() ==
+        std::vector<int64_t>{-1, 0, 0, 0, 3, -1}));
+    TF_AXIOM(table.GetCategories()[4] == TraceCategory::Default);
+
+    std::cout << " PASSED\n";
+}
+
+static void
+TestAggregateTable()
+{
+    std::cout << "Testing aggregate table\n";
+
+    const std::unique_ptr<TraceCollection> collection = CreateCollection();
+    TraceAggregateTreeRefPtr tree = TraceAggregateTree::New();
+    tree->Append(TraceEventTree::New(*collection), *collection);
+
+    const TraceAggregateTable table(*tree);
+    TF_AXIOM(table.GetSize() == 5);
+    TF_AXIOM((GetKeys(table) ==
+        std::vector<std::string>{"Main", "A", "B", "A", "A"}));
+    TF_AXIOM((GetThreads(table) == std::vector<std::string>{
+        "Thread 1", "Thread 1", "Thread 1", "Thread 1", "Thread 2"}));
+    TF_AXIOM((table.GetDepths() == std::vector<uint32_t>{0, 1, 1, 2, 0}));
+    TF_AXIOM((table.GetParents() == std::vector<int64_t>{-1, 0, 0, 2, -1}));
+    TF_AXIOM((table.GetInclusiveTimes() ==
+        std::vector<TraceEvent::TimeStamp>{100, 25, 20, 5, 3}));
+    TF_AXIOM((table.GetExclusiveTimes() ==
+        std::vector<TraceEvent::TimeStamp>{55, 25, 15, 5, 3}));
+    TF_AXIOM((table.GetCounts() == std::vector<int>{1, 2, 1, 1, 1}));
+
+    std::cout << " PASSED\n";
+}
+
+int
+main(int argc, char *argv[])
+{
+    TestEventTable();
+    TestAggregateTable();
+}